@@ -48,8 +48,8 @@
 
 namespace rcsc {
 
-GameTime Body_AdvanceBall2009::S_last_calc_time( 0, 0 );
-AngleDeg Body_AdvanceBall2009::S_cached_best_angle = 0.0;
+thread_local GameTime Body_AdvanceBall2009::S_last_calc_time( 0, 0 );
+thread_local AngleDeg Body_AdvanceBall2009::S_cached_best_angle = 0.0;
 
 
 namespace {
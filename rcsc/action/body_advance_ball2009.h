@@ -46,9 +46,9 @@ class Body_AdvanceBall2009
     : public BodyAction {
 private:
     //! last game time when calcuration is done.
-    static GameTime S_last_calc_time;
+    static thread_local GameTime S_last_calc_time;
     //! last calculated result
-    static AngleDeg S_cached_best_angle;
+    static thread_local AngleDeg S_cached_best_angle;
 
 public:
     /*!
@@ -299,8 +299,8 @@ get_clear_course_recursive( const WorldModel & wm,
 AngleDeg
 get_clear_course( const WorldModel & wm )
 {
-    static GameTime s_update_time( 0, 0 );
-    static AngleDeg s_last_angle = 0.0;
+    thread_local GameTime s_update_time( 0, 0 );
+    thread_local AngleDeg s_last_angle = 0.0;
 
     if ( s_update_time == wm.time() )
     {
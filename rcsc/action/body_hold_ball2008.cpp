@@ -162,9 +162,9 @@ Body_HoldBall2008::avoidOpponent( PlayerAgent * agent )
 Vector2D
 Body_HoldBall2008::searchKeepPoint( const WorldModel & wm )
 {
-    static GameTime s_last_update_time( 0, 0 );
-    static std::vector< KeepPoint > s_keep_points;
-    static KeepPoint s_best_keep_point;
+    thread_local GameTime s_last_update_time( 0, 0 );
+    thread_local std::vector< KeepPoint > s_keep_points;
+    thread_local KeepPoint s_best_keep_point;
 
     if ( s_last_update_time != wm.time() )
     {
@@ -59,7 +59,7 @@
 
 namespace rcsc {
 
-std::vector< Body_Pass::PassRoute > Body_Pass::S_cached_pass_route;
+thread_local std::vector< Body_Pass::PassRoute > Body_Pass::S_cached_pass_route;
 
 /*-------------------------------------------------------------------*/
 /*!
@@ -156,11 +156,11 @@ Body_Pass::get_best_pass( const WorldModel & world,
                           double * first_speed,
                           int * receiver )
 {
-    static GameTime S_last_calc_time( 0, 0 );
-    static bool S_last_calc_valid = false;
-    static Vector2D S_last_calc_target;
-    static double S_last_calc_speed = 0.0;
-    static int S_last_calc_receiver = Unum_Unknown;
+    thread_local GameTime S_last_calc_time( 0, 0 );
+    thread_local bool S_last_calc_valid = false;
+    thread_local Vector2D S_last_calc_target;
+    thread_local double S_last_calc_speed = 0.0;
+    thread_local int S_last_calc_receiver = Unum_Unknown;
 
     if ( S_last_calc_time == world.time() )
     {
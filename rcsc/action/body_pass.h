@@ -98,7 +98,7 @@ public:
 private:
 
     //! cached calculated pass data
-    static std::vector< PassRoute > S_cached_pass_route;
+    static thread_local std::vector< PassRoute > S_cached_pass_route;
 
 
 public:
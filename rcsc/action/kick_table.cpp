@@ -49,8 +49,29 @@
 #include <rcsc/timer.h>
 
 #include <algorithm>
+#include <atomic>
 #include <functional>
 #include <fstream>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#ifdef HAVE_UNISTD_H
+#include <unistd.h> // close(), getpid()
+#endif
+#ifdef HAVE_FCNTL_H
+#include <fcntl.h> // open()
+#endif
+#ifdef HAVE_SYS_STAT_H
+#include <sys/stat.h> // fstat()
+#endif
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h> // mmap(), munmap()
+#endif
 
 // #define DEBUG_PROFILE
 // #define DEBUG
@@ -78,6 +99,54 @@ const int NUM_STATE = STATE_DIVS_NEAR + STATE_DIVS_MID + STATE_DIVS_FAR;
 
 const size_t MAX_TABLE_SIZE = 1024;
 
+//! binary cache format version. increment this value when the layout is changed.
+const std::uint32_t CACHE_VERSION = 1;
+//! binary cache file magic
+const char CACHE_MAGIC[8] = { 'R', 'C', 'S', 'C', 'K', 'T', 'B', 'L' };
+
+//! FNV-1a offset basis
+const std::uint64_t HASH_BASIS = 14695981039346656037ULL;
+//! FNV-1a prime
+const std::uint64_t HASH_PRIME = 1099511628211ULL;
+
+/*!
+  \struct CacheHeader
+  \brief header of the binary cache file.
+
+  The header is followed by the state list (CacheState x state_size_) and
+  the path entries of all angles (KickTable::Path x sum of table_sizes_).
+  All values are stored in the native byte order.
+ */
+struct CacheHeader {
+    char magic_[8]; //!< file magic
+    std::uint32_t version_; //!< format version
+    std::uint32_t state_size_; //!< the number of states
+    std::uint64_t key_; //!< hash value of the parameters
+    double player_size_; //!< default player size
+    double kickable_margin_; //!< default kickable margin
+    double ball_size_; //!< ball size
+    std::uint32_t table_sizes_[KickTable::DEST_DIR_DIVS]; //!< the number of paths for each angle
+};
+
+/*!
+  \struct CacheState
+  \brief state entry in the binary cache file
+ */
+struct CacheState {
+    std::int32_t index_; //!< index of this state
+    std::int32_t padding_; //!< not used
+    double dist_; //!< distance from self
+    double x_; //!< relative x
+    double y_; //!< relative y
+    double kick_rate_; //!< kick rate
+};
+
+static_assert( std::is_trivially_copyable< KickTable::Path >::value,
+               "KickTable::Path must be trivially copyable." );
+static_assert( sizeof( CacheHeader ) % alignof( KickTable::Path ) == 0
+               && sizeof( CacheState ) % alignof( KickTable::Path ) == 0,
+               "illegal alignment of the cache entries." );
+
 
 /*!
  \struct TableSorter
@@ -214,6 +283,397 @@ is_risky_flag( const int flag )
              || flag & KickTable::KICK_MISS_POSSIBILITY );
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+  \brief update FNV-1a hash value
+  \param hash current hash value
+  \param value hashed value
+  \return updated hash value
+ */
+template < typename T >
+std::uint64_t
+hash_value( std::uint64_t hash,
+            const T & value )
+{
+    unsigned char bytes[sizeof( T )];
+    std::memcpy( bytes, &value, sizeof( T ) );
+    for ( unsigned char b : bytes )
+    {
+        hash ^= b;
+        hash *= HASH_PRIME;
+    }
+    return hash;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief create the key of the binary cache
+  \param player_type the player type used to create the table
+  \return hash value of all parameters that affect the table
+ */
+std::uint64_t
+create_cache_key( const PlayerType & player_type )
+{
+    const ServerParam & SP = ServerParam::i();
+
+    std::uint64_t hash = HASH_BASIS;
+    hash = hash_value( hash, CACHE_VERSION );
+    hash = hash_value( hash, static_cast< std::int32_t >( NUM_STATE ) );
+    hash = hash_value( hash, static_cast< std::int32_t >( KickTable::DEST_DIR_DIVS ) );
+    hash = hash_value( hash, static_cast< std::uint64_t >( MAX_TABLE_SIZE ) );
+    hash = hash_value( hash, SP.ballSize() );
+    hash = hash_value( hash, SP.ballSpeedMax() );
+    hash = hash_value( hash, SP.ballAccelMax() );
+    hash = hash_value( hash, SP.maxPower() );
+    hash = hash_value( hash, PlayerParam::i().kickableMarginDeltaMin() );
+    hash = hash_value( hash, player_type.playerSize() );
+    hash = hash_value( hash, player_type.kickableMargin() );
+    hash = hash_value( hash, player_type.kickPowerRate() );
+    return hash;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief create the key of the state cache
+  \param world world model
+  \return hash value of the self and ball state that affect the state cache
+ */
+std::uint64_t
+create_state_key( const WorldModel & world )
+{
+    const SelfObject & self = world.self();
+    const BallObject & ball = world.ball();
+
+    std::uint64_t hash = HASH_BASIS;
+    hash = hash_value( hash, static_cast< std::int32_t >( self.playerType().id() ) );
+    hash = hash_value( hash, self.pos().x );
+    hash = hash_value( hash, self.pos().y );
+    hash = hash_value( hash, self.vel().x );
+    hash = hash_value( hash, self.vel().y );
+    hash = hash_value( hash, self.body().degree() );
+    hash = hash_value( hash, self.kickRate() );
+    hash = hash_value( hash, ball.pos().x );
+    hash = hash_value( hash, ball.pos().y );
+    return hash;
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \class KickTable::PathStorage
+  \brief read only storage of the static state list and the heuristic tables.
+
+  The path entries of all angles are held in one contiguous block, that is
+  either an owned buffer or a mapped binary cache file. Once created, the
+  storage is shared by all KickTable instances in the same process, and the
+  pages of the mapped file are shared by all processes on the same host.
+*/
+class KickTable::PathStorage {
+public:
+    std::uint64_t key_; //!< hash value of the parameters. 0 if not registered.
+    double player_size_; //!< default player size
+    double kickable_margin_; //!< default kickable margin
+    double ball_size_; //!< ball size
+    std::vector< State > states_; //!< state list
+    const Path * tables_[DEST_DIR_DIVS]; //!< head of the table for each angle
+    std::size_t table_sizes_[DEST_DIR_DIVS]; //!< the number of entries for each angle
+
+private:
+    std::vector< Path > M_buffer; //!< owned entries
+    void * M_map_addr; //!< head of the mapped file
+    std::size_t M_map_size; //!< mapped size
+
+    //! not used
+    PathStorage( const PathStorage & ) = delete;
+    PathStorage & operator=( const PathStorage & ) = delete;
+
+public:
+
+    PathStorage()
+        : key_( 0 ),
+          player_size_( 0.0 ),
+          kickable_margin_( 0.0 ),
+          ball_size_( 0.0 ),
+          M_map_addr( nullptr ),
+          M_map_size( 0 )
+      {
+          std::fill( tables_, tables_ + DEST_DIR_DIVS, nullptr );
+          std::fill( table_sizes_, table_sizes_ + DEST_DIR_DIVS, 0 );
+      }
+
+    ~PathStorage()
+      {
+#ifdef HAVE_SYS_MMAN_H
+          if ( M_map_addr )
+          {
+              ::munmap( M_map_addr, M_map_size );
+          }
+#endif
+      }
+
+    /*!
+      \brief create the storage that owns the entries
+      \param states state list
+      \param tables path list for each angle
+     */
+    void assign( const std::vector< State > & states,
+                 const std::vector< Path > * tables );
+
+    /*!
+      \brief set the binary cache data
+      \param data head of the cache data
+      \param size data size in bytes
+      \param key expected key value
+      \param copy if true, the entries are copied to the owned buffer
+      \return true if the data are valid for the key
+     */
+    bool assign( const char * data,
+                 const std::size_t size,
+                 const std::uint64_t key,
+                 const bool copy );
+
+    /*!
+      \brief create the storage from the binary cache file
+      \param file_path cache file path
+      \param key expected key value
+      \return created storage, or null if the file is not available
+     */
+    static
+    std::shared_ptr< const PathStorage > map( const std::string & file_path,
+                                              const std::uint64_t key );
+
+    /*!
+      \brief find the registered storage
+      \param key key value
+      \return registered storage, or null if not found
+     */
+    static
+    std::shared_ptr< const PathStorage > find( const std::uint64_t key );
+
+    /*!
+      \brief register the storage to share it in the process
+      \param storage registered storage
+     */
+    static
+    void add( const std::shared_ptr< const PathStorage > & storage );
+
+private:
+
+    //! mutex for the registry
+    static std::mutex S_mutex;
+    //! registered storages
+    static std::vector< std::weak_ptr< const PathStorage > > S_registry;
+};
+
+std::mutex KickTable::PathStorage::S_mutex;
+std::vector< std::weak_ptr< const KickTable::PathStorage > > KickTable::PathStorage::S_registry;
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+KickTable::PathStorage::assign( const std::vector< State > & states,
+                                const std::vector< Path > * tables )
+{
+    std::size_t total = 0;
+    for ( int i = 0; i < DEST_DIR_DIVS; ++i )
+    {
+        total += tables[i].size();
+    }
+
+    states_ = states;
+    M_buffer.clear();
+    M_buffer.reserve( total );
+
+    for ( int i = 0; i < DEST_DIR_DIVS; ++i )
+    {
+        M_buffer.insert( M_buffer.end(), tables[i].begin(), tables[i].end() );
+        table_sizes_[i] = tables[i].size();
+    }
+
+    std::size_t offset = 0;
+    for ( int i = 0; i < DEST_DIR_DIVS; ++i )
+    {
+        tables_[i] = M_buffer.data() + offset;
+        offset += table_sizes_[i];
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+KickTable::PathStorage::assign( const char * data,
+                                const std::size_t size,
+                                const std::uint64_t key,
+                                const bool copy )
+{
+    if ( size < sizeof( CacheHeader ) )
+    {
+        return false;
+    }
+
+    CacheHeader header;
+    std::memcpy( &header, data, sizeof( CacheHeader ) );
+
+    if ( std::memcmp( header.magic_, CACHE_MAGIC, sizeof( CACHE_MAGIC ) ) != 0
+         || header.version_ != CACHE_VERSION
+         || header.key_ != key
+         || header.state_size_ != static_cast< std::uint32_t >( NUM_STATE ) )
+    {
+        return false;
+    }
+
+    std::size_t total = 0;
+    for ( int i = 0; i < DEST_DIR_DIVS; ++i )
+    {
+        if ( header.table_sizes_[i] > MAX_TABLE_SIZE )
+        {
+            return false;
+        }
+        total += header.table_sizes_[i];
+    }
+
+    const std::size_t path_offset = sizeof( CacheHeader ) + sizeof( CacheState ) * header.state_size_;
+    if ( size != path_offset + sizeof( Path ) * total )
+    {
+        return false;
+    }
+
+    key_ = key;
+    player_size_ = header.player_size_;
+    kickable_margin_ = header.kickable_margin_;
+    ball_size_ = header.ball_size_;
+
+    states_.clear();
+    states_.reserve( header.state_size_ );
+    for ( std::uint32_t i = 0; i < header.state_size_; ++i )
+    {
+        CacheState s;
+        std::memcpy( &s, data + sizeof( CacheHeader ) + sizeof( CacheState ) * i, sizeof( CacheState ) );
+        states_.emplace_back( s.index_, s.dist_, Vector2D( s.x_, s.y_ ), s.kick_rate_ );
+    }
+
+    const Path * paths = reinterpret_cast< const Path * >( data + path_offset );
+    if ( copy )
+    {
+        M_buffer.assign( paths, paths + total );
+        paths = M_buffer.data();
+    }
+
+    std::size_t offset = 0;
+    for ( int i = 0; i < DEST_DIR_DIVS; ++i )
+    {
+        tables_[i] = paths + offset;
+        table_sizes_[i] = header.table_sizes_[i];
+        offset += header.table_sizes_[i];
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::shared_ptr< const KickTable::PathStorage >
+KickTable::PathStorage::map( const std::string & file_path,
+                             const std::uint64_t key )
+{
+    std::shared_ptr< PathStorage > ptr = std::make_shared< PathStorage >();
+
+#if defined(HAVE_SYS_MMAN_H) && defined(HAVE_SYS_STAT_H) && defined(HAVE_FCNTL_H)
+    const int fd = ::open( file_path.c_str(), O_RDONLY );
+    if ( fd == -1 )
+    {
+        return std::shared_ptr< const PathStorage >();
+    }
+
+    struct stat st;
+    if ( ::fstat( fd, &st ) == -1
+         || st.st_size <= 0 )
+    {
+        ::close( fd );
+        return std::shared_ptr< const PathStorage >();
+    }
+
+    void * addr = ::mmap( nullptr, static_cast< std::size_t >( st.st_size ),
+                          PROT_READ, MAP_SHARED, fd, 0 );
+    ::close( fd );
+
+    if ( addr == MAP_FAILED )
+    {
+        std::cerr << "(KickTable::PathStorage::map) mmap failed " << file_path << std::endl;
+        return std::shared_ptr< const PathStorage >();
+    }
+
+    // unmapped by the destructor
+    ptr->M_map_addr = addr;
+    ptr->M_map_size = static_cast< std::size_t >( st.st_size );
+
+    if ( ! ptr->assign( static_cast< const char * >( addr ), ptr->M_map_size, key, false ) )
+    {
+        return std::shared_ptr< const PathStorage >();
+    }
+#else
+    std::ifstream fin( file_path.c_str(), std::ios_base::in | std::ios_base::binary );
+    if ( ! fin.is_open() )
+    {
+        return std::shared_ptr< const PathStorage >();
+    }
+
+    const std::vector< char > buffer( ( std::istreambuf_iterator< char >( fin ) ),
+                                      std::istreambuf_iterator< char >() );
+    if ( ! ptr->assign( buffer.data(), buffer.size(), key, true ) )
+    {
+        return std::shared_ptr< const PathStorage >();
+    }
+#endif
+
+    return ptr;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::shared_ptr< const KickTable::PathStorage >
+KickTable::PathStorage::find( const std::uint64_t key )
+{
+    std::lock_guard< std::mutex > lock( S_mutex );
+
+    for ( const std::weak_ptr< const PathStorage > & w : S_registry )
+    {
+        std::shared_ptr< const PathStorage > ptr = w.lock();
+        if ( ptr
+             && ptr->key_ == key )
+        {
+            return ptr;
+        }
+    }
+
+    return std::shared_ptr< const PathStorage >();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+KickTable::PathStorage::add( const std::shared_ptr< const PathStorage > & storage )
+{
+    std::lock_guard< std::mutex > lock( S_mutex );
+
+    S_registry.erase( std::remove_if( S_registry.begin(), S_registry.end(),
+                                      []( const std::weak_ptr< const PathStorage > & w )
+                                        {
+                                            return w.expired();
+                                        } ),
+                      S_registry.end() );
+    S_registry.push_back( storage );
 }
 
 /*-------------------------------------------------------------------*/
@@ -296,7 +756,7 @@ KickTable::calc_max_velocity( const AngleDeg & target_angle,
 KickTable &
 KickTable::instance()
 {
-    static KickTable s_instance;
+    thread_local KickTable s_instance;
     return s_instance;
 }
 
@@ -308,8 +768,19 @@ KickTable::KickTable()
     : M_player_size( 0.0 ),
       M_kickable_margin( 0.0 ),
       M_ball_size( 0.0 ),
-      M_use_risky_node( false )
+      M_state_cache_time( -1, 0 ),
+      M_state_cache_key( 0 ),
+      M_state_cache_hit_count( 0 ),
+      M_state_cache_miss_count( 0 ),
+      M_use_risky_node( false ),
+      M_use_pruned_search( false ),
+      M_release_time( -1, 0 ),
+      M_release_speed( 0.0 ),
+      M_release_id( 0 )
 {
+    std::fill( M_tables, M_tables + DEST_DIR_DIVS, nullptr );
+    std::fill( M_table_sizes, M_table_sizes + DEST_DIR_DIVS, 0 );
+
     for ( int i = 0; i < MAX_DEPTH; ++ i )
     {
         M_state_cache[i].reserve( NUM_STATE );
@@ -322,10 +793,21 @@ KickTable::KickTable()
  */
 bool
 KickTable::createTables()
+{
+    return createTables( std::string() );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+KickTable::createTables( const std::string & cache_file )
 {
     const PlayerType player_type; // default type
 
-    if ( std::fabs( M_player_size - player_type.playerSize() ) < rcsc::EPS
+    if ( M_path_storage
+         && std::fabs( M_player_size - player_type.playerSize() ) < rcsc::EPS
          && std::fabs( M_kickable_margin - player_type.kickableMargin() ) < rcsc::EPS
          && std::fabs( M_ball_size - ServerParam::i().ballSize() ) < rcsc::EPS )
     {
@@ -334,25 +816,87 @@ KickTable::createTables()
 
     //std::cerr << "createTables" << std::endl;
 
-    M_player_size = player_type.playerSize();
-    M_kickable_margin = player_type.kickableMargin();
-    M_ball_size = ServerParam::i().ballSize();
+    const std::uint64_t key = create_cache_key( player_type );
 
-    createStateList( player_type );
+    //
+    // the table may be already created by other agents in this process.
+    //
+    std::shared_ptr< const PathStorage > storage = PathStorage::find( key );
+
+    if ( ! storage
+         && ! cache_file.empty() )
+    {
+        storage = PathStorage::map( cache_file, key );
+        if ( storage )
+        {
+            PathStorage::add( storage );
+        }
+    }
+
+    if ( storage )
+    {
+        setStorage( storage );
+        return true;
+    }
 
     Timer timer;
 
+    createStateList( player_type );
+
+    //
+    // create the table for each angle in parallel
+    //
+
+    std::vector< Path > tables[DEST_DIR_DIVS];
+
     const double angle_step = 360.0 / DEST_DIR_DIVS;
-    AngleDeg angle = -180.0;
+    const int n_threads = std::min( static_cast< int >( DEST_DIR_DIVS ),
+                                    std::max( 1, static_cast< int >( std::thread::hardware_concurrency() ) ) );
+
+    std::atomic< int > next_index( 0 );
+
+    const auto worker = [&]()
+                          {
+                              for ( int i = next_index++; i < DEST_DIR_DIVS; i = next_index++ )
+                              {
+                                  createTable( AngleDeg( -180.0 + angle_step * i ), tables[i] );
+                              }
+                          };
+
+    std::vector< std::thread > threads;
+    threads.reserve( n_threads - 1 );
+    for ( int i = 1; i < n_threads; ++i )
+    {
+        threads.emplace_back( worker );
+    }
 
-    for ( int i = 0; i < DEST_DIR_DIVS; ++i, angle += angle_step )
+    worker(); // the calling thread is also used as a worker.
+
+    for ( std::thread & t : threads )
     {
-        createTable( angle, M_tables[i] );
+        t.join();
     }
 
+    std::shared_ptr< PathStorage > new_storage = std::make_shared< PathStorage >();
+    new_storage->key_ = key;
+    new_storage->player_size_ = player_type.playerSize();
+    new_storage->kickable_margin_ = player_type.kickableMargin();
+    new_storage->ball_size_ = ServerParam::i().ballSize();
+    new_storage->assign( M_state_list, tables );
+
+    PathStorage::add( new_storage );
+    setStorage( new_storage );
+
     dlog.addText( Logger::KICK,
-                  "(KickTable::createTables) elapsed %f [ms]",
-                  timer.elapsedReal() );
+                  "(KickTable::createTables) elapsed %f [ms] threads=%d",
+                  timer.elapsedReal(), n_threads );
+
+    if ( ! cache_file.empty()
+         && ! writeBinary( cache_file ) )
+    {
+        std::cerr << "(KickTable::createTables) could not write the cache file "
+                  << cache_file << std::endl;
+    }
 
 #if 0
     const double kprate = ServerParam::i().kickPowerRate();
@@ -368,16 +912,16 @@ KickTable::createTables()
                   << std::endl;
     }
 
-    for ( int i = 0; i < DEST_DIR_DIVS; ++i, angle += angle_step )
+    for ( int i = 0; i < DEST_DIR_DIVS; ++i )
     {
-        std::cout << "create table " << i << " : angle="  << angle << std::endl;
-        for ( const Path & p : M_tables[i] )
+        std::cout << "create table " << i << " : angle="  << -180.0 + angle_step * i << std::endl;
+        for ( const Path * p = M_tables[i], * end = M_tables[i] + M_table_sizes[i]; p != end; ++p )
         {
             std::cout << "  table "
-                      << " origin=" << p.origin_
-                      << " dest=" << p.dest_
-                      << " max_speed=" << p.max_speed_
-                      << " power=" << p.power_
+                      << " origin=" << p->origin_
+                      << " dest=" << p->dest_
+                      << " max_speed=" << p->max_speed_
+                      << " power=" << p->power_
                       << std::endl;
         }
     }
@@ -385,6 +929,31 @@ KickTable::createTables()
     return true;
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+KickTable::setStorage( const std::shared_ptr< const PathStorage > & storage )
+{
+    M_path_storage = storage;
+
+    // the state cache has to be recreated for the new state list.
+    M_state_cache_time.assign( -1, 0 );
+
+    M_player_size = storage->player_size_;
+    M_kickable_margin = storage->kickable_margin_;
+    M_ball_size = storage->ball_size_;
+
+    M_state_list = storage->states_;
+
+    for ( int i = 0; i < DEST_DIR_DIVS; ++i )
+    {
+        M_tables[i] = storage->tables_[i];
+        M_table_sizes[i] = storage->table_sizes_[i];
+    }
+}
+
 /*-------------------------------------------------------------------*/
 /*!
 
@@ -400,13 +969,13 @@ KickTable::read( const std::string & file_path )
         return false;
     }
 
-    M_state_list.clear();
-    M_state_list.reserve( NUM_STATE );
+    std::vector< State > state_list;
+    state_list.reserve( NUM_STATE );
 
+    std::vector< Path > tables[DEST_DIR_DIVS];
     for ( int dir = 0; dir < DEST_DIR_DIVS; ++dir )
     {
-        M_tables[dir].clear();
-        M_tables[dir].reserve( NUM_STATE * NUM_STATE );
+        tables[dir].reserve( NUM_STATE * NUM_STATE );
     }
 
     std::string line_buf;
@@ -481,7 +1050,7 @@ KickTable::read( const std::string & file_path )
         }
 
         state.flag_ = SAFETY;
-        M_state_list.push_back( state );
+        state_list.push_back( state );
 
     }
 
@@ -531,13 +1100,17 @@ KickTable::read( const std::string & file_path )
                 return false;
             }
 
-            M_tables[dir].push_back( path );
+            tables[dir].push_back( path );
         }
     }
 
-    M_player_size = player_size;
-    M_kickable_margin = kickable_margin;
-    M_ball_size = ball_size;
+    std::shared_ptr< PathStorage > storage = std::make_shared< PathStorage >();
+    storage->player_size_ = player_size;
+    storage->kickable_margin_ = kickable_margin;
+    storage->ball_size_ = ball_size;
+    storage->assign( state_list, tables );
+
+    setStorage( storage );
 
     std::cerr << "read kick table ... ok" << std::endl;
 
@@ -582,14 +1155,14 @@ KickTable::write( const std::string & file_path )
 
     for ( int dir = 0; dir < DEST_DIR_DIVS; ++dir )
     {
-        fout << M_tables[dir].size() << '\n';
+        fout << M_table_sizes[dir] << '\n';
 
-        for ( const Path & t : M_tables[dir] )
+        for ( const Path * t = M_tables[dir], * end = M_tables[dir] + M_table_sizes[dir]; t != end; ++t )
         {
-            fout << t.origin_ << ' '
-                 << t.dest_ << ' '
-                 << t.max_speed_ << ' '
-                 << t.power_ << '\n';
+            fout << t->origin_ << ' '
+                 << t->dest_ << ' '
+                 << t->max_speed_ << ' '
+                 << t->power_ << '\n';
         }
     }
 
@@ -599,6 +1172,104 @@ KickTable::write( const std::string & file_path )
     return true;
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+KickTable::readBinary( const std::string & file_path )
+{
+    const PlayerType player_type; // default type
+    const std::uint64_t key = create_cache_key( player_type );
+
+    std::shared_ptr< const PathStorage > storage = PathStorage::map( file_path, key );
+    if ( ! storage )
+    {
+        return false;
+    }
+
+    PathStorage::add( storage );
+    setStorage( storage );
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+KickTable::writeBinary( const std::string & file_path ) const
+{
+    if ( ! M_path_storage
+         || M_path_storage->key_ == 0 )
+    {
+        return false;
+    }
+
+    CacheHeader header;
+    std::memset( &header, 0, sizeof( CacheHeader ) );
+    std::memcpy( header.magic_, CACHE_MAGIC, sizeof( CACHE_MAGIC ) );
+    header.version_ = CACHE_VERSION;
+    header.state_size_ = static_cast< std::uint32_t >( M_state_list.size() );
+    header.key_ = M_path_storage->key_;
+    header.player_size_ = M_player_size;
+    header.kickable_margin_ = M_kickable_margin;
+    header.ball_size_ = M_ball_size;
+    for ( int dir = 0; dir < DEST_DIR_DIVS; ++dir )
+    {
+        header.table_sizes_[dir] = static_cast< std::uint32_t >( M_table_sizes[dir] );
+    }
+
+    //
+    // write to the temporary file, then rename it.
+    // other agents never see the incomplete file.
+    //
+    std::string tmp_path = file_path + ".tmp";
+#ifdef HAVE_UNISTD_H
+    tmp_path += std::to_string( ::getpid() );
+#endif
+    tmp_path += '_';
+    tmp_path += std::to_string( std::hash< std::thread::id >()( std::this_thread::get_id() ) );
+
+    std::ofstream fout( tmp_path.c_str(), std::ios_base::out | std::ios_base::binary );
+    if ( ! fout.is_open() )
+    {
+        return false;
+    }
+
+    fout.write( reinterpret_cast< const char * >( &header ), sizeof( CacheHeader ) );
+
+    for ( const State & s : M_state_list )
+    {
+        CacheState cs;
+        std::memset( &cs, 0, sizeof( CacheState ) );
+        cs.index_ = s.index_;
+        cs.dist_ = s.dist_;
+        cs.x_ = s.pos_.x;
+        cs.y_ = s.pos_.y;
+        cs.kick_rate_ = s.kick_rate_;
+        fout.write( reinterpret_cast< const char * >( &cs ), sizeof( CacheState ) );
+    }
+
+    for ( int dir = 0; dir < DEST_DIR_DIVS; ++dir )
+    {
+        fout.write( reinterpret_cast< const char * >( M_tables[dir] ),
+                    sizeof( Path ) * M_table_sizes[dir] );
+    }
+
+    fout.close();
+
+    if ( ! fout
+         || std::rename( tmp_path.c_str(), file_path.c_str() ) != 0 )
+    {
+        std::remove( tmp_path.c_str() );
+        return false;
+    }
+
+    return true;
+}
+
 /*-------------------------------------------------------------------*/
 /*!
 
@@ -673,27 +1344,145 @@ KickTable::createStateList( const PlayerType & player_type )
  */
 void
 KickTable::createTable( const AngleDeg & angle,
-                        std::vector< Path > & table )
+                        std::vector< Path > & table ) const
 {
+    // the solutions nearer than this threshold to the origin are checked by
+    // calc_max_velocity(), because their direction is not reliable.
+    const double DIR_THR = 1.0e-3;
+
+    const ServerParam & SP = ServerParam::i();
+
     const int max_combination = NUM_STATE * NUM_STATE;
-    const int max_state = M_state_list.size();
+    const int max_state = std::min( static_cast< int >( M_state_list.size() ), NUM_STATE );
 
     table.clear();
     table.reserve( max_combination );
 
+    //
+    // the same line formula as Circle2D::intersection( const Ray2D & ).
+    // the vertical line is solved by calc_max_velocity().
+    //
+    const double line_a = -angle.sin();
+    const double line_b = angle.cos();
+    const double line_c = -line_a * 0.0 - line_b * 0.0;
+    const bool vertical = ( std::fabs( line_a ) < 1.0e-6 ); // Circle2D::EPSILON
+    const double m = ( vertical ? 0.0 : line_b / line_a );
+    const double d = ( vertical ? 0.0 : line_c / line_a );
+    const double qa = 1.0 + m * m;
+
+    const double speed_max = SP.ballSpeedMax();
+    const double speed_max2 = std::pow( speed_max, 2 );
+
+    //
+    // structure of arrays for the destination states
+    //
+    double pos_x[NUM_STATE];
+    double pos_y[NUM_STATE];
+    double kick_rate[NUM_STATE];
+    double accel_max[NUM_STATE];
+
+    for ( int i = 0; i < max_state; ++i )
+    {
+        pos_x[i] = M_state_list[i].pos_.x;
+        pos_y[i] = M_state_list[i].pos_.y;
+        kick_rate[i] = M_state_list[i].kick_rate_;
+        accel_max[i] = std::min( SP.maxPower() * kick_rate[i],
+                                 SP.ballAccelMax() );
+    }
+
+    double max_speed[NUM_STATE];
+    double power[NUM_STATE];
+    int exact[NUM_STATE];
+
     for ( int origin = 0; origin < max_state; ++origin )
     {
+        const double origin_x = pos_x[origin];
+        const double origin_y = pos_y[origin];
+
+        //
+        // calc_max_velocity() for all destinations.
+        // The arithmetic is the same as the original one, but this loop has no
+        // branch so that the compiler can vectorize it.
+        //
         for ( int dest = 0; dest < max_state; ++dest )
         {
-            Vector2D vel = M_state_list[dest].pos_ - M_state_list[origin].pos_;
-            Vector2D max_vel = calc_max_velocity( angle,
-                                                  M_state_list[dest].kick_rate_,
-                                                  vel );
-            Vector2D accel = max_vel - vel;
+            // the current ball velocity = the center of the reachable circle
+            const double cx = pos_x[dest] - origin_x;
+            const double cy = pos_y[dest] - origin_y;
+            const double r2 = accel_max[dest] * accel_max[dest];
+
+            // intersection of the line and the circle
+            const double qb = 2.0 * ( -cy + ( d + cx ) * m );
+            const double qc = ( d + cx ) * ( d + cx ) + cy * cy - r2;
+            const double disc = qb * qb - 4.0 * qa * qc;
+            const bool tangent = ( std::fabs( disc ) < 1.0e-5 );
+            const double root = std::sqrt( std::max( disc, 0.0 ) );
+
+            const double y1 = ( tangent ? -qb / ( 2.0 * qa ) : ( -qb + root ) / ( 2.0 * qa ) );
+            const double y2 = ( -qb - root ) / ( 2.0 * qa );
+            const double x1 = -( line_b * y1 + line_c ) / line_a;
+            const double x2 = -( line_b * y2 + line_c ) / line_a;
+
+            // the solutions behind the ray origin are removed.
+            const double dir1 = x1 * line_b - y1 * line_a;
+            const double dir2 = x2 * line_b - y2 * line_a;
+            const int n_line = ( tangent ? 1 : disc < 0.0 ? 0 : 2 );
+            const int n_sol2 = ( n_line > 1 && dir2 > 0.0 ? 2 : std::min( n_line, 1 ) );
+            const bool use_sol2 = ( n_sol2 > 0 && dir1 <= 0.0 );
+            const int n_sol = ( use_sol2 ? n_sol2 - 1 : n_sol2 );
+
+            double vx = ( use_sol2 ? x2 : x1 );
+            double vy = ( use_sol2 ? y2 : y1 );
+            double len1 = vx * vx + vy * vy;
+            const double len2 = x2 * x2 + y2 * y2;
+
+            // num == 2: use the faster solution
+            const bool swap = ( n_sol == 2 && len1 < len2 );
+            vx = ( swap ? x2 : vx );
+            vy = ( swap ? y2 : vy );
+            const double slow2 = ( swap ? len1 : len2 );
+            len1 = ( swap ? len2 : len1 );
+
+            const bool over = ( len1 > speed_max2 );
+            const bool failed = ( n_sol == 0
+                                  || ( n_sol == 1 && over && ! ( cx * cx + cy * cy < r2 ) )
+                                  || ( n_sol == 2 && over && slow2 > speed_max2 ) );
+            const double mag = std::sqrt( len1 );
+            const double rate = ( over && mag >= Vector2D::EPSILON ? speed_max / mag : 1.0 );
+            vx = ( failed ? 0.0 : over ? vx * rate : vx );
+            vy = ( failed ? 0.0 : over ? vy * rate : vy );
+
+            const double ax = vx - cx;
+            const double ay = vy - cy;
+
+            max_speed[dest] = std::sqrt( vx * vx + vy * vy );
+            power[dest] = std::sqrt( ax * ax + ay * ay ) / kick_rate[dest];
+            exact[dest] = ( vertical
+                            || ( n_line > 0 && std::fabs( dir1 ) < DIR_THR )
+                            || ( n_line > 1 && std::fabs( dir2 ) < DIR_THR ) );
+        }
 
+        for ( int dest = 0; dest < max_state; ++dest )
+        {
             Path path( origin, dest );
-            path.max_speed_ = max_vel.r();
-            path.power_ = accel.r() / M_state_list[dest].kick_rate_;
+
+            if ( exact[dest] )
+            {
+                Vector2D vel = M_state_list[dest].pos_ - M_state_list[origin].pos_;
+                Vector2D max_vel = calc_max_velocity( angle,
+                                                      M_state_list[dest].kick_rate_,
+                                                      vel );
+                Vector2D accel = max_vel - vel;
+
+                path.max_speed_ = max_vel.r();
+                path.power_ = accel.r() / M_state_list[dest].kick_rate_;
+            }
+            else
+            {
+                path.max_speed_ = max_speed[dest];
+                path.power_ = power[dest];
+            }
+
             table.push_back( path );
         }
     }
@@ -714,14 +1503,23 @@ KickTable::createTable( const AngleDeg & angle,
 void
 KickTable::updateState( const WorldModel & world )
 {
-    static GameTime s_update_time( -1, 0 );
+    const std::uint64_t key = create_state_key( world );
 
-    if ( s_update_time == world.time() )
+    if ( M_state_cache_time == world.time()
+         && M_state_cache_key == key )
     {
+        ++M_state_cache_hit_count;
+#ifdef DEBUG
+        dlog.addText( Logger::KICK,
+                      "(KickTable::updateState) reuse the state cache. hit=%ld miss=%ld",
+                      M_state_cache_hit_count, M_state_cache_miss_count );
+#endif
         return;
     }
 
-    s_update_time = world.time();
+    ++M_state_cache_miss_count;
+    M_state_cache_time = world.time();
+    M_state_cache_key = key;
 
     //
     // update current state
@@ -801,6 +1599,8 @@ KickTable::createStateCache( const WorldModel & world )
     // create future state
     //
 
+    M_release_time.assign( -1, 0 );
+
     Vector2D self_pos = world.self().pos();
     Vector2D self_vel = world.self().vel();
 
@@ -982,6 +1782,117 @@ KickTable::checkCollisionAfterRelease( const WorldModel & world,
     }
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+KickTable::updateReleaseCache( const WorldModel & world,
+                               const Vector2D & target_point,
+                               const double first_speed )
+{
+    if ( M_release_time == world.time()
+         && M_release_target.x == target_point.x
+         && M_release_target.y == target_point.y
+         && M_release_speed == first_speed )
+    {
+#ifdef DEBUG
+        dlog.addText( Logger::KICK,
+                      "(KickTable::updateReleaseCache) reuse" );
+#endif
+        return;
+    }
+
+    M_release_time = world.time();
+    M_release_target = target_point;
+    M_release_speed = first_speed;
+    ++M_release_id;
+
+    const PlayerType & self_type = world.self().playerType();
+    const double collide_dist2 = std::pow( self_type.playerSize() + ServerParam::i().ballSize(), 2 );
+
+    Vector2D self_pos = world.self().pos();
+    Vector2D self_vel = world.self().vel();
+
+    self_pos += self_vel;
+    self_vel *= self_type.playerDecay();
+
+    //
+    // current state. same as checkCollisionAfterRelease() and checkInterfereAfterRelease()
+    //
+    {
+        Vector2D release_pos = ( target_point - M_current_state.pos_ );
+        release_pos.setLength( first_speed );
+
+        if ( self_pos.dist2( release_pos ) < collide_dist2 )
+        {
+            M_current_state.flag_ |= SELF_COLLISION;
+        }
+        else
+        {
+            M_current_state.flag_ &= ~SELF_COLLISION;
+        }
+
+        checkInterfereAfterRelease( world, target_point, first_speed, 1, M_current_state );
+    }
+
+    for ( int i = 0; i < MAX_DEPTH; ++i )
+    {
+        self_pos += self_vel;
+        self_vel *= self_type.playerDecay();
+
+        M_release_self_pos[i] = self_pos;
+        M_release_checked[i].resize( M_state_cache[i].size(), 0 );
+    }
+
+    //
+    // the first future states are always used by the two step kick.
+    //
+    for ( size_t i = 0; i < M_state_cache[0].size(); ++i )
+    {
+        checkReleaseAt( world, 0, static_cast< int >( i ) );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+KickTable::checkReleaseAt( const WorldModel & world,
+                           const int depth,
+                           const int index )
+{
+    if ( M_release_checked[depth][index] == M_release_id )
+    {
+        return;
+    }
+
+    M_release_checked[depth][index] = M_release_id;
+
+    State & state = M_state_cache[depth][index];
+
+    const PlayerType & self_type = world.self().playerType();
+    const double collide_dist2 = std::pow( self_type.playerSize() + ServerParam::i().ballSize(), 2 );
+
+    Vector2D release_pos = ( M_release_target - state.pos_ );
+    release_pos.setLength( M_release_speed );
+
+    if ( M_release_self_pos[depth].dist2( release_pos ) < collide_dist2 )
+    {
+        state.flag_ |= SELF_COLLISION;
+    }
+    else
+    {
+        state.flag_ &= ~SELF_COLLISION;
+    }
+
+    state.flag_ &= ~RELEASE_INTERFERE;
+    state.flag_ &= ~MAYBE_RELEASE_INTERFERE;
+
+    checkInterfereAfterRelease( world, M_release_target, M_release_speed, depth + 2, state );
+}
+
 /*-------------------------------------------------------------------*/
 /*!
 
@@ -1655,16 +2566,64 @@ KickTable::simulateThreeStep( const WorldModel & world,
                   target_angle_index );
 #endif
 
-    const std::vector< Path > & table = M_tables[target_angle_index];
+    const Path * const table = M_tables[target_angle_index];
+    const size_t table_size = M_table_sizes[target_angle_index];
+
+    //
+    // upper bounds of the released ball speed for the pruned search.
+    // The speed after the last kick never exceeds |vel2| + max_accel(state_2nd).
+    //
+    const double PRUNE_EPS = 1.0e-6;
+
+    double last_accel[NUM_STATE]; // max accel of the last kick
+    double success_thr2[NUM_STATE]; // the state chain cannot reach first_speed if |vel2|^2 is less than this value
+    double speed_bound = 0.0; // the upper bound of all state chains
+    int pruned_count = 0;
+
+    if ( M_use_pruned_search )
+    {
+        const int state_size = std::min( static_cast< int >( M_state_cache[1].size() ), NUM_STATE );
+
+        double max_last_accel = 0.0;
+        for ( int i = 0; i < state_size; ++i )
+        {
+            last_accel[i] = std::min( M_state_cache[1][i].kick_rate_ * max_power, accel_max );
+            const double thr = first_speed - last_accel[i] - PRUNE_EPS;
+            success_thr2[i] = ( thr > 0.0 ? thr * thr : -1.0 );
+            max_last_accel = std::max( max_last_accel, last_accel[i] );
+        }
+
+        double max_move2 = 0.0;
+        for ( const State & s1 : M_state_cache[0] )
+        {
+            for ( const State & s2 : M_state_cache[1] )
+            {
+                max_move2 = std::max( max_move2, s1.pos_.dist2( s2.pos_ ) );
+            }
+        }
+
+        speed_bound = std::sqrt( max_move2 ) * ball_decay + max_last_accel + PRUNE_EPS;
+    }
 
     int success_count = 0;
     double max_speed2 = 0.0;
+    double max_speed = 0.0;
 
     size_t count = 0;
-    for ( std::vector< Path >::const_iterator it = table.begin(), end = table.end();
+    for ( const Path * it = table, * end = table + table_size;
           it != end && count < MAX_TABLE_SIZE && success_count <= 10;
           ++it, ++count )
     {
+        if ( M_use_pruned_search
+             && success_count == 0
+             && speed_bound < first_speed
+             && speed_bound <= max_speed )
+        {
+            // no state chain can update the result.
+            pruned_count += static_cast< int >( std::min( table_size, MAX_TABLE_SIZE ) - count );
+            break;
+        }
+
         const State & state_1st = M_state_cache[0][it->origin_];
         const State & state_2nd = M_state_cache[1][it->dest_];
 
@@ -1708,6 +2667,28 @@ KickTable::simulateThreeStep( const WorldModel & world,
             continue;
         }
 
+        if ( M_use_pruned_search )
+        {
+            const double vel2_r2 = state_2nd.pos_.dist2( state_1st.pos_ ) * ( ball_decay * ball_decay );
+            const double improve_thr = max_speed - last_accel[it->dest_] - PRUNE_EPS;
+
+            if ( vel2_r2 < success_thr2[it->dest_]
+                 && ( success_count > 0
+                      || ( improve_thr > 0.0
+                           && vel2_r2 <= improve_thr * improve_thr ) ) )
+            {
+#ifdef DEBUG_THREE_STEP_DETAIL
+                dlog.addText( Logger::KICK,
+                              "%zd: xx__ 3 step: pruned. speed bound=%.3f",
+                              count, std::sqrt( vel2_r2 ) + last_accel[it->dest_] );
+#endif
+                ++pruned_count;
+                continue;
+            }
+
+            checkReleaseAt( world, 1, it->dest_ );
+        }
+
         if ( state_2nd.flag_ & SELF_COLLISION )
         {
 #ifdef DEBUG_THREE_STEP_DETAIL
@@ -1828,6 +2809,7 @@ KickTable::simulateThreeStep( const WorldModel & world,
                         M_candidates.push_back( Sequence() );
                     }
                     max_speed2 = d2;
+                    max_speed = std::sqrt( d2 );
                     accel = max_vel - vel2;
 
                     M_candidates.back().index_ = 10000 + count;
@@ -1876,6 +2858,13 @@ KickTable::simulateThreeStep( const WorldModel & world,
     }
 
 #ifdef DEBUG_THREE_STEP
+    if ( M_use_pruned_search )
+    {
+        dlog.addText( Logger::KICK,
+                      "(KickTable::simulateThreeStep) pruned %d/%zd",
+                      pruned_count, count );
+    }
+
     dlog.addText( Logger::KICK,
                   "simulateThreeKick() solution_size=%d",
                   success_count );
@@ -2130,12 +3119,24 @@ KickTable::simulate( const WorldModel & world,
 
     updateState( world );
 
-    checkCollisionAfterRelease( world,
-                                target_point,
-                                target_speed );
-    checkInterfereAfterRelease( world,
-                                target_point,
-                                target_speed );
+    if ( M_use_pruned_search )
+    {
+        updateReleaseCache( world,
+                            target_point,
+                            target_speed );
+    }
+    else
+    {
+        // all release flags are overwritten.
+        M_release_time.assign( -1, 0 );
+
+        checkCollisionAfterRelease( world,
+                                    target_point,
+                                    target_speed );
+        checkInterfereAfterRelease( world,
+                                    target_point,
+                                    target_speed );
+    }
 
 #ifdef DEBUG_PRINT_STATE_CACHE
     debugPrintStateCache();
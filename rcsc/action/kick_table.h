@@ -34,13 +34,17 @@
 
 #include <rcsc/geom/vector_2d.h>
 #include <rcsc/geom/angle_deg.h>
+#include <rcsc/game_time.h>
 
 #include <vector>
+#include <string>
+#include <memory>
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
 
 namespace rcsc {
 
-class GameTime;
 class PlayerType;
 class WorldModel;
 
@@ -193,13 +197,33 @@ private:
     //! static state list
     std::vector< State > M_state_list;
 
-    //! static heuristic table
-    std::vector< Path > M_tables[DEST_DIR_DIVS];
+    class PathStorage;
+
+    //! shared owner of the static heuristic table
+    std::shared_ptr< const PathStorage > M_path_storage;
+
+    //! static heuristic table. the entries are owned by M_path_storage.
+    const Path * M_tables[DEST_DIR_DIVS];
+
+    //! the number of entries in each heuristic table
+    std::size_t M_table_sizes[DEST_DIR_DIVS];
 
     //
     // online data
     //
 
+    //! the game time of the state cache
+    GameTime M_state_cache_time;
+
+    //! hash value of the self and ball state used by the state cache
+    std::uint64_t M_state_cache_key;
+
+    //! the number of updateState() calls that reused the state cache
+    long M_state_cache_hit_count;
+
+    //! the number of updateState() calls that recreated the state cache
+    long M_state_cache_miss_count;
+
     //! current state cache
     State M_current_state;
 
@@ -216,6 +240,26 @@ private:
 
     bool M_use_risky_node;
 
+    //! if true, simulateThreeStep() uses the pruned search.
+    bool M_use_pruned_search;
+
+    //
+    // release check cache for the pruned search
+    //
+
+    //! the game time of the last release check
+    GameTime M_release_time;
+    //! the target point of the last release check
+    Vector2D M_release_target;
+    //! the first speed of the last release check
+    double M_release_speed;
+    //! the serial number of the current release check
+    int M_release_id;
+    //! the serial number of the last release check of each future state
+    std::vector< int > M_release_checked[MAX_DEPTH];
+    //! self position used by the collision check of each future state
+    Vector2D M_release_self_pos[MAX_DEPTH];
+
     /*!
       \brief private constructor for singleton
      */
@@ -233,15 +277,22 @@ private:
     void createStateList( const PlayerType & player_type );
 
     /*!
-      \brief create table for angle
+      \brief create table for angle. this method can be called from several threads.
       \param angle target angle relative to body angle
       \param table referecne to the container variable
      */
     void createTable( const AngleDeg & angle,
-                      std::vector< Path > & table );
+                      std::vector< Path > & table ) const;
 
     /*!
-      \brief update internal state
+      \brief set the static table data
+      \param storage table data
+     */
+    void setStorage( const std::shared_ptr< const PathStorage > & storage );
+
+    /*!
+      \brief update internal state. The state cache is reused while the game
+      time and the self and ball state are not changed.
       \param world const rererence to the WorldModel
      */
     void updateState( const WorldModel & world );
@@ -262,6 +313,30 @@ private:
                                      const Vector2D & target_point,
                                      const double first_speed );
 
+    /*!
+      \brief update the release flags of the current state and the first
+      future states. The results are reused while the game time, the target
+      point and the first speed are not changed. The release flags of the
+      second future states are updated lazily by checkReleaseAt().
+      \param world const rererence to the WorldModel
+      \param target_point kick target point
+      \param first_speed required first speed
+     */
+    void updateReleaseCache( const WorldModel & world,
+                             const Vector2D & target_point,
+                             const double first_speed );
+
+    /*!
+      \brief update the collision and interfere flags after release kick of
+      the future state, if it has not been checked for the current target.
+      \param world const rererence to the WorldModel
+      \param depth index of the state cache
+      \param index index of the state in M_state_cache[depth]
+     */
+    void checkReleaseAt( const WorldModel & world,
+                         const int depth,
+                         const int index );
+
     /*!
       \brief update interfere level at state
       \param world const reference to the WorldModel
@@ -352,7 +427,8 @@ private:
 public:
 
     /*!
-      \brief singleton interface
+      \brief singleton interface. each thread has its own instance, because
+      the table holds the state of the current agent.
       \return reference to the singleton instance
      */
     static
@@ -364,6 +440,16 @@ public:
      */
     bool createTables();
 
+    /*!
+      \brief create heuristic table with the binary cache file.
+      If the cache file was created for the current parameters, the file is
+      mapped into memory and shared with other agents. Otherwise, the table is
+      created and saved to the cache file.
+      \param cache_file binary cache file path. if empty, the cache is not used.
+      \return result of table creation
+     */
+    bool createTables( const std::string & cache_file );
+
     /*!
       \brief read table data from file
       \param file_path file path to read
@@ -378,6 +464,70 @@ public:
      */
     bool write( const std::string & file_path );
 
+    /*!
+      \brief map the binary table data. The data are used only if the file was
+      created for the current ServerParam and the default PlayerType.
+      \param file_path file path to read
+      \return read result
+     */
+    bool readBinary( const std::string & file_path );
+
+    /*!
+      \brief write table data to the binary file
+      \param file_path file path to write
+      \return write result
+     */
+    bool writeBinary( const std::string & file_path ) const;
+
+    /*!
+      \brief set the search mode of the three step kick.
+      If on, the state chains whose upper bound of the released ball speed
+      cannot beat the current best are skipped, and the interfere checks of
+      the future states are cached while the game time and the target are
+      not changed. The result is the same as the exhaustive search.
+      \param on if true, the pruned search is used.
+     */
+    void setUsePrunedSearch( const bool on )
+      {
+          M_use_pruned_search = on;
+      }
+
+    /*!
+      \brief get the search mode of the three step kick.
+      \return true if the pruned search is used.
+     */
+    bool usePrunedSearch() const
+      {
+          return M_use_pruned_search;
+      }
+
+    /*!
+      \brief get the number of simulate() calls that reused the state cache
+      \return hit count since the last reset
+     */
+    long stateCacheHitCount() const
+      {
+          return M_state_cache_hit_count;
+      }
+
+    /*!
+      \brief get the number of simulate() calls that recreated the state cache
+      \return miss count since the last reset
+     */
+    long stateCacheMissCount() const
+      {
+          return M_state_cache_miss_count;
+      }
+
+    /*!
+      \brief reset the hit/miss counters of the state cache
+     */
+    void resetStateCacheCount()
+      {
+          M_state_cache_hit_count = 0;
+          M_state_cache_miss_count = 0;
+      }
+
     /*!
       \brief simulate kick sequence
       \param world const reference to the WorldModel
@@ -39,6 +39,7 @@
 #include <rcsc/action/neck_scan_players.h>
 
 #include <rcsc/player/player_agent.h>
+#include <rcsc/player/view_grid_map.h>
 #include <rcsc/common/logger.h>
 #include <rcsc/common/server_param.h>
 #include <rcsc/geom/rect_2d.h>
@@ -60,9 +61,9 @@ const double Neck_ScanField::INVALID_ANGLE = -360.0;
 bool
 Neck_ScanField::execute( PlayerAgent * agent )
 {
-    static GameTime s_last_calc_time( 0, 0 );
-    static ViewWidth s_last_calc_view_width = ViewWidth::NORMAL;
-    static AngleDeg s_cached_target_angle = 0.0;
+    thread_local GameTime s_last_calc_time( 0, 0 );
+    thread_local ViewWidth s_last_calc_view_width = ViewWidth::NORMAL;
+    thread_local AngleDeg s_cached_target_angle = 0.0;
 
     const WorldModel & wm = agent->world();
 
@@ -237,6 +238,17 @@ Neck_ScanField::calcAngleDefault( const PlayerAgent * agent,
         return sol_angle.degree();
     }
 
+    //
+    // the cells of the view grid map are in the pitch.
+    //
+    if ( consider_pitch )
+    {
+        const double grid_angle = calcAngleByGridMap( agent, left_start, scan_range, next_view_width );
+        if ( grid_angle != INVALID_ANGLE )
+        {
+            return grid_angle;
+        }
+    }
 
     AngleDeg tmp_angle = left_start;
 
@@ -351,6 +363,59 @@ Neck_ScanField::calcAngleDefault( const PlayerAgent * agent,
 /*-------------------------------------------------------------------*/
 /*!
 
+*/
+double
+Neck_ScanField::calcAngleByGridMap( const PlayerAgent * agent,
+                                    const AngleDeg & left_start,
+                                    const double scan_range,
+                                    const double next_view_width )
+{
+    // the same margin as ViewGridMap::update()
+    const double edge_margin = 2.0;
+    const double scan_dist = 40.0;
+
+    const WorldModel & wm = agent->world();
+    const Vector2D my_next = agent->effector().queuedNextSelfPos();
+
+    Vector2D oldest_pos;
+    const int oldest_count = wm.viewGridMap().oldestSeenCount( my_next,
+                                                               left_start + edge_margin,
+                                                               left_start + ( scan_range - edge_margin ),
+                                                               scan_dist,
+                                                               &oldest_pos );
+    if ( oldest_count <= 0 )
+    {
+#ifdef DEBUG_PRINT
+        dlog.addText( Logger::ACTION,
+                      __FILE__": (calcAngleByGridMap) no old cell. count=%d",
+                      oldest_count );
+#endif
+        return INVALID_ANGLE;
+    }
+
+    //
+    // face to the cell, but keep the face angle in the reachable range.
+    // then, the cell is still in the next view cone.
+    //
+    const double half_width = next_view_width * 0.5;
+    const double rel_dir = ( ( oldest_pos - my_next ).th() - left_start ).degree();
+    const double dir = bound( half_width,
+                              ( rel_dir < 0.0 ? rel_dir + 360.0 : rel_dir ),
+                              scan_range - half_width );
+    const AngleDeg angle = left_start + dir;
+
+#ifdef DEBUG_PRINT
+    dlog.addText( Logger::ACTION,
+                  __FILE__": (calcAngleByGridMap) oldest=(%.1f %.1f) count=%d angle=%.0f",
+                  oldest_pos.x, oldest_pos.y, oldest_count,
+                  angle.degree() );
+#endif
+    return angle.degree();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
 */
 double
 Neck_ScanField::calcAngleForWidePitchEdge( const PlayerAgent * agent )
@@ -81,6 +81,19 @@ private:
     double calcAngleDefault( const PlayerAgent * agent,
                              const bool consider_pitch );
 
+    /*!
+      \brief face to the oldest seen cell of the view grid map in the reachable range
+      \param agent pointer to the agent itself
+      \param left_start the left limit of the reachable range
+      \param scan_range the width of the reachable range
+      \param next_view_width the view width in the next cycle
+      \retval -360.0 if no solution.
+     */
+    double calcAngleByGridMap( const PlayerAgent * agent,
+                               const AngleDeg & left_start,
+                               const double scan_range,
+                               const double next_view_width );
+
     /*!
       \retval -360.0 if no solution.
      */
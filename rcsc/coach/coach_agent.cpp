@@ -48,6 +48,7 @@
 #include <rcsc/common/offline_client.h>
 #include <rcsc/common/logger.h>
 #include <rcsc/common/server_param.h>
+#include <rcsc/common/shared_param_lock.h>
 #include <rcsc/common/player_param.h>
 #include <rcsc/common/player_type.h>
 #include <rcsc/common/team_graphic.h>
@@ -1366,8 +1367,14 @@ CoachAgent::Impl::analyzeChangePlayerType( const char * msg )
 void
 CoachAgent::Impl::analyzePlayerType( const char * msg )
 {
-    PlayerType player_type( msg, agent_.config().version() );
-    PlayerTypeSet::instance().insert( player_type );
+    {
+        SharedParamLock lock( msg );
+        if ( lock.isNewMessage() )
+        {
+            PlayerType player_type( msg, agent_.config().version() );
+            PlayerTypeSet::instance().insert( player_type );
+        }
+    }
 
     agent_.handlePlayerType();
 }
@@ -1379,7 +1386,13 @@ CoachAgent::Impl::analyzePlayerType( const char * msg )
 void
 CoachAgent::Impl::analyzePlayerParam( const char * msg )
 {
-    PlayerParam::instance().parse( msg, agent_.config().version() );
+    {
+        SharedParamLock lock( msg );
+        if ( lock.isNewMessage() )
+        {
+            PlayerParam::instance().parse( msg, agent_.config().version() );
+        }
+    }
     //PlayerParam::i().print( std::cout );
 
     agent_.M_worldmodel.setPlayerParam();
@@ -1393,8 +1406,14 @@ CoachAgent::Impl::analyzePlayerParam( const char * msg )
 void
 CoachAgent::Impl::analyzeServerParam( const char * msg )
 {
-    ServerParam::instance().parse( msg, agent_.config().version() );
-    PlayerTypeSet::instance().resetDefaultType();
+    {
+        SharedParamLock lock( msg );
+        if ( lock.isNewMessage() )
+        {
+            ServerParam::instance().parse( msg, agent_.config().version() );
+            PlayerTypeSet::instance().resetDefaultType();
+        }
+    }
 
     if ( ! ServerParam::i().synchMode()
          && ServerParam::i().slowDownFactor() > 1 )
@@ -2097,8 +2116,8 @@ CoachAgent::doTeamGraphic( const int x,
                            const int y,
                            const TeamGraphic & team_graphic )
 {
-    static int send_count = 0;
-    static GameTime send_time( -1, 0 );
+    thread_local int send_count = 0;
+    thread_local GameTime send_time( -1, 0 );
 
     if ( send_time != M_impl->current_time_ )
     {
@@ -0,0 +1,626 @@
+// -*-c++-*-
+
+/*!
+  \file agent_host.cpp
+  \brief multiple agents runtime in one process Source File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "agent_host.h"
+
+#include "online_client.h"
+#include "shared_param_lock.h"
+#include "soccer_agent.h"
+
+#include <rcsc/net/udp_socket.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/select.h> // select()
+#include <sys/time.h> // select()
+#include <sys/types.h> // select()
+
+#if defined(HAVE_SYS_EPOLL_H) && defined(HAVE_SYS_TIMERFD_H)
+#include <sys/epoll.h>
+#define RCSC_USE_EPOLL
+#endif
+
+namespace rcsc {
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+//! the number of the reserved latency samples (a whole match with sense_body, see and hear)
+const std::size_t RESERVED_SAMPLES = 6000 * 4;
+
+//! the time limit to receive all the parameter messages [ms]
+const double HANDSHAKE_TIMEOUT_MSEC = 5000.0;
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief get the elapsed time
+  \param start start time
+  \param end end time
+  \return milli seconds
+ */
+inline
+double
+elapsed_msec( const Clock::time_point & start,
+              const Clock::time_point & end )
+{
+    return std::chrono::duration< double, std::milli >( end - start ).count();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief create the statistics
+  \param values sample values. the order is changed.
+  \return statistics of the values
+ */
+AgentHost::LatencyStats
+make_stats( std::vector< double > values )
+{
+    AgentHost::LatencyStats stats;
+
+    if ( values.empty() )
+    {
+        return stats;
+    }
+
+    std::sort( values.begin(), values.end() );
+
+    const std::size_t n = values.size();
+    double sum = 0.0;
+    for ( double v : values )
+    {
+        sum += v;
+    }
+
+    stats.count_ = n;
+    stats.mean_ = sum / n;
+    stats.median_ = values[std::min( n - 1, n / 2 )];
+    stats.p95_ = values[std::min( n - 1, n * 95 / 100 )];
+    stats.p99_ = values[std::min( n - 1, n * 99 / 100 )];
+    stats.max_ = values.back();
+
+    return stats;
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \struct AgentHost::Entry
+  \brief per agent data shared by the poller and the worker.
+ */
+struct AgentHost::Entry {
+    std::shared_ptr< SoccerAgent > agent_; //!< agent instance
+    std::shared_ptr< OnlineClient > client_; //!< connection of the agent
+    std::thread thread_; //!< worker thread bound to the agent
+
+    std::mutex mutex_; //!< lock for the following event data
+    std::condition_variable cond_; //!< notified by the poller
+    bool readable_; //!< true if the socket has the new message
+    Clock::time_point event_time_; //!< the time when the poller detected the message
+
+    // the samples are written only by the worker, and read after run() returns.
+    std::vector< double > latency_; //!< decision latency samples [ms]
+    std::vector< double > wait_; //!< waiting time samples [ms]
+
+    Entry()
+        : readable_( false )
+      {
+          latency_.reserve( RESERVED_SAMPLES );
+          wait_.reserve( RESERVED_SAMPLES );
+      }
+};
+
+/*-------------------------------------------------------------------*/
+/*!
+  \struct AgentHost::StartGate
+  \brief the agents except the first one wait until this gate is opened.
+ */
+struct AgentHost::StartGate {
+    std::mutex mutex_; //!< lock for opened_
+    std::condition_variable cond_; //!< notified when the gate is opened
+    bool opened_; //!< true if the agents can be started
+
+    StartGate()
+        : opened_( false )
+      { }
+
+    /*!
+      \brief open the gate and wake up the waiting agents.
+     */
+    void open()
+      {
+          {
+              std::lock_guard< std::mutex > lock( mutex_ );
+              opened_ = true;
+          }
+          cond_.notify_all();
+      }
+
+    /*!
+      \brief block until the gate is opened.
+     */
+    void wait()
+      {
+          std::unique_lock< std::mutex > lock( mutex_ );
+          cond_.wait( lock, [this]() { return opened_; } );
+      }
+};
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+AgentHost::LatencyStats::LatencyStats()
+    : count_( 0 ),
+      mean_( 0.0 ),
+      median_( 0.0 ),
+      p95_( 0.0 ),
+      p99_( 0.0 ),
+      max_( 0.0 )
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+AgentHost::AgentHost()
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+AgentHost::~AgentHost()
+{
+    for ( std::unique_ptr< Entry > & e : M_entries )
+    {
+        if ( e->thread_.joinable() )
+        {
+            e->thread_.join();
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+AgentHost::addAgent( std::shared_ptr< SoccerAgent > agent )
+{
+    if ( ! agent )
+    {
+        return false;
+    }
+
+    std::unique_ptr< Entry > entry( new Entry() );
+    entry->agent_ = agent;
+    entry->client_ = std::shared_ptr< OnlineClient >( new OnlineClient() );
+
+    agent->setClient( entry->client_ );
+
+    M_entries.push_back( std::move( entry ) );
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+AgentHost::run()
+{
+    if ( M_entries.empty() )
+    {
+        return;
+    }
+
+    int poll_fd = -1;
+    int wake_fd[2] = { -1, -1 };
+
+#ifdef RCSC_USE_EPOLL
+    poll_fd = ::epoll_create1( EPOLL_CLOEXEC );
+    if ( poll_fd == -1 )
+    {
+        perror( "epoll_create1" );
+    }
+    else if ( ::pipe( wake_fd ) == -1 )
+    {
+        perror( "pipe" );
+        ::close( poll_fd );
+        poll_fd = -1;
+    }
+    else
+    {
+        ::fcntl( wake_fd[0], F_SETFD, FD_CLOEXEC );
+        ::fcntl( wake_fd[1], F_SETFD, FD_CLOEXEC );
+
+        // the pipe is registered with NULL to distinguish it from the agents.
+        struct epoll_event ev;
+        std::memset( &ev, 0, sizeof( ev ) );
+        ev.events = EPOLLIN;
+        ev.data.ptr = nullptr;
+        if ( ::epoll_ctl( poll_fd, EPOLL_CTL_ADD, wake_fd[0], &ev ) == -1 )
+        {
+            perror( "epoll_ctl" );
+            ::close( wake_fd[0] );
+            ::close( wake_fd[1] );
+            ::close( poll_fd );
+            poll_fd = -1;
+        }
+    }
+#endif
+
+    std::atomic< std::size_t > active( M_entries.size() );
+
+    // the shared parameters are written only by the first agent.
+    StartGate gate;
+    const Entry * first = M_entries.front().get();
+
+    for ( std::unique_ptr< Entry > & e : M_entries )
+    {
+        Entry * entry = e.get();
+        entry->thread_ = std::thread( [this, entry, first, poll_fd, &gate, &wake_fd, &active]()
+                                      {
+                                          if ( entry == first )
+                                          {
+                                              runAgent( *entry, poll_fd, &gate );
+                                              // open the gate even if the handshake failed.
+                                              gate.open();
+                                          }
+                                          else
+                                          {
+                                              gate.wait();
+                                              runAgent( *entry, poll_fd, nullptr );
+                                          }
+
+                                          if ( --active == 0
+                                               && wake_fd[1] != -1 )
+                                          {
+                                              const char c = 0;
+                                              if ( ::write( wake_fd[1], &c, 1 ) == -1 )
+                                              {
+                                                  perror( "write" );
+                                              }
+                                          }
+                                      } );
+    }
+
+    if ( poll_fd != -1 )
+    {
+        runPoller( poll_fd );
+    }
+
+    for ( std::unique_ptr< Entry > & e : M_entries )
+    {
+        e->thread_.join();
+    }
+
+    if ( poll_fd != -1 )
+    {
+        ::close( wake_fd[0] );
+        ::close( wake_fd[1] );
+        ::close( poll_fd );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+AgentHost::runPoller( const int poll_fd )
+{
+#ifdef RCSC_USE_EPOLL
+    const int MAX_EVENTS = 64;
+    struct epoll_event events[MAX_EVENTS];
+
+    while ( true )
+    {
+        const int n = ::epoll_wait( poll_fd, events, MAX_EVENTS, -1 );
+        if ( n < 0 )
+        {
+            if ( errno == EINTR )
+            {
+                continue;
+            }
+            perror( "epoll_wait" );
+            // the workers continue with their own timeout handling.
+            return;
+        }
+
+        const Clock::time_point now = Clock::now();
+
+        for ( int i = 0; i < n; ++i )
+        {
+            Entry * entry = static_cast< Entry * >( events[i].data.ptr );
+            if ( ! entry )
+            {
+                // all agents have exited.
+                return;
+            }
+
+            // the socket is disabled by EPOLLONESHOT until the worker rearms it.
+            {
+                std::lock_guard< std::mutex > lock( entry->mutex_ );
+                entry->readable_ = true;
+                entry->event_time_ = now;
+            }
+            entry->cond_.notify_one();
+        }
+    }
+#else
+    (void)poll_fd;
+#endif
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+AgentHost::runAgent( Entry & entry,
+                     const int poll_fd,
+                     StartGate * gate )
+{
+    SoccerAgent * agent = entry.agent_.get();
+    OnlineClient & client = *entry.client_;
+
+    if ( ! client.handleStart( agent )
+         || ! client.isServerAlive() )
+    {
+        client.handleExit( agent );
+        return;
+    }
+
+    if ( gate )
+    {
+        runHandshake( entry );
+        gate->open();
+    }
+
+    if ( poll_fd == -1 )
+    {
+        if ( ! client.runEpoll( agent ) )
+        {
+            client.runSelect( agent );
+        }
+        client.handleExit( agent );
+        return;
+    }
+
+#ifdef RCSC_USE_EPOLL
+    const int fd = client.M_socket->fd();
+
+    struct epoll_event ev;
+    std::memset( &ev, 0, sizeof( ev ) );
+    ev.events = EPOLLIN | EPOLLONESHOT;
+    ev.data.ptr = &entry;
+
+    if ( ::epoll_ctl( poll_fd, EPOLL_CTL_ADD, fd, &ev ) == -1 )
+    {
+        perror( "epoll_ctl" );
+        client.runSelect( agent );
+        client.handleExit( agent );
+        return;
+    }
+
+    int timeout_count = 0;
+    int waited_msec = 0;
+
+    while ( client.isServerAlive() )
+    {
+        std::unique_lock< std::mutex > lock( entry.mutex_ );
+        if ( ! entry.cond_.wait_for( lock,
+                                     std::chrono::milliseconds( client.intervalMSec() ),
+                                     [&entry]() { return entry.readable_; } ) )
+        {
+            lock.unlock();
+
+            // no meesage. timeout.
+            waited_msec += client.intervalMSec();
+            ++timeout_count;
+            client.handleTimeout( agent, timeout_count, waited_msec );
+            continue;
+        }
+
+        entry.readable_ = false;
+        const Clock::time_point event_time = entry.event_time_;
+        lock.unlock();
+
+        // received message, reset wait time
+        waited_msec = 0;
+        timeout_count = 0;
+
+        const Clock::time_point start_time = Clock::now();
+        client.dispatchMessage( agent );
+        const Clock::time_point end_time = Clock::now();
+
+        entry.wait_.push_back( elapsed_msec( event_time, start_time ) );
+        entry.latency_.push_back( elapsed_msec( event_time, end_time ) );
+
+        if ( ::epoll_ctl( poll_fd, EPOLL_CTL_MOD, fd, &ev ) == -1 )
+        {
+            perror( "epoll_ctl" );
+            client.runSelect( agent );
+            break;
+        }
+    }
+
+    ::epoll_ctl( poll_fd, EPOLL_CTL_DEL, fd, &ev );
+    client.handleExit( agent );
+#endif
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+AgentHost::runHandshake( Entry & entry )
+{
+    SoccerAgent * agent = entry.agent_.get();
+    OnlineClient & client = *entry.client_;
+
+    const int fd = client.M_socket->fd();
+    const Clock::time_point start_time = Clock::now();
+
+    // set interval timeout
+    struct timeval interval;
+
+    fd_set read_fds;
+
+    int timeout_count = 0;
+    int waited_msec = 0;
+
+    while ( client.isServerAlive()
+            && ! SharedParamLock::isAllReceived() )
+    {
+        if ( elapsed_msec( start_time, Clock::now() ) > HANDSHAKE_TIMEOUT_MSEC )
+        {
+            std::cerr << "(AgentHost::runHandshake) parameter messages are not received."
+                      << " start other agents." << std::endl;
+            break;
+        }
+
+        FD_ZERO( &read_fds );
+        FD_SET( fd, &read_fds );
+        interval.tv_sec = client.intervalMSec() / 1000;
+        interval.tv_usec = ( client.intervalMSec() % 1000 ) * 1000;
+
+        int ret = ::select( fd + 1, &read_fds,
+                            static_cast< fd_set * >( 0 ),
+                            static_cast< fd_set * >( 0 ),
+                            &interval );
+        if ( ret < 0 )
+        {
+            if ( errno == EINTR )
+            {
+                continue;
+            }
+            perror( "select" );
+            break;
+        }
+        else if ( ret == 0 )
+        {
+            // no meesage. timeout.
+            waited_msec += client.intervalMSec();
+            ++timeout_count;
+            client.handleTimeout( agent, timeout_count, waited_msec );
+        }
+        else
+        {
+            // received message, reset wait time
+            waited_msec = 0;
+            timeout_count = 0;
+            client.dispatchMessage( agent );
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+AgentHost::LatencyStats
+AgentHost::latencyStats( const std::size_t idx ) const
+{
+    if ( idx >= M_entries.size() )
+    {
+        return LatencyStats();
+    }
+
+    return make_stats( M_entries[idx]->latency_ );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+AgentHost::LatencyStats
+AgentHost::waitStats( const std::size_t idx ) const
+{
+    if ( idx >= M_entries.size() )
+    {
+        return LatencyStats();
+    }
+
+    return make_stats( M_entries[idx]->wait_ );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::ostream &
+AgentHost::printLatency( std::ostream & os ) const
+{
+    char buf[256];
+
+    for ( std::size_t i = 0; i < M_entries.size(); ++i )
+    {
+        const LatencyStats latency = latencyStats( i );
+        const LatencyStats wait = waitStats( i );
+
+        snprintf( buf, sizeof( buf ),
+                  "agent %zu: count=%zu latency[ms] mean=%.3f median=%.3f p95=%.3f p99=%.3f max=%.3f"
+                  " wait[ms] mean=%.3f p99=%.3f\n",
+                  i, latency.count_,
+                  latency.mean_, latency.median_, latency.p95_, latency.p99_, latency.max_,
+                  wait.mean_, wait.p99_ );
+        os << buf;
+    }
+
+    return os << std::flush;
+}
+
+}
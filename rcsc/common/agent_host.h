@@ -0,0 +1,176 @@
+// -*-c++-*-
+
+/*!
+  \file agent_host.h
+  \brief multiple agents runtime in one process Header File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+
+#ifndef RCSC_COMMON_AGENT_HOST_H
+#define RCSC_COMMON_AGENT_HOST_H
+
+#include <memory>
+#include <vector>
+#include <iosfwd>
+#include <cstddef>
+
+namespace rcsc {
+
+class SoccerAgent;
+
+/*!
+  \class AgentHost
+  \brief runtime that runs several agents in one process.
+
+  All agent sockets are watched by one poller on the thread that calls
+  run(), and the decision of each agent is executed on the worker thread
+  bound to that agent. Because the per agent state in the library (e.g.
+  dlog and the action caches) is thread local, an agent is never moved
+  to another worker. ServerParam, PlayerParam and PlayerTypeSet are
+  shared by all agents.
+
+  run() connects the first agent alone and starts the other agents after
+  the first agent has received all the parameter messages (server_param,
+  player_param and player_type). The same messages received by the other
+  agents are ignored by SharedParamLock, so the shared parameters are not
+  modified while the agents read them. Therefore, all agents have to use
+  the same protocol version.
+
+  The decision latency, the time from the message arrival to the end of
+  the message handling, is recorded for each agent. The statistics can be
+  read only after run() returns.
+ */
+class AgentHost {
+public:
+
+    /*!
+      \struct LatencyStats
+      \brief decision latency statistics [ms]
+     */
+    struct LatencyStats {
+        std::size_t count_; //!< the number of handled events
+        double mean_; //!< mean value
+        double median_; //!< 50th percentile
+        double p95_; //!< 95th percentile
+        double p99_; //!< 99th percentile
+        double max_; //!< max value
+
+        /*!
+          \brief initialize all values by 0.
+         */
+        LatencyStats();
+    };
+
+private:
+
+    //! per agent data
+    struct Entry;
+
+    //! the gate that starts the agents after the parameter handshake
+    struct StartGate;
+
+    //! registered agents
+    std::vector< std::unique_ptr< Entry > > M_entries;
+
+    // not used
+    AgentHost( const AgentHost & ) = delete;
+    AgentHost & operator=( const AgentHost & ) = delete;
+
+public:
+
+    /*!
+      \brief create an empty host.
+     */
+    AgentHost();
+
+    /*!
+      \brief destructor.
+     */
+    ~AgentHost();
+
+    /*!
+      \brief register the agent. the online client is created and set to the agent.
+      \param agent initialized agent instance
+      \return true if the agent is registered.
+     */
+    bool addAgent( std::shared_ptr< SoccerAgent > agent );
+
+    /*!
+      \brief get the number of registered agents
+      \return the number of registered agents
+     */
+    std::size_t size() const
+      {
+          return M_entries.size();
+      }
+
+    /*!
+      \brief mainloop. this method blocks until all agents exit.
+      The agents except the first one are started after the parameter handshake of the first agent.
+     */
+    void run();
+
+    /*!
+      \brief get the decision latency statistics of the agent.
+      \param idx index of the agent in the registration order
+      \return statistics of the decision latency
+
+      This method must not be called while run() is running.
+     */
+    LatencyStats latencyStats( const std::size_t idx ) const;
+
+    /*!
+      \brief get the waiting time statistics of the agent, the time from
+      the message arrival to the start of the message handling.
+      \param idx index of the agent in the registration order
+      \return statistics of the waiting time
+
+      This method must not be called while run() is running.
+     */
+    LatencyStats waitStats( const std::size_t idx ) const;
+
+    /*!
+      \brief print the latency statistics of all agents
+      \param os reference to the output stream
+      \return reference to the output stream
+
+      This method must not be called while run() is running.
+     */
+    std::ostream & printLatency( std::ostream & os ) const;
+
+private:
+
+    void runAgent( Entry & entry,
+                   const int poll_fd,
+                   StartGate * gate );
+    void runHandshake( Entry & entry );
+    void runPoller( const int poll_fd );
+};
+
+}
+
+#endif
@@ -0,0 +1,653 @@
+// -*-c++-*-
+
+/*!
+  \file log_record.cpp
+  \brief debug log record and its binary encoding Source File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "log_record.h"
+
+#include <rcsc/game_time.h>
+
+#include <algorithm>
+#include <istream>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace rcsc {
+
+const int LogRecordEncoder::FORMAT_REVISION = 1;
+
+namespace {
+
+//! file header
+const char BINARY_LOG_MAGIC[4] = { 'R', 'C', 'L', 'B' };
+
+//! the resolution of the text format
+const double VALUE_SCALE = 10000.0;
+
+//! the maximum scaled value stored as the fixed point value
+const double MAX_SCALED_VALUE = 9.0e15;
+
+//! sanity limit of the text length
+const std::uint64_t MAX_TEXT_SIZE = 64 * 1024 * 1024;
+
+/*-------------------------------------------------------------------*/
+inline
+std::uint64_t
+zigzag( const std::int64_t val )
+{
+    return ( static_cast< std::uint64_t >( val ) << 1 ) ^ static_cast< std::uint64_t >( val >> 63 );
+}
+
+/*-------------------------------------------------------------------*/
+inline
+std::int64_t
+unzigzag( const std::uint64_t val )
+{
+    return static_cast< std::int64_t >( val >> 1 ) ^ -static_cast< std::int64_t >( val & 1 );
+}
+
+/*-------------------------------------------------------------------*/
+inline
+void
+put_varint( std::string & out,
+            std::uint64_t val )
+{
+    while ( val >= 0x80 )
+    {
+        out += static_cast< char >( ( val & 0x7f ) | 0x80 );
+        val >>= 7;
+    }
+    out += static_cast< char >( val );
+}
+
+/*-------------------------------------------------------------------*/
+inline
+void
+put_raw( std::string & out,
+         std::uint64_t val,
+         const int size )
+{
+    for ( int i = 0; i < size; ++i )
+    {
+        out += static_cast< char >( val & 0xff );
+        val >>= 8;
+    }
+}
+
+/*-------------------------------------------------------------------*/
+inline
+bool
+get_varint( std::istream & is,
+            std::uint64_t * val )
+{
+    *val = 0;
+    for ( int shift = 0; shift < 64; shift += 7 )
+    {
+        const int c = is.get();
+        if ( c == std::char_traits< char >::eof() )
+        {
+            return false;
+        }
+
+        *val |= static_cast< std::uint64_t >( c & 0x7f ) << shift;
+        if ( ! ( c & 0x80 ) )
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*-------------------------------------------------------------------*/
+inline
+bool
+get_raw( std::istream & is,
+         std::uint64_t * val,
+         const int size )
+{
+    unsigned char buf[8];
+    if ( ! is.read( reinterpret_cast< char * >( buf ), size ) )
+    {
+        return false;
+    }
+
+    *val = 0;
+    for ( int i = size - 1; i >= 0; --i )
+    {
+        *val = ( *val << 8 ) | buf[i];
+    }
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief write the coordinate value.
+  The value is stored as the fixed point integer (the lowest bit is 0) if
+  the text format can be restored from it. Otherwise the raw double value
+  follows the escape code 1.
+ */
+inline
+void
+put_value( std::string & out,
+           const double val )
+{
+    const double scaled = val * VALUE_SCALE;
+    if ( -MAX_SCALED_VALUE < scaled && scaled < MAX_SCALED_VALUE )
+    {
+        const std::int64_t q = std::llround( scaled );
+        // keep "-0.0000"
+        if ( q != 0 || ! std::signbit( val ) )
+        {
+            put_varint( out, zigzag( q ) << 1 );
+            return;
+        }
+    }
+
+    std::uint64_t bits;
+    std::memcpy( &bits, &val, sizeof( bits ) );
+    put_varint( out, 1 );
+    put_raw( out, bits, 8 );
+}
+
+/*-------------------------------------------------------------------*/
+inline
+bool
+get_value( std::istream & is,
+           double * val )
+{
+    std::uint64_t code;
+    if ( ! get_varint( is, &code ) )
+    {
+        return false;
+    }
+
+    if ( code & 1 )
+    {
+        std::uint64_t bits;
+        if ( ! get_raw( is, &bits, 8 ) )
+        {
+            return false;
+        }
+        std::memcpy( val, &bits, sizeof( bits ) );
+        return true;
+    }
+
+    *val = static_cast< double >( unzigzag( code >> 1 ) ) / VALUE_SCALE;
+    return true;
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+LogRecord::LogRecord()
+    : cycle_( 0 ),
+      stopped_( 0 ),
+      level_( 0 ),
+      color_{ 0, 0, 0 },
+      text_size_( 0 ),
+      tag_( 0 ),
+      n_values_( 0 ),
+      color_type_( NO_COLOR )
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+LogRecord::LogRecord( const GameTime & time,
+                      const std::int32_t level,
+                      const char tag,
+                      std::initializer_list< double > values )
+    : cycle_( time.cycle() ),
+      stopped_( time.stopped() ),
+      level_( level ),
+      color_{ 0, 0, 0 },
+      text_size_( 0 ),
+      tag_( tag ),
+      n_values_( static_cast< std::uint8_t >( std::min( values.size(), MAX_VALUES ) ) ),
+      color_type_( NO_COLOR )
+{
+    std::copy( values.begin(), values.begin() + n_values_, values_ );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+LogRecord::appendText( const char * color,
+                       const char * text,
+                       const std::size_t text_size,
+                       std::string & out ) const
+{
+    if ( tag_ == 'M' )
+    {
+        char header[32];
+        snprintf( header, 32, "%ld,%ld %d M ",
+                  cycle_,
+                  stopped_,
+                  level_ );
+        out += header;
+        out.append( text, text_size );
+        out += '\n';
+        return;
+    }
+
+    if ( tag_ == 'm' )
+    {
+        char header[128];
+        snprintf( header, 128, "%ld,%ld %d m %.4f %.4f ",
+                  cycle_,
+                  stopped_,
+                  level_,
+                  values_[0], values_[1] );
+        out += header;
+
+        if ( color_type_ == NAMED_COLOR )
+        {
+            out += "(c ";
+            out += color;
+            out += ") ";
+        }
+        else if ( color_type_ == RGB_COLOR )
+        {
+            char col[8];
+            snprintf( col, 8, "#%02x%02x%02x",
+                      color_[0], color_[1], color_[2] );
+            out += "(c ";
+            out += col;
+            out += ") ";
+        }
+
+        out.append( text, text_size );
+        out += '\n';
+        return;
+    }
+
+    // shapes. the same format as the single snprintf call of the old implementation.
+    static const char * const formats[7][2] = {
+        { "%ld,%ld %d %c ", "%ld,%ld %d %c #%02x%02x%02x" },
+        { "%ld,%ld %d %c %.4f ", "%ld,%ld %d %c %.4f #%02x%02x%02x" },
+        { "%ld,%ld %d %c %.4f %.4f ", "%ld,%ld %d %c %.4f %.4f #%02x%02x%02x" },
+        { "%ld,%ld %d %c %.4f %.4f %.4f ", "%ld,%ld %d %c %.4f %.4f %.4f #%02x%02x%02x" },
+        { "%ld,%ld %d %c %.4f %.4f %.4f %.4f ", "%ld,%ld %d %c %.4f %.4f %.4f %.4f #%02x%02x%02x" },
+        { "%ld,%ld %d %c %.4f %.4f %.4f %.4f %.4f ", "%ld,%ld %d %c %.4f %.4f %.4f %.4f %.4f #%02x%02x%02x" },
+        { "%ld,%ld %d %c %.4f %.4f %.4f %.4f %.4f %.4f ", "%ld,%ld %d %c %.4f %.4f %.4f %.4f %.4f %.4f #%02x%02x%02x" },
+    };
+
+    const double * v = values_;
+    const std::int32_t * c = color_;
+    const char * fmt = formats[n_values_][color_type_ == RGB_COLOR ? 1 : 0];
+
+    // unused trailing arguments are ignored by snprintf.
+    char msg[128];
+    switch ( n_values_ ) {
+    case 0:
+        snprintf( msg, 128, fmt, cycle_, stopped_, level_, tag_,
+                  c[0], c[1], c[2] );
+        break;
+    case 1:
+        snprintf( msg, 128, fmt, cycle_, stopped_, level_, tag_,
+                  v[0], c[0], c[1], c[2] );
+        break;
+    case 2:
+        snprintf( msg, 128, fmt, cycle_, stopped_, level_, tag_,
+                  v[0], v[1], c[0], c[1], c[2] );
+        break;
+    case 3:
+        snprintf( msg, 128, fmt, cycle_, stopped_, level_, tag_,
+                  v[0], v[1], v[2], c[0], c[1], c[2] );
+        break;
+    case 4:
+        snprintf( msg, 128, fmt, cycle_, stopped_, level_, tag_,
+                  v[0], v[1], v[2], v[3], c[0], c[1], c[2] );
+        break;
+    case 5:
+        snprintf( msg, 128, fmt, cycle_, stopped_, level_, tag_,
+                  v[0], v[1], v[2], v[3], v[4], c[0], c[1], c[2] );
+        break;
+    default:
+        snprintf( msg, 128, fmt, cycle_, stopped_, level_, tag_,
+                  v[0], v[1], v[2], v[3], v[4], v[5], c[0], c[1], c[2] );
+        break;
+    }
+
+    out += msg;
+    if ( color_type_ == NAMED_COLOR )
+    {
+        out += color;
+    }
+    out += '\n';
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::int32_t
+LogColorTable::intern( const char * color,
+                       bool * added )
+{
+    *added = false;
+
+    std::unordered_map< const char *, std::int32_t >::const_iterator cached = M_cache.find( color );
+    if ( cached != M_cache.end()
+         && M_names[cached->second] == color )
+    {
+        return cached->second;
+    }
+
+    std::int32_t id = 0;
+    std::unordered_map< std::string, std::int32_t >::const_iterator it = M_ids.find( color );
+    if ( it != M_ids.end() )
+    {
+        id = it->second;
+    }
+    else
+    {
+        id = static_cast< std::int32_t >( M_names.size() );
+        M_ids.emplace( color, id );
+        M_names.emplace_back( color );
+        *added = true;
+    }
+
+    // temporary strings may be passed. limit the cache size.
+    if ( M_cache.size() >= 1024 )
+    {
+        M_cache.clear();
+    }
+    M_cache[color] = id;
+    return id;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+LogColorTable::truncate( const std::size_t size )
+{
+    if ( size >= M_names.size() )
+    {
+        return;
+    }
+
+    for ( std::size_t i = size; i < M_names.size(); ++i )
+    {
+        M_ids.erase( M_names[i] );
+    }
+    M_names.resize( size );
+    M_cache.clear();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+LogRecordEncoder::LogRecordEncoder()
+    : M_committed_colors( 0 )
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+LogRecordEncoder::write_header( std::string & out )
+{
+    out.append( BINARY_LOG_MAGIC, 4 );
+    out += static_cast< char >( FORMAT_REVISION );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+LogRecordEncoder::encode( const LogRecord & record,
+                          const char * color,
+                          const char * text,
+                          const std::size_t text_size,
+                          std::string & out )
+{
+    std::int32_t color_id = 0;
+    if ( record.color_type_ == LogRecord::NAMED_COLOR )
+    {
+        bool added = false;
+        color_id = M_colors.intern( color, &added );
+        if ( added )
+        {
+            const std::string & name = M_colors.name( color_id );
+            out += static_cast< char >( LogRecord::DEFINE_COLOR );
+            put_varint( out, color_id );
+            put_varint( out, name.length() );
+            out += name;
+        }
+    }
+
+    out += record.tag_;
+    out += static_cast< char >( record.n_values_ | ( record.color_type_ << 4 ) );
+    put_raw( out, static_cast< std::uint32_t >( record.level_ ), 4 );
+    put_varint( out, zigzag( record.cycle_ ) );
+    put_varint( out, zigzag( record.stopped_ ) );
+
+    for ( int i = 0; i < record.n_values_; ++i )
+    {
+        put_value( out, record.values_[i] );
+    }
+
+    if ( record.color_type_ == LogRecord::NAMED_COLOR )
+    {
+        put_varint( out, color_id );
+    }
+    else if ( record.color_type_ == LogRecord::RGB_COLOR )
+    {
+        put_varint( out, zigzag( record.color_[0] ) );
+        put_varint( out, zigzag( record.color_[1] ) );
+        put_varint( out, zigzag( record.color_[2] ) );
+    }
+
+    if ( record.hasText() )
+    {
+        put_varint( out, text_size );
+        out.append( text, text_size );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+LogRecordDecoder::read_header( std::istream & is )
+{
+    char header[5];
+    if ( ! is.read( header, 5 ) )
+    {
+        return false;
+    }
+
+    return ( std::memcmp( header, BINARY_LOG_MAGIC, 4 ) == 0
+             && static_cast< int >( header[4] ) == LogRecordEncoder::FORMAT_REVISION );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+LogRecordDecoder::read( std::istream & is,
+                        LogRecord & record,
+                        std::string & text )
+{
+    std::uint64_t val = 0;
+
+    int tag = is.get();
+    while ( tag == LogRecord::DEFINE_COLOR )
+    {
+        std::uint64_t id = 0;
+        if ( ! get_varint( is, &id )
+             || ! get_varint( is, &val )
+             || val > MAX_TEXT_SIZE )
+        {
+            return false;
+        }
+
+        std::string name( val, '\0' );
+        if ( val > 0
+             && ! is.read( &name[0], val ) )
+        {
+            return false;
+        }
+
+        if ( M_colors.size() <= id )
+        {
+            M_colors.resize( id + 1 );
+        }
+        M_colors[id].swap( name );
+
+        tag = is.get();
+    }
+
+    if ( tag == std::char_traits< char >::eof() )
+    {
+        return false;
+    }
+
+    const int flags = is.get();
+    if ( flags == std::char_traits< char >::eof()
+         || static_cast< std::size_t >( flags & 0x0f ) > LogRecord::MAX_VALUES )
+    {
+        return false;
+    }
+
+    record.tag_ = static_cast< char >( tag );
+    record.n_values_ = static_cast< std::uint8_t >( flags & 0x0f );
+    record.color_type_ = static_cast< std::uint8_t >( ( flags >> 4 ) & 0x0f );
+
+    if ( ! get_raw( is, &val, 4 ) )
+    {
+        return false;
+    }
+    record.level_ = static_cast< std::int32_t >( static_cast< std::uint32_t >( val ) );
+
+    if ( ! get_varint( is, &val ) )
+    {
+        return false;
+    }
+    record.cycle_ = static_cast< long >( unzigzag( val ) );
+
+    if ( ! get_varint( is, &val ) )
+    {
+        return false;
+    }
+    record.stopped_ = static_cast< long >( unzigzag( val ) );
+
+    for ( int i = 0; i < record.n_values_; ++i )
+    {
+        if ( ! get_value( is, &record.values_[i] ) )
+        {
+            return false;
+        }
+    }
+
+    if ( record.color_type_ == LogRecord::NAMED_COLOR )
+    {
+        if ( ! get_varint( is, &val )
+             || val >= M_colors.size() )
+        {
+            return false;
+        }
+        record.color_[0] = static_cast< std::int32_t >( val );
+    }
+    else if ( record.color_type_ == LogRecord::RGB_COLOR )
+    {
+        for ( int i = 0; i < 3; ++i )
+        {
+            if ( ! get_varint( is, &val ) )
+            {
+                return false;
+            }
+            record.color_[i] = static_cast< std::int32_t >( unzigzag( val ) );
+        }
+    }
+
+    text.clear();
+    record.text_size_ = 0;
+    if ( record.hasText() )
+    {
+        if ( ! get_varint( is, &val )
+             || val > MAX_TEXT_SIZE )
+        {
+            return false;
+        }
+
+        text.resize( val );
+        if ( val > 0
+             && ! is.read( &text[0], val ) )
+        {
+            return false;
+        }
+        record.text_size_ = static_cast< std::uint32_t >( val );
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+const char *
+LogRecordDecoder::colorName( const LogRecord & record ) const
+{
+    if ( record.color_type_ != LogRecord::NAMED_COLOR
+         || record.color_[0] < 0
+         || M_colors.size() <= static_cast< std::size_t >( record.color_[0] ) )
+    {
+        return nullptr;
+    }
+
+    return M_colors[record.color_[0]].c_str();
+}
+
+}
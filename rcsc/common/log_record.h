@@ -0,0 +1,305 @@
+// -*-c++-*-
+
+/*!
+  \file log_record.h
+  \brief debug log record and its binary encoding Header File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_COMMON_LOG_RECORD_H
+#define RCSC_COMMON_LOG_RECORD_H
+
+#include <unordered_map>
+#include <initializer_list>
+#include <vector>
+#include <string>
+#include <iosfwd>
+#include <cstddef>
+#include <cstdint>
+
+namespace rcsc {
+
+class GameTime;
+
+/*!
+  \struct LogRecord
+  \brief binary representation of one debug log line.
+
+  The text data of 'M' and 'm' records and the color name are held
+  outside of the record.
+*/
+struct LogRecord {
+
+    //! color specification type
+    enum ColorType : std::uint8_t {
+        NO_COLOR,
+        NAMED_COLOR,
+        RGB_COLOR,
+    };
+
+    //! message tags used only by the logger internally
+    enum ControlTag : char {
+        DEFINE_COLOR = '#', //!< register the color name. color_[0] is its id.
+        FLUSH = '!', //!< write the buffered data
+        CLEAR = '~', //!< discard the buffered data
+    };
+
+    //! the maximum number of coordinates
+    static const std::size_t MAX_VALUES = 6;
+
+    long cycle_; //!< game time
+    long stopped_; //!< game time
+    double values_[MAX_VALUES]; //!< coordinates
+    std::int32_t level_; //!< log level
+    std::int32_t color_[3]; //!< color id or rgb values
+    std::uint32_t text_size_; //!< length of the text
+    char tag_; //!< message tag
+    std::uint8_t n_values_; //!< the number of coordinates
+    std::uint8_t color_type_; //!< color specification type
+
+    /*!
+      \brief create an empty record
+     */
+    LogRecord();
+
+    /*!
+      \brief create a record without color
+      \param time game time
+      \param level log level
+      \param tag message tag
+      \param values coordinates
+     */
+    LogRecord( const GameTime & time,
+               const std::int32_t level,
+               const char tag,
+               std::initializer_list< double > values );
+
+    /*!
+      \brief set the named color
+      \param color color name string. NULL means no color.
+     */
+    void setColor( const char * color )
+      {
+          color_type_ = ( color ? NAMED_COLOR : NO_COLOR );
+      }
+
+    /*!
+      \brief set the rgb color
+      \param r red value
+      \param g green value
+      \param b blue value
+     */
+    void setColor( const int r, const int g, const int b )
+      {
+          color_type_ = RGB_COLOR;
+          color_[0] = r;
+          color_[1] = g;
+          color_[2] = b;
+      }
+
+    /*!
+      \brief check if this record has the text data
+      \return true if the text data follows this record
+     */
+    bool hasText() const
+      {
+          return tag_ == 'M' || tag_ == 'm';
+      }
+
+    /*!
+      \brief append the text format line to the buffer.
+      \param color color name string. used only if the record has the named color.
+      \param text text data
+      \param text_size length of the text
+      \param out output buffer
+     */
+    void appendText( const char * color,
+                     const char * text,
+                     const std::size_t text_size,
+                     std::string & out ) const;
+};
+
+/*-------------------------------------------------------------------*/
+/*!
+  \class LogColorTable
+  \brief interned color names.
+
+  Color names are usually string literals, so the address of the string
+  is checked before the string itself.
+*/
+class LogColorTable {
+private:
+
+    std::unordered_map< std::string, std::int32_t > M_ids; //!< name to id
+    std::unordered_map< const char *, std::int32_t > M_cache; //!< address to id
+    std::vector< std::string > M_names; //!< id to name
+
+public:
+
+    /*!
+      \brief get the id of the color name. new id is assigned to the unknown color.
+      \param color color name string
+      \param added set true if the new id is assigned
+      \return color id
+     */
+    std::int32_t intern( const char * color,
+                         bool * added );
+
+    /*!
+      \brief get the color name
+      \param id color id
+      \return color name string
+     */
+    const std::string & name( const std::int32_t id ) const
+      {
+          return M_names[id];
+      }
+
+    /*!
+      \brief get the number of registered colors
+      \return the number of registered colors
+     */
+    std::size_t size() const
+      {
+          return M_names.size();
+      }
+
+    /*!
+      \brief remove the colors registered after the specified id
+      \param size the number of colors to keep
+     */
+    void truncate( const std::size_t size );
+};
+
+/*-------------------------------------------------------------------*/
+/*!
+  \class LogRecordEncoder
+  \brief binary debug log encoder.
+
+  The binary log starts with the 4 bytes "RCLB" and the 1 byte format
+  revision. Coordinates are stored as variable length fixed point values
+  with the resolution of the text format (0.0001), and color names are
+  defined once and referred by id. LogRecordDecoder converts the data back
+  to the text format.
+*/
+class LogRecordEncoder {
+public:
+
+    //! binary format revision
+    static const int FORMAT_REVISION;
+
+private:
+
+    LogColorTable M_colors; //!< interned color names
+    std::size_t M_committed_colors; //!< the number of colors already written to the file
+
+public:
+
+    /*!
+      \brief create an encoder without color definitions
+     */
+    LogRecordEncoder();
+
+    /*!
+      \brief append the file header
+      \param out output buffer
+     */
+    static
+    void write_header( std::string & out );
+
+    /*!
+      \brief append the encoded record
+      \param record record data
+      \param color color name string. used only if the record has the named color.
+      \param text text data
+      \param text_size length of the text
+      \param out output buffer
+     */
+    void encode( const LogRecord & record,
+                 const char * color,
+                 const char * text,
+                 const std::size_t text_size,
+                 std::string & out );
+
+    /*!
+      \brief notify that the buffered data is written to the file
+     */
+    void commit()
+      {
+          M_committed_colors = M_colors.size();
+      }
+
+    /*!
+      \brief notify that the buffered data is discarded
+     */
+    void rollback()
+      {
+          M_colors.truncate( M_committed_colors );
+      }
+};
+
+/*-------------------------------------------------------------------*/
+/*!
+  \class LogRecordDecoder
+  \brief binary debug log decoder.
+*/
+class LogRecordDecoder {
+private:
+
+    std::vector< std::string > M_colors; //!< id to name
+
+public:
+
+    /*!
+      \brief read the file header
+      \param is input stream
+      \return true if the stream is the binary debug log
+     */
+    static
+    bool read_header( std::istream & is );
+
+    /*!
+      \brief read the next record. the color definitions are handled internally.
+      \param is input stream
+      \param record record data
+      \param text text data of the record
+      \return true if the record is read
+     */
+    bool read( std::istream & is,
+               LogRecord & record,
+               std::string & text );
+
+    /*!
+      \brief get the color name of the record
+      \param record record data
+      \return color name string, or NULL if the record does not have the named color
+     */
+    const char * colorName( const LogRecord & record ) const;
+};
+
+}
+
+#endif
@@ -35,9 +35,17 @@
 
 #include "logger.h"
 
+#include "log_record.h"
+
 #include <rcsc/game_time.h>
 
 #include <string>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <algorithm>
 #include <iostream>
 #include <cstdio>
 #include <cstdarg>
@@ -51,15 +59,343 @@ namespace  {
 #define G_BUFFER_SIZE 2048
 
 //! temporary buffer
-char g_buffer[G_BUFFER_SIZE];
+thread_local char g_buffer[G_BUFFER_SIZE];
 
 //! main buffer
-std::string g_str;
+thread_local std::string g_str;
+
+//! buffered data size that triggers the output
+const std::size_t FLUSH_THRESHOLD = 8192 * 3;
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \class AsyncLogWriter
+  \brief background log writer.
+
+  The logger thread pushes the records into a single producer/single
+  consumer ring buffer without any lock. The writer thread pops them,
+  formats (or encodes) them and writes the result to the file. The color
+  names are sent only once and referred by their id.
+*/
+class AsyncLogWriter {
+private:
+
+    //! ring buffer size. must be a power of 2.
+    static const std::size_t BUFFER_SIZE = 1024 * 1024;
+
+    //! output file. only used by the writer thread.
+    FILE * M_fout;
+
+    //! binary encoder. NULL means the text format.
+    std::unique_ptr< LogRecordEncoder > M_encoder;
+
+    std::vector< char > M_ring; //!< ring buffer
+
+    alignas( 64 ) std::atomic< std::size_t > M_head; //!< total bytes pushed. updated by the producer.
+    alignas( 64 ) std::atomic< std::size_t > M_tail; //!< total bytes popped. updated by the consumer.
+
+    std::atomic< bool > M_stop;
+
+    //! used only to put the idle writer thread to sleep
+    std::mutex M_mutex;
+    std::condition_variable M_cond;
+
+    //
+    // producer side
+    //
+    LogColorTable M_color_table; //!< interned color names
+
+    //
+    // consumer side
+    //
+    std::vector< std::string > M_colors; //!< id to name
+    std::string M_text; //!< text data of the current record
+    std::string M_pending; //!< output data not yet written
+
+    std::thread M_thread;
+
+public:
+
+    AsyncLogWriter( FILE * fout,
+                    std::unique_ptr< LogRecordEncoder > encoder );
+
+    ~AsyncLogWriter();
+
+    void push( LogRecord & record,
+               const char * color,
+               const char * text,
+               const std::size_t text_size );
+
+    void pushControl( const char tag );
+
+    std::unique_ptr< LogRecordEncoder > stop();
+
+private:
+
+    void write( const void * data,
+                std::size_t size );
+    bool read( void * data,
+               std::size_t size );
+
+    void run();
+    void output();
+};
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+AsyncLogWriter::AsyncLogWriter( FILE * fout,
+                                std::unique_ptr< LogRecordEncoder > encoder )
+    : M_fout( fout ),
+      M_encoder( std::move( encoder ) ),
+      M_ring( BUFFER_SIZE ),
+      M_head( 0 ),
+      M_tail( 0 ),
+      M_stop( false )
+{
+    M_pending.reserve( FLUSH_THRESHOLD + 8192 );
+    M_thread = std::thread( &AsyncLogWriter::run, this );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+AsyncLogWriter::~AsyncLogWriter()
+{
+    stop();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::unique_ptr< LogRecordEncoder >
+AsyncLogWriter::stop()
+{
+    M_stop.store( true, std::memory_order_release );
+    M_cond.notify_one();
+    if ( M_thread.joinable() )
+    {
+        M_thread.join();
+    }
+
+    return std::move( M_encoder );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+AsyncLogWriter::push( LogRecord & record,
+                      const char * color,
+                      const char * text,
+                      const std::size_t text_size )
+{
+    if ( record.color_type_ == LogRecord::NAMED_COLOR )
+    {
+        bool added = false;
+        record.color_[0] = M_color_table.intern( color, &added );
+        if ( added )
+        {
+            const std::string & name = M_color_table.name( record.color_[0] );
+            LogRecord def;
+            def.tag_ = LogRecord::DEFINE_COLOR;
+            def.color_[0] = record.color_[0];
+            def.text_size_ = static_cast< std::uint32_t >( name.length() );
+            write( &def, sizeof( LogRecord ) );
+            write( name.data(), name.length() );
+        }
+    }
+    record.text_size_ = static_cast< std::uint32_t >( text_size );
+
+    write( &record, sizeof( LogRecord ) );
+    if ( text_size > 0 )
+    {
+        write( text, text_size );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+AsyncLogWriter::pushControl( const char tag )
+{
+    LogRecord record;
+    record.tag_ = tag;
+    write( &record, sizeof( LogRecord ) );
 
+    if ( tag == LogRecord::FLUSH )
+    {
+        M_cond.notify_one();
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+AsyncLogWriter::write( const void * data,
+                       std::size_t size )
+{
+    const char * ptr = static_cast< const char * >( data );
+
+    while ( size > 0 )
+    {
+        const std::size_t head = M_head.load( std::memory_order_relaxed );
+        const std::size_t tail = M_tail.load( std::memory_order_acquire );
+        const std::size_t space = BUFFER_SIZE - ( head - tail );
+
+        if ( space == 0 )
+        {
+            // the buffer is full. wake up the writer and wait.
+            M_cond.notify_one();
+            std::this_thread::yield();
+            continue;
+        }
+
+        const std::size_t offset = head & ( BUFFER_SIZE - 1 );
+        const std::size_t n = std::min( { size, space, BUFFER_SIZE - offset } );
+
+        std::memcpy( M_ring.data() + offset, ptr, n );
+        M_head.store( head + n, std::memory_order_release );
+
+        ptr += n;
+        size -= n;
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+AsyncLogWriter::read( void * data,
+                      std::size_t size )
+{
+    char * ptr = static_cast< char * >( data );
+
+    while ( size > 0 )
+    {
+        const std::size_t tail = M_tail.load( std::memory_order_relaxed );
+        const std::size_t head = M_head.load( std::memory_order_acquire );
+
+        if ( head == tail )
+        {
+            if ( M_stop.load( std::memory_order_acquire )
+                 && M_head.load( std::memory_order_acquire ) == tail )
+            {
+                return false;
+            }
+
+            std::unique_lock< std::mutex > lock( M_mutex );
+            M_cond.wait_for( lock, std::chrono::milliseconds( 10 ) );
+            continue;
+        }
+
+        const std::size_t offset = tail & ( BUFFER_SIZE - 1 );
+        const std::size_t n = std::min( { size, head - tail, BUFFER_SIZE - offset } );
+
+        std::memcpy( ptr, M_ring.data() + offset, n );
+        M_tail.store( tail + n, std::memory_order_release );
+
+        ptr += n;
+        size -= n;
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+AsyncLogWriter::run()
+{
+    LogRecord record;
+
+    while ( read( &record, sizeof( LogRecord ) ) )
+    {
+        M_text.resize( record.text_size_ );
+        if ( record.text_size_ > 0
+             && ! read( &M_text[0], record.text_size_ ) )
+        {
+            break;
+        }
+
+        switch ( record.tag_ ) {
+        case LogRecord::DEFINE_COLOR:
+            if ( M_colors.size() <= static_cast< std::size_t >( record.color_[0] ) )
+            {
+                M_colors.resize( record.color_[0] + 1 );
+            }
+            M_colors[record.color_[0]] = M_text;
+            break;
+        case LogRecord::FLUSH:
+            output();
+            break;
+        case LogRecord::CLEAR:
+            M_pending.clear();
+            if ( M_encoder )
+            {
+                M_encoder->rollback();
+            }
+            break;
+        default:
+            {
+                const char * color = ( record.color_type_ == LogRecord::NAMED_COLOR
+                                       ? M_colors[record.color_[0]].c_str()
+                                       : nullptr );
+                if ( M_encoder )
+                {
+                    M_encoder->encode( record, color, M_text.data(), M_text.size(), M_pending );
+                }
+                else
+                {
+                    record.appendText( color, M_text.data(), M_text.size(), M_pending );
+                }
+            }
+            if ( M_pending.length() > FLUSH_THRESHOLD )
+            {
+                output();
+            }
+            break;
+        }
+    }
+
+    output();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+AsyncLogWriter::output()
+{
+    if ( M_fout && ! M_pending.empty() )
+    {
+        std::fwrite( M_pending.data(), sizeof( char ), M_pending.length(), M_fout );
+        std::fflush( M_fout );
+    }
+    M_pending.clear();
+
+    if ( M_encoder )
+    {
+        M_encoder->commit();
+    }
 }
 
 //! global variable
-Logger dlog;
+thread_local Logger dlog;
 
 /*-------------------------------------------------------------------*/
 /*!
@@ -70,7 +406,9 @@ Logger::Logger()
       M_fout( nullptr ),
       M_flags( 0 ),
       M_start_time( -1 ),
-      M_end_time( 99999999 )
+      M_end_time( 99999999 ),
+      M_async( false ),
+      M_binary( false )
 {
     g_str.reserve( 8192 * 4 );
     std::strcpy( g_buffer, "" );
@@ -115,6 +453,43 @@ Logger::setTimeRange( const int start_time,
     M_end_time = end_time;
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+Logger::setAsync( const bool on )
+{
+    M_async = on;
+
+    if ( ! M_fout )
+    {
+        return;
+    }
+
+    if ( on && ! M_async_writer )
+    {
+        flush();
+        M_async_writer.reset( new AsyncLogWriter( M_fout, std::move( M_encoder ) ) );
+    }
+    else if ( ! on && M_async_writer )
+    {
+        flush();
+        M_encoder = M_async_writer->stop();
+        M_async_writer.reset();
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+Logger::setBinary( const bool on )
+{
+    M_binary = on;
+}
+
 /*-------------------------------------------------------------------*/
 /*!
 
@@ -125,6 +500,9 @@ Logger::close()
     if ( M_fout )
     {
         flush();
+        // wait for the background writer
+        M_async_writer.reset();
+        M_encoder.reset();
         if ( M_fout != stdout
              && M_fout != stderr )
         {
@@ -144,6 +522,8 @@ Logger::open( const std::string & filepath )
     close();
 
     M_fout = std::fopen( filepath.c_str(), "w" );
+
+    startOutput();
 }
 
 /*-------------------------------------------------------------------*/
@@ -156,6 +536,8 @@ Logger::openStandardOutput()
     close();
 
     M_fout = stdout;
+
+    startOutput();
 }
 
 /*-------------------------------------------------------------------*/
@@ -168,6 +550,35 @@ Logger::openStandardError()
     close();
 
     M_fout = stderr;
+
+    startOutput();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+Logger::startOutput()
+{
+    if ( ! M_fout )
+    {
+        return;
+    }
+
+    if ( M_binary )
+    {
+        std::string header;
+        LogRecordEncoder::write_header( header );
+        std::fwrite( header.data(), sizeof( char ), header.length(), M_fout );
+
+        M_encoder.reset( new LogRecordEncoder() );
+    }
+
+    if ( M_async )
+    {
+        M_async_writer.reset( new AsyncLogWriter( M_fout, std::move( M_encoder ) ) );
+    }
 }
 
 /*-------------------------------------------------------------------*/
@@ -177,13 +588,24 @@ Logger::openStandardError()
 void
 Logger::flush()
 {
+    if ( M_async_writer )
+    {
+        M_async_writer->pushControl( LogRecord::FLUSH );
+        return;
+    }
+
     if ( M_fout && g_str.length() > 0 )
     {
-        fputs( g_str.c_str(), M_fout );
-        //fwrite( g_str.c_str(), sizeof( char ), g_str.length(), M_fout );
+        // binary data may contain null characters.
+        fwrite( g_str.data(), sizeof( char ), g_str.length(), M_fout );
         fflush( M_fout );
     }
     g_str.erase();
+
+    if ( M_encoder )
+    {
+        M_encoder->commit();
+    }
 }
 
 /*-------------------------------------------------------------------*/
@@ -193,7 +615,42 @@ Logger::flush()
 void
 Logger::clear()
 {
+    if ( M_async_writer )
+    {
+        M_async_writer->pushControl( LogRecord::CLEAR );
+        return;
+    }
+
     g_str.erase();
+
+    if ( M_encoder )
+    {
+        M_encoder->rollback();
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+Logger::addRecord( LogRecord & record,
+                   const char * color,
+                   const char * text,
+                   const std::size_t text_size )
+{
+    if ( M_async_writer )
+    {
+        M_async_writer->push( record, color, text, text_size );
+    }
+    else if ( M_encoder )
+    {
+        M_encoder->encode( record, color, text, text_size, g_str );
+    }
+    else
+    {
+        record.appendText( color, text, text_size, g_str );
+    }
 }
 
 /*-------------------------------------------------------------------*/
@@ -216,16 +673,10 @@ Logger::addText( const std::int32_t level,
         vsnprintf( g_buffer, G_BUFFER_SIZE, msg, argp );
         va_end( argp );
 
-        char header[32];
-        snprintf( header, 32, "%ld,%ld %d M ",
-                  M_time->cycle(),
-                  M_time->stopped(),
-                  level );
+        LogRecord record( *M_time, level, 'M', {} );
+        addRecord( record, nullptr, g_buffer, std::strlen( g_buffer ) );
 
-        g_str += header;
-        g_str += g_buffer;
-        g_str += '\n';
-        if ( g_str.length() > 8192 * 3 )
+        if ( g_str.length() > FLUSH_THRESHOLD )
         {
             flush();
         }
@@ -248,18 +699,9 @@ Logger::addPoint( const std::int32_t level,
          && M_start_time <= M_time->cycle()
          && M_time->cycle() <= M_end_time )
     {
-        char msg[128];
-        snprintf( msg, 128, "%ld,%ld %d p %.4f %.4f ",
-                  M_time->cycle(),
-                  M_time->stopped(),
-                  level,
-                  x, y );
-        g_str += msg;
-        if ( color )
-        {
-            g_str += color;
-        }
-        g_str += '\n';
+        LogRecord record( *M_time, level, 'p', { x, y } );
+        record.setColor( color );
+        addRecord( record, color, nullptr, 0 );
     }
 }
 
@@ -279,15 +721,9 @@ Logger::addPoint( const std::int32_t level,
          && M_start_time <= M_time->cycle()
          && M_time->cycle() <= M_end_time )
     {
-        char msg[128];
-        snprintf( msg, 128, "%ld,%ld %d p %.4f %.4f #%02x%02x%02x",
-                  M_time->cycle(),
-                  M_time->stopped(),
-                  level,
-                  x, y,
-                  r, g, b );
-        g_str += msg;
-        g_str += '\n';
+        LogRecord record( *M_time, level, 'p', { x, y } );
+        record.setColor( r, g, b );
+        addRecord( record, nullptr, nullptr, 0 );
     }
 }
 
@@ -309,18 +745,9 @@ Logger::addLine( const std::int32_t level,
          && M_start_time <= M_time->cycle()
          && M_time->cycle() <= M_end_time )
     {
-        char msg[128];
-        snprintf( msg, 128, "%ld,%ld %d l %.4f %.4f %.4f %.4f ",
-                  M_time->cycle(),
-                  M_time->stopped(),
-                  level,
-                  x1, y1, x2, y2 );
-        g_str += msg;
-        if ( color )
-        {
-            g_str += color;
-        }
-        g_str += '\n';
+        LogRecord record( *M_time, level, 'l', { x1, y1, x2, y2 } );
+        record.setColor( color );
+        addRecord( record, color, nullptr, 0 );
     }
 }
 
@@ -342,15 +769,9 @@ Logger::addLine( const std::int32_t level,
          && M_start_time <= M_time->cycle()
          && M_time->cycle() <= M_end_time )
     {
-        char msg[128];
-        snprintf( msg, 128, "%ld,%ld %d l %.4f %.4f %.4f %.4f #%02x%02x%02x",
-                  M_time->cycle(),
-                  M_time->stopped(),
-                  level,
-                  x1, y1, x2, y2,
-                  r, g, b );
-        g_str += msg;
-        g_str += '\n';
+        LogRecord record( *M_time, level, 'l', { x1, y1, x2, y2 } );
+        record.setColor( r, g, b );
+        addRecord( record, nullptr, nullptr, 0 );
     }
 }
 
@@ -373,20 +794,10 @@ Logger::addArc( const std::int32_t level,
          && M_start_time <= M_time->cycle()
          && M_time->cycle() <= M_end_time )
     {
-        char msg[128];
-        snprintf( msg, 128, "%ld,%ld %d a %.4f %.4f %.4f %.4f %.4f ",
-                  M_time->cycle(),
-                  M_time->stopped(),
-                  level,
-                  x, y, radius, start_angle.degree(), span_angle );
-        g_str += msg;
-
-        if ( color )
-        {
-            g_str += color;
-        }
-
-        g_str += '\n';
+        LogRecord record( *M_time, level, 'a',
+                          { x, y, radius, start_angle.degree(), span_angle } );
+        record.setColor( color );
+        addRecord( record, color, nullptr, 0 );
     }
 }
 
@@ -410,15 +821,10 @@ Logger::addArc( const std::int32_t level,
          && M_start_time <= M_time->cycle()
          && M_time->cycle() <= M_end_time )
     {
-        char msg[128];
-        snprintf( msg, 128, "%ld,%ld %d a %.4f %.4f %.4f %.4f %.4f #%02x%02x%02x",
-                  M_time->cycle(),
-                  M_time->stopped(),
-                  level,
-                  x, y, radius, start_angle.degree(), span_angle,
-                  r, g, b );
-        g_str += msg;
-        g_str += '\n';
+        LogRecord record( *M_time, level, 'a',
+                          { x, y, radius, start_angle.degree(), span_angle } );
+        record.setColor( r, g, b );
+        addRecord( record, nullptr, nullptr, 0 );
     }
 }
 
@@ -440,19 +846,10 @@ Logger::addCircle( const std::int32_t level,
          && M_start_time <= M_time->cycle()
          && M_time->cycle() <= M_end_time )
     {
-        char msg[128];
-        snprintf( msg, 128, "%ld,%ld %d %c %.4f %.4f %.4f ",
-                  M_time->cycle(),
-                  M_time->stopped(),
-                  level,
-                  ( fill ? 'C' : 'c' ),
-                  x, y, radius );
-        g_str += msg;
-        if ( color )
-        {
-            g_str += color;
-        }
-        g_str += '\n';
+        LogRecord record( *M_time, level, ( fill ? 'C' : 'c' ),
+                          { x, y, radius } );
+        record.setColor( color );
+        addRecord( record, color, nullptr, 0 );
     }
 }
 
@@ -474,16 +871,10 @@ Logger::addCircle( const std::int32_t level,
          && M_start_time <= M_time->cycle()
          && M_time->cycle() <= M_end_time )
     {
-        char msg[128];
-        snprintf( msg, 128, "%ld,%ld %d %c %.4f %.4f %.4f #%02x%02x%02x",
-                  M_time->cycle(),
-                  M_time->stopped(),
-                  level,
-                  ( fill ? 'C' : 'c' ),
-                  x, y, radius,
-                  r, g, b );
-        g_str += msg;
-        g_str += '\n';
+        LogRecord record( *M_time, level, ( fill ? 'C' : 'c' ),
+                          { x, y, radius } );
+        record.setColor( r, g, b );
+        addRecord( record, nullptr, nullptr, 0 );
     }
 }
 
@@ -508,19 +899,10 @@ Logger::addTriangle( const std::int32_t level,
          && M_start_time <= M_time->cycle()
          && M_time->cycle() <= M_end_time )
     {
-        char msg[128];
-        snprintf( msg, 128, "%ld,%ld %d %c %.4f %.4f %.4f %.4f %.4f %.4f ",
-                  M_time->cycle(),
-                  M_time->stopped(),
-                  level,
-                  ( fill ? 'T' : 't' ),
-                  x1, y1, x2, y2, x3, y3 );
-        g_str += msg;
-        if ( color )
-        {
-            g_str += color;
-        }
-        g_str += '\n';
+        LogRecord record( *M_time, level, ( fill ? 'T' : 't' ),
+                          { x1, y1, x2, y2, x3, y3 } );
+        record.setColor( color );
+        addRecord( record, color, nullptr, 0 );
     }
 }
 
@@ -545,16 +927,10 @@ Logger::addTriangle( const std::int32_t level,
          && M_start_time <= M_time->cycle()
          && M_time->cycle() <= M_end_time )
     {
-        char msg[128];
-        snprintf( msg, 128, "%ld,%ld %d %c %.4f %.4f %.4f %.4f %.4f %.4f #%02x%02x%02x",
-                  M_time->cycle(),
-                  M_time->stopped(),
-                  level,
-                  ( fill ? 'T' : 't' ),
-                  x1, y1, x2, y2, x3, y3,
-                  r, g, b );
-        g_str += msg;
-        g_str += '\n';
+        LogRecord record( *M_time, level, ( fill ? 'T' : 't' ),
+                          { x1, y1, x2, y2, x3, y3 } );
+        record.setColor( r, g, b );
+        addRecord( record, nullptr, nullptr, 0 );
     }
 }
 
@@ -577,19 +953,10 @@ Logger::addRect( const std::int32_t level,
          && M_start_time <= M_time->cycle()
          && M_time->cycle() <= M_end_time )
     {
-        char msg[128];
-        snprintf( msg, 128, "%ld,%ld %d %c %.4f %.4f %.4f %.4f ",
-                  M_time->cycle(),
-                  M_time->stopped(),
-                  level,
-                  ( fill ? 'R' : 'r' ),
-                  left, top, length, width );
-        g_str += msg;
-        if ( color )
-        {
-            g_str += color;
-        }
-        g_str += '\n';
+        LogRecord record( *M_time, level, ( fill ? 'R' : 'r' ),
+                          { left, top, length, width } );
+        record.setColor( color );
+        addRecord( record, color, nullptr, 0 );
     }
 }
 
@@ -612,16 +979,10 @@ Logger::addRect( const std::int32_t level,
          && M_start_time <= M_time->cycle()
          && M_time->cycle() <= M_end_time )
     {
-        char msg[128];
-        snprintf( msg, 128, "%ld,%ld %d %c %.4f %.4f %.4f %.4f #%02x%02x%02x",
-                  M_time->cycle(),
-                  M_time->stopped(),
-                  level,
-                  ( fill ? 'R' : 'r' ),
-                  left, top, length, width,
-                  r, g, b );
-        g_str += msg;
-        g_str += '\n';
+        LogRecord record( *M_time, level, ( fill ? 'R' : 'r' ),
+                          { left, top, length, width } );
+        record.setColor( r, g, b );
+        addRecord( record, nullptr, nullptr, 0 );
     }
 }
 
@@ -646,20 +1007,11 @@ Logger::addSector( const std::int32_t level,
          && M_start_time <= M_time->cycle()
          && M_time->cycle() <= M_end_time )
     {
-        char msg[128];
-        snprintf( msg, 128, "%ld,%ld %d %c %.4f %.4f %.4f %.4f %.4f %.4f ",
-                  M_time->cycle(),
-                  M_time->stopped(),
-                  level,
-                  ( fill ? 'S' : 's' ),
-                  x, y, min_radius, max_radius,
-                  start_angle.degree(), span_angle );
-        g_str += msg;
-        if ( color )
-        {
-            g_str += color;
-        }
-        g_str += '\n';
+        LogRecord record( *M_time, level, ( fill ? 'S' : 's' ),
+                          { x, y, min_radius, max_radius,
+                            start_angle.degree(), span_angle } );
+        record.setColor( color );
+        addRecord( record, color, nullptr, 0 );
     }
 }
 
@@ -684,17 +1036,11 @@ Logger::addSector( const std::int32_t level,
          && M_start_time <= M_time->cycle()
          && M_time->cycle() <= M_end_time )
     {
-        char msg[128];
-        snprintf( msg, 128, "%ld,%ld %d %c %.4f %.4f %.4f %.4f %.4f %.4f #%02x%02x%02x",
-                  M_time->cycle(),
-                  M_time->stopped(),
-                  level,
-                  ( fill ? 'S' : 's' ),
-                  x, y, min_radius, max_radius,
-                  start_angle.degree(), span_angle,
-                  r, g, b );
-        g_str += msg;
-        g_str += '\n';
+        LogRecord record( *M_time, level, ( fill ? 'S' : 's' ),
+                          { x, y, min_radius, max_radius,
+                            start_angle.degree(), span_angle } );
+        record.setColor( r, g, b );
+        addRecord( record, nullptr, nullptr, 0 );
     }
 }
 
@@ -714,24 +1060,15 @@ Logger::addSector( const std::int32_t level,
          && M_start_time <= M_time->cycle()
          && M_time->cycle() <= M_end_time )
     {
-        char msg[128];
         double span_angle = ( sector.angleLeftStart().isLeftOf( sector.angleRightEnd() )
                               ? ( sector.angleLeftStart() - sector.angleRightEnd() ).abs()
                               : 360.0 - ( sector.angleLeftStart() - sector.angleRightEnd() ).abs() );
-        snprintf( msg, 128, "%ld,%ld %d %c %.4f %.4f %.4f %.4f %.4f %.4f ",
-                  M_time->cycle(),
-                  M_time->stopped(),
-                  level,
-                  ( fill ? 'S' : 's' ),
-                  sector.center().x, sector.center().y,
-                  sector.radiusMin(), sector.radiusMax(),
-                  sector.angleLeftStart().degree(), span_angle );
-        g_str += msg;
-        if ( color )
-        {
-            g_str += color;
-        }
-        g_str += '\n';
+        LogRecord record( *M_time, level, ( fill ? 'S' : 's' ),
+                          { sector.center().x, sector.center().y,
+                            sector.radiusMin(), sector.radiusMax(),
+                            sector.angleLeftStart().degree(), span_angle } );
+        record.setColor( color );
+        addRecord( record, color, nullptr, 0 );
     }
 }
 
@@ -751,21 +1088,15 @@ Logger::addSector( const std::int32_t level,
          && M_start_time <= M_time->cycle()
          && M_time->cycle() <= M_end_time )
     {
-        char msg[128];
         double span_angle = ( sector.angleLeftStart().isLeftOf( sector.angleRightEnd() )
                               ? ( sector.angleLeftStart() - sector.angleRightEnd() ).abs()
                               : 360.0 - ( sector.angleLeftStart() - sector.angleRightEnd() ).abs() );
-        snprintf( msg, 128, "%ld,%ld %d %c %.4f %.4f %.4f %.4f %.4f %.4f #%02x%02x%02x",
-                  M_time->cycle(),
-                  M_time->stopped(),
-                  level,
-                  ( fill ? 'S' : 's' ),
-                  sector.center().x, sector.center().y,
-                  sector.radiusMin(), sector.radiusMax(),
-                  sector.angleLeftStart().degree(), span_angle,
-                  r, g, b );
-        g_str += msg;
-        g_str += '\n';
+        LogRecord record( *M_time, level, ( fill ? 'S' : 's' ),
+                          { sector.center().x, sector.center().y,
+                            sector.radiusMin(), sector.radiusMax(),
+                            sector.angleLeftStart().degree(), span_angle } );
+        record.setColor( r, g, b );
+        addRecord( record, nullptr, nullptr, 0 );
     }
 }
 
@@ -786,23 +1117,9 @@ Logger::addMessage( const std::int32_t level,
          && M_start_time <= M_time->cycle()
          && M_time->cycle() <= M_end_time )
     {
-        char header[128];
-        snprintf( header, 128, "%ld,%ld %d m %.4f %.4f ",
-                  M_time->cycle(),
-                  M_time->stopped(),
-                  level,
-                  x, y );
-        g_str += header;
-
-        if ( color )
-        {
-            g_str += "(c ";
-            g_str += color;
-            g_str += ") ";
-        }
-
-        g_str += msg;
-        g_str += '\n';
+        LogRecord record( *M_time, level, 'm', { x, y } );
+        record.setColor( color );
+        addRecord( record, color, msg, std::strlen( msg ) );
     }
 }
 
@@ -823,22 +1140,9 @@ Logger::addMessage( const std::int32_t level,
          && M_start_time <= M_time->cycle()
          && M_time->cycle() <= M_end_time )
     {
-        char header[128];
-        snprintf( header, 128, "%ld,%ld %d m %.4f %.4f ",
-                  M_time->cycle(),
-                  M_time->stopped(),
-                  level,
-                  x, y );
-        g_str += header;
-
-        char col[8];
-        snprintf( col, 8, "#%02x%02x%02x", r, g, b );
-        g_str += "(c ";
-        g_str += col;
-        g_str += ") ";
-
-        g_str += msg;
-        g_str += '\n';
+        LogRecord record( *M_time, level, 'm', { x, y } );
+        record.setColor( r, g, b );
+        addRecord( record, nullptr, msg, std::strlen( msg ) );
     }
 }
 
@@ -38,6 +38,7 @@
 #include <rcsc/geom/sector_2d.h>
 #include <rcsc/geom/triangle_2d.h>
 
+#include <memory>
 #include <string>
 #include <cstdio>
 #include <cstdint>
@@ -45,6 +46,9 @@
 namespace rcsc {
 
 class GameTime;
+class AsyncLogWriter;
+class LogRecordEncoder;
+struct LogRecord;
 
 /*!
   \class Logger
@@ -158,6 +162,18 @@ private:
     int M_start_time;
     int M_end_time;
 
+    //! if true, the background thread formats and writes the records
+    bool M_async;
+
+    //! the background writer. only available in the asynchronous mode.
+    std::unique_ptr< AsyncLogWriter > M_async_writer;
+
+    //! if true, the records are written in the binary format
+    bool M_binary;
+
+    //! the binary encoder. owned by the background writer in the asynchronous mode.
+    std::unique_ptr< LogRecordEncoder > M_encoder;
+
 public:
     /*!
       \brief allocate message buffer memory
@@ -187,6 +203,41 @@ public:
     void setTimeRange( const int start_time,
                        const int end_time );
 
+    /*!
+      \brief set the output mode.
+      In the asynchronous mode, the caller thread only pushes the binary
+      records into a ring buffer, and a background thread formats and writes
+      them. The output text is the same as the synchronous mode.
+      \param on if true, the asynchronous mode is used.
+     */
+    void setAsync( const bool on );
+
+    /*!
+      \brief check if the asynchronous mode is used.
+      \return true if the asynchronous mode is used.
+     */
+    bool isAsync() const
+      {
+          return M_async;
+      }
+
+    /*!
+      \brief set the output format. this setting takes effect when the file is opened.
+      The binary format is much smaller and cheaper to write than the text
+      format. The binary log can be converted to the text format by dlog2txt.
+      \param on if true, the binary format is used.
+     */
+    void setBinary( const bool on );
+
+    /*!
+      \brief check if the binary format is used.
+      \return true if the binary format is used.
+     */
+    bool isBinary() const
+      {
+          return M_binary;
+      }
+
     /*!
       \brief check if the level is enabled
       \param level checked log level
@@ -237,6 +288,27 @@ public:
     */
     void clear();
 
+private:
+
+    /*!
+      \brief write the file header and start the background writer if needed.
+     */
+    void startOutput();
+
+    /*!
+      \brief format the record into the buffer or push it to the background writer.
+      \param record record data
+      \param color color name string. if the record has the named color, this must not be NULL.
+      \param text text data
+      \param text_size length of the text
+     */
+    void addRecord( LogRecord & record,
+                    const char * color,
+                    const char * text,
+                    const std::size_t text_size );
+
+public:
+
     /*!
       \brief add free message to buffer with cycle, level & message tag 'T'
       \param level debug flag level
@@ -961,8 +1033,8 @@ public:
 
 };
 
-//! global variable
-extern Logger dlog;
+//! global variable. each thread has its own logger.
+extern thread_local Logger dlog;
 
 }
 
@@ -37,6 +37,7 @@
 
 #include "soccer_agent.h"
 
+#include <fstream>
 #include <iostream>
 #include <cstring>
 #include <cassert>
@@ -48,7 +49,8 @@ namespace rcsc {
 
 */
 OfflineClient::OfflineClient()
-    : AbstractClient()
+    : AbstractClient(),
+      M_read_pos( 0 )
 {
 
 }
@@ -113,13 +115,26 @@ OfflineClient::sendMessage( const char * /*msg*/ )
 int
 OfflineClient::receiveMessage()
 {
-    while ( std::getline( M_offline_in, M_received_message ) )
+    const std::size_t size = M_log_data.size();
+    const char * data = M_log_data.data();
+
+    while ( M_read_pos < size )
     {
-        if ( M_received_message.empty() )
+        const char * begin = data + M_read_pos;
+        const char * end = static_cast< const char * >( std::memchr( begin, '\n', size - M_read_pos ) );
+        if ( ! end )
+        {
+            end = data + size;
+        }
+
+        M_read_pos = ( end - data ) + 1;
+
+        if ( end == begin )
         {
             continue;
         }
 
+        M_received_message.assign( begin, end - begin );
         return M_received_message.size();
     }
 
@@ -134,10 +149,28 @@ OfflineClient::receiveMessage()
 bool
 OfflineClient::openOfflineLog( const std::string & filepath )
 {
-    M_offline_in.close();
-    M_offline_in.open( filepath.c_str() );
+    M_log_data.clear();
+    M_read_pos = 0;
 
-    return M_offline_in.is_open();
+    std::ifstream fin( filepath.c_str(), std::ios_base::in | std::ios_base::binary );
+    if ( ! fin.is_open() )
+    {
+        return false;
+    }
+
+    // the whole file is loaded at once to exclude the file access from the replay.
+    fin.seekg( 0, std::ios_base::end );
+    const std::streamoff size = fin.tellg();
+    fin.seekg( 0, std::ios_base::beg );
+
+    if ( size > 0 )
+    {
+        M_log_data.resize( static_cast< std::size_t >( size ) );
+        fin.read( &M_log_data[0], size );
+        M_log_data.resize( static_cast< std::size_t >( fin.gcount() ) );
+    }
+
+    return true;
 }
 
 /*-------------------------------------------------------------------*/
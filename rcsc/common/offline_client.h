@@ -34,7 +34,8 @@
 
 #include <rcsc/common/abstract_client.h>
 
-#include <fstream>
+#include <string>
+#include <cstddef>
 
 namespace rcsc {
 
@@ -46,8 +47,11 @@ class OfflineClient
     : public AbstractClient {
 private:
 
-    //! input log file for offline client
-    std::ifstream M_offline_in;
+    //! whole contents of the offline client log file
+    std::string M_log_data;
+
+    //! read position in the log data
+    std::size_t M_read_pos;
 
 public:
 
@@ -87,14 +91,14 @@ public:
     int sendMessage( const char * msg );
 
     /*!
-      \brief read a recorded message from the offline log file.
+      \brief read a recorded message from the preloaded log data.
       \return length of read message
      */
     virtual
     int receiveMessage();
 
     /*!
-      \brief open the offline client log file.
+      \brief open the offline client log file and load all data into memory.
       \param filepath file path string to be opened.
       \return result status.
      */
@@ -39,22 +39,77 @@
 
 #include <rcsc/net/udp_socket.h>
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <cstring>
+#include <cstdint>
+#include <cerrno>
 
 #include <unistd.h> // select()
 #include <sys/select.h> // select()
 #include <sys/time.h> // select()
 #include <sys/types.h> // select()
 
+#if defined(HAVE_SYS_EPOLL_H) && defined(HAVE_SYS_TIMERFD_H)
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#define RCSC_USE_EPOLL
+#endif
+
 namespace rcsc {
 
+namespace {
+
+//! the maximum number of datagrams received at once
+const int RECV_BATCH_SIZE = 16;
+
+#ifdef RCSC_USE_EPOLL
+/*-------------------------------------------------------------------*/
+/*!
+  \brief get the current monotonic time
+  \return milli seconds
+ */
+inline
+long
+now_msec()
+{
+    return std::chrono::duration_cast< std::chrono::milliseconds >
+        ( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief set the one shot timer
+  \param fd timerfd
+  \param msec expiration time
+  \return result of timerfd_settime()
+ */
+inline
+int
+set_timer( const int fd,
+           const long msec )
+{
+    struct itimerspec spec;
+    std::memset( &spec, 0, sizeof( spec ) );
+    spec.it_value.tv_sec = msec / 1000;
+    spec.it_value.tv_nsec = ( msec % 1000 ) * 1000 * 1000;
+    return ::timerfd_settime( fd, 0, &spec, nullptr );
+}
+#endif
+
+}
+
 /*-------------------------------------------------------------------*/
 /*!
 
  */
 OnlineClient::OnlineClient()
-    : AbstractClient()
+    : AbstractClient(),
+      M_recv_buffer( RECV_BATCH_SIZE * MAX_MESG ),
+      M_recv_sizes( RECV_BATCH_SIZE, 0 ),
+      M_recv_count( 0 ),
+      M_recv_index( 0 )
 {
 
 }
@@ -89,6 +144,158 @@ OnlineClient::run( SoccerAgent * agent )
         return;
     }
 
+    if ( ! runEpoll( agent ) )
+    {
+        runSelect( agent );
+    }
+
+    handleExit( agent );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+OnlineClient::dispatchMessage( SoccerAgent * agent )
+{
+    // the datagrams already read from the socket are not notified by select/epoll.
+    do
+    {
+        handleMessage( agent );
+    }
+    while ( hasBufferedMessage()
+            && isServerAlive() );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+OnlineClient::runEpoll( SoccerAgent * agent )
+{
+#ifdef RCSC_USE_EPOLL
+    const int epoll_fd = ::epoll_create1( EPOLL_CLOEXEC );
+    if ( epoll_fd == -1 )
+    {
+        perror( "epoll_create1" );
+        return false;
+    }
+
+    const int timer_fd = ::timerfd_create( CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC );
+    if ( timer_fd == -1 )
+    {
+        perror( "timerfd_create" );
+        ::close( epoll_fd );
+        return false;
+    }
+
+    struct epoll_event ev;
+    std::memset( &ev, 0, sizeof( ev ) );
+    ev.events = EPOLLIN;
+    ev.data.fd = M_socket->fd();
+    if ( ::epoll_ctl( epoll_fd, EPOLL_CTL_ADD, M_socket->fd(), &ev ) == -1 )
+    {
+        perror( "epoll_ctl" );
+        ::close( timer_fd );
+        ::close( epoll_fd );
+        return false;
+    }
+
+    ev.data.fd = timer_fd;
+    if ( ::epoll_ctl( epoll_fd, EPOLL_CTL_ADD, timer_fd, &ev ) == -1
+         || set_timer( timer_fd, intervalMSec() ) == -1 )
+    {
+        perror( "epoll_ctl" );
+        ::close( timer_fd );
+        ::close( epoll_fd );
+        return false;
+    }
+
+    int timeout_count = 0;
+    int waited_msec = 0;
+
+    // the time when the last interval started.
+    // the timer is not rearmed for each message to save the system calls.
+    // instead, the remaining time is checked when the timer expires.
+    long interval_start = now_msec();
+
+    while ( isServerAlive() )
+    {
+        struct epoll_event events[2];
+        const int n = ::epoll_wait( epoll_fd, events, 2, -1 );
+        if ( n < 0 )
+        {
+            if ( errno == EINTR )
+            {
+                continue;
+            }
+            perror( "epoll_wait" );
+            break;
+        }
+
+        bool readable = false;
+        bool expired = false;
+        for ( int i = 0; i < n; ++i )
+        {
+            if ( events[i].data.fd == timer_fd )
+            {
+                std::uint64_t expirations;
+                if ( ::read( timer_fd, &expirations, sizeof( expirations ) ) > 0 )
+                {
+                    expired = true;
+                }
+            }
+            else
+            {
+                readable = true;
+            }
+        }
+
+        if ( readable )
+        {
+            // received message, reset wait time
+            waited_msec = 0;
+            timeout_count = 0;
+            dispatchMessage( agent );
+            interval_start = now_msec();
+        }
+
+        if ( expired )
+        {
+            long rest = intervalMSec() - ( now_msec() - interval_start );
+            if ( ! readable
+                 && rest <= 0 )
+            {
+                // no meesage. timeout.
+                waited_msec += intervalMSec();
+                ++timeout_count;
+                handleTimeout( agent, timeout_count, waited_msec );
+                interval_start = now_msec();
+                rest = intervalMSec();
+            }
+
+            set_timer( timer_fd, std::max( 1L, rest ) );
+        }
+    }
+
+    ::close( timer_fd );
+    ::close( epoll_fd );
+    return true;
+#else
+    (void)agent;
+    return false;
+#endif
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+OnlineClient::runSelect( SoccerAgent * agent )
+{
     // set interval timeout
     struct timeval interval;
 
@@ -129,11 +336,9 @@ OnlineClient::run( SoccerAgent * agent )
             // received message, reset wait time
             waited_msec = 0;
             timeout_count = 0;
-            handleMessage( agent );
+            dispatchMessage( agent );
         }
     }
-
-    handleExit( agent );
 }
 
 /*-------------------------------------------------------------------*/
@@ -194,14 +399,28 @@ OnlineClient::sendMessage( const char * msg )
 int
 OnlineClient::receiveMessage()
 {
-    static char msg[MAX_MESG];
-
     if ( ! M_socket )
     {
         return 0;
     }
 
-    int n = M_socket->readDatagram( msg, MAX_MESG );
+    if ( M_recv_index >= M_recv_count )
+    {
+        // read all pending datagrams by one system call
+        M_recv_index = 0;
+        M_recv_count = M_socket->readDatagrams( M_recv_buffer.data(), MAX_MESG,
+                                                M_recv_sizes.data(), RECV_BATCH_SIZE );
+        if ( M_recv_count <= 0 )
+        {
+            const int result = M_recv_count;
+            M_recv_count = 0;
+            return result;
+        }
+    }
+
+    const char * msg = M_recv_buffer.data() + M_recv_index * MAX_MESG;
+    const int n = M_recv_sizes[M_recv_index];
+    ++M_recv_index;
 
     if ( n > 0 )
     {
@@ -34,6 +34,7 @@
 
 #include <rcsc/common/abstract_client.h>
 
+#include <vector>
 #include <fstream>
 
 namespace rcsc {
@@ -53,12 +54,24 @@ class OnlineClient
     : public AbstractClient {
 private:
 
+    // the host drives the client by its own event loop.
+    friend class AgentHost;
+
     //! udp connection
     std::shared_ptr< UDPSocket > M_socket;
 
     //! output file for offline logging
     std::ofstream M_offline_out;
 
+    //! buffer for the datagrams received at once
+    std::vector< char > M_recv_buffer;
+    //! the length of each received datagram
+    std::vector< int > M_recv_sizes;
+    //! the number of datagrams in the buffer
+    int M_recv_count;
+    //! the index of the next datagram to be processed
+    int M_recv_index;
+
 public:
 
     /*!
@@ -76,8 +89,9 @@ public:
       \param agent pointer to the soccer agent instance.
 
       Thie method keep infinite loop while client can estimate server is alive.
-      To handle server message, select() is used.
-      Timeout interval of select() is specified by M_interval_msec member variable.
+      To handle server message, epoll and timerfd are used on Linux, and
+      select() is used on other platforms.
+      Timeout interval is specified by M_interval_msec member variable.
       When server message is received, handleMessage() is called.
       When timeout occurs, handleTimeout() is called.
       When server is not alive, loop is end and handleExit() is called.
@@ -106,6 +120,7 @@ public:
 
     /*!
       \brief receive server message in the socket queue.
+      All pending datagrams are read at once and returned one by one in order.
       If an offline log file is opened, all received messages are recoreded to the file.
       \return length of received message
      */
@@ -126,6 +141,35 @@ public:
     virtual
     void printOfflineThink();
 
+private:
+
+    /*!
+      \brief check if the received datagrams remain in the buffer.
+      \return true if the buffer is not empty.
+     */
+    bool hasBufferedMessage() const
+      {
+          return M_recv_index < M_recv_count;
+      }
+
+    /*!
+      \brief call handleMessage() until the buffered datagrams are processed.
+      \param agent pointer to the soccer agent instance.
+     */
+    void dispatchMessage( SoccerAgent * agent );
+
+    /*!
+      \brief mainloop using epoll and timerfd.
+      \param agent pointer to the soccer agent instance.
+      \return false if the event loop is not available.
+     */
+    bool runEpoll( SoccerAgent * agent );
+
+    /*!
+      \brief mainloop using select().
+      \param agent pointer to the soccer agent instance.
+     */
+    void runSelect( SoccerAgent * agent );
 };
 
 }
@@ -36,7 +36,9 @@
 #include "player_type.h"
 
 #include "player_param.h"
+#include "reach_step_table.h"
 #include "server_param.h"
+#include "sexp_cursor.h"
 #include "stamina_model.h"
 
 #include <rcsc/rcg/util.h>
@@ -45,6 +47,7 @@
 #include <sstream>
 #include <iostream>
 #include <algorithm>
+#include <functional>
 #include <string>
 #include <cstdio>
 #include <cstring>
@@ -391,36 +394,40 @@ PlayerType::parseV8( const char * msg )
       (extra_stamina 98) (effort_max 0.804) (effort_min 0.404))";
     */
 
-    int n_read = 0;
+    SExpCursor cursor( msg );
 
     char name[32];
     int id = 0;
-    if ( std::sscanf( msg, " ( player_type ( %s %d ) %n ",
-                      name, &id, &n_read ) != 2
-         || n_read == 0
+    if ( ! cursor.consume( '(' )
+         || ! cursor.consume( "player_type" )
+         || ! cursor.consume( '(' )
+         || ! cursor.skipToken() // "id"
+         || ! cursor.readInt( id )
+         || ! cursor.consume( ')' )
          || id < 0 )
     {
         std::cerr << __FILE__ << ":(PlayerType::parseV8) "
                   << "ERROR: could not read id value " << msg << std::endl;
         return;
     }
-    msg += n_read;
+    cursor.skipSpace();
 
     M_id = id;
 
     int n_param = 0;
-    while ( *msg != '\0' && *msg != ')' )
+    while ( ! cursor.atEnd() && cursor.peek() != ')' )
     {
         double val = 0.0;
-        if ( std::sscanf( msg, " ( %s %lf ) %n ",
-                          name, &val, &n_read ) != 2
-             || n_read == 0 )
+        if ( ! cursor.consume( '(' )
+             || ! cursor.readToken( name, sizeof( name ) )
+             || ! cursor.readDouble( val )
+             || ! cursor.consume( ')' ) )
         {
             std::cerr << __FILE__ << ":(PlayerType::parseV8) "
-                      << " ERROR: illegal parameter format " << msg << std::endl;
+                      << " ERROR: illegal parameter format " << cursor.pos() << std::endl;
             break;
         }
-        msg += n_read;
+        cursor.skipSpace();
 
         if ( ! std::strcmp( name, "player_speed_max" ) )
         {
@@ -1173,6 +1180,7 @@ PlayerTypeSet::instance()
 
 */
 PlayerTypeSet::PlayerTypeSet()
+    : M_reach_step_key( 0 )
 {
     resetDefaultType();
 }
@@ -1194,6 +1202,8 @@ void
 PlayerTypeSet::clear()
 {
     M_player_type_map.clear();
+    std::atomic_store( &M_reach_step_table, std::shared_ptr< const ReachStepTable >() );
+    M_reach_step_key = 0;
     resetDefaultType();
 }
 
@@ -1212,6 +1222,8 @@ PlayerTypeSet::generate( const int seed )
     {
         M_player_type_map.insert( std::make_pair( i, PlayerType( i, delta ) ) );
     }
+
+    createReachStepTable();
 }
 
 /*-------------------------------------------------------------------*/
@@ -1252,6 +1264,7 @@ PlayerTypeSet::insert( const PlayerType & param )
     if ( static_cast< int >( M_player_type_map.size() ) == PlayerParam::i().playerTypes() )
     {
         createDummyType();
+        createReachStepTable();
     }
 }
 
@@ -1279,6 +1292,61 @@ PlayerTypeSet::createDummyType()
     }
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+PlayerTypeSet::createReachStepTable()
+{
+    std::vector< const PlayerType * > types;
+    types.reserve( M_player_type_map.size() + 1 );
+
+    types.push_back( &M_dummy_type );
+    for ( const Map::value_type & v : M_player_type_map )
+    {
+        types.push_back( &v.second );
+    }
+
+    std::sort( types.begin(), types.end(),
+               []( const PlayerType * lhs, const PlayerType * rhs )
+                 {
+                     return lhs->id() < rhs->id();
+                 } );
+
+    //
+    // the parameters used by the dash and stamina simulation of the table.
+    // the same player type message is received by all agents in the process,
+    // and the table is rebuilt only when the parameters are changed.
+    //
+    const ServerParam & SP = ServerParam::i();
+    std::ostringstream os;
+    os.precision( 17 );
+    os << SP.staminaMax() << ' ' << SP.staminaCapacity() << ' '
+       << SP.recoverInit() << ' ' << SP.recoverDecThrValue() << ' '
+       << SP.recoverDec() << ' ' << SP.recoverMin() << ' '
+       << SP.effortDecThrValue() << ' ' << SP.effortDec() << ' '
+       << SP.effortIncThrValue() << ' ' << SP.effortInc() << ' '
+       << SP.minDashPower() << ' ' << SP.maxDashPower() << ' '
+       << SP.backDashRate() << ' ' << SP.sideDashRate() << '\n';
+    for ( const PlayerType * t : types )
+    {
+        t->print( os );
+    }
+
+    const std::size_t key = std::hash< std::string >()( os.str() );
+    if ( key == M_reach_step_key
+         && std::atomic_load( &M_reach_step_table ) )
+    {
+        return;
+    }
+
+    // the agents in other threads may be reading the old table.
+    std::atomic_store( &M_reach_step_table,
+                       std::make_shared< const ReachStepTable >( types ) );
+    M_reach_step_key = key;
+}
+
 /*-------------------------------------------------------------------*/
 /*!
   return pointer to param
@@ -38,11 +38,14 @@
 #include <rcsc/types.h>
 
 #include <unordered_map>
+#include <memory>
 #include <vector>
 #include <iostream>
 
 namespace rcsc {
 
+class ReachStepTable;
+
 /*!
   \class PlayerType
   \brief heterogeneous player parametor class
@@ -788,6 +791,13 @@ private:
     //! dummy player type
     PlayerType M_dummy_type;
 
+    //! reach step table of all player types. created when all types are received.
+    //! replaced and read by std::atomic_store/std::atomic_load.
+    std::shared_ptr< const ReachStepTable > M_reach_step_table;
+
+    //! hash value of the parameters used by M_reach_step_table
+    std::size_t M_reach_step_key;
+
     /*!
       \brief create dummy type. private access for singleton.
      */
@@ -848,6 +858,12 @@ private:
      */
     void createDummyType();
 
+    /*!
+      \brief create the reach step table of the current player types,
+      if the player types or the related server parameters are changed.
+     */
+    void createReachStepTable();
+
 public:
 
     /*!
@@ -864,6 +880,15 @@ public:
           return M_default_type;
       }
 
+    /*!
+      \brief get the reach step table shared by all agents in the process
+      \return shared pointer to the table. NULL until all player types are received.
+     */
+    std::shared_ptr< const ReachStepTable > reachStepTable() const
+      {
+          return std::atomic_load( &M_reach_step_table );
+      }
+
     /*!
       \brief get player type parameter that Id is id
       \param id wanted player type Id
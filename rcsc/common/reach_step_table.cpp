@@ -0,0 +1,259 @@
+// -*-c++-*-
+
+/*!
+  \file reach_step_table.cpp
+  \brief precomputed reach step table for all player types Source File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "reach_step_table.h"
+
+#include "player_type.h"
+#include "server_param.h"
+#include "stamina_model.h"
+
+#include <rcsc/geom/angle_deg.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace rcsc {
+
+const double ReachStepTable::DIST_STEP = 0.5;
+const double ReachStepTable::ANGLE_STEP = 15.0;
+
+namespace {
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief simulate the full power dashes from the standing state
+  \param ptype player type
+  \param stamina initial stamina
+  \param dash_rate dash direction rate
+  \param max_dist the simulation is stopped when the player moves this distance
+  \param result the movable distance of each step. result[n] is the distance after (n+1) dashes.
+ */
+void
+simulate_dashes( const PlayerType & ptype,
+                 const double stamina,
+                 const double dash_rate,
+                 const double max_dist,
+                 std::vector< double > & result )
+{
+    const ServerParam & SP = ServerParam::i();
+
+    StaminaModel stamina_model;
+    stamina_model.init( ptype );
+    stamina_model.setValues( stamina,
+                             ptype.effortMax(),
+                             SP.recoverInit(),
+                             SP.staminaCapacity() );
+
+    double speed = 0.0;
+    double reach_dist = 0.0;
+
+    result.clear();
+
+    while ( static_cast< int >( result.size() ) < ReachStepTable::MAX_STEP - 1
+            && reach_dist < max_dist )
+    {
+        const double dash_power = std::max( 0.0,
+                                            std::min( SP.maxDashPower(),
+                                                      stamina_model.stamina() + ptype.extraStamina() ) );
+        const double accel = dash_power * ptype.dashPowerRate() * stamina_model.effort() * dash_rate;
+
+        speed = std::min( speed + accel, ptype.playerSpeedMax() );
+        reach_dist += speed;
+        result.push_back( reach_dist );
+
+        speed *= ptype.playerDecay();
+        stamina_model.simulateDash( ptype, dash_power );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief get the dash rate without the discretization of the dash direction
+  \param dir dash direction relative to the body [degree]
+  \return dash rate. see ServerParam::dashDirRate().
+ */
+double
+dash_dir_rate( const double dir )
+{
+    const ServerParam & SP = ServerParam::i();
+    const double d = std::fabs( dir );
+    const double r = ( d > 90.0
+                       ? SP.backDashRate() - ( ( SP.backDashRate() - SP.sideDashRate() )
+                                               * ( 1.0 - ( d - 90.0 ) / 90.0 ) )
+                       : SP.sideDashRate() + ( ( 1.0 - SP.sideDashRate() )
+                                               * ( 1.0 - d / 90.0 ) ) );
+    return std::min( std::max( 1.0e-5, r ), 1.0 );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief get the maximum acceleration rate to the target direction
+  \param min_angle the lower bound of the angle between the body and the target [degree]
+  \return the maximum acceleration rate without turn
+
+  Several dashes to the different directions can be combined, but the
+  acceleration to the target direction never exceeds
+  max( dash_dir_rate( dir ) * cos( dir - angle ) ).
+ */
+double
+get_max_accel_rate( const double min_angle )
+{
+    double result = 0.0;
+    for ( double angle = min_angle; angle <= 180.0 + 1.0e-9; angle += 1.0 )
+    {
+        for ( int dir = -180; dir <= 180; ++dir )
+        {
+            result = std::max( result,
+                               dash_dir_rate( dir ) * std::cos( ( dir - angle ) * AngleDeg::DEG2RAD ) );
+        }
+    }
+
+    // margin for the sampling error
+    return std::min( 1.0, result + 0.01 );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief get the number of dashes to move the distance
+  \param movable the result of simulate_dashes()
+  \param dist move distance
+  \return the number of dashes. MAX_STEP if the player cannot reach.
+ */
+int
+get_dash_step( const std::vector< double > & movable,
+               const double dist )
+{
+    if ( dist <= 1.0e-3 )
+    {
+        return 0;
+    }
+
+    std::vector< double >::const_iterator it = std::lower_bound( movable.begin(),
+                                                                 movable.end(),
+                                                                 dist - 1.0e-3 );
+    if ( it == movable.end() )
+    {
+        return ReachStepTable::MAX_STEP;
+    }
+
+    return static_cast< int >( it - movable.begin() ) + 1;
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+ReachStepTable::ReachStepTable( const std::vector< const PlayerType * > & types )
+    : M_stamina_step( ServerParam::i().staminaMax() / ( STAMINA_SIZE - 1 ) )
+{
+    int max_id = -1;
+    for ( const PlayerType * t : types )
+    {
+        max_id = std::max( max_id, t->id() );
+    }
+
+    M_accel_rates.resize( ANGLE_SIZE );
+    for ( int a = 0; a < ANGLE_SIZE; ++a )
+    {
+        M_accel_rates[a] = get_max_accel_rate( a * ANGLE_STEP );
+    }
+
+    M_type_index.assign( max_id + 2, -1 );
+    M_steps.resize( types.size() * TYPE_SIZE );
+
+    int index = 0;
+    for ( const PlayerType * t : types )
+    {
+        if ( t->id() + 1 < 0
+             || M_type_index[t->id() + 1] >= 0 )
+        {
+            continue;
+        }
+
+        M_type_index[t->id() + 1] = index;
+        createTypeBlock( *t, M_steps.data() + index * TYPE_SIZE );
+        ++index;
+    }
+
+    M_steps.resize( index * TYPE_SIZE );
+    M_steps.shrink_to_fit();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+ReachStepTable::createTypeBlock( const PlayerType & ptype,
+                                 std::uint8_t * steps ) const
+{
+    const double max_dist = ( DIST_SIZE - 1 ) * DIST_STEP;
+
+    std::vector< double > forward;
+    std::vector< double > omni;
+    forward.reserve( MAX_STEP );
+    omni.reserve( MAX_STEP );
+
+    for ( int s = 0; s < STAMINA_SIZE; ++s )
+    {
+        simulate_dashes( ptype, M_stamina_step * s, 1.0, max_dist, forward );
+
+        for ( int a = 0; a < ANGLE_SIZE; ++a )
+        {
+            if ( a > 0 )
+            {
+                simulate_dashes( ptype, M_stamina_step * s, M_accel_rates[a], max_dist, omni );
+            }
+
+            std::uint8_t * block = steps + ( s * ANGLE_SIZE + a ) * DIST_SIZE;
+            for ( int d = 0; d < DIST_SIZE; ++d )
+            {
+                const double dist = d * DIST_STEP;
+                int step = get_dash_step( forward, dist );
+                if ( a > 0
+                     && step > 0 )
+                {
+                    // one turn is enough for the standing player.
+                    step = std::min( step + 1, get_dash_step( omni, dist ) );
+                }
+                block[d] = static_cast< std::uint8_t >( std::min( step, int( MAX_STEP ) ) );
+            }
+        }
+    }
+}
+
+}
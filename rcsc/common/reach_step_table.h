@@ -0,0 +1,173 @@
+// -*-c++-*-
+
+/*!
+  \file reach_step_table.h
+  \brief precomputed reach step table for all player types Header File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_COMMON_REACH_STEP_TABLE_H
+#define RCSC_COMMON_REACH_STEP_TABLE_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace rcsc {
+
+class PlayerType;
+
+/*!
+  \class ReachStepTable
+  \brief read only table of the minimal reach steps for all player types.
+
+  Each entry is the lower bound of the number of cycles for a standing
+  player to move the given distance, when the angle between the body
+  direction and the target direction is at least the given angle, and the
+  stamina is at most the given value. The player may turn once and dash
+  forward, or dash to any directions without turning. The effort and the
+  recovery are assumed to be maximal.
+
+  The entries of all types are stored in one contiguous block in the order
+  of [type][stamina][angle][distance]. The table is created by PlayerTypeSet
+  when all player types are received, and it is shared by all agents in the
+  same process.
+*/
+class ReachStepTable {
+public:
+
+    //! distance resolution
+    static const double DIST_STEP;
+    //! the number of distance entries
+    static const int DIST_SIZE = 121;
+    //! angle resolution [degree]
+    static const double ANGLE_STEP;
+    //! the number of angle entries
+    static const int ANGLE_SIZE = 13;
+    //! the number of stamina entries
+    static const int STAMINA_SIZE = 9;
+    //! the maximum step value. the real step may be greater than this value.
+    static const int MAX_STEP = 255;
+
+private:
+
+    //! the number of entries for each player type
+    static const std::size_t TYPE_SIZE = std::size_t( STAMINA_SIZE ) * ANGLE_SIZE * DIST_SIZE;
+
+    //! the stamina resolution
+    double M_stamina_step;
+
+    //! the maximum acceleration rate without turn for each angle entry
+    std::vector< double > M_accel_rates;
+
+    //! the index of the type block. key: type id + 1, value: block index or -1
+    std::vector< int > M_type_index;
+
+    //! all entries
+    std::vector< std::uint8_t > M_steps;
+
+    // not used
+    ReachStepTable( const ReachStepTable & ) = delete;
+    ReachStepTable & operator=( const ReachStepTable & ) = delete;
+
+public:
+
+    /*!
+      \brief create the table for the given player types
+      \param types player types. Hetero_Unknown is also allowed.
+     */
+    explicit
+    ReachStepTable( const std::vector< const PlayerType * > & types );
+
+    /*!
+      \brief check if the table of the player type exists
+      \param type_id player type id
+      \return true if the table exists
+     */
+    bool hasType( const int type_id ) const
+      {
+          return 0 <= type_id + 1
+              && type_id + 1 < static_cast< int >( M_type_index.size() )
+              && M_type_index[type_id + 1] >= 0;
+      }
+
+    /*!
+      \brief get the lower bound of the reach step
+      \param type_id player type id
+      \param dist move distance
+      \param angle the lower bound of the angle difference between the body and the target [degree]
+      \param stamina the upper bound of the stamina
+      \return the lower bound of the reach step. 0 if the type is not registered.
+     */
+    int minStep( const int type_id,
+                 const double dist,
+                 const double angle,
+                 const double stamina ) const
+      {
+          if ( ! hasType( type_id ) )
+          {
+              return 0;
+          }
+
+          const int d = ( dist <= 0.0 ? 0
+                          : dist >= ( DIST_SIZE - 1 ) * DIST_STEP ? DIST_SIZE - 1
+                          : static_cast< int >( dist / DIST_STEP ) );
+          const int a = ( angle <= 0.0 ? 0
+                          : angle >= ( ANGLE_SIZE - 1 ) * ANGLE_STEP ? ANGLE_SIZE - 1
+                          : static_cast< int >( angle / ANGLE_STEP ) );
+          const double s_rate = stamina / M_stamina_step;
+          const int s = ( s_rate <= 0.0 ? 0
+                          : s_rate >= STAMINA_SIZE - 1 ? STAMINA_SIZE - 1
+                          : static_cast< int >( s_rate + ( 1.0 - 1.0e-9 ) ) );
+
+          return M_steps[M_type_index[type_id + 1] * TYPE_SIZE
+                         + ( std::size_t( s ) * ANGLE_SIZE + a ) * DIST_SIZE
+                         + d];
+      }
+
+    /*!
+      \brief get the size of the table
+      \return the number of bytes used by the entries
+     */
+    std::size_t byteSize() const
+      {
+          return M_steps.size();
+      }
+
+private:
+
+    /*!
+      \brief create the entries of the player type
+      \param ptype player type
+      \param steps pointer to the first entry of the type block
+     */
+    void createTypeBlock( const PlayerType & ptype,
+                          std::uint8_t * steps ) const;
+};
+
+}
+
+#endif
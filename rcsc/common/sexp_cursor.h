@@ -0,0 +1,293 @@
+// -*-c++-*-
+
+/*!
+  \file sexp_cursor.h
+  \brief locale independent cursor on the server message Header File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_COMMON_SEXP_CURSOR_H
+#define RCSC_COMMON_SEXP_CURSOR_H
+
+#include <charconv>
+#include <cstring>
+#include <cstddef>
+
+namespace rcsc {
+
+/*!
+  \class SExpCursor
+  \brief read only cursor on the S-expression message from rcssserver.
+
+  The numbers are converted by std::from_chars. Unlike strtod() and
+  sscanf(), the result never depends on the current locale and no memory is
+  allocated. All read methods skip the leading white spaces. If a read method
+  fails, the cursor position and the destination variable are not changed.
+*/
+class SExpCursor {
+private:
+    const char * M_pos; //!< current position
+    const char * M_end; //!< end of the message
+
+public:
+
+    /*!
+      \brief construct with the range of the message
+      \param begin the first character
+      \param end the position after the last character
+     */
+    SExpCursor( const char * begin,
+                const char * end )
+        : M_pos( begin ),
+          M_end( end )
+      { }
+
+    /*!
+      \brief construct with the null terminated message
+      \param str message string
+     */
+    explicit
+    SExpCursor( const char * str )
+        : M_pos( str ),
+          M_end( str + std::strlen( str ) )
+      { }
+
+    /*!
+      \brief get the current position
+      \return pointer to the current character
+     */
+    const char * pos() const
+      {
+          return M_pos;
+      }
+
+    /*!
+      \brief get the end of the message
+      \return pointer to the position after the last character
+     */
+    const char * end() const
+      {
+          return M_end;
+      }
+
+    /*!
+      \brief check if the cursor reaches the end of the message
+      \return true if no character remains
+     */
+    bool atEnd() const
+      {
+          return M_pos >= M_end;
+      }
+
+    /*!
+      \brief get the current character without moving
+      \return the current character, or '\\0' at the end
+     */
+    char peek() const
+      {
+          return M_pos < M_end ? *M_pos : '\0';
+      }
+
+    /*!
+      \brief skip white spaces
+     */
+    void skipSpace()
+      {
+          while ( M_pos < M_end
+                  && ( *M_pos == ' ' || *M_pos == '\t' || *M_pos == '\r' || *M_pos == '\n' ) )
+          {
+              ++M_pos;
+          }
+      }
+
+    /*!
+      \brief move the cursor to the next specified character. the character is not skipped.
+      \param c target character
+      \return true if the character is found
+     */
+    bool skipTo( const char c )
+      {
+          while ( M_pos < M_end && *M_pos != c ) ++M_pos;
+          return M_pos < M_end;
+      }
+
+    /*!
+      \brief skip white spaces and one token delimited by white spaces or parentheses
+      \return true if at least one character is skipped
+     */
+    bool skipToken()
+      {
+          skipSpace();
+          const char * start = M_pos;
+          while ( M_pos < M_end
+                  && ! isDelimiter( *M_pos ) )
+          {
+              ++M_pos;
+          }
+          return M_pos != start;
+      }
+
+    /*!
+      \brief skip white spaces and the specified character.
+      \param c expected character
+      \return true if the character is skipped.
+     */
+    bool consume( const char c )
+      {
+          skipSpace();
+          if ( M_pos < M_end && *M_pos == c )
+          {
+              ++M_pos;
+              return true;
+          }
+          return false;
+      }
+
+    /*!
+      \brief skip white spaces and the specified keyword.
+      \param str expected keyword. the keyword itself may contain white spaces.
+      \return true if the keyword is skipped.
+     */
+    bool consume( const char * str )
+      {
+          skipSpace();
+          const std::size_t len = std::strlen( str );
+          if ( static_cast< std::size_t >( M_end - M_pos ) >= len
+               && ! std::memcmp( M_pos, str, len ) )
+          {
+              M_pos += len;
+              return true;
+          }
+          return false;
+      }
+
+    /*!
+      \brief read one token delimited by white spaces or parentheses
+      \param begin variable to store the first character of the token
+      \param len variable to store the length of the token
+      \return true if the token is not empty
+     */
+    bool readToken( const char ** begin,
+                    std::size_t * len )
+      {
+          skipSpace();
+          const char * start = M_pos;
+          while ( M_pos < M_end
+                  && ! isDelimiter( *M_pos ) )
+          {
+              ++M_pos;
+          }
+          *begin = start;
+          *len = static_cast< std::size_t >( M_pos - start );
+          return M_pos != start;
+      }
+
+    /*!
+      \brief read one token delimited by white spaces or parentheses
+      \param buf destination buffer. the result is null terminated and truncated to the buffer size.
+      \param size size of the destination buffer.
+      \return true if the token is not empty
+     */
+    bool readToken( char * buf,
+                    const std::size_t size )
+      {
+          const char * begin = nullptr;
+          std::size_t len = 0;
+          if ( ! readToken( &begin, &len ) )
+          {
+              buf[0] = '\0';
+              return false;
+          }
+          if ( len >= size ) len = size - 1;
+          std::memcpy( buf, begin, len );
+          buf[len] = '\0';
+          return true;
+      }
+
+    /*!
+      \brief read the integer value
+      \param val variable to store the result
+      \return true if the value is read
+     */
+    template < typename T >
+    bool readInt( T & val )
+      {
+          skipSpace();
+          const char * first = skipPlus();
+          std::from_chars_result r = std::from_chars( first, M_end, val );
+          if ( r.ec != std::errc() )
+          {
+              return false;
+          }
+          M_pos = r.ptr;
+          return true;
+      }
+
+    /*!
+      \brief read the floating point value
+      \param val variable to store the result
+      \return true if the value is read
+     */
+    bool readDouble( double & val )
+      {
+          skipSpace();
+          const char * first = skipPlus();
+          std::from_chars_result r = std::from_chars( first, M_end, val );
+          if ( r.ec != std::errc() )
+          {
+              return false;
+          }
+          M_pos = r.ptr;
+          return true;
+      }
+
+private:
+
+    /*!
+      \brief check if the character is a token delimiter
+     */
+    static
+    bool isDelimiter( const char c )
+      {
+          return c == ' ' || c == '(' || c == ')'
+              || c == '\t' || c == '\r' || c == '\n' || c == '\0';
+      }
+
+    /*!
+      \brief get the first character of the number. the plus sign accepted by strtod() is skipped.
+     */
+    const char * skipPlus() const
+      {
+          return ( M_pos < M_end && *M_pos == '+'
+                   && M_pos + 1 < M_end && *( M_pos + 1 ) != '-' )
+              ? M_pos + 1
+              : M_pos;
+      }
+};
+
+}
+
+#endif
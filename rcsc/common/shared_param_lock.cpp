@@ -0,0 +1,135 @@
+// -*-c++-*-
+
+/*!
+  \file shared_param_lock.cpp
+  \brief lock for the process wide parameter instances Source File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "shared_param_lock.h"
+
+#include "player_param.h"
+
+#include <unordered_set>
+#include <string>
+#include <cstring>
+
+namespace rcsc {
+
+namespace {
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief get the mutex for the shared parameters
+  \return reference to the mutex instance
+ */
+std::mutex &
+param_mutex()
+{
+    static std::mutex s_mutex;
+    return s_mutex;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief get the set of the analyzed parameter messages
+  \return reference to the set instance
+ */
+std::unordered_set< std::string > &
+received_messages()
+{
+    static std::unordered_set< std::string > s_messages;
+    return s_messages;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \struct ReceivedCount
+  \brief the number of the analyzed parameter messages of each type
+ */
+struct ReceivedCount {
+    int server_param_;
+    int player_param_;
+    int player_type_;
+};
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief get the number of the analyzed parameter messages
+  \return reference to the counter instance
+ */
+ReceivedCount &
+received_count()
+{
+    static ReceivedCount s_count = { 0, 0, 0 };
+    return s_count;
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+SharedParamLock::SharedParamLock( const char * msg )
+    : M_lock( param_mutex() ),
+      M_new_message( true )
+{
+    if ( msg )
+    {
+        M_new_message = received_messages().insert( msg ).second;
+
+        if ( M_new_message )
+        {
+            ReceivedCount & count = received_count();
+            if ( ! std::strncmp( msg, "(server_param", 13 ) ) ++count.server_param_;
+            else if ( ! std::strncmp( msg, "(player_param", 13 ) ) ++count.player_param_;
+            else if ( ! std::strncmp( msg, "(player_type", 12 ) ) ++count.player_type_;
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+SharedParamLock::isAllReceived()
+{
+    std::lock_guard< std::mutex > lock( param_mutex() );
+
+    const ReceivedCount & count = received_count();
+    return ( count.server_param_ > 0
+             && count.player_param_ > 0
+             && count.player_type_ >= PlayerParam::i().playerTypes() );
+}
+
+}
@@ -0,0 +1,90 @@
+// -*-c++-*-
+
+/*!
+  \file shared_param_lock.h
+  \brief lock for the process wide parameter instances Header File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+
+#ifndef RCSC_COMMON_SHARED_PARAM_LOCK_H
+#define RCSC_COMMON_SHARED_PARAM_LOCK_H
+
+#include <mutex>
+
+namespace rcsc {
+
+/*!
+  \class SharedParamLock
+  \brief scoped lock for ServerParam, PlayerParam and PlayerTypeSet.
+
+  These instances are shared by all agents in the process. When several
+  agents run in one process, every agent receives the same parameter
+  messages. The first message is analyzed under this lock, and the
+  identical messages received later are ignored.
+*/
+class SharedParamLock {
+private:
+
+    //! lock of the shared mutex
+    std::lock_guard< std::mutex > M_lock;
+
+    //! true if the message has not been received yet
+    bool M_new_message;
+
+    // not used
+    SharedParamLock( const SharedParamLock & ) = delete;
+    SharedParamLock & operator=( const SharedParamLock & ) = delete;
+
+public:
+
+    /*!
+      \brief lock the shared parameters and register the message.
+      \param msg received parameter message. if NULL, the message is not checked.
+     */
+    explicit
+    SharedParamLock( const char * msg = nullptr );
+
+    /*!
+      \brief check if the message has to be analyzed.
+      \return true if the message has not been received yet.
+     */
+    bool isNewMessage() const
+      {
+          return M_new_message;
+      }
+
+    /*!
+      \brief check if all the shared parameters have been analyzed.
+      \return true if server_param, player_param and all player_type messages have been received.
+     */
+    static
+    bool isAllReceived();
+};
+
+}
+
+#endif
@@ -36,7 +36,6 @@
 #include "angle_deg.h"
 
 #include <algorithm>
-#include <vector>
 
 #ifndef M_PI
 //! PI value macro
@@ -103,28 +102,28 @@ AngleDeg::sinMinMax( const double angle_err,
     double mindir = this->degree() - angle_err;
     double maxdir = this->degree() + angle_err;
 
-    std::vector< double > sol;
-    sol.reserve( 4 );
+    double sol[4];
+    int n = 0;
 
     if ( ( mindir < -90.0 && -90.0 < maxdir )
          || ( mindir < 270.0 && 270.0 < maxdir )
          )
     {
-        sol.push_back( -1.0 );
+        sol[n++] = -1.0;
     }
 
     if ( ( mindir < 90.0 && 90.0 < maxdir )
          || ( mindir < -270.0 && -270.0 < maxdir )
          )
     {
-        sol.push_back( 1.0 );
+        sol[n++] = 1.0;
     }
 
-    sol.push_back( AngleDeg::sin_deg( mindir ) );
-    sol.push_back( AngleDeg::sin_deg( maxdir ) );
+    sol[n++] = AngleDeg::sin_deg( mindir );
+    sol[n++] = AngleDeg::sin_deg( maxdir );
 
-    *minsin = *std::min_element( sol.begin(), sol.end() );
-    *maxsin = *std::max_element( sol.begin(), sol.end() );
+    *minsin = *std::min_element( sol, sol + n );
+    *maxsin = *std::max_element( sol, sol + n );
 }
 
 /*-------------------------------------------------------------------*/
@@ -148,24 +147,24 @@ AngleDeg::cosMinMax( const double angle_err,
     double mindir = this->degree() - angle_err;
     double maxdir = this->degree() + angle_err;
 
-    std::vector< double > sol;
-    sol.reserve( 4 );
+    double sol[4];
+    int n = 0;
 
     if ( mindir < -180.0 && -180.0 < maxdir )
     {
-        sol.push_back( -1.0 );
+        sol[n++] = -1.0;
     }
 
     if ( mindir < 0.0 && 0.0 < maxdir )
     {
-        sol.push_back( 1.0 );
+        sol[n++] = 1.0;
     }
 
-    sol.push_back( AngleDeg::cos_deg( mindir ) );
-    sol.push_back( AngleDeg::cos_deg( maxdir ) );
+    sol[n++] = AngleDeg::cos_deg( mindir );
+    sol[n++] = AngleDeg::cos_deg( maxdir );
 
-    *mincos = *std::min_element( sol.begin(), sol.end() );
-    *maxcos = *std::max_element( sol.begin(), sol.end() );
+    *mincos = *std::min_element( sol, sol + n );
+    *maxcos = *std::max_element( sol, sol + n );
 }
 
 
@@ -0,0 +1,546 @@
+// -*-c++-*-
+
+/*!
+  \file gzpipestream.cpp
+  \brief pipelined gzip file input stream Source File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "gzpipestream.h"
+
+#ifdef HAVE_LIBZ
+#include <zlib.h>
+#else
+#include <cstdio>
+#endif
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rcsc {
+
+const std::size_t gzpipebuf::DEFAULT_BLOCK_SIZE = 256 * 1024;
+const std::size_t gzpipebuf::DEFAULT_BLOCK_COUNT = 4;
+
+/*!
+  \brief implementation of gzpipebuf
+
+  The blocks are used as a ring. The consumer owns blocks_[read_index_]
+  while holding_ is true. The producer fills the blocks from
+  (read_index_ + filled_) while filled_ < blocks_.size(). All indices and
+  counters are guarded by mutex_, but the block data are not, because the
+  producer and the consumer never touch the same block at the same time.
+ */
+struct gzpipebuf::Impl {
+
+    /*!
+      \brief decompressed data block
+     */
+    struct Block {
+        std::vector< char > data_; //!< data buffer
+        std::size_t size_; //!< the number of valid bytes
+        std::streamoff offset_; //!< position of the first byte in the decompressed stream
+
+        Block()
+            : size_( 0 ),
+              offset_( 0 )
+          { }
+    };
+
+#ifdef HAVE_LIBZ
+    gzFile file_; //!< zlib file handler
+#else
+    std::FILE * file_; //!< file handler
+#endif
+
+    std::vector< Block > blocks_; //!< ring of blocks
+
+    std::thread thread_; //!< background decompression thread
+    std::mutex mutex_; //!< guard of the following variables
+    std::condition_variable cond_; //!< signaled when a block is filled or released
+
+    std::size_t read_index_; //!< index of the block held or to be held next by the consumer
+    std::size_t filled_; //!< the number of filled blocks from read_index_
+    bool holding_; //!< true if the consumer holds blocks_[read_index_]
+    bool finished_; //!< true if the producer reached EOF or error
+    bool stop_; //!< request to stop the producer
+
+    std::streamoff position_; //!< stream position after the last released block
+
+    Impl()
+        : file_( nullptr ),
+          read_index_( 0 ),
+          filled_( 0 ),
+          holding_( false ),
+          finished_( false ),
+          stop_( false ),
+          position_( 0 )
+      { }
+
+    bool openFile( const char * path )
+      {
+#ifdef HAVE_LIBZ
+          file_ = gzopen( path, "rb" );
+          if ( file_ )
+          {
+              gzbuffer( file_, 128 * 1024 );
+          }
+#else
+          file_ = std::fopen( path, "rb" );
+#endif
+          return file_ != nullptr;
+      }
+
+    void closeFile()
+      {
+          if ( file_ )
+          {
+#ifdef HAVE_LIBZ
+              gzclose( file_ );
+#else
+              std::fclose( file_ );
+#endif
+              file_ = nullptr;
+          }
+      }
+
+    bool rewindFile()
+      {
+#ifdef HAVE_LIBZ
+          return gzrewind( file_ ) == 0;
+#else
+          return std::fseek( file_, 0, SEEK_SET ) == 0;
+#endif
+      }
+
+    long readFile( char * buf,
+                   const std::size_t len )
+      {
+#ifdef HAVE_LIBZ
+          return gzread( file_, buf, static_cast< unsigned int >( len ) );
+#else
+          std::size_t n = std::fread( buf, 1, len, file_ );
+          return ( n == 0 && std::ferror( file_ ) ? -1 : static_cast< long >( n ) );
+#endif
+      }
+
+    void start()
+      {
+          read_index_ = 0;
+          filled_ = 0;
+          holding_ = false;
+          finished_ = false;
+          stop_ = false;
+          position_ = 0;
+
+          thread_ = std::thread( &Impl::produce, this );
+      }
+
+    void stop()
+      {
+          if ( thread_.joinable() )
+          {
+              {
+                  std::lock_guard< std::mutex > lock( mutex_ );
+                  stop_ = true;
+              }
+              cond_.notify_all();
+              thread_.join();
+          }
+      }
+
+    void produce()
+      {
+          const std::size_t n_blocks = blocks_.size();
+          std::streamoff offset = 0;
+
+          while ( true )
+          {
+              std::size_t index = 0;
+              {
+                  std::unique_lock< std::mutex > lock( mutex_ );
+                  cond_.wait( lock, [this, n_blocks]() { return stop_ || filled_ < n_blocks; } );
+                  if ( stop_ )
+                  {
+                      return;
+                  }
+                  index = ( read_index_ + filled_ ) % n_blocks;
+              }
+
+              // this block is not visible to the consumer until filled_ is incremented.
+              Block & block = blocks_[index];
+              const long n = readFile( block.data_.data(), block.data_.size() );
+
+              {
+                  std::lock_guard< std::mutex > lock( mutex_ );
+                  if ( n > 0 )
+                  {
+                      block.size_ = static_cast< std::size_t >( n );
+                      block.offset_ = offset;
+                      offset += n;
+                      ++filled_;
+                  }
+                  else
+                  {
+                      finished_ = true;
+                  }
+              }
+              cond_.notify_all();
+
+              if ( n <= 0 )
+              {
+                  return;
+              }
+          }
+      }
+};
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+gzpipebuf::gzpipebuf()
+    : std::streambuf(),
+      M_impl( new Impl() )
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+gzpipebuf::~gzpipebuf()
+{
+    close();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+gzpipebuf::is_open() const
+{
+    return M_impl->file_ != nullptr;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+gzpipebuf *
+gzpipebuf::open( const char * path,
+                 const std::size_t block_size,
+                 const std::size_t block_count )
+{
+    if ( is_open()
+         || ! M_impl->openFile( path ) )
+    {
+        return nullptr;
+    }
+
+    M_impl->blocks_.clear();
+    M_impl->blocks_.resize( std::max< std::size_t >( 2, block_count ) );
+    for ( Impl::Block & b : M_impl->blocks_ )
+    {
+        b.data_.resize( std::max< std::size_t >( 4096, block_size ) );
+    }
+
+    this->setg( nullptr, nullptr, nullptr );
+    M_impl->start();
+
+    return this;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+gzpipebuf *
+gzpipebuf::close()
+{
+    if ( ! is_open() )
+    {
+        return nullptr;
+    }
+
+    M_impl->stop();
+    M_impl->closeFile();
+    M_impl->blocks_.clear();
+
+    this->setg( nullptr, nullptr, nullptr );
+
+    return this;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+gzpipebuf::releaseBlock()
+{
+    Impl & impl = *M_impl;
+
+    {
+        std::lock_guard< std::mutex > lock( impl.mutex_ );
+        if ( ! impl.holding_ )
+        {
+            return;
+        }
+
+        const Impl::Block & block = impl.blocks_[impl.read_index_];
+        impl.position_ = block.offset_ + static_cast< std::streamoff >( block.size_ );
+        impl.read_index_ = ( impl.read_index_ + 1 ) % impl.blocks_.size();
+        --impl.filled_;
+        impl.holding_ = false;
+    }
+    impl.cond_.notify_all();
+
+    this->setg( nullptr, nullptr, nullptr );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+gzpipebuf::restart()
+{
+    M_impl->stop();
+    M_impl->rewindFile();
+    this->setg( nullptr, nullptr, nullptr );
+    M_impl->start();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+std::streambuf::int_type
+gzpipebuf::underflow()
+{
+    if ( this->gptr() && this->gptr() < this->egptr() )
+    {
+        return traits_type::to_int_type( *this->gptr() );
+    }
+
+    if ( ! is_open() )
+    {
+        return traits_type::eof();
+    }
+
+    releaseBlock();
+
+    Impl & impl = *M_impl;
+    std::unique_lock< std::mutex > lock( impl.mutex_ );
+    impl.cond_.wait( lock, [&impl]() { return impl.filled_ > 0 || impl.finished_; } );
+
+    if ( impl.filled_ == 0 )
+    {
+        return traits_type::eof();
+    }
+
+    impl.holding_ = true;
+    Impl::Block & block = impl.blocks_[impl.read_index_];
+    lock.unlock();
+
+    this->setg( block.data_.data(), block.data_.data(), block.data_.data() + block.size_ );
+
+    return traits_type::to_int_type( *this->gptr() );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+std::streampos
+gzpipebuf::seekoff( std::streamoff off,
+                    std::ios_base::seekdir way,
+                    std::ios_base::openmode mode )
+{
+    if ( ! is_open()
+         || ! ( mode & std::ios_base::in ) )
+    {
+        return -1;
+    }
+
+    std::streamoff current = M_impl->position_;
+    if ( M_impl->holding_ )
+    {
+        current = M_impl->blocks_[M_impl->read_index_].offset_ + ( this->gptr() - this->eback() );
+    }
+
+    if ( way == std::ios_base::beg )
+    {
+        return seekpos( std::streampos( off ), mode );
+    }
+
+    if ( way == std::ios_base::cur )
+    {
+        if ( off == 0 )
+        {
+            return std::streampos( current );
+        }
+        return seekpos( std::streampos( current + off ), mode );
+    }
+
+    // zlib does not support seeking from 'end'.
+    return -1;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+std::streampos
+gzpipebuf::seekpos( std::streampos pos,
+                    std::ios_base::openmode mode )
+{
+    const std::streamoff target = pos;
+
+    if ( ! is_open()
+         || ! ( mode & std::ios_base::in )
+         || target < 0 )
+    {
+        return -1;
+    }
+
+    // seek in the current block
+    if ( M_impl->holding_ )
+    {
+        const Impl::Block & block = M_impl->blocks_[M_impl->read_index_];
+        if ( block.offset_ <= target
+             && target <= block.offset_ + static_cast< std::streamoff >( block.size_ ) )
+        {
+            this->setg( this->eback(), this->eback() + ( target - block.offset_ ), this->egptr() );
+            return pos;
+        }
+    }
+
+    std::streamoff current = M_impl->position_;
+    if ( M_impl->holding_ )
+    {
+        current = M_impl->blocks_[M_impl->read_index_].offset_ + ( this->gptr() - this->eback() );
+    }
+
+    if ( target < current )
+    {
+        restart();
+        current = 0;
+    }
+
+    // skip forward
+    while ( current < target )
+    {
+        if ( this->gptr() == this->egptr()
+             && traits_type::eq_int_type( underflow(), traits_type::eof() ) )
+        {
+            return -1;
+        }
+
+        const std::streamoff n = std::min< std::streamoff >( target - current, this->egptr() - this->gptr() );
+        this->gbump( static_cast< int >( n ) );
+        current += n;
+    }
+
+    return pos;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+std::streamsize
+gzpipebuf::showmanyc()
+{
+    return ( this->gptr() ? std::streamsize( this->egptr() - this->gptr() ) : 0 );
+}
+
+///////////////////////////////////////////////////////////////////////
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+gzpipeifstream::gzpipeifstream()
+    : std::istream( nullptr ),
+      M_file_buf()
+{
+    this->init( &M_file_buf );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+gzpipeifstream::gzpipeifstream( const char * path )
+    : std::istream( nullptr ),
+      M_file_buf()
+{
+    this->init( &M_file_buf );
+    this->open( path );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+gzpipeifstream::open( const char * path )
+{
+    if ( ! M_file_buf.open( path ) )
+    {
+        this->setstate( std::ios_base::failbit );
+    }
+    else
+    {
+        this->clear();
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+gzpipeifstream::close()
+{
+    if ( ! M_file_buf.close() )
+    {
+        this->setstate( std::ios_base::failbit );
+    }
+}
+
+}
@@ -0,0 +1,217 @@
+// -*-c++-*-
+
+/*!
+  \file gzpipestream.h
+  \brief pipelined gzip file input stream Header File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_GZ_GZPIPESTREAM_H
+#define RCSC_GZ_GZPIPESTREAM_H
+
+#include <memory>
+#include <iostream>
+#include <cstddef>
+
+namespace rcsc {
+
+/*!
+  \class gzpipebuf
+  \brief read only gzip file stream buffer that inflates on a background thread.
+
+  A background thread decompresses the file into a ring of fixed size
+  blocks, and underflow() hands the finished blocks to the reader. The
+  reader and zlib run in parallel, and they only synchronize when a block
+  is exchanged. Uncompressed files are also readable.
+
+  Seeking to any position in the current block is cheap. Seeking backward
+  beyond the current block restarts the decompression from the beginning
+  of the file.
+*/
+class gzpipebuf
+    : public std::streambuf {
+public:
+
+    //! default block size in bytes
+    static const std::size_t DEFAULT_BLOCK_SIZE;
+    //! default number of blocks in the ring
+    static const std::size_t DEFAULT_BLOCK_COUNT;
+
+private:
+
+    //! Pimpl ideom
+    struct Impl;
+    //! Pimpl ideom. the instance of the reader state.
+    std::unique_ptr< Impl > M_impl;
+
+    //! not used
+    gzpipebuf( const gzpipebuf & ) = delete;
+    //! not used
+    gzpipebuf & operator=( const gzpipebuf & ) = delete;
+
+public:
+
+    /*!
+      \brief default constructor.
+     */
+    gzpipebuf();
+
+    /*!
+      \brief destructor. stop the background thread and close the file.
+     */
+    virtual
+    ~gzpipebuf();
+
+    /*!
+      \brief check if file is open.
+      \return returns true if file is opened, else false.
+     */
+    bool is_open() const;
+
+    /*!
+      \brief open the file and start the background thread.
+      \param path file path
+      \param block_size size of each block in bytes
+      \param block_count the number of blocks in the ring (at least 2)
+      \return this pointer if successfully opened, else NULL.
+     */
+    gzpipebuf * open( const char * path,
+                      const std::size_t block_size = DEFAULT_BLOCK_SIZE,
+                      const std::size_t block_count = DEFAULT_BLOCK_COUNT );
+
+    /*!
+      \brief stop the background thread and close the file.
+      \return this pointer if the file was opened, else NULL.
+    */
+    gzpipebuf * close();
+
+protected:
+
+    /*!
+      \brief overrided method. wait for the next decompressed block.
+      \return current character. in the case of EOF or error, returned EOF.
+     */
+    virtual
+    std::streambuf::int_type underflow() override;
+
+    /*!
+      \brief overrided method. set relative position of the read pointer.
+      \param off offset to move. This is decompressed data size.
+      \param way ios_base::beg or ios_base::cur. ios_base::end is not supported.
+      \param mode IO mode
+      \return new position. in case of error, returned -1.
+    */
+    virtual
+    std::streampos seekoff( std::streamoff off,
+                            std::ios_base::seekdir way,
+                            std::ios_base::openmode mode ) override;
+
+    /*!
+      \brief overrided method. set absolute position of the read pointer.
+      \param pos new position
+      \param mode IO mode
+      \return new position. in case of error, returned -1.
+    */
+    virtual
+    std::streampos seekpos( std::streampos pos,
+                            std::ios_base::openmode mode ) override;
+
+    /*!
+      \brief overrided method.
+      \return number of characters remaining in the current block
+     */
+    virtual
+    std::streamsize showmanyc() override;
+
+private:
+
+    void releaseBlock();
+    void restart();
+};
+
+/*-------------------------------------------------------------------*/
+/*!
+  \class gzpipeifstream
+  \brief gzipped file input stream class with the background decompression.
+
+  This class can be used in place of gzifstream.
+*/
+class gzpipeifstream
+    : public std::istream {
+private:
+    //! underlying stream buffer.
+    gzpipebuf M_file_buf;
+
+public:
+    /*!
+      \brief default constructor
+    */
+    gzpipeifstream();
+
+    /*!
+      \brief init stream buffer and open file.
+      \param path file path to be opened.
+     */
+    explicit
+    gzpipeifstream( const char * path );
+
+    /*!
+      \brief get underlying stream buffer.
+      \return pointer to the file buffer
+     */
+    gzpipebuf * rdbuf() const
+      {
+          return const_cast< gzpipebuf * >( &M_file_buf );
+      }
+
+    /*!
+      \brief check if file is open.
+      \retval true file opened.
+      \retval false file is not opened.
+    */
+    bool is_open() const
+      {
+          return M_file_buf.is_open();
+      }
+
+    /*!
+      \brief open gzipped file.
+      \param path file path.
+      Stream will be in state good() if file opens successfully;
+      otherwise in state fail().
+     */
+    void open( const char * path );
+
+    /*!
+      \brief close gzipped file.
+      if failed, stream will become state fail()
+     */
+    void close();
+};
+
+}
+
+#endif
@@ -35,7 +35,9 @@
 
 #include "udp_socket.h"
 
+#include <algorithm>
 #include <cstdio>
+#include <cstring>
 #include <cerrno>
 
 #ifdef HAVE_SYS_TYPES_H
@@ -171,4 +173,76 @@ UDPSocket::readDatagram( char * buf,
     return n;
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+int
+UDPSocket::readDatagrams( char * buf,
+                          const size_t len,
+                          int * sizes,
+                          const int count )
+{
+#ifdef HAVE_RECVMMSG
+    static const int MAX_BATCH = 64;
+
+    struct mmsghdr msgs[MAX_BATCH];
+    struct iovec iovs[MAX_BATCH];
+    HostAddress::AddrType from_addrs[MAX_BATCH];
+
+    const int batch = std::min( count, MAX_BATCH );
+    for ( int i = 0; i < batch; ++i )
+    {
+        iovs[i].iov_base = buf + i * len;
+        iovs[i].iov_len = len;
+
+        std::memset( &msgs[i].msg_hdr, 0, sizeof( msgs[i].msg_hdr ) );
+        msgs[i].msg_hdr.msg_name = &from_addrs[i];
+        msgs[i].msg_hdr.msg_namelen = sizeof( HostAddress::AddrType );
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        msgs[i].msg_len = 0;
+    }
+
+    int n = ::recvmmsg( fd(), msgs, batch, 0, nullptr );
+
+    if ( n == -1 )
+    {
+        if ( errno == EWOULDBLOCK )
+        {
+            return 0;
+        }
+
+        std::perror( "recvmmsg" );
+        return -1;
+    }
+
+    for ( int i = 0; i < n; ++i )
+    {
+        sizes[i] = static_cast< int >( msgs[i].msg_len );
+    }
+
+    if ( n > 0 )
+    {
+        M_peer_address.setAddress( from_addrs[n - 1] );
+    }
+
+    return n;
+#else
+    if ( count <= 0 )
+    {
+        return 0;
+    }
+
+    int n = readDatagram( buf, len );
+    if ( n <= 0 )
+    {
+        return n;
+    }
+
+    sizes[0] = n;
+    return 1;
+#endif
+}
+
 } // end namespace
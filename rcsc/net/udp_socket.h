@@ -115,6 +115,23 @@ public:
                       const size_t len,
                       HostAddress * from );
 
+    /*!
+      \brief receive all pending datagram packets from the remote host at once.
+      recvmmsg() is used if available. Otherwise, only one packet is received.
+      The peer address is updated by the source address of the last packet.
+      \param buf contiguous buffer for count packets. i-th packet is stored at buf + i * len.
+      \param len maximum length of each packet
+      \param sizes array to store the length of each received packet
+      \param count the number of packets that can be received
+      \retval 0 no packet or error occured and errno is EWOULDBLOCK
+      \retval -1 error occured
+      \return the number of received packets.
+     */
+    int readDatagrams( char * buf,
+                       const size_t len,
+                       int * sizes,
+                       const int count );
+
 };
 
 } // end namespace
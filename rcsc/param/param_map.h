@@ -34,7 +34,9 @@
 
 #include <boost/lexical_cast.hpp>
 
+#include <charconv>
 #include <memory>
+#include <type_traits>
 #include <vector>
 #include <map>
 #include <string>
@@ -279,16 +281,39 @@ public:
      */
     bool analyze( const std::string & value_str )
       {
-          try
+          if constexpr ( std::is_arithmetic< Type >::value )
           {
-              *M_value_ptr = boost::lexical_cast< Type >( value_str );
+              // locale independent and no exception
+              const char * first = value_str.data();
+              const char * last = first + value_str.size();
+              if ( first != last && *first == '+' ) ++first;
+
+              Type value = Type();
+              const std::from_chars_result r = std::from_chars( first, last, value );
+              if ( r.ec != std::errc()
+                   || r.ptr != last )
+              {
+                  std::cerr << "bad numeric value  [" << value_str << "]"
+                            << std::endl;
+                  return false;
+              }
+
+              *M_value_ptr = value;
               return true;
           }
-          catch ( boost::bad_lexical_cast & e )
+          else
           {
-              std::cerr << e.what() << "  [" << value_str << "]"
-                        << std::endl;
-              return false;
+              try
+              {
+                  *M_value_ptr = boost::lexical_cast< Type >( value_str );
+                  return true;
+              }
+              catch ( boost::bad_lexical_cast & e )
+              {
+                  std::cerr << e.what() << "  [" << value_str << "]"
+                            << std::endl;
+                  return false;
+              }
           }
       }
 
@@ -36,6 +36,7 @@
 #include "audio_sensor.h"
 
 #include <rcsc/common/say_message_parser.h>
+#include <rcsc/common/sexp_cursor.h>
 #include <rcsc/common/logger.h>
 #include <rcsc/math_util.h>
 
@@ -176,19 +177,23 @@ AudioSensor::parsePlayerMessage( const char * msg,
     long cycle = 0;
     double dir = 0.0;
     int unum = 0;
-    char sender[8];
-    int n_read = 0;
+    const char * sender = nullptr;
+    std::size_t sender_len = 0;
 
     // v8+ complete message
-    if ( std::sscanf( msg, " (hear %ld %lf %7[^ ] %d %n ",
-                      &cycle, &dir, sender, &unum, &n_read ) != 4 )
+    SExpCursor cursor( msg );
+    if ( ! cursor.consume( "(hear" )
+         || ! cursor.readInt( cycle )
+         || ! cursor.readDouble( dir )
+         || ! cursor.readToken( &sender, &sender_len )
+         || ! cursor.readInt( unum ) )
     {
         std::cerr << "***ERROR*** AudioSensor::parsePlayerMessage()"
                   << " heard unsupported message. [" << msg << "]"
                   << std::endl;
         return;
     }
-    msg += n_read;
+    msg = cursor.pos();
 
     while ( *msg == ' ' ) ++msg;
 
@@ -220,7 +225,8 @@ AudioSensor::parsePlayerMessage( const char * msg,
         return;
     }
 
-    if ( ! std::strncmp( sender, "our", 3 ) )
+    if ( sender_len >= 3
+         && ! std::strncmp( sender, "our", 3 ) )
     {
         if ( M_teammate_message_time != current )
         {
@@ -234,7 +240,8 @@ AudioSensor::parsePlayerMessage( const char * msg,
 
         parseTeammateMessage( message );
     }
-    else if ( ! std::strncmp( sender, "opp", 3 ) )
+    else if ( sender_len >= 3
+              && ! std::strncmp( sender, "opp", 3 ) )
     {
         if ( M_opponent_message_time != current )
         {
@@ -288,10 +295,10 @@ AudioSensor::parseCoachMessage( const char * msg,
     //
 
     char message_type[32];
-    int n_read = 0;
 
-    if ( std::sscanf( msg, " ( %31[^ ] %n ",
-                      message_type, &n_read ) != 1 )
+    SExpCursor cursor( msg );
+    if ( ! cursor.consume( '(' )
+         || ! cursor.readToken( message_type, sizeof( message_type ) ) )
     {
         std::cerr << "***ERROR*** failed to parse clang message type. ["
                   << msg << ']' << std::endl;
@@ -300,7 +307,8 @@ AudioSensor::parseCoachMessage( const char * msg,
 
     if ( ! std::strcmp( message_type, "freeform" ) )
     {
-        msg += n_read; // skip "(freeform "
+        cursor.skipSpace();
+        msg = cursor.pos(); // skip "(freeform "
 
         buildFreeformMessage( msg );
         if ( parseFreeformMessage() )
@@ -333,19 +341,19 @@ AudioSensor::parseTrainerMessage( const char * msg,
     // (hear <time> coach "<msg>") : v7+
     // (hear <time> coach <clang>) : v7+
 
-    int n_read = 0;
     long cycle;
-    char sender[32];
 
-    if ( std::sscanf( msg, "(hear %ld %31s %n ",
-                      &cycle, sender, &n_read ) != 2 )
+    SExpCursor cursor( msg );
+    if ( ! cursor.consume( "(hear" )
+         || ! cursor.readInt( cycle )
+         || ! cursor.skipToken() ) // sender
     {
         std::cerr << "***ERRORR*** failed to parse trainer message. ["
                   << msg << ']'
                   << std::endl;
         return;
     }
-    msg += n_read;
+    msg = cursor.pos();
 
     while ( *msg == ' ' ) ++msg;
 
@@ -495,13 +503,15 @@ AudioSensor::parseFreeformMessage()
     const FreeformParserMap::iterator end = M_freeform_parsers.end();
 
     const char * msg = M_freeform_message.c_str();
+    const char * const msg_end = msg + M_freeform_message.length();
 
     char tag[16];
 
     while ( *msg != '\0' )
     {
-        int n_read = 0;
-        if ( std::sscanf( msg, " ( %15s %n ",  tag, &n_read ) != 1 )
+        SExpCursor cursor( msg, msg_end );
+        if ( ! cursor.consume( '(' )
+             || ! cursor.readToken( tag, sizeof( tag ) ) )
         {
             dlog.addText( Logger::SENSOR,
                           __FILE__" (parseFreeformMessage) illegal message [%s] in [%s]",
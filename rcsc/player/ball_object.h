@@ -32,14 +32,14 @@
 #ifndef RCSC_PLAYER_BALL_OBJECT_H
 #define RCSC_PLAYER_BALL_OBJECT_H
 
+#include <rcsc/player/position_history.h>
+
 #include <rcsc/common/server_param.h>
 #include <rcsc/geom/vector_2d.h>
 #include <rcsc/game_time.h>
 #include <rcsc/soccer_math.h>
 #include <rcsc/math_util.h>
 
-#include <list>
-
 namespace rcsc {
 
 class GameMode;
@@ -100,7 +100,7 @@ private:
     AngleDeg M_angle_from_self; //!< estimated global angle from self
 
 
-    std::list< Vector2D > M_pos_history;
+    PositionHistory M_pos_history; //!< estimated positions in the past cycles
 
     // not used
     BallObject( const BallObject & ball ) = delete;
@@ -289,7 +289,7 @@ public:
       \brief get the history of estimated position.
       \return position list. the front element is the position at the previous cycle.
      */
-    const std::list< Vector2D > & posHistory() const
+    const PositionHistory & posHistory() const
       {
           return M_pos_history;
       }
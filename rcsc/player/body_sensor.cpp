@@ -35,6 +35,8 @@
 
 #include "body_sensor.h"
 
+#include <rcsc/common/sexp_cursor.h>
+
 #include <string>
 #include <cstdio>
 #include <cstdlib>
@@ -42,6 +44,40 @@
 
 namespace rcsc {
 
+namespace {
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief skip to the next element and its name. e.g. "(stamina"
+  \param cursor message cursor
+*/
+inline
+void
+skip_element_name( SExpCursor & cursor )
+{
+    cursor.skipTo( '(' );
+    cursor.consume( '(' );
+    cursor.skipToken();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief skip the open paren and the element name
+  \param cursor message cursor
+  \param name expected element name
+  \return true if the name is matched
+*/
+inline
+bool
+open_element( SExpCursor & cursor,
+              const char * name )
+{
+    return cursor.consume( '(' )
+        && cursor.consume( name );
+}
+
+}
+
 /*-------------------------------------------------------------------*/
 /*!
 
@@ -149,13 +185,18 @@ BodySensor::parse( const char * msg,
 
     M_time = current;
 
-    ++msg; // skip first paren
-    while ( *msg != '\0' && *msg != '(' ) ++msg; // skip "sense_body <time> "
+    SExpCursor cursor( msg );
+
+    cursor.consume( '(' ); // skip first paren
+    cursor.skipTo( '(' ); // skip "sense_body <time> "
 
-    while ( *msg != '\0' && *msg != ' ' ) ++msg; // skip "(view_mode"
-    ++msg; // skip space
+    const char * token = nullptr;
+    std::size_t len = 0;
+
+    skip_element_name( cursor ); // skip "(view_mode"
     // parse view quality
-    switch ( *msg ) {
+    cursor.readToken( &token, &len );
+    switch ( len > 0 ? token[0] : '\0' ) {
     case 'h':  // high
         M_view_quality = ViewQuality::HIGH;
         break;
@@ -167,11 +208,9 @@ BodySensor::parse( const char * msg,
         break;
     }
 
-    while ( *msg != '\0' && *msg != ' ' ) ++msg; // skip view_quality string
-    ++msg; // skip space
-
     // parse view width
-    switch ( *( msg + 1 ) ) {
+    cursor.readToken( &token, &len );
+    switch ( len > 1 ? token[1] : '\0' ) {
     case 'o':  // "normal"
         M_view_width = ViewWidth::NORMAL;
         break;
@@ -186,98 +225,73 @@ BodySensor::parse( const char * msg,
         break;
     }
 
-    char *next;
-
     // read stamina values
-    while ( *msg != '\0' && *msg != '(' ) ++msg;
-    while ( *msg != '\0' && *msg != ' ' ) ++msg; // skip "(stamina"
-    M_stamina = std::strtod( msg, &next ); msg = next;
-    M_effort = std::strtod( msg, &next ); msg = next;
+    skip_element_name( cursor ); // skip "(stamina"
+    cursor.readDouble( M_stamina );
+    cursor.readDouble( M_effort );
     if ( version >= 13.0 )
     {
-        if ( *msg != ')' )
+        cursor.skipSpace();
+        if ( cursor.peek() != ')' )
         {
-            M_stamina_capacity = std::strtod( msg, &next ); msg = next;
+            cursor.readDouble( M_stamina_capacity );
         }
     }
 
     // read speed values
-    while ( *msg != '\0' && *msg != '(' ) ++msg;
-    while ( *msg != '\0' && *msg != ' ' ) ++msg; // skip "(speed"
-    M_speed_mag = std::strtod( msg, &next );
-    msg = next; // this value is quantized by 0.01
+    skip_element_name( cursor ); // skip "(speed"
+    cursor.readDouble( M_speed_mag ); // this value is quantized by 0.01
     if ( version >= 6.0 )
     {
         // Sensed speed_dir is the velocity dir relative to player's face angle
         // global_vel_dir = (sensed_speed_dir + my_global_neck_angle)
-        M_speed_dir_relative = std::strtod( msg, &next );
-        msg = next;
+        cursor.readDouble( M_speed_dir_relative );
     }
 
     if ( version >= 5.0 )
     {
-        while ( *msg != '(' ) ++msg;
-        while ( *msg != ' ' ) ++msg; // skip "(head_angle"
-        M_neck_relative = std::strtod( msg, &next );
-        msg = next;
+        skip_element_name( cursor ); // skip "(head_angle"
+        cursor.readDouble( M_neck_relative );
     }
 
-    while ( *msg != '\0' && *msg != '(' ) ++msg;
-    while ( *msg != '\0' && *msg != ' ' ) ++msg; // skip "(kick"
-    M_kick_count = static_cast< int >( std::strtol( msg, &next, 10 ) );
-    msg = next;
+    skip_element_name( cursor ); // skip "(kick"
+    cursor.readInt( M_kick_count );
 
-    while ( *msg != '\0' && *msg != '(' ) ++msg;
-    while ( *msg != '\0' && *msg != ' ' ) ++msg; // skip "(dash"
-    M_dash_count = static_cast< int >( std::strtol( msg, &next, 10 ) );
-    msg = next;
+    skip_element_name( cursor ); // skip "(dash"
+    cursor.readInt( M_dash_count );
 
-    while ( *msg != '\0' && *msg != '(' ) ++msg;
-    while ( *msg != '\0' && *msg != ' ' ) ++msg; // skip "(turn"
-    M_turn_count = static_cast< int >( std::strtol( msg, &next, 10 ) );
-    msg = next;
+    skip_element_name( cursor ); // skip "(turn"
+    cursor.readInt( M_turn_count );
 
-    while ( *msg != '\0' && *msg != '(' ) ++msg;
-    while ( *msg != '\0' && *msg != ' ' ) ++msg; // skip "(say"
-    M_say_count = static_cast< int >( std::strtol( msg, &next, 10 ) );
-    msg = next;
+    skip_element_name( cursor ); // skip "(say"
+    cursor.readInt( M_say_count );
 
     if ( version < 5.0 )
     {
         return;
     }
 
-    while ( *msg != '\0' && *msg != '(' ) ++msg;
-    while ( *msg != '\0' && *msg != ' ' ) ++msg; // skip "(turn_neck"
-    M_turn_neck_count = static_cast< int >( std::strtol( msg, &next, 10 ) );
-    msg = next;
+    skip_element_name( cursor ); // skip "(turn_neck"
+    cursor.readInt( M_turn_neck_count );
 
     if ( version < 7.0 )
     {
         return;
     }
 
-    while ( *msg != '\0' && *msg != '(' ) ++msg;
-    while ( *msg != '\0' && *msg != ' ' ) ++msg; // skip "(catch"
-    M_catch_count = static_cast< int >( std::strtol( msg, &next, 10 ) );
-    msg = next;
+    skip_element_name( cursor ); // skip "(catch"
+    cursor.readInt( M_catch_count );
 
-    while ( *msg != '\0' && *msg != '(' ) ++msg;
-    while ( *msg != '\0' && *msg != ' ' ) ++msg; // skip "(move"
-    M_move_count  = static_cast< int >( std::strtol( msg, &next, 10 ) );
-    msg = next;
+    skip_element_name( cursor ); // skip "(move"
+    cursor.readInt( M_move_count );
 
-    while ( *msg != '\0' && *msg != '(' ) ++msg;
-    while ( *msg != '\0' && *msg != ' ' ) ++msg; // skip "(chage_view"
-    M_change_view_count = static_cast< int >( std::strtol( msg, &next, 10 ) );
-    msg = next;
+    skip_element_name( cursor ); // skip "(chage_view"
+    cursor.readInt( M_change_view_count );
 
     if ( version >= 18.0 )
     {
-        while ( *msg != '\0' && *msg != '(' ) ++msg;
-        while ( *msg != '\0' && *msg != ' ' ) ++msg; // skip "(change_focus"
-        M_change_focus_count = static_cast< int >( std::strtol( msg, &next, 10 ) );
-        msg = next;
+        skip_element_name( cursor ); // skip "(change_focus"
+        cursor.readInt( M_change_focus_count );
     }
 
     if ( version < 8.0 )
@@ -285,28 +299,25 @@ BodySensor::parse( const char * msg,
         return;
     }
 
-    while ( *msg != '\0' && *msg != '(' ) ++msg;
-    if ( ! parseArm( msg, &next ) )
+    cursor.skipTo( '(' );
+    if ( ! parseArm( cursor ) )
     {
         return;
     }
-    msg = next;
 
     // (focus (target <SIDE> [<UNUM>]) (count <COUNT>)
-    while ( *msg != '\0' && *msg != '(' ) ++msg;
-    if ( ! parseAttentionto( msg, &next ) )
+    cursor.skipTo( '(' );
+    if ( ! parseAttentionto( cursor ) )
     {
         return;
     }
-    msg = next;
 
     // (tackle (expires <EXPIRES>) (count <COUNT>))
-    while ( *msg != '\0' && *msg != '(' ) ++msg;
-    if ( ! parseTackle( msg, &next ) )
+    cursor.skipTo( '(' );
+    if ( ! parseTackle( cursor ) )
     {
         return;
     }
-    msg = next;
 
     if ( version < 12.0 )
     {
@@ -314,9 +325,8 @@ BodySensor::parse( const char * msg,
     }
 
     // (collision {none|[(ball)][(player)][(post)]})
-    while ( *msg != '\0' && *msg != '(' ) ++msg;
-    parseCollision( msg, &next );
-    msg = next;
+    cursor.skipTo( '(' );
+    parseCollision( cursor );
 
     if ( version < 14.0 )
     {
@@ -326,9 +336,8 @@ BodySensor::parse( const char * msg,
     //
     // (foul (charged 0) (card {none|yellow|red}))
     //
-    while ( *msg != '\0' && *msg != '(' ) ++msg;
-    parseFoul( msg, &next );
-    msg = next;
+    cursor.skipTo( '(' );
+    parseFoul( cursor );
 
     if ( version < 18.0 )
     {
@@ -338,8 +347,8 @@ BodySensor::parse( const char * msg,
     //
     //  (focus_point 0.0 0.0))
     //
-    while ( *msg != '\0' && *msg != '(' ) ++msg;
-    parseFocusPoint( msg, &next );
+    cursor.skipTo( '(' );
+    parseFocusPoint( cursor );
 }
 
 #if 0
@@ -533,15 +542,20 @@ BodySensor::parse2( const char * msg,
 
 /*-------------------------------------------------------------------*/
 bool
-BodySensor::parseArm( const char * msg,
-                      char ** next )
+BodySensor::parseArm( SExpCursor & cursor )
 {
+    // (arm (movable <MOVABLE>) (expires <EXPIRES>) (target <DIST> <DIR>) (count <COUNT>))
+    const char * msg = cursor.pos();
+
     int movable, expires, count;
     double dist, dir;
-    int n_read = 0;
-    if ( std::sscanf( msg,
-                      " ( arm ( movable %d ) ( expires %d ) ( target %lf %lf ) ( count %d ) ) %n",
-                      &movable, &expires, &dist, &dir, &count, &n_read ) != 5 )
+    if ( ! open_element( cursor, "arm" )
+         || ! open_element( cursor, "movable" ) || ! cursor.readInt( movable ) || ! cursor.consume( ')' )
+         || ! open_element( cursor, "expires" ) || ! cursor.readInt( expires ) || ! cursor.consume( ')' )
+         || ! open_element( cursor, "target" ) || ! cursor.readDouble( dist ) || ! cursor.readDouble( dir )
+         || ! cursor.consume( ')' )
+         || ! open_element( cursor, "count" ) || ! cursor.readInt( count ) || ! cursor.consume( ')' )
+         || ! cursor.consume( ')' ) )
     {
         std::cerr << M_time << " sense_body. illegal arm [" << msg << "]" << std::endl;
         return false;
@@ -553,47 +567,47 @@ BodySensor::parseArm( const char * msg,
     M_pointto_dir = dir;
     M_pointto_count = count;
 
-    *next = const_cast< char * >( msg ) + n_read;
     return true;
 }
 
 /*-------------------------------------------------------------------*/
 bool
-BodySensor::parseAttentionto( const char * msg,
-                              char ** next )
+BodySensor::parseAttentionto( SExpCursor & cursor )
 {
     // `(focus (target <SIDE> [<UNUM>]) (count <COUNT>)'
     // <SIDE> := "none" | "l" | "r"
+    const char * msg = cursor.pos();
 
     char side[8];
     int unum = Unum_Unknown;
     int count = 0;
-    int n_read = 0;
 
-    if ( std::strncmp( "(focus ", msg, 7 ) )
+    if ( ! open_element( cursor, "focus" )
+         || cursor.peek() != ' ' )
     {
         std::cerr << "ERROR: " << M_time
                   << " (BodySensor::parseAttentionto)  [" << msg << "]" << std::endl;
         return false;
     }
 
-    msg += 7;
-    if ( std::sscanf( msg, " ( target %7[^)] %d ) %n", side, &unum, &n_read ) != 2
-         && std::sscanf( msg, " ( target %7[^)] ) %n", side, &n_read ) != 1 )
+    if ( ! open_element( cursor, "target" )
+         || ! cursor.readToken( side, sizeof( side ) ) )
     {
         std::cerr << "ERROR: " << M_time
                   << " (BodySensor::parseAttentionto)  [" << msg << "]" << std::endl;
         return false;
     }
-    msg += n_read;
+    cursor.readInt( unum ); // unum is omitted if the target is none.
 
-    if ( std::sscanf( msg, " ( count %d ) %n", &count, &n_read ) != 1 )
+    if ( ! cursor.consume( ')' )
+         || ! open_element( cursor, "count" )
+         || ! cursor.readInt( count )
+         || ! cursor.consume( ')' ) )
     {
         std::cerr << "ERROR: " << M_time
                   << " (BodySensor::parseAttentionto)  [" << msg << "]" << std::endl;
         return false;
     }
-    msg += n_read;
 
     if ( side[0] == 'n' )
     {
@@ -621,23 +635,23 @@ BodySensor::parseAttentionto( const char * msg,
     M_attentionto_count = count;
 
     // skip to the next element
-    while ( *msg != '\0' && *msg != '(' ) ++msg;
-    *next = const_cast< char * >( msg );
+    cursor.skipTo( '(' );
 
     return true;
 }
 
 /*-------------------------------------------------------------------*/
 bool
-BodySensor::parseTackle( const char * msg,
-                         char ** next )
+BodySensor::parseTackle( SExpCursor & cursor )
 {
     // `(tackle (expires <EXPIRES>) (count <COUNT>))'
+    const char * msg = cursor.pos();
+
     int expires, count;
-    int n_read = 0;
-    if ( std::sscanf( msg,
-                      " ( tackle ( expires %d ) ( count %d ) ) %n",
-                      &expires, &count, &n_read ) != 2 )
+    if ( ! open_element( cursor, "tackle" )
+         || ! open_element( cursor, "expires" ) || ! cursor.readInt( expires ) || ! cursor.consume( ')' )
+         || ! open_element( cursor, "count" ) || ! cursor.readInt( count ) || ! cursor.consume( ')' )
+         || ! cursor.consume( ')' ) )
     {
         std::cerr << "ERROR: " << M_time
                   << " (BodySensor::parseTackle) [" << msg << "]" << std::endl;
@@ -647,7 +661,6 @@ BodySensor::parseTackle( const char * msg,
     M_tackle_expires = expires;
     M_tackle_count = count;
 
-    *next = const_cast< char * >( msg ) + n_read;
     return true;
 }
 
@@ -656,15 +669,14 @@ BodySensor::parseTackle( const char * msg,
 
 */
 bool
-BodySensor::parseCollision( const char * msg,
-                            char ** next )
+BodySensor::parseCollision( SExpCursor & cursor )
 {
     // (collision {none|[(ball)][(player)][(post)]})
 
-    if ( std::strncmp( "(collision ", msg, 11 ) )
+    if ( ! cursor.consume( "(collision " ) )
     {
         std::cerr << M_time << " sense_body. illegal collision tag ["
-                  << msg << "]" << std::endl;
+                  << cursor.pos() << "]" << std::endl;
         return false;
     }
 
@@ -673,33 +685,21 @@ BodySensor::parseCollision( const char * msg,
     M_player_collided = false;
     M_post_collided = false;
 
-    msg += 11;
-    //while ( *msg != '\0' && *msg != '(' ) ++msg;
-    //while ( *msg != '\0' && *msg != ' ' ) ++msg; // skip "(collision"
-    while ( *msg == ' ' ) ++msg; // skip space
-
-    if ( ! std::strncmp( msg, "none", 4 ) )
+    if ( cursor.consume( "none" ) )
     {
         M_none_collided = true;
-
-        if ( next )
-        {
-            while ( *msg != '\0' && *msg != '(' ) ++msg;
-            *next = const_cast< char * >( msg );
-        }
+        cursor.skipTo( '(' );
         return true;
     }
 
-    int n_read = 0;
     char name[16];
-    while ( *msg != '\0' && *msg != ')' )
+    while ( cursor.consume( '(' ) )
     {
-        if ( std::sscanf( msg, " ( %15[^()] ) %n ",
-                          name, &n_read ) != 1 )
+        if ( ! cursor.readToken( name, sizeof( name ) )
+             || ! cursor.consume( ')' ) )
         {
             break;
         }
-        msg += n_read;
 
         if ( ! std::strcmp( "ball", name ) )
         {
@@ -720,11 +720,7 @@ BodySensor::parseCollision( const char * msg,
         }
     }
 
-    if ( next )
-    {
-        while ( *msg != '\0' && *msg != '(' ) ++msg;
-        *next = const_cast< char * >( msg );
-    }
+    cursor.skipTo( '(' );
 
     return true;
 }
@@ -735,42 +731,35 @@ BodySensor::parseCollision( const char * msg,
 
 */
 bool
-BodySensor::parseFoul( const char * msg,
-                       char ** next )
+BodySensor::parseFoul( SExpCursor & cursor )
 {
     // (foul (charged 0) (card {none|yellow|red}))
 
-    int n_read = 0;
-
-    while ( *msg != '\0' && *msg != '(' ) ++msg;
-    while ( *msg != '\0' && *msg != ' ' ) ++msg; // skip "(foul"
+    skip_element_name( cursor ); // skip "(foul"
 
     int cycles = 0;
 
-    if ( std::sscanf( msg, " ( charged %d ) %n ",
-                      &cycles, &n_read ) != 1
-         || n_read == 0 )
+    if ( ! open_element( cursor, "charged" )
+         || ! cursor.readInt( cycles )
+         || ! cursor.consume( ')' ) )
     {
         std::cerr << M_time << " sense_body. illegal foul charge expires ["
-                  << msg << "]" << std::endl;
+                  << cursor.pos() << "]" << std::endl;
         return false;
     }
-    msg += n_read;
-    n_read = 0;
 
     M_charged_expires = cycles;
 
     char card[8];
 
-    if ( std::sscanf( msg, " ( card %7[^)] ) %n",
-                      card, &n_read ) != 1
-         || n_read == 0 )
+    if ( ! open_element( cursor, "card" )
+         || ! cursor.readToken( card, sizeof( card ) )
+         || ! cursor.consume( ')' ) )
     {
         std::cerr << M_time << " sense_body. illegal card information ["
-                  << msg << "]" << std::endl;
+                  << cursor.pos() << "]" << std::endl;
         return false;
     }
-    msg += n_read;
 
     if ( ! std::strcmp( card, "none" ) )
     {
@@ -791,13 +780,7 @@ BodySensor::parseFoul( const char * msg,
         M_card = NO_CARD;
     }
 
-    while ( *msg == ' ' ) ++msg;
-    if ( *msg == ')' ) ++msg;
-
-    if ( next )
-    {
-        *next = const_cast< char * >( msg );
-    }
+    cursor.consume( ')' );
 
     return true;
 }
@@ -808,16 +791,18 @@ BodySensor::parseFoul( const char * msg,
 
 */
 bool
-BodySensor::parseFocusPoint( const char * msg,
-                             char ** next )
+BodySensor::parseFocusPoint( SExpCursor & cursor )
 {
     // (focus_point <REAL> <REAL>)
+    const char * msg = cursor.pos();
 
     double focus_dist = 0.0;
     double focus_dir = 0.0;
-    int n_read = 0;
 
-    if ( std::sscanf( msg, " (focus_point %lf %lf) %n", &focus_dist, &focus_dir, &n_read ) != 2 )
+    if ( ! open_element( cursor, "focus_point" )
+         || ! cursor.readDouble( focus_dist )
+         || ! cursor.readDouble( focus_dir )
+         || ! cursor.consume( ')' ) )
     {
         std::cerr << M_time << " ERROR: Illegal focus_point in sense_body [" << msg << "]" << std::endl;
         return false;
@@ -826,10 +811,6 @@ BodySensor::parseFocusPoint( const char * msg,
     M_focus_dist = focus_dist;
     M_focus_dir = focus_dir;
 
-    if ( next )
-    {
-        *next = const_cast< char * >( msg ) + n_read;
-    }
     return true;
 }
 
@@ -40,6 +40,8 @@
 
 namespace rcsc {
 
+class SExpCursor;
+
 /*!
   \class BodySensor
   \brief sense_body info holder
@@ -136,58 +138,46 @@ private:
 
     /*!
       \brief analyze arm information in the sense_body message.
-      \param msg server message started with (arm
-      \param pointer pointer to the next character after parsing
+      \param cursor message cursor at (arm. the cursor is moved after the parsed element.
       \return parsing result
      */
-    bool parseArm( const char * msg,
-                   char ** next );
+    bool parseArm( SExpCursor & cursor );
 
     /*!
       \brief analyze attentionto(focus) information in the sense_body message.
-      \param msg server message started with (focus
-      \param pointer pointer to the next character after parsing
+      \param cursor message cursor at (focus. the cursor is moved after the parsed element.
       \return parsing result
      */
-    bool parseAttentionto( const char * msg,
-                           char ** next );
+    bool parseAttentionto( SExpCursor & cursor );
 
     /*!
       \brief analyze tackle information in the sense_body message.
-      \param msg server message started with (tackle
-      \param pointer pointer to the next character after parsing
+      \param cursor message cursor at (tackle. the cursor is moved after the parsed element.
       \return parsing result
      */
-    bool parseTackle( const char * msg,
-                      char ** next );
+    bool parseTackle( SExpCursor & cursor );
 
 
     /*!
       \brief analyze collision information contained by sense_body message.
-      \param msg server message started with (collision
-      \param pointer pointer to the next character after parsing
+      \param cursor message cursor at (collision. the cursor is moved after the parsed element.
       \return parsing result
      */
-    bool parseCollision( const char * msg,
-                         char ** next );
+    bool parseCollision( SExpCursor & cursor );
 
     /*!
       \brief analyze card information
-      \param msg server message started with (card
-      \param pointer pointer to the next character after parsing
+      \param cursor message cursor at (foul. the cursor is moved after the parsed element.
       \return parsing result
      */
-    bool parseFoul( const char * msg,
-                    char ** next );
+    bool parseFoul( SExpCursor & cursor );
 
     /*!
       \brief analyze focus point information
-      \param msg server message started with (focus_point
-      \param pointer pointer to the next character after parsing
+      \param cursor message cursor at (focus_point. the cursor is moved after the parsed element.
       \return parsing result
      */
-    bool parseFocusPoint( const char * msg,
-                          char ** next );
+    bool parseFocusPoint( SExpCursor & cursor );
 
 public:
 
@@ -36,12 +36,55 @@
 #include "fullstate_sensor.h"
 
 #include <rcsc/common/logger.h>
+#include <rcsc/common/sexp_cursor.h>
 
 #include <algorithm>
 #include <cstring>
 
 namespace rcsc {
 
+namespace {
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief read the floating point value in the same manner as strtod()
+  \param msg pointer to the current position. moved after the value.
+  \param msg_end end of the message
+  \return the read value, or 0.0 if no value is read.
+ */
+inline
+double
+read_double( const char ** msg,
+             const char * msg_end )
+{
+    SExpCursor cursor( *msg, msg_end );
+    double val = 0.0;
+    cursor.readDouble( val );
+    *msg = cursor.pos();
+    return val;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief read the integer value in the same manner as strtol()
+  \param msg pointer to the current position. moved after the value.
+  \param msg_end end of the message
+  \return the read value, or 0 if no value is read.
+ */
+inline
+int
+read_int( const char ** msg,
+          const char * msg_end )
+{
+    SExpCursor cursor( *msg, msg_end );
+    int val = 0;
+    cursor.readInt( val );
+    *msg = cursor.pos();
+    return val;
+}
+
+}
+
 /*-------------------------------------------------------------------*/
 /*!
 
@@ -183,7 +226,7 @@ FullstateSensor::parseV8( const char * msg,
 
       */
 
-    char * next;
+    const char * const msg_end = msg + std::strlen( msg );
 
     while ( *msg != '\0' && *msg != ' ' ) ++msg; // skip "(fullstate"
     // play mode
@@ -221,8 +264,8 @@ FullstateSensor::parseV8( const char * msg,
     while ( *msg != '\0' && *msg != '(' ) ++msg; // skip to (score
     while ( *msg != '\0' && *msg != ' ' ) ++msg; // skip to " LSCORE..."
 
-    int score_l = static_cast< int >( std::strtol( msg, &next, 10) ); msg = next;
-    int score_r = static_cast< int >( std::strtol( msg, &next, 10 ) ); msg = next;
+    int score_l = read_int( &msg, msg_end );
+    int score_r = read_int( &msg, msg_end );
 
     if ( our_side == LEFT )
     {
@@ -240,10 +283,10 @@ FullstateSensor::parseV8( const char * msg,
     while ( *msg != '\0' && *msg != '(' ) ++msg; // skip to (ball
     while ( *msg != '\0' && *msg != ' ' ) ++msg; // skip "(ball"
 
-    M_ball.pos_.x = std::strtod( msg, &next ); msg = next;
-    M_ball.pos_.y = std::strtod( msg, &next ); msg = next;
-    M_ball.vel_.x = std::strtod( msg, &next ); msg = next;
-    M_ball.vel_.y = std::strtod( msg, &next ); msg = next;
+    M_ball.pos_.x = read_double( &msg, msg_end );
+    M_ball.pos_.y = read_double( &msg, msg_end );
+    M_ball.vel_.x = read_double( &msg, msg_end );
+    M_ball.vel_.y = read_double( &msg, msg_end );
 
     //((p {l|r} <unum>{g|<player_type_id>}) <pos.x> <pos.y>
     //   <vel.x> <vel.y> <body_angle> <neck_angle>
@@ -270,8 +313,7 @@ FullstateSensor::parseV8( const char * msg,
                          : RIGHT );
 
         msg += 2; // skip "l " or "r "
-        player.unum_ = static_cast< int >( std::strtol( msg, &next, 10 ) );
-        msg = next;
+        player.unum_ = read_int( &msg, msg_end );
 
         while ( *msg == ' ' ) ++msg;
 
@@ -285,44 +327,43 @@ FullstateSensor::parseV8( const char * msg,
 
         if ( std::isdigit( *msg ) )
         {
-            player.type_ = static_cast< int >( std::strtol( msg, &next, 10 ) );
-            msg = next;
+            player.type_ = read_int( &msg, msg_end );
         }
 
         while ( *msg == ' ' || *msg == ')' ) ++msg; // skip to x pos
 
-        player.pos_.x = std::strtod( msg, &next ); msg = next;
-        player.pos_.y = std::strtod( msg, &next ); msg = next;
-        player.vel_.x = std::strtod( msg, &next ); msg = next;
-        player.vel_.y = std::strtod( msg, &next ); msg = next;
-        player.body_ = std::strtod( msg, &next ); msg = next;
-        player.neck_ = std::strtod( msg, &next ); msg = next;
+        player.pos_.x = read_double( &msg, msg_end );
+        player.pos_.y = read_double( &msg, msg_end );
+        player.vel_.x = read_double( &msg, msg_end );
+        player.vel_.y = read_double( &msg, msg_end );
+        player.body_ = read_double( &msg, msg_end );
+        player.neck_ = read_double( &msg, msg_end );
 
         while ( *msg != '\0' && *msg == ' ' ) ++msg;
         if ( *msg != '(' )
         {
-            player.pointto_dist_ = std::strtod( msg, &next ); msg = next;
-            player.pointto_dir_ = std::strtod( msg, &next ); msg = next;
+            player.pointto_dist_ = read_double( &msg, msg_end );
+            player.pointto_dir_ = read_double( &msg, msg_end );
         }
         while ( *msg != '\0' && *msg != '(' ) ++msg; // skip to "("
 
         if ( std::strncmp( msg, "(focus_point ", 13 ) == 0 )
         {
             msg += 13;
-            player.focus_dist_ = std::strtod( msg, &next ); msg = next;
-            player.focus_dir_ = std::strtod( msg, &next ); msg = next;
+            player.focus_dist_ = read_double( &msg, msg_end );
+            player.focus_dir_ = read_double( &msg, msg_end );
             while ( *msg != '\0' && *msg != '(' ) ++msg; // skip to "("
         }
 
         if ( std::strncmp( msg, "(stamina ", 9 ) == 0 )
         {
             msg += 9;
-            player.stamina_ = std::strtod( msg, &next ); msg = next;
-            player.effort_ = std::strtod( msg, &next ); msg = next;
-            player.recovery_ = std::strtod( msg, &next ); msg = next;
+            player.stamina_ = read_double( &msg, msg_end );
+            player.effort_ = read_double( &msg, msg_end );
+            player.recovery_ = read_double( &msg, msg_end );
             if ( *msg != ')' )
             {
-                player.stamina_capacity_ = std::strtod( msg, &next ); msg = next;
+                player.stamina_capacity_ = read_double( &msg, msg_end );
             }
             while ( *msg == ')' ) ++msg;
         }
@@ -388,7 +429,7 @@ FullstateSensor::parseV7( const char * msg,
     //   This class doesn't manage playmode & view mode
     // !!!!!!!!!!!!!!!!!!!!!    //! left team score!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
 
-    char *next;
+    const char * const msg_end = msg + std::strlen( msg );
 
     while ( *msg != ' ' ) ++msg; // skip "(fullstate"
     while ( *msg != '(' ) ++msg; // skip to "(pmode"
@@ -404,8 +445,8 @@ FullstateSensor::parseV7( const char * msg,
     while ( *msg != '(' ) ++msg; // skip to (score
     while ( *msg != ' ' ) ++msg; // skip to " LSCORE..."
 
-    int score_l = static_cast< int >( std::strtol( msg, &next, 10 ) ); msg = next;
-    int score_r = static_cast< int >( std::strtol( msg, &next, 10 ) ); msg = next;
+    int score_l = read_int( &msg, msg_end );
+    int score_r = read_int( &msg, msg_end );
     if ( our_side == LEFT )
     {
         M_our_score = score_l;
@@ -420,10 +461,10 @@ FullstateSensor::parseV7( const char * msg,
     while ( *msg != '(' ) ++msg; // skip to (ball
     while ( *msg != ' ' ) ++msg; // skip "(ball"
 
-    M_ball.pos_.x = std::strtod( msg, &next ); msg = next;
-    M_ball.pos_.y = std::strtod( msg, &next ); msg = next;
-    M_ball.vel_.x = std::strtod( msg, &next ); msg = next;
-    M_ball.vel_.y = std::strtod( msg, &next ); msg = next;
+    M_ball.pos_.x = read_double( &msg, msg_end );
+    M_ball.pos_.y = read_double( &msg, msg_end );
+    M_ball.vel_.x = read_double( &msg, msg_end );
+    M_ball.vel_.y = read_double( &msg, msg_end );
 
     while ( *msg != '\0' )
     {
@@ -443,18 +484,17 @@ FullstateSensor::parseV7( const char * msg,
                          : RIGHT );
 
         msg += 2; // skip "l_" or "r_"
-        player.unum_ = std::atoi( msg );
-        msg += 2; // skip to x pos
-
-        player.pos_.x = std::strtod( msg, &next ); msg = next;
-        player.pos_.y = std::strtod( msg, &next ); msg = next;
-        player.vel_.x = std::strtod( msg, &next ); msg = next;
-        player.vel_.y = std::strtod( msg, &next ); msg = next;
-        player.body_ = std::strtod( msg, &next ); msg = next;
-        player.neck_ = std::strtod( msg, &next ); msg = next;
-        player.stamina_ = std::strtod( msg, &next ); msg = next;
-        player.effort_ = std::strtod( msg, &next ); msg = next;
-        player.recovery_ = std::strtod( msg, &next ); msg = next;
+        player.unum_ = read_int( &msg, msg_end );
+
+        player.pos_.x = read_double( &msg, msg_end );
+        player.pos_.y = read_double( &msg, msg_end );
+        player.vel_.x = read_double( &msg, msg_end );
+        player.vel_.y = read_double( &msg, msg_end );
+        player.body_ = read_double( &msg, msg_end );
+        player.neck_ = read_double( &msg, msg_end );
+        player.stamina_ = read_double( &msg, msg_end );
+        player.effort_ = read_double( &msg, msg_end );
+        player.recovery_ = read_double( &msg, msg_end );
         // now, msg point the last paren of this player
 
         if ( our_side == player.side_ )
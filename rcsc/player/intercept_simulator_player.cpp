@@ -44,6 +44,10 @@
 #include <rcsc/common/player_type.h>
 #include <rcsc/soccer_math.h>
 
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
 // #define DEBUG
 // #define DEBUG2
 
@@ -132,8 +136,15 @@ InterceptSimulatorPlayer::PlayerData::inertiaPoint( const int step ) const
  */
 InterceptSimulatorPlayer::InterceptSimulatorPlayer( const Vector2D & ball_pos,
                                                     const Vector2D & ball_vel )
-    : M_ball_move_angle( ball_vel.th() )
+    : M_ball_size( 0 ),
+      M_ball_in_penalty_area( 0 ),
+      M_ball_move_angle( ball_vel.th() )
 {
+    // the same values as Vector2D::rotate( - M_ball_move_angle )
+    const AngleDeg rot = - M_ball_move_angle;
+    M_rotation_cos = std::cos( rot.degree() * AngleDeg::DEG2RAD );
+    M_rotation_sin = std::sin( rot.degree() * AngleDeg::DEG2RAD );
+
     createBallCache( ball_pos, ball_vel );
 }
 
@@ -142,8 +153,6 @@ void
 InterceptSimulatorPlayer::createBallCache( const Vector2D & ball_pos,
                                            const Vector2D & ball_vel )
 {
-    constexpr int MAX_STEP = 50;
-
     const ServerParam & SP = ServerParam::i();
     const double max_x = ( SP.keepawayMode()
                            ? SP.keepawayLength() * 0.5
@@ -151,10 +160,12 @@ InterceptSimulatorPlayer::createBallCache( const Vector2D & ball_pos,
     const double max_y = ( SP.keepawayMode()
                            ? SP.keepawayWidth() * 0.5
                            : SP.pitchHalfWidth() + 5.0 );
+    const double pen_area_x = SP.pitchHalfLength() - SP.penaltyAreaLength();
+    const double pen_area_y = SP.penaltyAreaHalfWidth();
     const double bdecay = SP.ballDecay();
 
-    M_ball_cache.clear();
-    M_ball_cache.reserve( MAX_STEP );
+    M_ball_size = 0;
+    M_ball_in_penalty_area = 0;
 
     Vector2D bpos = ball_pos;
     Vector2D bvel = ball_vel;
@@ -162,7 +173,14 @@ InterceptSimulatorPlayer::createBallCache( const Vector2D & ball_pos,
 
     for ( int i = 0; i < MAX_STEP; ++i )
     {
-        M_ball_cache.push_back( bpos );
+        M_ball_x[i] = bpos.x;
+        M_ball_y[i] = bpos.y;
+        if ( pen_area_x <= bpos.absX()
+             && bpos.absY() <= pen_area_y )
+        {
+            M_ball_in_penalty_area |= ( std::uint64_t( 1 ) << i );
+        }
+        ++M_ball_size;
 
         if ( bspeed < 0.005 && i >= 10 )
         {
@@ -190,97 +208,347 @@ InterceptSimulatorPlayer::simulate( const WorldModel & wm,
                                     const PlayerObject & player,
                                     const bool goalie ) const
 {
-    if ( player.posCount() >= 10 )
-    {
-        return 1000;
-    }
+    const PlayerObject * players[1] = { &player };
+    const bool goalies[1] = { goalie };
+    int result = 1000;
 
-    if ( player.isKickable( 0.0 ) )
-    {
-        return 0;
-    }
+    simulate( wm, players, goalies, 1, &result );
+    return result;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
 
-    const PlayerType * ptype = player.playerTypePtr();
+ */
+void
+InterceptSimulatorPlayer::simulate( const WorldModel & wm,
+                                    const PlayerObject * const * players,
+                                    const bool * goalie,
+                                    const int size,
+                                    int * result,
+                                    const int * min_steps ) const
+{
+    const auto create_data = [&]( const int i )
+        {
+            const PlayerObject & p = *players[i];
+            return PlayerData( p,
+                               *p.playerTypePtr(),
+                               get_pos( p ),
+                               get_vel( p ),
+                               get_control_area( p, wm, goalie[i] ),
+                               get_bonus_step( p, wm.ourSide() ),
+                               get_penalty_step( p ) );
+        };
+
+    const int max_step = M_ball_size - 1;
+
+    Batch batch;
+    int index[BATCH_SIZE];
+    int n = 0;
+
+    const auto flush = [&]()
+        {
+            // clear the unused lanes, because the rough test checks all lanes.
+            for ( int j = n; j < BATCH_SIZE; ++j )
+            {
+                batch.x_[j] = batch.y_[j] = 0.0;
+                batch.vel_x_[j] = batch.vel_y_[j] = 0.0;
+                batch.body_x_[j] = batch.body_y_[j] = 0.0;
+                batch.decay_[j] = batch.decay_pow_[j] = batch.inertia_rate_[j] = 0.0;
+                batch.control_area_[j] = batch.speed_max_[j] = batch.step_offset_[j] = 0.0;
+                batch.ptype_[j] = nullptr;
+                batch.min_step_[j] = MAX_STEP;
+            }
+
+            int first_step = MAX_STEP;
+            for ( int j = 0; j < n; ++j )
+            {
+                first_step = std::min( first_step, batch.min_step_[j] );
+            }
+
+            for ( int j = 0; j < BATCH_SIZE; ++j )
+            {
+                batch.decay_pow_[j] *= std::pow( batch.decay_[j], first_step );
+            }
+
+            //
+            // the rough test and the detailed test are executed by turns,
+            // because most players reach the ball within a few steps.
+            //
+            int rest = n;
+            for ( int step = first_step;
+                  step < max_step && rest > 0;
+                  step += CHECK_STEP_SIZE )
+            {
+                const int last_step = std::min( step + CHECK_STEP_SIZE, max_step );
+                const std::uint64_t range = ( ( std::uint64_t( 1 ) << last_step ) - 1 );
+
+                checkReachableSteps( batch, step, last_step );
+
+                for ( int j = 0; j < n; ++j )
+                {
+                    if ( ! batch.ptype_[j] )
+                    {
+                        continue;
+                    }
+
+                    std::uint64_t candidates = ( batch.reachable_[j]
+                                                 & range
+                                                 & ~( ( std::uint64_t( 1 ) << batch.min_step_[j] ) - 1 ) );
+                    if ( goalie[index[j]] )
+                    {
+                        // goalie never reach the ball out of the penalty area
+                        candidates &= M_ball_in_penalty_area;
+                    }
+
+                    if ( ! candidates )
+                    {
+                        continue;
+                    }
+
+                    const int reach_step = predictReachStep( create_data( index[j] ), candidates );
+                    if ( reach_step >= 0 )
+                    {
+                        result[index[j]] = reach_step;
+                        batch.ptype_[j] = nullptr;
+                        --rest;
+                    }
+                }
+            }
+
+            for ( int j = 0; j < n; ++j )
+            {
+                if ( ! batch.ptype_[j] )
+                {
+                    continue;
+                }
+
+                if ( goalie[index[j]]
+                     && ! ( M_ball_in_penalty_area & ( std::uint64_t( 1 ) << max_step ) ) )
+                {
+#ifdef DEBUG
+                    dlog.addText( Logger::INTERCEPT,
+                                  "FAILURE goalie. final. over the penalty area. bpos=(%.2f %.2f)",
+                                  M_ball_x[max_step], M_ball_y[max_step] );
+#endif
+                    result[index[j]] = 1000;
+                    continue;
+                }
 
-    if ( ! ptype )
+                result[index[j]] = predictFinal( create_data( index[j] ) );
+            }
+
+            n = 0;
+        };
+
+    for ( int i = 0; i < size; ++i )
     {
-        std::cerr << __FILE__ << ' ' << __LINE__
-                  << ": ERROR NULL player type." << std::endl;
-        dlog.addText( Logger::INTERCEPT,
-                      __FILE__": NULL player type. side=%c unum=%d",
-                      side_char( player.side() ), player.unum() );
-        return 1000;
-    }
+        const PlayerObject & player = *players[i];
 
-    const ServerParam & SP = ServerParam::i();
+        if ( player.posCount() >= 10 )
+        {
+            result[i] = 1000;
+            continue;
+        }
 
-    const double pen_area_x = SP.pitchHalfLength() - SP.penaltyAreaLength();
-    const double pen_area_y = SP.penaltyAreaHalfWidth();
+        if ( player.isKickable( 0.0 ) )
+        {
+            result[i] = 0;
+            continue;
+        }
 
-    const PlayerData data( player,
-                           *ptype,
-                           get_pos( player ),
-                           get_vel( player ),
-                           get_control_area( player, wm, goalie ),
-                           get_bonus_step( player, wm.ourSide() ),
-                           get_penalty_step( player ) );
+        if ( ! player.playerTypePtr() )
+        {
+            std::cerr << __FILE__ << ' ' << __LINE__
+                      << ": ERROR NULL player type." << std::endl;
+            dlog.addText( Logger::INTERCEPT,
+                          __FILE__": NULL player type. side=%c unum=%d",
+                          side_char( player.side() ), player.unum() );
+            result[i] = 1000;
+            continue;
+        }
 
-    const int min_step = estimateMinStep( data );
-    const int max_step = M_ball_cache.size() - 1;
+        const PlayerData data = create_data( i );
+        const int min_step = ( min_steps
+                               ? std::max( estimateMinStep( data ), min_steps[i] )
+                               : estimateMinStep( data ) );
 
 #ifdef DEBUG
-    dlog.addText( Logger::INTERCEPT,
-                  "Intercept Player %c %d (%.1f %.1f) - min=%d max=%d pos=(%.1f %.1f) bonus=%d penalty=%d",
-                  side_char( player.side() ),
-                  player.unum(),
-                  player.pos().x, player.pos().y,
-                  min_step, max_step,
-                  data.pos_.x, data.pos_.y,
-                  data.bonus_step_, data.penalty_step_ );
+        dlog.addText( Logger::INTERCEPT,
+                      "Intercept Player %c %d (%.1f %.1f) - min=%d max=%d pos=(%.1f %.1f) bonus=%d penalty=%d",
+                      side_char( player.side() ),
+                      player.unum(),
+                      player.pos().x, player.pos().y,
+                      min_step, max_step,
+                      data.pos_.x, data.pos_.y,
+                      data.bonus_step_, data.penalty_step_ );
 #endif
 
-    if ( min_step > max_step )
-    {
-        return predictFinal( data );
+        if ( min_step > max_step )
+        {
+            result[i] = predictFinal( data );
+            continue;
+        }
+
+        batch.x_[n] = data.pos_.x;
+        batch.y_[n] = data.pos_.y;
+        batch.vel_x_[n] = data.vel_.x;
+        batch.vel_y_[n] = data.vel_.y;
+        batch.body_x_[n] = player.body().cos();
+        batch.body_y_[n] = player.body().sin();
+        batch.decay_[n] = data.ptype_.playerDecay();
+        batch.decay_pow_[n] = std::pow( data.ptype_.playerDecay(), data.bonus_step_ );
+        batch.inertia_rate_[n] = 1.0 / ( 1.0 - data.ptype_.playerDecay() );
+        batch.control_area_[n] = data.control_area_;
+        batch.speed_max_[n] = data.ptype_.realSpeedMax();
+        batch.step_offset_[n] = data.bonus_step_ - data.penalty_step_;
+        batch.ptype_[n] = &data.ptype_;
+        batch.dash_offset_[n] = data.bonus_step_ - data.penalty_step_;
+        batch.turn_dash_offset_[n] = std::max( 0, data.bonus_step_ - 1 ) - 1 - data.penalty_step_;
+        batch.min_step_[n] = min_step;
+        index[n] = i;
+        ++n;
+
+        if ( n == BATCH_SIZE )
+        {
+            flush();
+        }
     }
 
-    for ( int total_step = min_step; total_step < max_step; ++total_step )
+    if ( n > 0 )
     {
-        const Vector2D & ball_pos = M_ball_cache[total_step];
-#ifdef DEBUG2
-        dlog.addText( Logger::INTERCEPT,
-                      "*** step=%d  ball(%.2f %.2f)",
-                      total_step, ball_pos.x, ball_pos.y );
-#endif
+        flush();
+    }
+}
 
-        if ( goalie
-             && ( ball_pos.absX() < pen_area_x
-                  || pen_area_y < ball_pos.absY() ) )
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+InterceptSimulatorPlayer::checkReachableSteps( Batch & batch,
+                                               const int first_step,
+                                               const int last_step ) const
+{
+    for ( int i = 0; i < BATCH_SIZE; ++i )
+    {
+        batch.reachable_[i] = 0;
+
+        //
+        // n_dash in canReachAfterDash() never exceeds (step + bonus - penalty),
+        // or (step + max(0, bonus - 1) - 1 - penalty) if the player needs to turn.
+        // cyclesToReachDistance() is the inverse of getMovableDistance().
+        //
+        if ( ! batch.ptype_[i] )
         {
-            // never reach
-#ifdef DEBUG2
-            dlog.addText( Logger::INTERCEPT,
-                          "--->cycle=%d goalie. out of penalty area. ball(%.2f %.2f)",
-                          total_step, ball_pos.x, ball_pos.y );
-#endif
+            for ( int k = 0; k < CHECK_STEP_SIZE; ++k )
+            {
+                batch.movable_[k][i] = batch.turn_movable_[k][i] = 0.0;
+            }
             continue;
         }
 
-        if ( std::pow( data.control_area_
-                       + data.ptype_.realSpeedMax() * ( total_step + data.bonus_step_ - data.penalty_step_ )
-                       + 0.5, 2 )
-             < data.pos_.dist2( ball_pos ) )
+        const std::vector< double > & table = batch.ptype_[i]->dashDistanceTable();
+        const int table_size = table.size();
+        const double speed_max = batch.ptype_[i]->realSpeedMax();
+        const auto movable = [&]( const int n_dash )
+            {
+                // the same as PlayerType::getMovableDistance()
+                return ( n_dash <= 0 ? 0.0
+                         : n_dash <= table_size ? table[n_dash - 1]
+                         : table.back() + speed_max * ( n_dash - table_size ) );
+            };
+
+        for ( int k = 0; k < CHECK_STEP_SIZE; ++k )
+        {
+            batch.movable_[k][i] = movable( first_step + k + batch.dash_offset_[i] );
+            batch.turn_movable_[k][i] = movable( first_step + k + batch.turn_dash_offset_[i] );
+        }
+    }
+
+    //
+    // all lanes are always computed. the loop over the players has the
+    // fixed length, and it is vectorized by the compiler.
+    //
+    // The player cannot reach the ball if the ball is out of the movable
+    // distance from the player's inertia point. The turn is detected
+    // without the trigonometric functions in the same way as predictTurnCycle().
+    //
+    const double cos_min_turn_margin2 = std::pow( std::cos( 15.0 * AngleDeg::DEG2RAD ), 2 );
+
+    for ( int step = first_step; step < last_step; ++step )
+    {
+        const int k = step - first_step;
+        const double bx = M_ball_x[step];
+        const double by = M_ball_y[step];
+        const std::uint64_t bit = std::uint64_t( 1 ) << step;
+
+        for ( int i = 0; i < BATCH_SIZE; ++i )
+        {
+            const double n_step = step + batch.step_offset_[i];
+            const double reach_radius = ( batch.control_area_[i]
+                                          + batch.speed_max_[i] * n_step
+                                          + 0.5 );
+            const double dx = batch.x_[i] - bx;
+            const double dy = batch.y_[i] - by;
+
+            // ball position relative to the inertia point
+            const double rate = ( 1.0 - batch.decay_pow_[i] ) * batch.inertia_rate_[i];
+            const double ix = bx - ( batch.x_[i] + batch.vel_x_[i] * rate );
+            const double iy = by - ( batch.y_[i] + batch.vel_y_[i] * rate );
+            const double ball_dist2 = ix * ix + iy * iy;
+
+            // the player needs to turn if the ball direction is out of the turn margin.
+            // back dash is always assumed near the boundary of the distance.
+            // all values are compared as squared values with a small margin.
+            double dir = batch.body_x_[i] * ix + batch.body_y_[i] * iy;
+            dir = ( ball_dist2 < 100.01 ? std::fabs( dir ) : dir );
+            const double control2 = batch.control_area_[i] * batch.control_area_[i];
+            const double margin2 = std::min( ball_dist2 * cos_min_turn_margin2,
+                                             ball_dist2 - control2 ) * ( 1.0 - 1.0e-9 );
+            const bool turn = ( ( control2 + 1.0e-6 < ball_dist2 )
+                                & ( ( dir < 0.0 ) | ( dir * dir < margin2 ) ) );
+
+            const double movable = batch.movable_[k][i];
+            const double turn_movable = batch.turn_movable_[k][i];
+            const double dash_radius = ( batch.control_area_[i]
+                                         + ( turn ? turn_movable : movable )
+                                         + 0.01 );
+
+            const std::uint64_t reach_bit = ( reach_radius * reach_radius < dx * dx + dy * dy
+                                              ? std::uint64_t( 0 )
+                                              : bit );
+            const std::uint64_t dash_bit = ( dash_radius * dash_radius < ball_dist2
+                                             ? std::uint64_t( 0 )
+                                             : bit );
+            batch.reachable_[i] |= ( reach_bit & dash_bit );
+            batch.decay_pow_[i] *= batch.decay_[i];
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+int
+InterceptSimulatorPlayer::predictReachStep( const PlayerData & data,
+                                            const std::uint64_t candidates ) const
+{
+    for ( int total_step = 0; total_step < M_ball_size; ++total_step )
+    {
+        if ( ! ( candidates & ( std::uint64_t( 1 ) << total_step ) ) )
         {
-            // never reach
-#ifdef DEBUG2
-            dlog.addText( Logger::INTERCEPT,
-                          "--->step=%d  never reach! ball(%.2f %.2f) dist=%.3f",
-                          total_step, ball_pos.x, ball_pos.y,
-                          data.pos_.dist( ball_pos ) );
-#endif
             continue;
         }
 
+        const Vector2D ball_pos = ballPos( total_step );
+#ifdef DEBUG2
+        dlog.addText( Logger::INTERCEPT,
+                      "*** step=%d  ball(%.2f %.2f)",
+                      total_step, ball_pos.x, ball_pos.y );
+#endif
+
         if ( canReachAfterTurnDash( data,
                                     ball_pos,
                                     total_step ) )
@@ -294,19 +562,7 @@ InterceptSimulatorPlayer::simulate( const WorldModel & wm,
         }
     }
 
-    if ( goalie
-         && ( M_ball_cache.back().absX() < pen_area_x
-              || pen_area_y < M_ball_cache.back().absY() ) )
-    {
-#ifdef DEBUG
-        dlog.addText( Logger::INTERCEPT,
-                      "FAILURE goalie. final. over the penalty area. bpos=(%.2f %.2f)",
-                      M_ball_cache.back().x, M_ball_cache.back().y );
-#endif
-        return 1000;
-    }
-
-    return predictFinal( data );
+    return -1;
 }
 
 /*-------------------------------------------------------------------*/
@@ -316,10 +572,11 @@ InterceptSimulatorPlayer::simulate( const WorldModel & wm,
 int
 InterceptSimulatorPlayer::estimateMinStep( const PlayerData & data ) const
 {
-    Vector2D rel = data.pos_ - M_ball_cache.front();
-    rel.rotate( - M_ball_move_angle );
+    const double rel_x = data.pos_.x - M_ball_x[0];
+    const double rel_y = data.pos_.y - M_ball_y[0];
+    const double rel_abs_y = std::fabs( rel_x * M_rotation_sin + rel_y * M_rotation_cos );
 
-    double move_dist = std::max( 0.3, rel.absY() - data.control_area_ );
+    double move_dist = std::max( 0.3, rel_abs_y - data.control_area_ );
     int step = static_cast< int >( std::floor( move_dist / data.ptype_.realSpeedMax() ) );
     return std::max( 0, step - data.bonus_step_ + data.penalty_step_ );
 }
@@ -341,7 +598,9 @@ InterceptSimulatorPlayer::canReachAfterTurnDash( const PlayerData & data,
       }
     */
 
-    int n_turn = predictTurnCycle( data, ball_pos, total_step );
+    const Vector2D inertia_pos = data.inertiaPoint( total_step );
+
+    int n_turn = predictTurnCycle( data, inertia_pos, ball_pos );
 #ifdef DEBUG2
     dlog.addText( Logger::INTERCEPT,
                   "______ step %d  turn=%d",
@@ -360,6 +619,7 @@ InterceptSimulatorPlayer::canReachAfterTurnDash( const PlayerData & data,
     }
 
     return canReachAfterDash( data,
+                              inertia_pos,
                               ball_pos,
                               total_step,
                               n_turn );
@@ -371,10 +631,9 @@ InterceptSimulatorPlayer::canReachAfterTurnDash( const PlayerData & data,
  */
 int
 InterceptSimulatorPlayer::predictTurnCycle( const PlayerData & data,
-                                            const Vector2D & ball_pos,
-                                            const int total_step ) const
+                                            const Vector2D & inertia_pos,
+                                            const Vector2D & ball_pos ) const
 {
-    Vector2D inertia_pos = data.inertiaPoint( total_step );
     Vector2D ball_rel = ball_pos - inertia_pos;
     double ball_dist = ball_rel.r();
 
@@ -395,8 +654,8 @@ InterceptSimulatorPlayer::predictTurnCycle( const PlayerData & data,
 
 #ifdef DEBUG2
     dlog.addText( Logger::INTERCEPT,
-                  "______ step %d: player=(%.1f %.1f) ball_dist=%.3f angle_diff=%.1f turn_margin=%.1f",
-                  total_step, data.pos_.x, data.pos_.y,//inertia_pos.x, inertia_pos.y,
+                  "______ player=(%.1f %.1f) ball_dist=%.3f angle_diff=%.1f turn_margin=%.1f",
+                  data.pos_.x, data.pos_.y,//inertia_pos.x, inertia_pos.y,
                   ball_dist, angle_diff, turn_margin );
 #endif
 
@@ -427,11 +686,11 @@ InterceptSimulatorPlayer::predictTurnCycle( const PlayerData & data,
  */
 bool
 InterceptSimulatorPlayer::canReachAfterDash( const PlayerData & data,
+                                             const Vector2D & inertia_pos,
                                              const Vector2D & ball_pos,
                                              const int total_step,
                                              const int n_turn ) const
 {
-    Vector2D inertia_pos = data.inertiaPoint( total_step );
     Vector2D ball_rel = ball_pos - inertia_pos;
 
     double dash_dist = ball_rel.r() - data.control_area_;
@@ -483,12 +742,12 @@ InterceptSimulatorPlayer::canReachAfterDash( const PlayerData & data,
 int
 InterceptSimulatorPlayer::predictFinal( const PlayerData & data ) const
 {
-    Vector2D ball_pos = M_ball_cache.back();
-    int ball_step = M_ball_cache.size() - 1;
+    Vector2D ball_pos = ballPos( M_ball_size - 1 );
+    int ball_step = M_ball_size - 1;
 
     Vector2D inertia_pos = data.inertiaPoint( 100 );
 
-    int n_turn = predictTurnCycle( data, ball_pos, 100 );
+    int n_turn = predictTurnCycle( data, inertia_pos, ball_pos );
 
     double dash_dist = inertia_pos.dist( ball_pos ) - data.control_area_;
 
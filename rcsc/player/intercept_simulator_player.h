@@ -33,7 +33,7 @@
 #define RCSC_PLAYER_INTERCEPT_SIMULATOR_PLAYER_H
 
 #include <rcsc/geom/vector_2d.h>
-#include <vector>
+#include <cstdint>
 
 namespace rcsc {
 
@@ -45,10 +45,52 @@ class WorldModel;
 /*!
   \class InterceptSimulatorPlayer
   \brief intercept simulator for other players
+
+  The predicted ball positions and the player states are held in the
+  structure of arrays layout. Players x ball steps are checked by the rough
+  reachability test (the distance to the ball against the movable distance
+  of the player type) in one loop that the compiler can vectorize. Then, the
+  detailed turn & dash simulation is performed only for the remaining steps.
 */
 class InterceptSimulatorPlayer {
+public:
+
+    //! the maximum number of the predicted ball steps
+    static const int MAX_STEP = 50;
+
 private:
 
+    //! the number of players checked in one batch of the rough test
+    static const int BATCH_SIZE = 8;
+    //! the number of ball steps checked at once in the rough test
+    static const int CHECK_STEP_SIZE = 8;
+
+    /*!
+      \struct Batch
+      \brief player variables for the rough reachability test
+     */
+    struct Batch {
+        double x_[BATCH_SIZE]; //!< initial x
+        double y_[BATCH_SIZE]; //!< initial y
+        double control_area_[BATCH_SIZE]; //!< kickable or catchable area
+        double vel_x_[BATCH_SIZE]; //!< initial velocity x
+        double vel_y_[BATCH_SIZE]; //!< initial velocity y
+        double body_x_[BATCH_SIZE]; //!< body direction x
+        double body_y_[BATCH_SIZE]; //!< body direction y
+        double decay_[BATCH_SIZE]; //!< player decay
+        double decay_pow_[BATCH_SIZE]; //!< decay^(step + bonus step) for the current step
+        double inertia_rate_[BATCH_SIZE]; //!< 1 / (1 - decay)
+        double speed_max_[BATCH_SIZE]; //!< max moving distance per step
+        double step_offset_[BATCH_SIZE]; //!< bonus step - penalty step
+        const PlayerType * ptype_[BATCH_SIZE]; //!< player type
+        int dash_offset_[BATCH_SIZE]; //!< max dash step - ball step
+        int turn_dash_offset_[BATCH_SIZE]; //!< max dash step - ball step, if the player needs to turn
+        int min_step_[BATCH_SIZE]; //!< estimated minimum reach step
+        double movable_[CHECK_STEP_SIZE][BATCH_SIZE]; //!< max dash distance at each checked ball step
+        double turn_movable_[CHECK_STEP_SIZE][BATCH_SIZE]; //!< max dash distance at each checked ball step, if the player needs to turn
+        std::uint64_t reachable_[BATCH_SIZE]; //!< result bit mask. n-th bit is set if the ball at step n may be reachable.
+    };
+
     /*!
       \struct PlayerData
       \brief player data
@@ -83,10 +125,20 @@ private:
     };
 
 
-    //! predicted ball positions
-    std::vector< Vector2D > M_ball_cache;
+    //! the number of predicted ball positions
+    int M_ball_size;
+    //! predicted ball x
+    double M_ball_x[MAX_STEP];
+    //! predicted ball y
+    double M_ball_y[MAX_STEP];
+    //! bit mask of the steps when the ball is in the penalty area
+    std::uint64_t M_ball_in_penalty_area;
     //! ball velocity angle
     const AngleDeg M_ball_move_angle;
+    //! cosine of the rotation to the ball velocity coordinate
+    double M_rotation_cos;
+    //! sine of the rotation to the ball velocity coordinate
+    double M_rotation_sin;
 
     // not used
     InterceptSimulatorPlayer() = delete;
@@ -120,8 +172,64 @@ public:
                   const PlayerObject & player,
                   const bool goalie ) const;
 
+    /*!
+      \brief get predicted ball gettable cycles of several players
+      \param wm const reference to the instance of world model
+      \param players array of the player objects
+      \param goalie array of goalie mode flags
+      \param size the number of players
+      \param result array to store the predicted cycles
+      \param min_steps array of the known lower bounds of the cycles, or NULL
+    */
+    void simulate( const WorldModel & wm,
+                   const PlayerObject * const * players,
+                   const bool * goalie,
+                   const int size,
+                   int * result,
+                   const int * min_steps = nullptr ) const;
+
+    /*!
+      \brief get the number of the predicted ball positions
+      \return the size of the ball cache
+     */
+    int ballCacheSize() const
+      {
+          return M_ball_size;
+      }
+
 private:
 
+    /*!
+      \brief get the predicted ball position
+      \param step ball step
+      \return ball position
+     */
+    Vector2D ballPos( const int step ) const
+      {
+          return Vector2D( M_ball_x[step], M_ball_y[step] );
+      }
+
+    /*!
+      \brief check the rough reachability of all players in the batch at the ball steps
+      [first_step, last_step). Both the distance from the initial position and the
+      distance from the inertia point are compared with the max moving distance.
+      \param batch player variables and the result
+      \param first_step the first ball step to be checked
+      \param last_step the ball step after the last step to be checked
+     */
+    void checkReachableSteps( Batch & batch,
+                              const int first_step,
+                              const int last_step ) const;
+
+    /*!
+      \brief get the first ball step that the player can reach
+      \param data player data
+      \param candidates bit mask of the ball steps to be checked
+      \return the reachable step, or -1 if the player cannot reach any step
+     */
+    int predictReachStep( const PlayerData & data,
+                          const std::uint64_t candidates ) const;
+
     /*!
       \brief create predicted ball positions
       \param ball_pos initial ball position
@@ -155,16 +263,14 @@ private:
 
     /*!
       \brief predict required cycle to face to the ball position
-      \param cycle we consder the status 'cycle' cycles later
-      \param player const reference to the player object
-      \param player_type player type parameter
-      \param control_area player's ball controllable radius
-      \param ball_pos ball position 'cycle' cycles later
+      \param data player data
+      \param inertia_pos player's inertia point at the target step
+      \param ball_pos ball position at the target step
       \return predicted cycle value
     */
     int predictTurnCycle( const PlayerData & data,
-                          const Vector2D & ball_pos,
-                          const int total_step ) const;
+                          const Vector2D & inertia_pos,
+                          const Vector2D & ball_pos ) const;
 
     /*!
       \brief check if player can reach by n_dash dashes
@@ -173,10 +279,12 @@ private:
       \param player const reference to the player object
       \param player_type player type parameter
       \param control_area player's ball controllable radius
+      \param inertia_pos player's inertia point at total_step
       \param ball_pos ball position 'cycle' cycles later
       \return true if player can get the ball
     */
     bool canReachAfterDash( const PlayerData & data,
+                            const Vector2D & inertia_pos,
                             const Vector2D & ball_pos,
                             const int total_step,
                             const int n_turn ) const;
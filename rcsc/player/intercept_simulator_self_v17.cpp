@@ -44,6 +44,7 @@
 #include <rcsc/common/stamina_model.h>
 #include <rcsc/common/server_param.h>
 #include <rcsc/common/player_type.h>
+#include <rcsc/common/reach_step_table.h>
 #include <rcsc/geom/matrix_2d.h>
 #include <rcsc/geom/segment_2d.h>
 #include <rcsc/geom/vector_2d.h>
@@ -66,6 +67,8 @@ namespace {
 const double CONTROL_BUF = 0.15;
 const double BALL_NOISE_RATE = 0.25;
 const int BACK_DASH_COUNT_THR = 5;
+const double TURN_MARGIN_MIN = 12.5;
+const size_t MAX_DASH_ANGLE_DIVS = 72; // 360 / (min dash angle step = 5)
 
 #ifdef DEBUG_PRINT_RESULTS
 /*-------------------------------------------------------------------*/
@@ -1011,7 +1014,7 @@ simulate_turn_step( const WorldModel & wm,
         if ( back_dash ) dash_angle += 180.0;
 
         const AngleDeg target_angle = inertia_rel.th();
-        const double turn_margin = std::max( 12.5, // Magic Number
+        const double turn_margin = std::max( TURN_MARGIN_MIN,
                                              AngleDeg::asin_deg( control_area / inertia_dist ) );
 
         double angle_diff = ( target_angle - dash_angle ).abs();
@@ -1046,6 +1049,80 @@ simulate_turn_step( const WorldModel & wm,
 
     return n_turn;
 }
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief get the lower bound of the turn-dash step by the reach step table
+ */
+int
+estimate_turn_dash_step( const ReachStepTable & table,
+                         const WorldModel & wm,
+                         const Vector2D & ball_pos,
+                         const double control_area,
+                         const int move_step,
+                         const bool back_dash )
+{
+    const Vector2D inertia_self_pos = wm.self().inertiaPoint( move_step );
+    const Vector2D inertia_rel = ball_pos - inertia_self_pos;
+    const double inertia_dist = inertia_rel.r();
+    const double inertia_move = wm.self().pos().dist( inertia_self_pos );
+
+    //
+    // getTurnDash() accepts the player that reaches the control area,
+    // that passes the ball along the dash direction, or that moves farther
+    // than the ball. The dash direction is within the turn margin.
+    //
+    const double dash_dist = std::min( inertia_dist - control_area,
+                                       inertia_dist * std::cos( TURN_MARGIN_MIN * AngleDeg::DEG2RAD )
+                                       - inertia_move * 2.0 );
+
+    double turn_angle = 0.0;
+    if ( control_area < inertia_dist )
+    {
+        const AngleDeg dash_angle = ( back_dash
+                                      ? wm.self().body() + 180.0
+                                      : wm.self().body() );
+        const double turn_margin = std::max( TURN_MARGIN_MIN,
+                                             AngleDeg::asin_deg( control_area / inertia_dist ) );
+        turn_angle = ( inertia_rel.th() - dash_angle ).abs() - turn_margin;
+    }
+
+    return table.minStep( wm.self().playerType().id(),
+                          dash_dist,
+                          turn_angle,
+                          wm.self().stamina() );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief get the lower bound of the omni-dash step by the reach step table
+ */
+int
+estimate_omni_dash_step( const ReachStepTable & table,
+                         const WorldModel & wm,
+                         const Vector2D & ball_pos,
+                         const double control_area,
+                         const int move_step )
+{
+    const Vector2D inertia_self_pos = wm.self().inertiaPoint( move_step );
+    const double inertia_move = wm.self().pos().dist( inertia_self_pos );
+
+    //
+    // the omni-dash is accepted in the middle of the dashes, and the player
+    // is also accepted if the player moves farther than the ball.
+    // the dash direction is not restricted.
+    //
+    const double dash_dist = ( ball_pos.dist( inertia_self_pos )
+                               - inertia_move
+                               - std::max( { control_area,
+                                             wm.self().playerType().kickableArea(),
+                                             inertia_move } ) );
+
+    return table.minStep( wm.self().playerType().id(),
+                          dash_dist,
+                          0.0,
+                          wm.self().stamina() );
+}
 }
 
 /*-------------------------------------------------------------------*/
@@ -1061,6 +1138,7 @@ InterceptSimulatorSelfV17::simulateTurnDash( const WorldModel & wm,
     const ServerParam & SP = ServerParam::i();
     const PlayerType & ptype = wm.self().playerType();
     const int min_step = get_min_step( wm, ballVel() );
+    const std::shared_ptr< const ReachStepTable > reach_table = PlayerTypeSet::i().reachStepTable();
 
     //Vector2D ball_pos = wm.ball().inertiaPoint( min_step - 1 );
     Vector2D ball_pos = inertia_n_step_point( wm.ball().pos(), ballVel(), min_step - 1, SP.ballDecay() );
@@ -1109,6 +1187,17 @@ InterceptSimulatorSelfV17::simulateTurnDash( const WorldModel & wm,
             continue;
         }
 
+        if ( reach_table
+             && estimate_turn_dash_step( *reach_table, wm, ball_pos, control_area, step, back_dash ) > step )
+        {
+#ifdef DEBUG_PRINT_TURN_DASH
+            dlog.addText( Logger::INTERCEPT,
+                          "%d: XX never reach. reach step table",
+                          step );
+#endif
+            continue;
+        }
+
         Intercept info = getTurnDash( wm, ball_pos, control_area, ball_noise, step, back_dash );
         if ( info.isValid() )
         {
@@ -1313,6 +1402,7 @@ InterceptSimulatorSelfV17::simulateOmniDashAny( const WorldModel & wm,
     const Matrix2D rotate_matrix = Matrix2D::make_rotation( -wm.self().body() );
     //const double first_ball_speed = wm.ball().vel().r();
     const double first_ball_speed = ballVel().r();
+    const std::shared_ptr< const ReachStepTable > reach_table = PlayerTypeSet::i().reachStepTable();
 
 #ifdef DEBUG_PRINT_OMNI_DASH
     dlog.addText( Logger::INTERCEPT,
@@ -1346,6 +1436,12 @@ InterceptSimulatorSelfV17::simulateOmniDashAny( const WorldModel & wm,
             continue;
         }
 
+        if ( reach_table
+             && estimate_omni_dash_step( *reach_table, wm, ball_pos, control_area, ball_step ) > ball_step )
+        {
+            continue;
+        }
+
         //const AngleDeg accel_angle = ( ball_pos - self_inertia ).th();
 
         double first_dash_power = 0.0;
@@ -1433,7 +1529,8 @@ InterceptSimulatorSelfV17::simulateOmniDashOld( const WorldModel & wm,
 {
     const ServerParam & SP = ServerParam::i();
     const double dash_angle_step = std::max( 5.0, SP.dashAngleStep() );
-    const size_t dash_angle_divs = static_cast< size_t >( std::floor( 360.0 / dash_angle_step ) );
+    const size_t dash_angle_divs = std::min( MAX_DASH_ANGLE_DIVS,
+                                             static_cast< size_t >( std::floor( 360.0 / dash_angle_step ) ) );
 
     const PlayerType & ptype = wm.self().playerType();
     const double max_side_speed = ( SP.maxDashPower()
@@ -1442,16 +1539,10 @@ InterceptSimulatorSelfV17::simulateOmniDashOld( const WorldModel & wm,
                                     * SP.dashDirRate( 90.0 ) ) / ( 1.0 - ptype.playerDecay() );
     const Matrix2D rotate_matrix = Matrix2D::make_rotation( -wm.self().body() );
 
-    std::vector< double > dash_powers;
-    std::vector< double > dash_base_rates;
-    std::vector< AngleDeg > accel_angles;
-    std::vector< Matrix2D > accel_rot_matrix;
-    std::vector< Matrix2D > accel_inv_matrix;
-    dash_powers.reserve( dash_angle_divs );
-    dash_base_rates.reserve( dash_angle_divs );
-    accel_angles.reserve( dash_angle_divs );
-    accel_rot_matrix.reserve( dash_angle_divs );
-    accel_inv_matrix.reserve( dash_angle_divs );
+    double dash_powers[MAX_DASH_ANGLE_DIVS];
+    double dash_base_rates[MAX_DASH_ANGLE_DIVS];
+    Matrix2D accel_rot_matrix[MAX_DASH_ANGLE_DIVS];
+    Matrix2D accel_inv_matrix[MAX_DASH_ANGLE_DIVS];
 
     for ( size_t d = 0; d < dash_angle_divs; ++d )
     {
@@ -1462,23 +1553,23 @@ InterceptSimulatorSelfV17::simulateOmniDashOld( const WorldModel & wm,
         if ( std::fabs( forward_dash_rate * SP.maxDashPower() )
              > std::fabs( back_dash_rate * SP.minDashPower() ) - 0.001 )
         {
-            dash_powers.push_back( SP.maxDashPower() );
-            dash_base_rates.push_back( ptype.dashPowerRate() * forward_dash_rate );
+            dash_powers[d] = SP.maxDashPower();
+            dash_base_rates[d] = ptype.dashPowerRate() * forward_dash_rate;
         }
         else
         {
-            dash_powers.push_back( SP.minDashPower() );
-            dash_base_rates.push_back( ptype.dashPowerRate() * back_dash_rate );
+            dash_powers[d] = SP.minDashPower();
+            dash_base_rates[d] = ptype.dashPowerRate() * back_dash_rate;
         }
-        accel_angles.push_back( accel_angle );
-        accel_rot_matrix.push_back( Matrix2D::make_rotation( -accel_angle ) );
-        accel_inv_matrix.push_back( Matrix2D::make_rotation( accel_angle ) );
+        accel_rot_matrix[d] = Matrix2D::make_rotation( -accel_angle );
+        accel_inv_matrix[d] = Matrix2D::make_rotation( accel_angle );
     }
 
     //
     // simulation loop
     //
     const double first_ball_speed = ballVel().r();
+    const std::shared_ptr< const ReachStepTable > reach_table = PlayerTypeSet::i().reachStepTable();
 
 #ifdef DEBUG_PRINT_OMNI_DASH
     dlog.addText( Logger::INTERCEPT,
@@ -1535,6 +1626,12 @@ InterceptSimulatorSelfV17::simulateOmniDashOld( const WorldModel & wm,
             last_y_diff = ball_rel.absY();
         }
 
+        if ( reach_table
+             && estimate_omni_dash_step( *reach_table, wm, ball_pos, control_area, reach_step ) > reach_step )
+        {
+            continue;
+        }
+
         const double ball_noise = ( first_ball_speed * std::pow( SP.ballDecay(), reach_step - 1 )
                                     * SP.ballRand()
                                     * BALL_NOISE_RATE );
@@ -48,6 +48,7 @@
 #include <rcsc/game_time.h>
 
 #include <algorithm>
+#include <cmath>
 
 // #define DEBUG_PRINT
 
@@ -55,16 +56,42 @@ namespace rcsc {
 
 namespace {
 const int MAX_STEP = 50;
+const int MAX_TARGET = PlayerObjectPool::CAPACITY * 2; //!< players and their goalie mode entries
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief check if the accuracy count was only incremented by the world model update
+  \param last_count the count in the last cycle
+  \param count the count in this cycle
+  \return true if no new information was received
+ */
+inline
+bool
+is_advanced( const int last_count,
+             const int count )
+{
+    return count == std::min( 1000, last_count + 1 );
 }
 
+}
+
+bool InterceptTable::S_incremental = false;
+bool InterceptTable::S_validate = false;
+
 /*-------------------------------------------------------------------*/
 /*!
 
 */
 InterceptTable::InterceptTable()
-    : M_update_time( 0, 0 )
+    : M_update_time( 0, 0 ),
+      M_reuse_records( false ),
+      M_record_time( -1, 0 ),
+      M_record_ball_size( 0 )
 {
     M_self_results.reserve( ( MAX_STEP + 1 ) * 2 );
+    M_records.reserve( MAX_TARGET * 2 );
+    M_last_records.reserve( MAX_TARGET * 2 );
+    M_spare_player_nodes.reserve( MAX_TARGET );
 
     clear();
 }
@@ -72,6 +99,18 @@ InterceptTable::InterceptTable()
 /*-------------------------------------------------------------------*/
 /*!
 
+*/
+void
+InterceptTable::set_update_mode( const bool incremental,
+                                 const bool validate )
+{
+    S_incremental = incremental;
+    S_validate = validate;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
 */
 void
 InterceptTable::clear()
@@ -91,7 +130,38 @@ InterceptTable::clear()
 
     M_self_results.clear();
 
-    M_player_map.clear();
+    while ( ! M_player_map.empty() )
+    {
+        M_spare_player_nodes.push_back( M_player_map.extract( M_player_map.begin() ) );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+InterceptTable::setPlayerStep( const AbstractPlayerObject * p,
+                               const int step )
+{
+    std::map< const AbstractPlayerObject *, int >::iterator it = M_player_map.find( p );
+    if ( it != M_player_map.end() )
+    {
+        it->second = step;
+        return;
+    }
+
+    if ( M_spare_player_nodes.empty() )
+    {
+        M_player_map.emplace( p, step );
+        return;
+    }
+
+    std::map< const AbstractPlayerObject *, int >::node_type node = std::move( M_spare_player_nodes.back() );
+    M_spare_player_nodes.pop_back();
+    node.key() = p;
+    node.mapped() = step;
+    M_player_map.insert( std::move( node ) );
 }
 
 /*-------------------------------------------------------------------*/
@@ -116,6 +186,11 @@ InterceptTable::update( const WorldModel & wm )
     // clear all data
     this->clear();
 
+    M_reuse_records = ( S_incremental
+                        && canReuseRecords( wm ) );
+    M_last_records.swap( M_records );
+    M_records.clear();
+
     // playmode check
     if ( wm.gameMode().type() == GameMode::TimeOver
          || wm.gameMode().type() == GameMode::BeforeKickOff )
@@ -162,6 +237,15 @@ InterceptTable::update( const WorldModel & wm )
 
     predictTeammate( wm );
 
+    if ( ! wm.self().isKickable()
+         && ! wm.kickableTeammate()
+         && ! wm.kickableOpponent() )
+    {
+        M_record_time = wm.time();
+        M_record_ball_pos = wm.ball().pos();
+        M_record_ball_vel = wm.ball().vel();
+    }
+
     dlog.addText( Logger::INTERCEPT,
                   "<-----Intercept Self reach step = %d. exhaust reach step = %d ",
                   M_self_step,
@@ -247,7 +331,7 @@ InterceptTable::hearTeammate( const WorldModel & wm,
         M_first_teammate = target;
         M_teammate_step = step;
 
-        M_player_map[ target ] = step;
+        setPlayerStep( target, step );
 
         dlog.addText( Logger::INTERCEPT,
                       "<----- Hear Intercept Teammate  fastest reach step = %d."
@@ -309,7 +393,7 @@ InterceptTable::hearOpponent( const WorldModel & wm,
         M_first_opponent = p;
         M_opponent_step = step;
 
-        M_player_map[ p ] = step;
+        setPlayerStep( p, step );
 
         dlog.addText( Logger::INTERCEPT,
                       "<----- Hear Intercept Opponent  fastest reach step = %d."
@@ -339,8 +423,8 @@ InterceptTable::predictSelf( const WorldModel & wm )
 
     constexpr int max_step = 50;
 
-    std::shared_ptr< InterceptSimulatorSelf > sim( new InterceptSimulatorSelfV17() );
-    sim->simulate( wm, max_step, M_self_results );
+    InterceptSimulatorSelfV17 sim;
+    sim.simulate( wm, max_step, M_self_results );
 
     if ( M_self_results.empty() )
     {
@@ -410,14 +494,44 @@ InterceptTable::predictTeammate( const WorldModel & wm )
                       M_first_teammate->pos().x, M_first_teammate->pos().y );
     }
 
-    InterceptSimulatorPlayer sim( wm.ball().pos(),
-                                  ( wm.kickableOpponent() ? Vector2D( 0.0, 0.0 ) : wm.ball().vel() ) );
+    //
+    // simulate all target players at once
+    //
+    const PlayerObject * players[MAX_TARGET];
+    bool goalie[MAX_TARGET];
+    int steps[MAX_TARGET];
+    int size = 0;
+
+    for ( const PlayerObject * t : wm.teammatesFromBall() )
+    {
+        if ( t == wm.kickableTeammate()
+             || t->posCount() >= 10
+             || size + 2 > MAX_TARGET )
+        {
+            continue;
+        }
+
+        players[size] = t;
+        goalie[size] = false;
+        ++size;
+        if ( t->goalie() )
+        {
+            players[size] = t;
+            goalie[size] = true;
+            ++size;
+        }
+    }
+
+    simulatePlayers( wm,
+                     ( wm.kickableOpponent() ? Vector2D( 0.0, 0.0 ) : wm.ball().vel() ),
+                     players, goalie, size, steps );
 
+    int index = 0;
     for ( const PlayerObject * t : wm.teammatesFromBall() )
     {
         if ( t == wm.kickableTeammate() )
         {
-            M_player_map[ t ] = 0;
+            setPlayerStep( t, 0 );
             continue;
         }
 
@@ -431,10 +545,16 @@ InterceptTable::predictTeammate( const WorldModel & wm )
             continue;
         }
 
-        int step = sim.simulate( wm, *t, false );
+        if ( index >= size
+             || players[index] != t )
+        {
+            continue;
+        }
+
+        int step = steps[index++];
         if ( t->goalie() )
         {
-            M_our_goalie_step = sim.simulate( wm, *t, true );
+            M_our_goalie_step = steps[index++];
             if ( step > M_our_goalie_step )
             {
                 step = M_our_goalie_step;
@@ -459,7 +579,7 @@ InterceptTable::predictTeammate( const WorldModel & wm )
             }
         }
 
-        M_player_map[ t ] = step;
+        setPlayerStep( t, step );
     }
 
     if ( M_second_teammate && second_min_step < 1000 )
@@ -497,14 +617,44 @@ InterceptTable::predictOpponent( const WorldModel & wm )
                       M_first_opponent->pos().x, M_first_opponent->pos().y );
     }
 
-    InterceptSimulatorPlayer sim( wm.ball().pos(),
-                                  ( wm.kickableOpponent() ? Vector2D( 0.0, 0.0 ) : wm.ball().vel() ) );
+    //
+    // simulate all target players at once
+    //
+    const PlayerObject * players[MAX_TARGET];
+    bool goalie[MAX_TARGET];
+    int steps[MAX_TARGET];
+    int size = 0;
 
+    for ( const PlayerObject * o : wm.opponentsFromBall() )
+    {
+        if ( o == wm.kickableOpponent()
+             || o->posCount() >= 15
+             || size + 2 > MAX_TARGET )
+        {
+            continue;
+        }
+
+        players[size] = o;
+        goalie[size] = false;
+        ++size;
+        if ( o->goalie() )
+        {
+            players[size] = o;
+            goalie[size] = true;
+            ++size;
+        }
+    }
+
+    simulatePlayers( wm,
+                     ( wm.kickableOpponent() ? Vector2D( 0.0, 0.0 ) : wm.ball().vel() ),
+                     players, goalie, size, steps );
+
+    int index = 0;
     for ( const PlayerObject * o : wm.opponentsFromBall() )
     {
         if ( o == wm.kickableOpponent() )
         {
-            M_player_map[ o ] = 0;
+            setPlayerStep( o, 0 );
             continue;
         }
 
@@ -518,10 +668,16 @@ InterceptTable::predictOpponent( const WorldModel & wm )
             continue;
         }
 
-        int step = sim.simulate( wm, *o, false );
+        if ( index >= size
+             || players[index] != o )
+        {
+            continue;
+        }
+
+        int step = steps[index++];
         if ( o->goalie() )
         {
-            int goalie_step = sim.simulate( wm, *o, true );
+            int goalie_step = steps[index++];
             if ( goalie_step > 0
                  && step > goalie_step )
             {
@@ -547,7 +703,7 @@ InterceptTable::predictOpponent( const WorldModel & wm )
             }
         }
 
-        M_player_map[ o ] = step;
+        setPlayerStep( o, step );
     }
 
     if ( M_second_opponent && second_min_step < 1000 )
@@ -561,4 +717,179 @@ InterceptTable::predictOpponent( const WorldModel & wm )
     }
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+bool
+InterceptTable::canReuseRecords( const WorldModel & wm ) const
+{
+    if ( M_records.empty()
+         || M_record_time.stopped() != 0
+         || wm.time().stopped() != 0
+         || M_record_time.cycle() + 1 != wm.time().cycle() )
+    {
+        return false;
+    }
+
+    if ( wm.gameMode().type() != GameMode::PlayOn
+         || wm.self().isKickable()
+         || wm.kickableTeammate()
+         || wm.kickableOpponent() )
+    {
+        return false;
+    }
+
+    // the ball must be on the trajectory predicted in the last cycle
+    const Vector2D ball_pos = M_record_ball_pos + M_record_ball_vel;
+    const Vector2D ball_vel = M_record_ball_vel * ServerParam::i().ballDecay();
+
+    if ( wm.ball().pos().dist2( ball_pos ) > std::pow( 1.0e-6, 2 )
+         || wm.ball().vel().dist2( ball_vel ) > std::pow( 1.0e-6, 2 ) )
+    {
+        dlog.addText( Logger::INTERCEPT,
+                      __FILE__" (canReuseRecords) ball is not on the predicted trajectory" );
+        return false;
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+int
+InterceptTable::getShiftedStep( const PlayerObject & player,
+                                const bool goalie ) const
+{
+    if ( ! M_reuse_records )
+    {
+        return 0;
+    }
+
+    for ( const PlayerRecord & r : M_last_records )
+    {
+        if ( r.player_ != &player
+             || r.goalie_ != goalie )
+        {
+            continue;
+        }
+
+        // new see/hear information, or the bonus step for the
+        // position accuracy is not fixed yet.
+        if ( r.id_ != player.id()
+             || r.player_type_ != player.playerTypePtr()
+             || player.isTackling()
+             || ! is_advanced( r.pos_count_, player.posCount() )
+             || ! is_advanced( r.seen_pos_count_, player.seenPosCount() )
+             || ! is_advanced( r.heard_pos_count_, player.heardPosCount() )
+             || ! is_advanced( r.vel_count_, player.velCount() )
+             || ! is_advanced( r.seen_vel_count_, player.seenVelCount() )
+             || ! is_advanced( r.body_count_, player.bodyCount() )
+             || std::min( r.seen_pos_count_, r.heard_pos_count_ ) < 3 )
+        {
+            return 0;
+        }
+
+        //
+        // The simulated state of the player is not changed, and the ball
+        // trajectory of this cycle is the last one without the first step.
+        // If the player could reach the ball in n steps in this cycle,
+        // the player could reach the same point in (n + 1) steps in the last cycle.
+        // The result of the last cycle beyond the ball cache is not reliable.
+        //
+        return std::max( 0, std::min( r.step_, M_record_ball_size - 1 ) - 1 );
+    }
+
+    return 0;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+InterceptTable::simulatePlayers( const WorldModel & wm,
+                                 const Vector2D & ball_vel,
+                                 const PlayerObject * const * players,
+                                 const bool * goalie,
+                                 const int size,
+                                 int * steps )
+{
+    const InterceptSimulatorPlayer sim( wm.ball().pos(), ball_vel );
+
+    int min_steps[MAX_TARGET];
+    int shifted = 0;
+
+    for ( int i = 0; i < size; ++i )
+    {
+        min_steps[i] = getShiftedStep( *players[i], goalie[i] );
+        if ( min_steps[i] > 0 )
+        {
+            ++shifted;
+        }
+    }
+
+    sim.simulate( wm, players, goalie, size, steps,
+                  ( shifted > 0 ? min_steps : nullptr ) );
+
+    if ( M_reuse_records )
+    {
+        dlog.addText( Logger::INTERCEPT,
+                      __FILE__" (simulatePlayers) shifted %d/%d",
+                      shifted, size );
+    }
+
+    //
+    // validation. compare the results with the results from scratch.
+    //
+    if ( S_validate
+         && shifted > 0 )
+    {
+        int full_steps[MAX_TARGET];
+        sim.simulate( wm, players, goalie, size, full_steps );
+
+        for ( int i = 0; i < size; ++i )
+        {
+            if ( steps[i] != full_steps[i] )
+            {
+                std::cerr << wm.self().unum() << ' '
+                          << wm.time()
+                          << ": (InterceptTable::simulatePlayers) mismatch. player "
+                          << side_char( players[i]->side() ) << players[i]->unum()
+                          << ( goalie[i] ? " (goalie)" : "" )
+                          << " min_step=" << min_steps[i]
+                          << " incremental=" << steps[i]
+                          << " full=" << full_steps[i]
+                          << std::endl;
+                dlog.addText( Logger::INTERCEPT,
+                              __FILE__" (simulatePlayers) mismatch. player %c %d goalie=%d"
+                              " min_step=%d incremental=%d full=%d",
+                              side_char( players[i]->side() ), players[i]->unum(),
+                              goalie[i] ? 1 : 0,
+                              min_steps[i], steps[i], full_steps[i] );
+            }
+        }
+    }
+
+    M_record_ball_size = sim.ballCacheSize();
+
+    for ( int i = 0; i < size; ++i )
+    {
+        const PlayerObject & p = *players[i];
+        M_records.push_back( PlayerRecord{ &p,
+                                           p.id(),
+                                           p.playerTypePtr(),
+                                           goalie[i],
+                                           p.posCount(),
+                                           p.seenPosCount(),
+                                           p.heardPosCount(),
+                                           p.velCount(),
+                                           p.seenVelCount(),
+                                           p.bodyCount(),
+                                           steps[i] } );
+    }
+}
+
 }
@@ -42,6 +42,7 @@ namespace rcsc {
 
 class AbstractPlayerObject;
 class PlayerObject;
+class PlayerType;
 class WorldModel;
 
 /*-------------------------------------------------------------------*/
@@ -49,10 +50,40 @@ class WorldModel;
 /*!
   \class InterceptTable
   \brief interception info holder for all players
+
+  In the incremental mode, the results of other players in the last cycle
+  are reused if the ball is moving on the predicted trajectory and the
+  player has received no new see/hear information. The last result shifted
+  by one cycle is the lower bound of the result, and the simulation starts
+  from that step. In the validation mode, such players are also simulated
+  from scratch and the mismatches are reported.
 */
 class InterceptTable {
 private:
 
+    /*!
+      \struct PlayerRecord
+      \brief the simulation result and the observation counts of the player
+    */
+    struct PlayerRecord {
+        const PlayerObject * player_; //!< player pointer
+        int id_; //!< player object id
+        const PlayerType * player_type_; //!< player type
+        bool goalie_; //!< simulated as goalie or not
+        int pos_count_; //!< position accuracy count
+        int seen_pos_count_; //!< seen position accuracy count
+        int heard_pos_count_; //!< heard position accuracy count
+        int vel_count_; //!< velocity accuracy count
+        int seen_vel_count_; //!< seen velocity accuracy count
+        int body_count_; //!< body angle accuracy count
+        int step_; //!< simulated step
+    };
+
+    //! if true, the results of other players are reused in the next cycle
+    static bool S_incremental;
+    //! if true, the reused results are compared with the results from scratch
+    static bool S_validate;
+
     //! last updated time
     GameTime M_update_time;
 
@@ -85,6 +116,23 @@ private:
 
     //! all players' intercept step container. key: pointer, value: step value
     std::map< const AbstractPlayerObject *, int > M_player_map;
+    //! the nodes removed from M_player_map, reused to avoid the reallocation in every cycle
+    std::vector< std::map< const AbstractPlayerObject *, int >::node_type > M_spare_player_nodes;
+
+    //! true if the records of the last cycle can be reused in this cycle
+    bool M_reuse_records;
+    //! the time when M_records were created
+    GameTime M_record_time;
+    //! the ball position when M_records were created
+    Vector2D M_record_ball_pos;
+    //! the ball velocity when M_records were created
+    Vector2D M_record_ball_vel;
+    //! the size of the ball cache when M_records were created
+    int M_record_ball_size;
+    //! the simulation results in this cycle
+    std::vector< PlayerRecord > M_records;
+    //! the simulation results in the last cycle
+    std::vector< PlayerRecord > M_last_records;
 
     // not used
     InterceptTable( const InterceptTable & ) = delete;
@@ -103,6 +151,15 @@ public:
     ~InterceptTable()
       { }
 
+    /*!
+      \brief set the update mode of all tables
+      \param incremental if true, the results of other players are reused in the next cycle
+      \param validate if true, the reused results are compared with the results from scratch
+     */
+    static
+    void set_update_mode( const bool incremental,
+                          const bool validate );
+
     /*!
       \brief update table information
       \param wm const reference to the world model
@@ -223,6 +280,14 @@ private:
     */
     void clear();
 
+    /*!
+      \brief set the intercept step of the player to the player map
+      \param p target player
+      \param step intercept step
+    */
+    void setPlayerStep( const AbstractPlayerObject * p,
+                        const int step );
+
     /*!
       \brief predict self interception
       \param wm const reference to the world model
@@ -240,6 +305,38 @@ private:
       \param wm const reference to the world model
     */
     void predictOpponent( const WorldModel & wm );
+
+    /*!
+      \brief check if the records of the last cycle can be reused
+      \param wm const reference to the world model
+      \return true if the ball is moving on the predicted trajectory
+     */
+    bool canReuseRecords( const WorldModel & wm ) const;
+
+    /*!
+      \brief get the lower bound of the step from the result of the last cycle
+      \param player target player
+      \param goalie goalie mode or not
+      \return the lower bound of the step. 0 if the last result is not available.
+     */
+    int getShiftedStep( const PlayerObject & player,
+                        const bool goalie ) const;
+
+    /*!
+      \brief simulate players with the results of the last cycle
+      \param wm const reference to the world model
+      \param ball_vel ball velocity used by the simulation
+      \param players array of the target players
+      \param goalie array of the goalie mode flags
+      \param size the number of target players
+      \param steps array to store the results
+     */
+    void simulatePlayers( const WorldModel & wm,
+                          const Vector2D & ball_vel,
+                          const PlayerObject * const * players,
+                          const bool * goalie,
+                          const int size,
+                          int * steps );
 };
 
 }
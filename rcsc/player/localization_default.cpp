@@ -47,6 +47,7 @@
 
 #include <algorithm>
 #include <random>
+#include <cmath>
 
 using std::min;
 using std::max;
@@ -59,7 +60,21 @@ using std::max;
 #define USE_OBJECT_TABLE
 
 namespace {
-static int g_filter_count = 0;
+thread_local int g_filter_count = 0;
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief get the object table shared by all agents in the process.
+  the table is never modified after the construction.
+  \return const reference to the table instance
+ */
+const rcsc::ObjectTable &
+shared_object_table()
+{
+    static const rcsc::ObjectTable s_table;
+    return s_table;
+}
+
 }
 
 namespace rcsc {
@@ -72,20 +87,49 @@ class LocalizationDefault::Impl {
 
 private:
 
-    //! object distance table
-    ObjectTable M_object_table;
+    //! the maximum number of candidate points. see generatePoints().
+    static const std::size_t MAX_POINTS = 32 * 16;
+
+    //! object distance table shared by all agents
+    const ObjectTable & M_object_table;
+
+    //! random engine used by resamplePoints()
+    std::mt19937 M_engine;
+
+    //! the number of candidate points
+    std::size_t M_point_count;
 
-    //! grid point container
-    std::vector< Vector2D > M_points;
+    //! x coordinates of candidate points. the size is always MAX_POINTS.
+    std::vector< double > M_points_x;
+
+    //! y coordinates of candidate points. the size is always MAX_POINTS.
+    std::vector< double > M_points_y;
+
+    //! work buffer for filterPoints(). the size is always MAX_POINTS.
+    std::vector< unsigned char > M_keep;
 
 public:
     /*!
-      \brief create landmark map and object table
+      \brief bind the shared object table and create the point buffers
+      \param seed seed of the random engine
     */
-    Impl()
-        : M_object_table()
+    explicit
+    Impl( const std::uint32_t seed )
+        : M_object_table( shared_object_table() ),
+          M_engine( seed ),
+          M_point_count( 0 ),
+          M_points_x( MAX_POINTS, 0.0 ),
+          M_points_y( MAX_POINTS, 0.0 ),
+          M_keep( MAX_POINTS, 0 )
+      { }
+
+    /*!
+      \brief reset the random engine
+      \param seed new seed value
+     */
+    void setRandomSeed( const std::uint32_t seed )
       {
-          M_points.reserve( 1024 );
+          M_engine.seed( seed );
       }
 
     /*!
@@ -99,13 +143,12 @@ public:
       }
 
     /*!
-      \brief get grid points
-      \return grid points
+      \brief get the number of candidate points
+      \return the number of candidate points
     */
-    const
-    std::vector< Vector2D > & points() const
+    std::size_t pointCount() const
       {
-          return M_points;
+          return M_point_count;
       }
 
     //
@@ -155,6 +198,20 @@ public:
                          const double & self_face,
                          const double & self_face_err );
 
+    /*!
+      \brief remove the points outside of the sector in one pass.
+      \param center center of the sector
+      \param min_r minimum radius
+      \param max_r maximum radius
+      \param dir center direction of the sector
+      \param half_width half of the sector angle width [degree]
+    */
+    void filterPoints( const Vector2D & center,
+                       const double min_r,
+                       const double max_r,
+                       const AngleDeg & dir,
+                       const double half_width );
+
     /*!
       \brief calculate average point and error with all points.
       \param ave_pos pointer to the variable to store the averaged point
@@ -441,7 +498,7 @@ LocalizationDefault::Impl::updatePointsByBehindMarker( const WorldModel & wm,
                     marker_id,
                     self_face, self_face_err );
 
-    if ( points().empty() )
+    if ( pointCount() == 0 )
     {
 #ifdef DEBUG_PRINT
         std::cerr << __FILE__ << ": " << current
@@ -453,7 +510,7 @@ LocalizationDefault::Impl::updatePointsByBehindMarker( const WorldModel & wm,
 
         generatePoints( wm, behind_markers.front(), marker_id, self_face, self_face_err );
 
-        if ( points().empty() )
+        if ( pointCount() == 0 )
         {
 #ifdef DEBUG_PRINT
             std::cerr << __FILE__ << ": no candidate point by behind marker!!" << std::endl;
@@ -533,12 +590,9 @@ LocalizationDefault::Impl::updatePointsBy( const WorldModel & wm,
     ave_dir += 180.0;
 
     ////////////////////////////////////////////////////////////////////
-    // create candidate sector
-    const Sector2D sector( marker_pos, // base point
-                           ave_dist - dist_error, // min dist
-                           ave_dist + dist_error, // max dist
-                           AngleDeg( ave_dir - dir_error ), // start left angle
-                           AngleDeg( ave_dir + dir_error ) ); // end right angle
+    // candidate sector
+    const double min_dist = std::max( 0.0, ave_dist - dist_error );
+    const double max_dist = std::max( min_dist, ave_dist + dist_error );
 
 #if 0
     {
@@ -565,6 +619,10 @@ LocalizationDefault::Impl::updatePointsBy( const WorldModel & wm,
 #endif
 #ifdef DEBUG_PRINT_SHAPE
     {
+        const Sector2D sector( marker_pos,
+                               min_dist, max_dist,
+                               AngleDeg( ave_dir - dir_error ),
+                               AngleDeg( ave_dir + dir_error ) );
 
         int r = 16 * ( g_filter_count % 16 );
         int g = 16 * ( ( g_filter_count + 5 ) % 16 );
@@ -582,22 +640,16 @@ LocalizationDefault::Impl::updatePointsBy( const WorldModel & wm,
 
 #ifdef DEBUG_PROFILE_REMOVE
     Timer timer;
-    int initial_size = M_points.size();
+    int initial_size = pointCount();
 #endif
 
-    M_points.erase( std::remove_if( M_points.begin(),
-                                    M_points.end(),
-                                    [&]( const Vector2D & p )
-                                      {
-                                          return ! sector.contains( p );
-                                      } ),
-                    M_points.end() );
+    filterPoints( marker_pos, min_dist, max_dist, AngleDeg( ave_dir ), dir_error );
 
 #ifdef DEBUG_PROFILE_REMOVE
     dlog.addText( Logger::WORLD,
                   __FILE__" (updatePointsBy) elapsed %f [ms] points=%d -> %d",
                   timer.elapsedReal(),
-                  initial_size, (int)points().size() );
+                  initial_size, (int)pointCount() );
 #endif
 
 #ifdef DEBUG_PRINT
@@ -605,13 +657,64 @@ LocalizationDefault::Impl::updatePointsBy( const WorldModel & wm,
                   __FILE__" (updatePointsBy) points=%d marker(% 7.2f, % 7.2f)"
                   " dist=%f, dist_range=%f"
                   " dir=%.1f, dir_range=%.1f",
-                  (int)M_points.size(),
+                  (int)pointCount(),
                   marker_pos.x, marker_pos.y,
                   ave_dist, dist_error * 2.0,
                   ave_dir, dir_error * 2.0 );
 #endif
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+LocalizationDefault::Impl::filterPoints( const Vector2D & center,
+                                         const double min_r,
+                                         const double max_r,
+                                         const AngleDeg & dir,
+                                         const double half_width )
+{
+    // A point is kept if min_r <= |rel| <= max_r and
+    //   rel * unit(dir) >= |rel| * cos(half_width)
+    // The angle condition is compared by the signed squares
+    // in order to avoid sqrt() and atan2() in the loop.
+
+    const std::size_t n = M_point_count;
+    double * const xs = M_points_x.data();
+    double * const ys = M_points_y.data();
+    unsigned char * const keep = M_keep.data();
+
+    const double min_r2 = min_r * min_r;
+    const double max_r2 = max_r * max_r;
+    const double ux = dir.cos();
+    const double uy = dir.sin();
+    const double c = std::cos( half_width * AngleDeg::DEG2RAD );
+    const double signed_c2 = c * std::fabs( c );
+
+    for ( std::size_t i = 0; i < n; ++i )
+    {
+        const double rx = xs[i] - center.x;
+        const double ry = ys[i] - center.y;
+        const double d2 = rx * rx + ry * ry;
+        const double dot = rx * ux + ry * uy;
+
+        keep[i] = static_cast< unsigned char >( ( min_r2 <= d2 )
+                                                & ( d2 <= max_r2 )
+                                                & ( dot * std::fabs( dot ) >= signed_c2 * d2 ) );
+    }
+
+    std::size_t count = 0;
+    for ( std::size_t i = 0; i < n; ++i )
+    {
+        xs[count] = xs[i];
+        ys[count] = ys[i];
+        count += keep[i];
+    }
+
+    M_point_count = count;
+}
+
 /*-------------------------------------------------------------------*/
 /*!
 
@@ -623,7 +726,7 @@ LocalizationDefault::Impl::averagePoints( Vector2D * ave_pos,
     ave_pos->assign( 0.0, 0.0 );
     ave_err->assign( 0.0, 0.0 );
 
-    if ( M_points.empty() )
+    if ( M_point_count == 0 )
     {
 #ifdef DEBUG_PRINT
         dlog.addText( Logger::WORLD,
@@ -635,44 +738,40 @@ LocalizationDefault::Impl::averagePoints( Vector2D * ave_pos,
 #ifdef DEBUG_PRINT
     dlog.addText( Logger::WORLD,
                   __FILE__" (averagePoints) rest %d points.",
-                  M_points.size() );
+                  (int)M_point_count );
 #endif
 
-    double max_x, min_x, max_y, min_y;
+    const std::size_t n = M_point_count;
+    const double * const xs = M_points_x.data();
+    const double * const ys = M_points_y.data();
 
-    max_x = min_x = M_points.front().x;
-    max_y = min_y = M_points.front().y;
+    double sum_x = 0.0, sum_y = 0.0;
+    double max_x = xs[0], min_x = xs[0];
+    double max_y = ys[0], min_y = ys[0];
 
-    for ( const Vector2D & p : M_points )
+    for ( std::size_t i = 0; i < n; ++i )
     {
-        *ave_pos += p;
+        sum_x += xs[i];
+        sum_y += ys[i];
+        max_x = std::max( max_x, xs[i] );
+        min_x = std::min( min_x, xs[i] );
+        max_y = std::max( max_y, ys[i] );
+        min_y = std::min( min_y, ys[i] );
+    }
+
 #ifdef DEBUG_PRINT_SHAPE
-        // display points
+    // display points
+    for ( std::size_t i = 0; i < n; ++i )
+    {
         dlog.addCircle( Logger::WORLD,
-                        p, 0.005,
+                        Vector2D( xs[i], ys[i] ), 0.005,
                         "#ff0000",
                         true ); // fill
-#endif
-        if ( p.x > max_x )
-        {
-            max_x = p.x;
-        }
-        else if ( p.x < min_x )
-        {
-            min_x = p.x;
-        }
-
-        if ( p.y > max_y )
-        {
-            max_y = p.y;
-        }
-        else if ( p.y < min_y )
-        {
-            min_y = p.y;
-        }
     }
+#endif
 
-    *ave_pos /= static_cast< double >( M_points.size() );
+    ave_pos->assign( sum_x / static_cast< double >( n ),
+                     sum_y / static_cast< double >( n ) );
 
 #ifdef DEBUG_PRINT
     dlog.addText( Logger::WORLD,
@@ -708,7 +807,7 @@ LocalizationDefault::Impl::generatePoints( const WorldModel & wm,
 
     ////////////////////////////////////////////////////////////////////
     // clear old points
-    M_points.clear();
+    M_point_count = 0;
 
 
     ////////////////////////////////////////////////////////////////////
@@ -765,28 +864,44 @@ LocalizationDefault::Impl::generatePoints( const WorldModel & wm,
                                 32 );
     const double dir_inc = dir_range / ( dir_loop - 1 );
 
+    // dir_loop * dist_loop never exceeds MAX_POINTS
+    double * const xs = M_points_x.data();
+    double * const ys = M_points_y.data();
+    std::size_t n = 0;
+
     AngleDeg base_angle( ave_dir - dir_error ); // left first;
     for ( int idir = 0; idir < dir_loop; ++idir, base_angle += dir_inc )
     {
-        Vector2D base_vec = Vector2D::polar2vector( 1.0, base_angle );
-
-        double add_dist = 0.0;
-        for ( int idist = 0; idist < dist_loop; ++idist, add_dist += dist_inc )
+        const double c = base_angle.cos();
+        const double s = base_angle.sin();
+        const double base_x = marker_pos.x + c * min_dist;
+        const double base_y = marker_pos.y + s * min_dist;
+        const double inc_x = c * dist_inc;
+        const double inc_y = s * dist_inc;
+
+        for ( int idist = 0; idist < dist_loop; ++idist )
         {
-            M_points.push_back( marker_pos
-                                + ( base_vec * ( min_dist + add_dist ) ) );
-#ifdef DEBUG_PRINT_SHAPE
-            dlog.addCircle( Logger::WORLD,
-                            M_points.back(), 0.01,
-                            "#ffff00" );
-#endif
+            xs[n + idist] = base_x + inc_x * idist;
+            ys[n + idist] = base_y + inc_y * idist;
         }
+        n += dist_loop;
     }
 
+    M_point_count = n;
+
+#ifdef DEBUG_PRINT_SHAPE
+    for ( std::size_t i = 0; i < n; ++i )
+    {
+        dlog.addCircle( Logger::WORLD,
+                        Vector2D( xs[i], ys[i] ), 0.01,
+                        "#ffff00" );
+    }
+#endif
+
 #ifdef DEBUG_PRINT
     dlog.addText( Logger::WORLD,
                   __FILE__" (generatePoints) generate %d points by marker(%.1f %.1f)",
-                  (int)M_points.size(), marker_pos.x, marker_pos.y );
+                  (int)M_point_count, marker_pos.x, marker_pos.y );
     dlog.addText( Logger::WORLD,
                   __FILE__" _____  dir_loop=%d dir_inc=%.3f dir_range=%.3f",
                   dir_loop, dir_inc, dir_range );
@@ -804,7 +919,7 @@ LocalizationDefault::Impl::generatePoints( const WorldModel & wm,
                   ave_dir, dir_range );
     dlog.addText( Logger::WORLD,
                   __FILE__" (generatePoints) first point (%f, %f)",
-                  M_points.front().x, M_points.front().y );
+                  M_points_x[0], M_points_y[0] );
 #endif
 #if 0
     // display candidate area
@@ -842,10 +957,9 @@ LocalizationDefault::Impl::resamplePoints( const WorldModel & wm,
                                            const double & self_face,
                                            const double & self_face_err )
 {
-    static std::mt19937 s_engine( 49827140 );
     static const size_t max_count = 50;
 
-    const std::size_t count = M_points.size();
+    const std::size_t count = M_point_count;
 
     if ( count >= max_count )
     {
@@ -878,14 +992,19 @@ LocalizationDefault::Impl::resamplePoints( const WorldModel & wm,
 
     for ( size_t i = count; i < max_count; ++i )
     {
-        M_points.push_back( M_points[index_dst( s_engine )]
-                            + Vector2D( xy_dst( s_engine ), xy_dst( s_engine ) ) );
+        const int index = index_dst( M_engine );
+        const double dx = xy_dst( M_engine );
+        const double dy = xy_dst( M_engine );
+        M_points_x[i] = M_points_x[index] + dx;
+        M_points_y[i] = M_points_y[index] + dy;
 #ifdef DEBUG_PRINT_SHAPE
         dlog.addCircle( Logger::WORLD,
-                        M_points.back(), 0.01,
+                        Vector2D( M_points_x[i], M_points_y[i] ), 0.01,
                         "#ff0000" );
 #endif
     }
+
+    M_point_count = max_count;
 }
 
 /*-------------------------------------------------------------------*/
@@ -1190,7 +1309,17 @@ LocalizationDefault::Impl::getDistRange( const double & seen_dist,
 
  */
 LocalizationDefault::LocalizationDefault()
-    : M_impl( new Impl() )
+    : M_impl( new Impl( DEFAULT_SEED ) )
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+LocalizationDefault::LocalizationDefault( const std::uint32_t seed )
+    : M_impl( new Impl( seed ) )
 {
 
 }
@@ -1204,6 +1333,16 @@ LocalizationDefault::~LocalizationDefault()
 
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+LocalizationDefault::setRandomSeed( const std::uint32_t seed )
+{
+    M_impl->setRandomSeed( seed );
+}
+
 /*-------------------------------------------------------------------*/
 /*!
 
@@ -1292,7 +1431,7 @@ LocalizationDefault::localizeSelf( const WorldModel & wm,
                             self_face,
                             self_face_err );
 
-    if ( M_impl->points().empty() )
+    if ( M_impl->pointCount() == 0 )
     {
 #ifdef DEBUG_PRINT
         dlog.addText( Logger::WORLD,
@@ -1302,7 +1441,7 @@ LocalizationDefault::localizeSelf( const WorldModel & wm,
     }
 
 #ifdef DEBUG_PROFILE
-    int initial_point_size = M_impl->points().size();
+    int initial_point_size = M_impl->pointCount();
     Timer update_timer;
 #endif
     ////////////////////////////////////////////////////////////////////
@@ -1339,7 +1478,7 @@ LocalizationDefault::localizeSelf( const WorldModel & wm,
                   timer.elapsedReal(), update_time,
                   (int)see.markers().size(),
                   initial_point_size,
-                  (int)M_impl->points().size() );
+                  (int)M_impl->pointCount() );
 #endif
 
     return self_pos->isValid();
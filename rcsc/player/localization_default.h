@@ -35,6 +35,7 @@
 #include <rcsc/player/localization.h>
 
 #include <memory>
+#include <cstdint>
 
 namespace rcsc {
 
@@ -57,17 +58,35 @@ private:
     LocalizationDefault & operator=( const LocalizationDefault & ) = delete;
 
 public:
+
+    //! default seed of the random engine used by the self localization
+    static const std::uint32_t DEFAULT_SEED = 49827140;
+
     /*!
-      \brief create internal implementation
+      \brief create internal implementation with the default random seed
     */
     LocalizationDefault();
 
+    /*!
+      \brief create internal implementation
+      \param seed seed of the random engine used by the self localization
+    */
+    explicit
+    LocalizationDefault( const std::uint32_t seed );
+
     /*!
       \brief implicitly delete internal impl
     */
     virtual
     ~LocalizationDefault();
 
+    /*!
+      \brief reset the random engine used by the self localization.
+      The same sequence of see messages gives the same result after the same seed is set.
+      \param seed new seed value
+     */
+    void setRandomSeed( const std::uint32_t seed );
+
 public:
 
    /*!
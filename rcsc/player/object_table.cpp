@@ -45,6 +45,55 @@ namespace rcsc {
 
 const double ObjectTable::SERVER_EPS = 1.0e-10;
 
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+ObjectTable::DistanceLookup::DistanceLookup()
+    : M_index( 1, 0 ),
+      M_entries( 1, DataEntry( -1.0 ) ),
+      M_max_key( 0.0 )
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+ObjectTable::DistanceLookup::build( const std::vector< DataEntry > & table )
+{
+    M_entries = table;
+    M_entries.push_back( DataEntry( -1.0 ) ); // invalid entry
+
+    M_index.clear();
+    M_index.reserve( table.empty() ? 1 : static_cast< std::size_t >( table.back().M_seen_dist * 10.0 ) + 2 );
+
+    // the same query as the binary search for the quantized distance key * 0.1.
+    // the last key refers to the invalid entry.
+    for ( int key = 0; ; ++key )
+    {
+        std::vector< DataEntry >::const_iterator
+            it = std::lower_bound( table.begin(),
+                                   table.end(),
+                                   DataEntry( key * 0.1 - 0.001 ),
+                                   []( const DataEntry & lhs,
+                                       const DataEntry & rhs )
+                                   {
+                                       return lhs.M_seen_dist < rhs.M_seen_dist;
+                                   } );
+        M_index.push_back( static_cast< std::uint16_t >( it - table.begin() ) );
+
+        if ( it == table.end() )
+        {
+            break;
+        }
+    }
+
+    M_max_key = static_cast< double >( M_index.size() - 1 );
+}
+
 /*-------------------------------------------------------------------*/
 /*!
 
@@ -57,6 +106,7 @@ ObjectTable::ObjectTable()
     createLandmarkMap();
 
     createTable();
+    createLookups();
 }
 
 /*-------------------------------------------------------------------*/
@@ -2314,6 +2364,24 @@ ObjectTable::createTable()
 
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+ObjectTable::createLookups()
+{
+    M_static_lookup.build( M_static_table );
+    M_static_lookup_v18_narrow.build( M_static_table_v18_narrow );
+    M_static_lookup_v18_normal.build( M_static_table_v18_normal );
+    M_static_lookup_v18_wide.build( M_static_table_v18_wide );
+
+    M_movable_lookup.build( M_movable_table );
+    M_movable_lookup_v18_narrow.build( M_movable_table_v18_narrow );
+    M_movable_lookup_v18_normal.build( M_movable_table_v18_normal );
+    M_movable_lookup_v18_wide.build( M_movable_table_v18_wide );
+}
+
 /*-------------------------------------------------------------------*/
 /*!
 
@@ -2323,25 +2391,13 @@ ObjectTable::getStaticObjInfo( const double & see_dist,
                                double * ave,
                                double * err ) const
 {
-    std::vector< DataEntry >::const_iterator
-        it = std::lower_bound( M_static_table.begin(),
-                               M_static_table.end(),
-                               ObjectTable::DataEntry( see_dist - 0.001 ),
-                               []( const DataEntry & lhs,
-                                   const DataEntry & rhs )
-                               {
-                                   return lhs.M_seen_dist < rhs.M_seen_dist;
-                               } );
-    if ( it == M_static_table.end() )
+    if ( ! M_static_lookup.get( see_dist, ave, err ) )
     {
         std::cerr << "(ObjectTable::getStaticObjInfo) illegal distance = "
                   << see_dist << std::endl;
         return false;
     }
 
-    *ave = it->M_average;
-    *err = it->M_error;
-
     return true;
 }
 
@@ -2354,26 +2410,13 @@ ObjectTable::getMovableObjInfo( const double & see_dist,
                                 double * ave,
                                 double * err ) const
 {
-
-    std::vector< DataEntry >::const_iterator
-        it = std::lower_bound( M_movable_table.begin(),
-                               M_movable_table.end(),
-                               DataEntry( see_dist - 0.001 ),
-                               []( const DataEntry & lhs,
-                                   const DataEntry & rhs )
-                               {
-                                   return lhs.M_seen_dist < rhs.M_seen_dist;
-                               } );
-    if ( it == M_movable_table.end() )
+    if ( ! M_movable_lookup.get( see_dist, ave, err ) )
     {
         std::cerr << "(ObjectTable::getMovableObjInfo) illegal distance = "
                   << see_dist << std::endl;
         return false;
     }
 
-    *ave = it->M_average;
-    *err = it->M_error;
-
     return true;
 }
 
@@ -2384,30 +2427,12 @@ ObjectTable::getLandmarkDistanceRangeV18( const ViewWidth::Type view_width,
                                           double * mean_dist,
                                           double * dist_error ) const
 {
-    const std::vector< DataEntry > * table = ( view_width == ViewWidth::NARROW
-                                               ? &M_static_table_v18_narrow
-                                               : view_width == ViewWidth::NORMAL
-                                               ? &M_static_table_v18_normal
-                                               : &M_static_table_v18_wide );
-
-    std::vector< DataEntry >::const_iterator
-        it = std::lower_bound( table->begin(),
-                               table->end(),
-                               DataEntry( quant_dist - 0.001 ),
-                               []( const DataEntry & lhs,
-                                   const DataEntry & rhs )
-                               {
-                                   return lhs.M_seen_dist < rhs.M_seen_dist;
-                               } );
-    if ( it == table->end() )
+    if ( ! landmarkLookupV18( view_width ).get( quant_dist, mean_dist, dist_error ) )
     {
         std::cerr << "(ObjectTable::getLandmarkDistanceRangeV18) illegal distance = " << quant_dist << std::endl;
         return false;
     }
 
-    *mean_dist = it->M_average;
-    *dist_error = it->M_error;
-
     return true;
 }
 
@@ -2418,30 +2443,12 @@ ObjectTable::getDistanceRangeV18( const ViewWidth::Type view_width,
                                   double * mean_dist,
                                   double * dist_error ) const
 {
-    const std::vector< DataEntry > * table = ( view_width == ViewWidth::NARROW
-                                               ? &M_movable_table_v18_narrow
-                                               : view_width == ViewWidth::NORMAL
-                                               ? &M_movable_table_v18_normal
-                                               : &M_movable_table_v18_wide );
-
-    std::vector< DataEntry >::const_iterator
-        it = std::lower_bound( table->begin(),
-                               table->end(),
-                               DataEntry( quant_dist - 0.001 ),
-                               []( const DataEntry & lhs,
-                                   const DataEntry & rhs )
-                               {
-                                   return lhs.M_seen_dist < rhs.M_seen_dist;
-                               } );
-    if ( it == table->end() )
+    if ( ! movableLookupV18( view_width ).get( quant_dist, mean_dist, dist_error ) )
     {
         std::cerr << "(ObjectTable::getDistanceRangeV18) illegal distance = " << quant_dist << std::endl;
         return false;
     }
 
-    *mean_dist = it->M_average;
-    *dist_error = it->M_error;
-
     return true;
 }
 
@@ -2455,6 +2462,9 @@ ObjectTable::create( const double & static_qstep,
 {
     createTable( static_qstep, M_static_table );
     createTable( movable_qstep, M_movable_table );
+
+    M_static_lookup.build( M_static_table );
+    M_movable_lookup.build( M_movable_table );
 }
 
 /*-------------------------------------------------------------------*/
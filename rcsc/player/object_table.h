@@ -38,6 +38,8 @@
 
 #include <unordered_map>
 #include <vector>
+#include <algorithm>
+#include <cstdint>
 
 namespace rcsc {
 
@@ -94,6 +96,69 @@ public:
           { }
     };
 
+    /*!
+      \class DistanceLookup
+      \brief direct indexed lookup array built from the distance table.
+
+      The key is the quantized distance multiplied by 10, that is the integer
+      encoding of the seen distance. Each key refers to the entry found by the
+      binary search in the original table, and the last key refers to the
+      invalid entry for the distances beyond the table. So the lookup needs
+      neither the search nor the branch.
+    */
+    class DistanceLookup {
+    private:
+        //! key: quantized distance * 10, value: index of M_entries
+        std::vector< std::uint16_t > M_index;
+        //! copy of the distance table. the last element is the invalid entry.
+        std::vector< DataEntry > M_entries;
+        //! the maximum key value
+        double M_max_key;
+
+    public:
+        /*!
+          \brief create the empty lookup. all keys refer to the invalid entry.
+        */
+        DistanceLookup();
+
+        /*!
+          \brief create the lookup array for the distance table
+          \param table distance table sorted by the seen distance
+        */
+        void build( const std::vector< DataEntry > & table );
+
+        /*!
+          \brief get the number of keys
+          \return the size of the lookup array
+        */
+        std::size_t size() const
+          {
+              return M_index.size();
+          }
+
+        /*!
+          \brief get the predefined distance range for the quantized distance
+          \param quant_dist seen distance value
+          \param mean_dist variable pointer to store the result mean distance
+          \param dist_error variable pointer to store the result error range
+          \return true if found the matched data. if false, 0 is set to the result variables.
+        */
+        bool get( const double quant_dist,
+                  double * mean_dist,
+                  double * dist_error ) const
+          {
+              // the negative value and NaN are mapped to the first key.
+              const double k = std::min( std::max( 0.0, ( quant_dist - 0.001 ) * 10.0 ), M_max_key );
+              const int floor_k = static_cast< int >( k );
+              const DataEntry & e = M_entries[M_index[floor_k + ( floor_k < k )]];
+
+              *mean_dist = e.M_average;
+              *dist_error = e.M_error;
+
+              return e.M_seen_dist >= 0.0;
+          }
+    };
+
     //! type of marker map container
     typedef std::unordered_map< MarkerID, Vector2D > MarkerMap;
 
@@ -116,6 +181,16 @@ private:
     std::vector< DataEntry > M_movable_table_v18_normal; //!< distance table for v18+ normal
     std::vector< DataEntry > M_movable_table_v18_wide; //!< distance table for v18+ wide
 
+    DistanceLookup M_static_lookup; //!< lookup array for M_static_table
+    DistanceLookup M_static_lookup_v18_narrow; //!< lookup array for M_static_table_v18_narrow
+    DistanceLookup M_static_lookup_v18_normal; //!< lookup array for M_static_table_v18_normal
+    DistanceLookup M_static_lookup_v18_wide; //!< lookup array for M_static_table_v18_wide
+
+    DistanceLookup M_movable_lookup; //!< lookup array for M_movable_table
+    DistanceLookup M_movable_lookup_v18_narrow; //!< lookup array for M_movable_table_v18_narrow
+    DistanceLookup M_movable_lookup_v18_normal; //!< lookup array for M_movable_table_v18_normal
+    DistanceLookup M_movable_lookup_v18_wide; //!< lookup array for M_movable_table_v18_wide
+
 public:
     /*!
       \brief create distance table
@@ -133,6 +208,106 @@ public:
           return M_landmark_map;
       }
 
+    /*!
+      \brief get the distance table for the stationary object
+      \return const reference to the table
+    */
+    const std::vector< DataEntry > & staticTable() const
+      {
+          return M_static_table;
+      }
+
+    /*!
+      \brief get the distance table for the landmark objects (v18+)
+      \param view_width current view width
+      \return const reference to the table
+    */
+    const std::vector< DataEntry > & staticTableV18( const ViewWidth::Type view_width ) const
+      {
+          return ( view_width == ViewWidth::NARROW
+                   ? M_static_table_v18_narrow
+                   : view_width == ViewWidth::NORMAL
+                   ? M_static_table_v18_normal
+                   : M_static_table_v18_wide );
+      }
+
+    /*!
+      \brief get the distance table for the movable object
+      \return const reference to the table
+    */
+    const std::vector< DataEntry > & movableTable() const
+      {
+          return M_movable_table;
+      }
+
+    /*!
+      \brief get the distance table for the movable objects (v18+)
+      \param view_width current view width
+      \return const reference to the table
+    */
+    const std::vector< DataEntry > & movableTableV18( const ViewWidth::Type view_width ) const
+      {
+          return ( view_width == ViewWidth::NARROW
+                   ? M_movable_table_v18_narrow
+                   : view_width == ViewWidth::NORMAL
+                   ? M_movable_table_v18_normal
+                   : M_movable_table_v18_wide );
+      }
+
+    /*!
+      \brief get the lookup array for the landmark objects (v18+)
+      \param view_width current view width
+      \return const reference to the lookup array
+    */
+    const DistanceLookup & landmarkLookupV18( const ViewWidth::Type view_width ) const
+      {
+          return ( view_width == ViewWidth::NARROW
+                   ? M_static_lookup_v18_narrow
+                   : view_width == ViewWidth::NORMAL
+                   ? M_static_lookup_v18_normal
+                   : M_static_lookup_v18_wide );
+      }
+
+    /*!
+      \brief get the lookup array used for the landmark objects
+      \return const reference to the lookup array
+    */
+    const DistanceLookup & landmarkLookup( const double /*client_version*/,
+                                           const ViewWidth::Type /*view_width*/ ) const
+      {
+          // return ( client_version >= 18.0
+          //          ? landmarkLookupV18( view_width )
+          //          : M_static_lookup );
+          return M_static_lookup;
+      }
+
+    /*!
+      \brief get the lookup array for the movable objects (v18+)
+      \param view_width current view width
+      \return const reference to the lookup array
+    */
+    const DistanceLookup & movableLookupV18( const ViewWidth::Type view_width ) const
+      {
+          return ( view_width == ViewWidth::NARROW
+                   ? M_movable_lookup_v18_narrow
+                   : view_width == ViewWidth::NORMAL
+                   ? M_movable_lookup_v18_normal
+                   : M_movable_lookup_v18_wide );
+      }
+
+    /*!
+      \brief get the lookup array used for the movable objects
+      \return const reference to the lookup array
+    */
+    const DistanceLookup & movableLookup( const double /*client_version*/,
+                                          const ViewWidth::Type /*view_width*/ ) const
+      {
+          // return ( client_version >= 18.0
+          //          ? movableLookupV18( view_width )
+          //          : M_movable_lookup );
+          return M_movable_lookup;
+      }
+
     /*!
       \brief get predefined distance info for the stationary object
       \param see_dist seen distance
@@ -235,6 +410,11 @@ private:
     */
     void createTable();
 
+    /*!
+      \brief create the lookup arrays for all distance tables
+    */
+    void createLookups();
+
     /*!
       \brief create distance table dynamically
       \param static_qstap quantizaztion step for the stationary object
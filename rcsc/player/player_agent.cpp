@@ -43,6 +43,7 @@
 #include "localization_default.h"
 
 #include "player_command.h"
+#include "replay_profile.h"
 #include "say_message_builder.h"
 #include "soccer_action.h"
 #include "soccer_intention.h"
@@ -56,15 +57,20 @@
 #include <rcsc/common/player_param.h>
 #include <rcsc/common/player_type.h>
 #include <rcsc/common/server_param.h>
+#include <rcsc/common/sexp_cursor.h>
+#include <rcsc/common/shared_param_lock.h>
 #include <rcsc/param/param_map.h>
 #include <rcsc/param/cmd_line_parser.h>
 #include <rcsc/param/conf_file_parser.h>
 #include <rcsc/math_util.h>
+#include <rcsc/random.h>
 #include <rcsc/game_time.h>
 #include <rcsc/game_mode.h>
 #include <rcsc/timer.h>
 #include <rcsc/version.h>
 
+#include <algorithm>
+#include <fstream>
 #include <sstream>
 #include <cstdio>
 #include <cstring>
@@ -143,6 +149,14 @@ struct PlayerAgent::Impl {
     //! intention queue
     SoccerIntention::Ptr intention_;
 
+    //! per cycle profile in offline client mode
+    std::unique_ptr< ReplayProfile > profile_;
+
+    //! clock used by the time stamps in offline client mode
+    TimeStamp::value_type virtual_now_;
+    //! virtual arrival time of the last sense_body in offline client mode
+    TimeStamp::value_type virtual_sense_time_;
+
     /*!
       \brief initialize all members
     */
@@ -178,6 +192,22 @@ struct PlayerAgent::Impl {
      */
     bool openDebugLog();
 
+    /*!
+      \brief reset the virtual clock, the random engine and the profile for offline client mode.
+     */
+    void startReplay();
+
+    /*!
+      \brief advance the virtual clock by the replayed message.
+      \param msg replayed server message
+     */
+    void advanceVirtualClock( const char * msg );
+
+    /*!
+      \brief write the profile and restore the system clock.
+     */
+    void finishReplay();
+
     /*!
       \brief set debug output flags to logger
      */
@@ -837,6 +867,9 @@ PlayerAgent::initImpl( CmdLineParser & cmd_parser )
                                  config().playerVelCountThr(),
                                  config().playerFaceCountThr() );
 
+    InterceptTable::set_update_mode( config().incrementalIntercept(),
+                                     config().validateIntercept() );
+
     AudioCodec::instance().createMap( config().audioShift() );
 
 
@@ -902,6 +935,8 @@ PlayerAgent::handleStartOffline()
         return false;
     }
 
+    M_impl->startReplay();
+
     M_client->setServerAlive( true );
     return true;
 }
@@ -989,6 +1024,7 @@ PlayerAgent::handleMessageOffline()
 
     if ( M_client->receiveMessage() > 0 )
     {
+        M_impl->advanceVirtualClock( M_client->message() );
         parse( M_client->message() );
     }
 
@@ -1074,6 +1110,12 @@ PlayerAgent::handleTimeout( const int timeout_count,
 void
 PlayerAgent::handleExit()
 {
+    if ( 1 <= config().offlineClientNumber()
+         && config().offlineClientNumber() <= 11 )
+    {
+        M_impl->finishReplay();
+    }
+
     finalize();
 }
 
@@ -1261,6 +1303,8 @@ PlayerAgent::Impl::openDebugLog()
     filepath << agent_.config().teamName() << '-' << agent_.world().self().unum()
              << agent_.config().debugLogExt();
 
+    dlog.setAsync( agent_.config().debugLogAsync() );
+    dlog.setBinary( agent_.config().debugLogBinary() );
     dlog.open( filepath.str() );
 
     if ( ! dlog.isOpen() )
@@ -1276,6 +1320,74 @@ PlayerAgent::Impl::openDebugLog()
     return true;
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+PlayerAgent::Impl::startReplay()
+{
+    // the time stamps and the random numbers are fixed so that every replay
+    // of the same log produces the same result.
+    virtual_now_ = TimeStamp::value_type( std::chrono::seconds( 1 ) );
+    virtual_sense_time_ = virtual_now_;
+    TimeStamp::set_virtual_clock( &virtual_now_ );
+
+    RandomEngine::instance().seed( RandomEngine::base_type::default_seed );
+
+    if ( ! agent_.config().offlineProfileFile().empty() )
+    {
+        profile_ = std::unique_ptr< ReplayProfile >( new ReplayProfile( &current_time_ ) );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+PlayerAgent::Impl::advanceVirtualClock( const char * msg )
+{
+    // the arrival time is not recorded in the offline client log.
+    // sense_body is assumed to arrive at the beginning of each cycle,
+    // and other messages are assumed to arrive 1 ms after the previous one.
+    if ( ! std::strncmp( msg, "(sense_body ", 12 ) )
+    {
+        virtual_sense_time_ += std::chrono::milliseconds( ServerParam::i().simulatorStep() );
+        virtual_now_ = std::max( virtual_now_, virtual_sense_time_ );
+    }
+    else
+    {
+        virtual_now_ += std::chrono::milliseconds( 1 );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+PlayerAgent::Impl::finishReplay()
+{
+    TimeStamp::set_virtual_clock( nullptr );
+
+    if ( ! profile_ )
+    {
+        return;
+    }
+
+    std::ofstream fout( agent_.config().offlineProfileFile().c_str() );
+    if ( ! fout.is_open() )
+    {
+        std::cerr << "Failed to open the profile file ["
+                  << agent_.config().offlineProfileFile()
+                  << "]" << std::endl;
+        return;
+    }
+
+    profile_->print( fout );
+}
+
 /*-------------------------------------------------------------------*/
 /*!
 
@@ -1442,6 +1554,7 @@ PlayerAgent::Impl::setDebugFlags()
 void
 PlayerAgent::parse( const char * msg )
 {
+    ReplayProfile::Scope profile_scope( M_impl->profile_.get(), ReplayProfile::PARSE );
 
     if ( ! std::strncmp( msg, "(see ", 5 ) )
     {
@@ -1518,10 +1631,11 @@ bool
 PlayerAgent::Impl::analyzeCycle( const char * msg,
                                  bool by_sense_body )
 {
-    char id[16];
     long cycle = 0;
-    if ( std::sscanf( msg, "(%15s %ld ",
-                      id, &cycle ) != 2 )
+    SExpCursor cursor( msg );
+    if ( ! cursor.consume( '(' )
+         || ! cursor.skipToken() // message type
+         || ! cursor.readInt( cycle ) )
     {
         std::cerr << agent_.world().teamName() << ' '
                   << agent_.world().self().unum() << ": "
@@ -1602,6 +1716,7 @@ PlayerAgent::Impl::analyzeSee( const char * msg )
          && agent_.world().seeTime() != current_time_ )
     {
         // update seen objects
+        ReplayProfile::Scope profile_scope( profile_.get(), ReplayProfile::WORLD );
         agent_.M_worldmodel.updateAfterSee( visual_,
                                             body_,
                                             agent_.effector(),
@@ -1652,6 +1767,7 @@ PlayerAgent::Impl::analyzeSenseBody( const char * msg )
     // check command counter
     agent_.M_effector.checkCommandCount( body_ );
     // pure internal update
+    ReplayProfile::Scope profile_scope( profile_.get(), ReplayProfile::WORLD );
     agent_.M_worldmodel.updateAfterSenseBody( body_,
                                               agent_.effector(),
                                               current_time_ );
@@ -1690,10 +1806,13 @@ PlayerAgent::Impl::analyzeHear( const char * msg )
     }
     // parse sender info
     long cycle;
-    char sender[128];
+    const char * sender = nullptr;
+    std::size_t sender_len = 0;
 
-    if ( std::sscanf( msg, "(hear %ld %127s ",
-                      &cycle, sender ) != 2 )
+    SExpCursor cursor( msg );
+    if ( ! cursor.consume( "(hear" )
+         || ! cursor.readInt( cycle )
+         || ! cursor.readToken( &sender, &sender_len ) )
     {
         std::cerr << agent_.world().teamName() << ' '
                   << agent_.world().self().unum() << ": "
@@ -1766,7 +1885,10 @@ PlayerAgent::Impl::analyzeHearReferee( const char * msg )
     long cycle;
     char mode[512]; // playmode or trainer's message
 
-    if ( std::sscanf( msg, "(hear %ld referee %511[^)]", &cycle, mode ) != 2 )
+    SExpCursor cursor( msg );
+    if ( ! cursor.consume( "(hear" )
+         || ! cursor.readInt( cycle )
+         || ! cursor.consume( "referee" ) )
     {
         std::cerr << agent_.world().teamName() << ' '
                   << agent_.world().self().unum() << ": "
@@ -1776,6 +1898,23 @@ PlayerAgent::Impl::analyzeHearReferee( const char * msg )
         return;
     }
 
+    cursor.skipSpace();
+    const char * mode_begin = cursor.pos();
+    cursor.skipTo( ')' );
+    const std::size_t mode_len = std::min( static_cast< std::size_t >( cursor.pos() - mode_begin ),
+                                           sizeof( mode ) - 1 );
+    if ( mode_len == 0 )
+    {
+        std::cerr << agent_.world().teamName() << ' '
+                  << agent_.world().self().unum() << ": "
+                  << agent_.world().time()
+                  << " playmode scan error. " << msg
+                  << std::endl;
+        return;
+    }
+    std::memcpy( mode, mode_begin, mode_len );
+    mode[mode_len] = '\0';
+
     if ( ! game_mode_.update( mode, current_time_ ) )
     {
         if ( ! std::strncmp( mode, "yellow_card", std::strlen( "yellow_card" ) ) )
@@ -1964,6 +2103,8 @@ PlayerAgent::Impl::analyzeFullstate( const char * msg )
                       agent_.config().version(),
                       current_time_ );
 
+    ReplayProfile::Scope profile_scope( profile_.get(), ReplayProfile::WORLD );
+
     if ( agent_.config().debugFullstate() )
     {
         agent_.M_fullstate_worldmodel.updateAfterFullstate( fullstate_,
@@ -1989,8 +2130,14 @@ PlayerAgent::Impl::analyzePlayerType( const char * msg )
 {
     dlog.addText( Logger::SENSOR,
                   "===receive player_type" );
-    PlayerType player_type( msg, agent_.config().version() );
-    PlayerTypeSet::instance().insert( player_type );
+    {
+        SharedParamLock lock( msg );
+        if ( lock.isNewMessage() )
+        {
+            PlayerType player_type( msg, agent_.config().version() );
+            PlayerTypeSet::instance().insert( player_type );
+        }
+    }
 
     agent_.handlePlayerType();
 }
@@ -2004,7 +2151,13 @@ PlayerAgent::Impl::analyzePlayerParam( const char * msg )
 {
     dlog.addText( Logger::SENSOR,
                   "===receive player_param" );
-    PlayerParam::instance().parse( msg, agent_.config().version() );
+    {
+        SharedParamLock lock( msg );
+        if ( lock.isNewMessage() )
+        {
+            PlayerParam::instance().parse( msg, agent_.config().version() );
+        }
+    }
 
     agent_.handlePlayerParam();
 }
@@ -2019,8 +2172,14 @@ PlayerAgent::Impl::analyzeServerParam( const char * msg )
     dlog.addText( Logger::SENSOR,
                   "===receive server_param" );
     //std::cout << msg << std::endl;
-    ServerParam::instance().parse( msg, agent_.config().version() );
-    PlayerTypeSet::instance().resetDefaultType();
+    {
+        SharedParamLock lock( msg );
+        if ( lock.isNewMessage() )
+        {
+            ServerParam::instance().parse( msg, agent_.config().version() );
+            PlayerTypeSet::instance().resetDefaultType();
+        }
+    }
 
     agent_.M_worldmodel.setServerParam();
 
@@ -2342,6 +2501,8 @@ PlayerAgent::Impl::analyzeWarning( const char * msg )
 void
 PlayerAgent::action()
 {
+    ReplayProfile::Scope profile_scope( M_impl->profile_.get(), ReplayProfile::ACTION );
+
     Timer timer;
     dlog.addText( Logger::SYSTEM,
                   __FILE__" (action) start" );
@@ -2379,13 +2540,16 @@ PlayerAgent::action()
     // ------------------------------------------------------------------------
     // last update
     // update positining matrix, offside line, defense line, etc.
-    M_worldmodel.updateJustBeforeDecision( effector(),
-                                           M_impl->current_time_ );
-    if ( config().debugFullstate()
-         && M_fullstate_worldmodel.isValid() )
     {
-        M_fullstate_worldmodel.updateJustBeforeDecision( effector(),
-                                                         M_impl->current_time_ );
+        ReplayProfile::Scope world_scope( M_impl->profile_.get(), ReplayProfile::WORLD );
+        M_worldmodel.updateJustBeforeDecision( effector(),
+                                               M_impl->current_time_ );
+        if ( config().debugFullstate()
+             && M_fullstate_worldmodel.isValid() )
+        {
+            M_fullstate_worldmodel.updateJustBeforeDecision( effector(),
+                                                             M_impl->current_time_ );
+        }
     }
 
     // reset last action effect
@@ -2415,7 +2579,10 @@ PlayerAgent::action()
     // ------------------------------------------------------------------------
     // set command effect. these must be called before command composing.
     // set self view mode, pointto and attentionto info.
-    M_worldmodel.updateJustAfterDecision( effector() );
+    {
+        ReplayProfile::Scope world_scope( M_impl->profile_.get(), ReplayProfile::WORLD );
+        M_worldmodel.updateJustAfterDecision( effector() );
+    }
     if ( effector().changeViewCommand() )
     {
         // set cycles till next see, update estimated next see arrival timing
@@ -2435,6 +2602,11 @@ PlayerAgent::action()
                           "---- send[%s]",
                           str.c_str() );
             M_client->sendMessage( str.c_str() );
+
+            if ( M_impl->profile_ )
+            {
+                M_impl->profile_->addCommand( str.data(), str.length() );
+            }
         }
     }
 
@@ -116,6 +116,9 @@ PlayerConfig::setDefaultParam()
     M_player_vel_count_thr = 5;
     M_player_face_count_thr = 2;
 
+    M_incremental_intercept = false;
+    M_validate_intercept = false;
+
     // formation param
     M_player_number = 0;
 
@@ -144,6 +147,7 @@ PlayerConfig::setDefaultParam()
     M_offline_log_ext = ".ocl";
 
     M_offline_client_number = Unum_Unknown;
+    M_offline_profile_file.clear();
 
     //
     // debug logging
@@ -152,6 +156,8 @@ PlayerConfig::setDefaultParam()
     M_debug_end_time = 99999999;
 
     M_debug_log_ext = ".log";
+    M_debug_log_async = false;
+    M_debug_log_binary = false;
 
     M_debug_system = false;
     M_debug_sensor = false;
@@ -226,6 +232,9 @@ PlayerConfig::createParamMap()
         ( "player_vel_count_thr", "", &M_player_vel_count_thr )
         ( "player_face_count_thr", "", &M_player_face_count_thr )
 
+        ( "incremental_intercept", "", BoolSwitch( &M_incremental_intercept ) )
+        ( "validate_intercept", "", BoolSwitch( &M_validate_intercept ) )
+
         ( "player_number", "n",  &M_player_number, "specifies the player's position number (not a uniform number)." )
 
         ( "config_dir", "", &M_config_dir )
@@ -241,11 +250,14 @@ PlayerConfig::createParamMap()
         ( "offline_logging", "", BoolSwitch( &M_offline_logging ) )
         ( "offline_log_ext", "", &M_offline_log_ext )
         ( "offline_client_number", "", &M_offline_client_number )
+        ( "offline_profile_file", "", &M_offline_profile_file )
 
         ( "debug_start_time", "", &M_debug_start_time )
         ( "debug_end_time", "", &M_debug_end_time )
 
         ( "debug_log_ext", "", &M_debug_log_ext )
+        ( "debug_log_async", "", BoolSwitch( &M_debug_log_async ) )
+        ( "debug_log_binary", "", BoolSwitch( &M_debug_log_binary ) )
 
         ( "debug_system", "", BoolSwitch( &M_debug_system ) )
         ( "debug_sensor", "", BoolSwitch( &M_debug_sensor ) )
@@ -288,6 +300,7 @@ PlayerConfig::parse( ParamParser & parser )
          || 11 < M_offline_client_number )
     {
         M_offline_client_number = Unum_Unknown;
+    M_offline_profile_file.clear();
     }
 }
 
@@ -98,6 +98,9 @@ private:
     int M_player_vel_count_thr; //!< player velocity confidence threshold
     int M_player_face_count_thr; //!< player angle confidence threshold
 
+    bool M_incremental_intercept; //!< if true, the intercept table reuses the results of the last cycle
+    bool M_validate_intercept; //!< if true, the reused intercept results are compared with the results from scratch
+
 
     //! specifies player's number independent of uniform number
     int M_player_number;
@@ -134,6 +137,9 @@ private:
     //! the uniform number for offline client. 1-11 means offline mode, other values mean online mode.
     int M_offline_client_number;
 
+    //! output file path of the per cycle profile in offline client mode. empty string means no profile.
+    std::string M_offline_profile_file;
+
     //
     // debug logging
     //
@@ -142,6 +148,8 @@ private:
     int M_debug_end_time; //!< the end time for recording the debug log
 
     std::string M_debug_log_ext; //!< the extension string of debug log file
+    bool M_debug_log_async; //!< if true, the debug log is written by the background thread
+    bool M_debug_log_binary; //!< if true, the debug log is written in the binary format
 
     bool M_debug_system; //!< debug level flag
     bool M_debug_sensor; //!< debug level flag
@@ -383,6 +391,18 @@ public:
      */
     int playerFaceCountThr() const { return M_player_face_count_thr; }
 
+    /*!
+      \brief get the switch for the incremental intercept table update
+      \return switch value for the incremental intercept table update
+     */
+    bool incrementalIntercept() const { return M_incremental_intercept; }
+
+    /*!
+      \brief get the switch for the validation of the incremental intercept table update
+      \return switch value for the validation of the incremental intercept table update
+     */
+    bool validateIntercept() const { return M_validate_intercept; }
+
     /*!
       \brief get the player number (not a uniform number)
       \return player number
@@ -468,6 +488,12 @@ public:
      */
     int offlineClientNumber() const { return M_offline_client_number; }
 
+    /*!
+      \brief get the output file path of the per cycle profile in offline client mode.
+      \return file path string. empty string means no profile.
+     */
+    const std::string & offlineProfileFile() const { return M_offline_profile_file; }
+
     //
     // debug logging
     //
@@ -490,6 +516,18 @@ public:
      */
     const std::string & debugLogExt() const { return M_debug_log_ext; }
 
+    /*!
+      \brief get the switch for the asynchronous debug log output.
+      \return switch value for the asynchronous debug log output.
+     */
+    bool debugLogAsync() const { return M_debug_log_async; }
+
+    /*!
+      \brief get the switch for the binary debug log format.
+      \return switch value for the binary debug log format.
+     */
+    bool debugLogBinary() const { return M_debug_log_binary; }
+
     /*!
       \brief get the debug flag
       \return debug flag
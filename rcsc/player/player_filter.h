@@ -0,0 +1,905 @@
+// -*-c++-*-
+
+/*!
+  \file player_filter.h
+  \brief inlined player filter expressions Header File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hiroki SHIMORA, Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+
+#ifndef RCSC_PLAYER_PLAYER_FILTER_H
+#define RCSC_PLAYER_PLAYER_FILTER_H
+
+#include <rcsc/player/player_predicate.h>
+#include <rcsc/player/world_model.h>
+#include <rcsc/player/abstract_player_object.h>
+#include <rcsc/geom/rect_2d.h>
+#include <rcsc/geom/vector_2d.h>
+#include <rcsc/geom/angle_deg.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace rcsc {
+
+/*!
+  \class PlayerFilter
+  \brief base of the player filter expressions.
+
+  PlayerFilter is the compile time version of PlayerPredicate. The filter
+  expressions are combined by the operators &&, || and !, and the result is
+  an ordinary value type. No memory allocation or virtual function call
+  is needed, so the compiler can inline the whole condition into the loop.
+
+  \code
+  using namespace rcsc::player_filter;
+  AbstractPlayerObject::Cont players
+      = wm.getPlayers( teammate( wm ) && x_forward( 10.0 ) && ! ghost() );
+  \endcode
+
+  PlayerPredicate is still available for the conditions determined at run
+  time.
+*/
+template < typename Derived >
+class PlayerFilter {
+public:
+
+    /*!
+      \brief get the actual filter object
+      \return const reference to the derived object
+     */
+    const Derived & derived() const
+      {
+          return static_cast< const Derived & >( *this );
+      }
+
+    /*!
+      \brief filter function
+      \param p const reference to the target player object
+      \return true if target player is matched to the condition.
+     */
+    template < typename Player >
+    bool operator()( const Player & p ) const
+      {
+          return derived().check( p );
+      }
+};
+
+/*-------------------------------------------------------------------*/
+/*!
+  \class FunctionPlayerFilter
+  \brief filter that calls the function object
+*/
+template < typename Func >
+class FunctionPlayerFilter
+    : public PlayerFilter< FunctionPlayerFilter< Func > > {
+private:
+    //! function object that takes the player object and returns bool
+    Func M_func;
+
+public:
+    /*!
+      \brief construct with the function object
+      \param func function object
+     */
+    explicit
+    FunctionPlayerFilter( const Func & func )
+        : M_func( func )
+      { }
+
+    /*!
+      \brief filter function
+      \param p const reference to the target player object
+      \return the result of the function object
+     */
+    template < typename Player >
+    bool check( const Player & p ) const
+      {
+          return M_func( p );
+      }
+
+    /*!
+      \brief get the rectangle that contains all the matched players.
+      \return always false
+     */
+    bool boundingRect( Rect2D * ) const
+      {
+          return false;
+      }
+};
+
+/*-------------------------------------------------------------------*/
+/*!
+  \class BoundedPlayerFilter
+  \brief filter that calls the function object, and the matched players are in the rectangle
+*/
+template < typename Func >
+class BoundedPlayerFilter
+    : public PlayerFilter< BoundedPlayerFilter< Func > > {
+private:
+    //! function object that takes the player object and returns bool
+    Func M_func;
+    //! rectangle that contains all the matched players
+    Rect2D M_rect;
+
+public:
+    /*!
+      \brief construct with the function object
+      \param func function object
+      \param rect rectangle that contains all the matched players
+     */
+    BoundedPlayerFilter( const Func & func,
+                         const Rect2D & rect )
+        : M_func( func ),
+          M_rect( rect )
+      { }
+
+    /*!
+      \brief filter function
+      \param p const reference to the target player object
+      \return the result of the function object
+     */
+    template < typename Player >
+    bool check( const Player & p ) const
+      {
+          return M_func( p );
+      }
+
+    /*!
+      \brief get the rectangle that contains all the matched players.
+      \param rect pointer to the variable to store the result
+      \return always true
+     */
+    bool boundingRect( Rect2D * rect ) const
+      {
+          *rect = M_rect;
+          return true;
+      }
+};
+
+/*-------------------------------------------------------------------*/
+/*!
+  \class AndPlayerFilter
+  \brief logical "and" of two filters
+*/
+template < typename L, typename R >
+class AndPlayerFilter
+    : public PlayerFilter< AndPlayerFilter< L, R > > {
+private:
+    L M_lhs; //!< left hand side filter
+    R M_rhs; //!< right hand side filter
+
+public:
+    /*!
+      \brief construct with two filters
+      \param lhs left hand side filter
+      \param rhs right hand side filter
+     */
+    AndPlayerFilter( const L & lhs,
+                     const R & rhs )
+        : M_lhs( lhs ),
+          M_rhs( rhs )
+      { }
+
+    /*!
+      \brief filter function
+      \param p const reference to the target player object
+      \return the result of "and" operation. rhs is not checked if lhs is false.
+     */
+    template < typename Player >
+    bool check( const Player & p ) const
+      {
+          return M_lhs.check( p ) && M_rhs.check( p );
+      }
+
+    /*!
+      \brief get the intersection of the bounded filters.
+      \param rect pointer to the variable to store the result
+      \return true if at least one filter is bounded.
+     */
+    bool boundingRect( Rect2D * rect ) const
+      {
+          Rect2D l, r;
+          const bool lb = M_lhs.boundingRect( &l );
+          const bool rb = M_rhs.boundingRect( &r );
+
+          if ( lb && rb )
+          {
+              const double left = std::max( l.left(), r.left() );
+              const double top = std::max( l.top(), r.top() );
+              const double right = std::min( l.right(), r.right() );
+              const double bottom = std::min( l.bottom(), r.bottom() );
+              *rect = ( left <= right && top <= bottom
+                        ? Rect2D::from_corners( left, top, right, bottom )
+                        : Rect2D::from_corners( 1.0e6, 1.0e6, 1.0e6, 1.0e6 ) );
+              return true;
+          }
+
+          if ( lb )
+          {
+              *rect = l;
+              return true;
+          }
+
+          if ( rb )
+          {
+              *rect = r;
+              return true;
+          }
+
+          return false;
+      }
+};
+
+/*-------------------------------------------------------------------*/
+/*!
+  \class OrPlayerFilter
+  \brief logical "or" of two filters
+*/
+template < typename L, typename R >
+class OrPlayerFilter
+    : public PlayerFilter< OrPlayerFilter< L, R > > {
+private:
+    L M_lhs; //!< left hand side filter
+    R M_rhs; //!< right hand side filter
+
+public:
+    /*!
+      \brief construct with two filters
+      \param lhs left hand side filter
+      \param rhs right hand side filter
+     */
+    OrPlayerFilter( const L & lhs,
+                    const R & rhs )
+        : M_lhs( lhs ),
+          M_rhs( rhs )
+      { }
+
+    /*!
+      \brief filter function
+      \param p const reference to the target player object
+      \return the result of "or" operation. rhs is not checked if lhs is true.
+     */
+    template < typename Player >
+    bool check( const Player & p ) const
+      {
+          return M_lhs.check( p ) || M_rhs.check( p );
+      }
+
+    /*!
+      \brief get the union of the bounded filters.
+      \param rect pointer to the variable to store the result
+      \return true if both filters are bounded.
+     */
+    bool boundingRect( Rect2D * rect ) const
+      {
+          Rect2D l, r;
+          if ( ! M_lhs.boundingRect( &l )
+               || ! M_rhs.boundingRect( &r ) )
+          {
+              return false;
+          }
+
+          *rect = Rect2D::from_corners( std::min( l.left(), r.left() ),
+                                        std::min( l.top(), r.top() ),
+                                        std::max( l.right(), r.right() ),
+                                        std::max( l.bottom(), r.bottom() ) );
+          return true;
+      }
+};
+
+/*-------------------------------------------------------------------*/
+/*!
+  \class NotPlayerFilter
+  \brief logical "not" of the filter
+*/
+template < typename T >
+class NotPlayerFilter
+    : public PlayerFilter< NotPlayerFilter< T > > {
+private:
+    T M_filter; //!< negated filter
+
+public:
+    /*!
+      \brief construct with the negated filter
+      \param filter negated filter
+     */
+    explicit
+    NotPlayerFilter( const T & filter )
+        : M_filter( filter )
+      { }
+
+    /*!
+      \brief filter function
+      \param p const reference to the target player object
+      \return the negated result
+     */
+    template < typename Player >
+    bool check( const Player & p ) const
+      {
+          return ! M_filter.check( p );
+      }
+
+    /*!
+      \brief get the rectangle that contains all the matched players.
+      \return always false
+     */
+    bool boundingRect( Rect2D * ) const
+      {
+          return false;
+      }
+};
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief create the logical "and" filter
+  \param lhs left hand side filter
+  \param rhs right hand side filter
+  \return filter object
+ */
+template < typename L, typename R >
+inline
+AndPlayerFilter< L, R >
+operator&&( const PlayerFilter< L > & lhs,
+            const PlayerFilter< R > & rhs )
+{
+    return AndPlayerFilter< L, R >( lhs.derived(), rhs.derived() );
+}
+
+/*!
+  \brief create the logical "or" filter
+  \param lhs left hand side filter
+  \param rhs right hand side filter
+  \return filter object
+ */
+template < typename L, typename R >
+inline
+OrPlayerFilter< L, R >
+operator||( const PlayerFilter< L > & lhs,
+            const PlayerFilter< R > & rhs )
+{
+    return OrPlayerFilter< L, R >( lhs.derived(), rhs.derived() );
+}
+
+/*!
+  \brief create the logical "not" filter
+  \param filter negated filter
+  \return filter object
+ */
+template < typename T >
+inline
+NotPlayerFilter< T >
+operator!( const PlayerFilter< T > & filter )
+{
+    return NotPlayerFilter< T >( filter.derived() );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \namespace player_filter
+  \brief factory functions of the filters. each one has the same condition
+  as the PlayerPredicate class with the corresponding name.
+*/
+namespace player_filter {
+
+/*!
+  \brief create the filter from the function object
+  \param func function object that takes the player object and returns bool
+  \return filter object
+ */
+template < typename Func >
+inline
+FunctionPlayerFilter< Func >
+custom( const Func & func )
+{
+    return FunctionPlayerFilter< Func >( func );
+}
+
+/*!
+  \brief create the filter from the function object and its bounding rectangle
+  \param func function object that takes the player object and returns bool
+  \param rect rectangle that contains all the players matched with func
+  \return filter object
+ */
+template < typename Func >
+inline
+BoundedPlayerFilter< Func >
+bounded( const Func & func,
+         const Rect2D & rect )
+{
+    return BoundedPlayerFilter< Func >( func, rect );
+}
+
+/*!
+  \brief same as SelfPlayerPredicate
+  \param our_side side self player belonging
+  \param self_unum uniform number of self
+  \return filter object
+ */
+inline
+auto
+self( const SideID our_side,
+      const int self_unum )
+{
+    return custom( [our_side, self_unum]( const auto & p )
+                   {
+                       return p.side() == our_side
+                           && p.unum() == self_unum;
+                   } );
+}
+
+/*!
+  \brief same as SelfPlayerPredicate
+  \param wm const reference to the WorldModel instance
+  \return filter object
+ */
+inline
+auto
+self( const WorldModel & wm )
+{
+    return self( wm.ourSide(), wm.self().unum() );
+}
+
+/*!
+  \brief same as TeammateOrSelfPlayerPredicate
+  \param our_side side self player belonging
+  \return filter object
+ */
+inline
+auto
+teammate_or_self( const SideID our_side )
+{
+    return custom( [our_side]( const auto & p )
+                   {
+                       return p.side() == our_side;
+                   } );
+}
+
+/*!
+  \brief same as TeammateOrSelfPlayerPredicate
+  \param wm const reference to the WorldModel instance
+  \return filter object
+ */
+inline
+auto
+teammate_or_self( const WorldModel & wm )
+{
+    return teammate_or_self( wm.ourSide() );
+}
+
+/*!
+  \brief same as TeammatePlayerPredicate
+  \param our_side side self player belonging
+  \param self_unum uniform number of self
+  \return filter object
+ */
+inline
+auto
+teammate( const SideID our_side,
+          const int self_unum )
+{
+    return custom( [our_side, self_unum]( const auto & p )
+                   {
+                       return p.side() == our_side
+                           && p.unum() != self_unum;
+                   } );
+}
+
+/*!
+  \brief same as TeammatePlayerPredicate
+  \param wm const reference to the WorldModel instance
+  \return filter object
+ */
+inline
+auto
+teammate( const WorldModel & wm )
+{
+    return teammate( wm.ourSide(), wm.self().unum() );
+}
+
+/*!
+  \brief same as OpponentPlayerPredicate
+  \param our_side side self player belonging
+  \return filter object
+ */
+inline
+auto
+opponent( const SideID our_side )
+{
+    return custom( [our_side]( const auto & p )
+                   {
+                       return p.side() != our_side
+                           && p.side() != NEUTRAL;
+                   } );
+}
+
+/*!
+  \brief same as OpponentPlayerPredicate
+  \param wm const reference to the WorldModel instance
+  \return filter object
+ */
+inline
+auto
+opponent( const WorldModel & wm )
+{
+    return opponent( wm.ourSide() );
+}
+
+/*!
+  \brief same as OpponentOrUnknownPlayerPredicate
+  \param our_side side self player belonging
+  \return filter object
+ */
+inline
+auto
+opponent_or_unknown( const SideID our_side )
+{
+    return custom( [our_side]( const auto & p )
+                   {
+                       return p.side() != our_side;
+                   } );
+}
+
+/*!
+  \brief same as OpponentOrUnknownPlayerPredicate
+  \param wm const reference to the WorldModel instance
+  \return filter object
+ */
+inline
+auto
+opponent_or_unknown( const WorldModel & wm )
+{
+    return opponent_or_unknown( wm.ourSide() );
+}
+
+/*!
+  \brief same as GoaliePlayerPredicate
+  \return filter object
+ */
+inline
+auto
+goalie()
+{
+    return custom( []( const auto & p )
+                   {
+                       return p.goalie();
+                   } );
+}
+
+/*!
+  \brief same as FieldPlayerPredicate
+  \return filter object
+ */
+inline
+auto
+field_player()
+{
+    return custom( []( const auto & p )
+                   {
+                       return ! p.goalie();
+                   } );
+}
+
+/*!
+  \brief same as CoordinateAccuratePlayerPredicate
+  \param threshold accuracy threshold value
+  \return filter object
+ */
+inline
+auto
+coordinate_accurate( const int threshold )
+{
+    return custom( [threshold]( const auto & p )
+                   {
+                       return p.posCount() <= threshold;
+                   } );
+}
+
+/*!
+  \brief same as GhostPlayerPredicate
+  \return filter object
+ */
+inline
+auto
+ghost()
+{
+    return custom( []( const auto & p )
+                   {
+                       return p.isGhost();
+                   } );
+}
+
+/*!
+  \brief same as NoGhostPlayerPredicate
+  \param threshold accuracy threshold value
+  \return filter object
+ */
+inline
+auto
+no_ghost( const int threshold = 0xFFFF )
+{
+    return custom( [threshold]( const auto & p )
+                   {
+                       return ! p.isGhost()
+                           && p.posCount() <= threshold;
+                   } );
+}
+
+/*!
+  \brief same as XCoordinateForwardPlayerPredicate
+  \param threshold x-coordinate threshold value
+  \return filter object
+ */
+inline
+auto
+x_forward( const double threshold )
+{
+    return bounded( [threshold]( const auto & p )
+                    {
+                        return p.pos().x >= threshold;
+                    },
+                    Rect2D::from_corners( threshold, -1.0e6, 1.0e6, 1.0e6 ) );
+}
+
+/*!
+  \brief same as XCoordinateBackwardPlayerPredicate
+  \param threshold x-coordinate threshold value
+  \return filter object
+ */
+inline
+auto
+x_backward( const double threshold )
+{
+    return bounded( [threshold]( const auto & p )
+                    {
+                        return p.pos().x <= threshold;
+                    },
+                    Rect2D::from_corners( -1.0e6, -1.0e6, threshold, 1.0e6 ) );
+}
+
+/*!
+  \brief same as YCoordinatePlusPlayerPredicate
+  \param threshold y-coordinate threshold value
+  \return filter object
+ */
+inline
+auto
+y_plus( const double threshold )
+{
+    return bounded( [threshold]( const auto & p )
+                    {
+                        return p.pos().y >= threshold;
+                    },
+                    Rect2D::from_corners( -1.0e6, threshold, 1.0e6, 1.0e6 ) );
+}
+
+/*!
+  \brief same as YCoordinateMinusPlayerPredicate
+  \param threshold y-coordinate threshold value
+  \return filter object
+ */
+inline
+auto
+y_minus( const double threshold )
+{
+    return bounded( [threshold]( const auto & p )
+                    {
+                        return p.pos().y <= threshold;
+                    },
+                    Rect2D::from_corners( -1.0e6, -1.0e6, 1.0e6, threshold ) );
+}
+
+/*!
+  \brief same as PointFarPlayerPredicate
+  \param base_point base point
+  \param threshold distance threshold value
+  \return filter object
+ */
+inline
+auto
+point_far( const Vector2D & base_point,
+           const double threshold )
+{
+    const double threshold2 = threshold * threshold;
+    return custom( [base_point, threshold2]( const auto & p )
+                   {
+                       return ( p.pos() - base_point ).r2() >= threshold2;
+                   } );
+}
+
+/*!
+  \brief same as PointNearPlayerPredicate
+  \param base_point base point
+  \param threshold distance threshold value
+  \return filter object
+ */
+inline
+auto
+point_near( const Vector2D & base_point,
+            const double threshold )
+{
+    const double threshold2 = threshold * threshold;
+    return bounded( [base_point, threshold2]( const auto & p )
+                    {
+                        return ( p.pos() - base_point ).r2() <= threshold2;
+                    },
+                    Rect2D::from_corners( base_point.x - threshold, base_point.y - threshold,
+                                          base_point.x + threshold, base_point.y + threshold ) );
+}
+
+/*!
+  \brief same as AbsAngleDiffLessPlayerPredicate
+  \param base_point base point
+  \param base_angle compared angle
+  \param degree_threshold angle threshold value (degree)
+  \return filter object
+ */
+inline
+auto
+abs_angle_diff_less( const Vector2D & base_point,
+                     const AngleDeg & base_angle,
+                     const double degree_threshold )
+{
+    const double threshold = std::fabs( degree_threshold );
+    return custom( [base_point, base_angle, threshold]( const auto & p )
+                   {
+                       return ( ( p.pos() - base_point ).th() - base_angle ).abs() <= threshold;
+                   } );
+}
+
+/*!
+  \brief same as AbsAngleDiffGreaterPlayerPredicate
+  \param base_point base point
+  \param base_angle compared angle
+  \param degree_threshold angle threshold value (degree)
+  \return filter object
+ */
+inline
+auto
+abs_angle_diff_greater( const Vector2D & base_point,
+                        const AngleDeg & base_angle,
+                        const double degree_threshold )
+{
+    const double threshold = std::fabs( degree_threshold );
+    return custom( [base_point, base_angle, threshold]( const auto & p )
+                   {
+                       return ( ( p.pos() - base_point ).th() - base_angle ).abs() >= threshold;
+                   } );
+}
+
+/*!
+  \brief same as ContainsPlayerPredicate. the filter is bounded if the region is
+  Rect2D, Circle2D or Sector2D.
+  \param region checked region
+  \return filter object
+ */
+template < typename T >
+inline
+auto
+contains( const T & region )
+{
+    Rect2D rect;
+    const bool is_bounded = get_bounding_rect( region, &rect );
+    return bounded( [region]( const auto & p )
+                    {
+                        return region.contains( p.pos() );
+                    },
+                    is_bounded
+                    ? rect
+                    : Rect2D::from_corners( -1.0e6, -1.0e6, 1.0e6, 1.0e6 ) );
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+template < typename Filter >
+AbstractPlayerObject::Cont
+WorldModel::getPlayers( const PlayerFilter< Filter > & filter ) const
+{
+    AbstractPlayerObject::Cont rval;
+    getPlayers( rval, filter );
+    return rval;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+template < typename Filter >
+void
+WorldModel::getPlayers( AbstractPlayerObject::Cont & cont,
+                        const PlayerFilter< Filter > & filter ) const
+{
+    const Filter & f = filter.derived();
+
+    Rect2D rect;
+    if ( f.boundingRect( &rect ) )
+    {
+        int indices[PlayerGrid::CAPACITY];
+        const int n = findPlayerIndicesIn( rect, indices );
+        for ( int i = 0; i < n; ++i )
+        {
+            const AbstractPlayerObject * p = M_all_players[indices[i]];
+            if ( f.check( *p ) )
+            {
+                cont.push_back( p );
+            }
+        }
+        return;
+    }
+
+    for ( const AbstractPlayerObject * p : M_all_players )
+    {
+        if ( f.check( *p ) )
+        {
+            cont.push_back( p );
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+template < typename Filter >
+size_t
+WorldModel::countPlayer( const PlayerFilter< Filter > & filter ) const
+{
+    const Filter & f = filter.derived();
+    size_t count = 0;
+
+    Rect2D rect;
+    if ( f.boundingRect( &rect ) )
+    {
+        int indices[PlayerGrid::CAPACITY];
+        const int n = findPlayerIndicesIn( rect, indices );
+        for ( int i = 0; i < n; ++i )
+        {
+            if ( f.check( *M_all_players[indices[i]] ) )
+            {
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    for ( const AbstractPlayerObject * p : M_all_players )
+    {
+        if ( f.check( *p ) )
+        {
+            ++count;
+        }
+    }
+
+    return count;
+}
+
+}
+
+#endif
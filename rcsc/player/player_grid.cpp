@@ -0,0 +1,250 @@
+// -*-c++-*-
+
+/*!
+  \file player_grid.cpp
+  \brief uniform grid index of player positions Source File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "player_grid.h"
+
+#include "abstract_player_object.h"
+
+#include <rcsc/geom/circle_2d.h>
+#include <rcsc/geom/sector_2d.h>
+
+#include <limits>
+#include <cassert>
+
+namespace rcsc {
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+PlayerGrid::PlayerGrid()
+    : M_size( 0 ),
+      M_added( 0 )
+{
+    std::fill( M_cell_start, M_cell_start + COLUMNS * ROWS + 1, 0 );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+PlayerGrid::clear()
+{
+    M_size = 0;
+    M_added = 0;
+    std::fill( M_cell_start, M_cell_start + COLUMNS * ROWS + 1, 0 );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+PlayerGrid::add( const AbstractPlayerObject * player,
+                 const int index,
+                 const Group group )
+{
+    if ( M_added >= CAPACITY )
+    {
+        return;
+    }
+
+    Entry & e = M_added_entries[M_added];
+    e.player_ = player;
+    e.index_ = index;
+    e.group_ = group;
+    M_added_cells[M_added] = row( player->pos().y ) * COLUMNS + column( player->pos().x );
+    ++M_added;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  counting sort by cell. the added order is kept in each cell.
+*/
+void
+PlayerGrid::build()
+{
+    const int n_cells = COLUMNS * ROWS;
+
+    std::fill( M_cell_start, M_cell_start + n_cells + 1, 0 );
+    for ( int i = 0; i < M_added; ++i )
+    {
+        ++M_cell_start[M_added_cells[i] + 1];
+    }
+
+    for ( int c = 0; c < n_cells; ++c )
+    {
+        M_cell_start[c + 1] += M_cell_start[c];
+    }
+
+    int next[COLUMNS * ROWS];
+    std::copy( M_cell_start, M_cell_start + n_cells, next );
+
+    for ( int i = 0; i < M_added; ++i )
+    {
+        const int pos = next[M_added_cells[i]]++;
+        M_entries[pos] = M_added_entries[i];
+        M_x[pos] = M_added_entries[i].player_->pos().x;
+        M_y[pos] = M_added_entries[i].player_->pos().y;
+    }
+
+    M_size = M_added;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+int
+PlayerGrid::findIn( const Rect2D & rect,
+                    const int groups,
+                    const Entry ** result ) const
+{
+    int n = 0;
+    forEachIn( rect, groups,
+               [&]( const Entry & e, double, double )
+               {
+                   result[n++] = &e;
+               } );
+    return n;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+int
+PlayerGrid::findIn( const Circle2D & circle,
+                    const int groups,
+                    const Entry ** result ) const
+{
+    const Vector2D & c = circle.center();
+    const double r = circle.radius();
+    const double r2 = r * r;
+
+    int n = 0;
+    forEachIn( Rect2D::from_corners( c.x - r, c.y - r, c.x + r, c.y + r ), groups,
+               [&]( const Entry & e, const double x, const double y )
+               {
+                   // the same condition as Circle2D::contains()
+                   const double dx = x - c.x;
+                   const double dy = y - c.y;
+                   if ( dx * dx + dy * dy < r2 )
+                   {
+                       result[n++] = &e;
+                   }
+               } );
+    return n;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+int
+PlayerGrid::findIn( const Sector2D & sector,
+                    const int groups,
+                    const Entry ** result ) const
+{
+    const Vector2D & c = sector.center();
+    const double r = sector.radiusMax();
+
+    int n = 0;
+    forEachIn( Rect2D::from_corners( c.x - r, c.y - r, c.x + r, c.y + r ), groups,
+               [&]( const Entry & e, const double x, const double y )
+               {
+                   if ( sector.contains( Vector2D( x, y ) ) )
+                   {
+                       result[n++] = &e;
+                   }
+               } );
+    return n;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+int
+PlayerGrid::findIndicesIn( const Rect2D & rect,
+                           int * result ) const
+{
+    int n = 0;
+    forEachIn( rect, ALL_PLAYERS,
+               [&]( const Entry & e, double, double )
+               {
+                   if ( e.index_ >= 0 )
+                   {
+                       result[n++] = e.index_;
+                   }
+               } );
+    std::sort( result, result + n );
+    return n;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+double
+PlayerGrid::ringClearance( const Vector2D & point,
+                           const int cx,
+                           const int cy,
+                           const int ring )
+{
+    double clearance = std::numeric_limits< double >::max();
+
+    if ( cx - ring > 0 )
+    {
+        clearance = std::min( clearance, point.x - ( MIN_X + ( cx - ring ) * CELL_SIZE ) );
+    }
+    if ( cx + ring < COLUMNS - 1 )
+    {
+        clearance = std::min( clearance, ( MIN_X + ( cx + ring + 1 ) * CELL_SIZE ) - point.x );
+    }
+    if ( cy - ring > 0 )
+    {
+        clearance = std::min( clearance, point.y - ( MIN_Y + ( cy - ring ) * CELL_SIZE ) );
+    }
+    if ( cy + ring < ROWS - 1 )
+    {
+        clearance = std::min( clearance, ( MIN_Y + ( cy + ring + 1 ) * CELL_SIZE ) - point.y );
+    }
+
+    return std::max( 0.0, clearance );
+}
+
+}
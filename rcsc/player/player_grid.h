@@ -0,0 +1,380 @@
+// -*-c++-*-
+
+/*!
+  \file player_grid.h
+  \brief uniform grid index of player positions Header File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_PLAYER_PLAYER_GRID_H
+#define RCSC_PLAYER_PLAYER_GRID_H
+
+#include <rcsc/player/player_object.h>
+#include <rcsc/geom/rect_2d.h>
+#include <rcsc/geom/vector_2d.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace rcsc {
+
+class AbstractPlayerObject;
+class Circle2D;
+class Sector2D;
+
+/*!
+  \class PlayerGrid
+  \brief uniform grid index of the player positions.
+
+  The grid is rebuilt once per cycle just before the decision making, and
+  answers the region queries by scanning only the overlapped cells. The
+  players are stored in the cell order with their positions in separate
+  arrays, and no memory allocation occurs after the construction.
+
+  Each entry has the index in WorldModel::allPlayers(), so the results of
+  a region query can be converted to the usual container order.
+*/
+class PlayerGrid {
+public:
+
+    //! player group flags
+    enum Group {
+        SELF = 1,
+        TEAMMATE = 2,
+        OPPONENT = 4,
+        UNKNOWN = 8,
+        OUR_PLAYERS = SELF | TEAMMATE,
+        THEIR_PLAYERS = OPPONENT | UNKNOWN,
+        ALL_PLAYERS = SELF | TEAMMATE | OPPONENT | UNKNOWN,
+    };
+
+    /*!
+      \struct Entry
+      \brief indexed player
+     */
+    struct Entry {
+        const AbstractPlayerObject * player_; //!< player object
+        int index_; //!< index in WorldModel::allPlayers(), or -1 if not included.
+        int group_; //!< group flag
+    };
+
+    //! the maximum number of entries
+    static const int CAPACITY = PlayerObjectPool::CAPACITY + 1;
+
+    //! the number of columns
+    static const int COLUMNS = 12;
+    //! the number of rows
+    static const int ROWS = 8;
+    //! the length of the cell edge
+    static constexpr double CELL_SIZE = 10.0;
+    //! the minimum x of the covered area. positions outside the area belong to the border cells.
+    static constexpr double MIN_X = -( COLUMNS * CELL_SIZE * 0.5 );
+    //! the minimum y of the covered area
+    static constexpr double MIN_Y = -( ROWS * CELL_SIZE * 0.5 );
+
+private:
+
+    int M_size; //!< the number of entries
+    Entry M_entries[CAPACITY]; //!< entries in the cell order
+    double M_x[CAPACITY]; //!< x coordinates of the entries
+    double M_y[CAPACITY]; //!< y coordinates of the entries
+    int M_cell_start[COLUMNS * ROWS + 1]; //!< the first entry of each cell
+
+    int M_added; //!< the number of entries added since clear()
+    Entry M_added_entries[CAPACITY]; //!< entries in the added order
+    int M_added_cells[CAPACITY]; //!< cells of the added entries
+
+    // not used
+    PlayerGrid( const PlayerGrid & ) = delete;
+    PlayerGrid & operator=( const PlayerGrid & ) = delete;
+
+public:
+
+    /*!
+      \brief create an empty grid
+     */
+    PlayerGrid();
+
+    /*!
+      \brief remove all entries
+     */
+    void clear();
+
+    /*!
+      \brief register the player. build() must be called after all players are added.
+      \param player player object
+      \param index index in WorldModel::allPlayers(), or -1
+      \param group group flag
+     */
+    void add( const AbstractPlayerObject * player,
+              const int index,
+              const Group group );
+
+    /*!
+      \brief sort the added entries by cell
+     */
+    void build();
+
+    /*!
+      \brief get the number of entries
+      \return the number of entries
+     */
+    int size() const
+      {
+          return M_size;
+      }
+
+    /*!
+      \brief call the function for each entry in the rectangle
+      \param rect checked rectangle
+      \param groups the bitwise or of the checked groups
+      \param func function object called with (const Entry &, double x, double y)
+     */
+    template < typename Func >
+    void forEachIn( const Rect2D & rect,
+                    const int groups,
+                    Func func ) const
+      {
+          const double left = rect.left();
+          const double right = rect.right();
+          const double top = rect.top();
+          const double bottom = rect.bottom();
+
+          const int c0 = column( left ), c1 = column( right );
+          const int r0 = row( top ), r1 = row( bottom );
+
+          for ( int r = r0; r <= r1; ++r )
+          {
+              const int * cell = M_cell_start + r * COLUMNS;
+              for ( int i = cell[c0], end = cell[c1 + 1]; i < end; ++i )
+              {
+                  if ( ( M_entries[i].group_ & groups )
+                       && left <= M_x[i] && M_x[i] <= right
+                       && top <= M_y[i] && M_y[i] <= bottom )
+                  {
+                      func( M_entries[i], M_x[i], M_y[i] );
+                  }
+              }
+          }
+      }
+
+    /*!
+      \brief get the entries in the rectangle
+      \param rect checked rectangle
+      \param groups the bitwise or of the checked groups
+      \param result array of CAPACITY elements to store the result
+      \return the number of found entries
+     */
+    int findIn( const Rect2D & rect,
+                const int groups,
+                const Entry ** result ) const;
+
+    /*!
+      \brief get the entries in the circle. the entries on the circle are not included.
+      \param circle checked circle
+      \param groups the bitwise or of the checked groups
+      \param result array of CAPACITY elements to store the result
+      \return the number of found entries
+     */
+    int findIn( const Circle2D & circle,
+                const int groups,
+                const Entry ** result ) const;
+
+    /*!
+      \brief get the entries in the sector
+      \param sector checked sector
+      \param groups the bitwise or of the checked groups
+      \param result array of CAPACITY elements to store the result
+      \return the number of found entries
+     */
+    int findIn( const Sector2D & sector,
+                const int groups,
+                const Entry ** result ) const;
+
+    /*!
+      \brief get the indices in WorldModel::allPlayers() of the players in the rectangle
+      \param rect checked rectangle
+      \param result array of CAPACITY elements to store the result
+      \return the number of found players. the result is sorted in ascending order.
+     */
+    int findIndicesIn( const Rect2D & rect,
+                       int * result ) const;
+
+    /*!
+      \brief get the nearest k entries that satisfy the filter
+      \param point base point
+      \param k the maximum number of the result
+      \param groups the bitwise or of the checked groups
+      \param filter function object that takes (const Entry &) and returns false to skip it
+      \param result array of at least k elements to store the result
+      \param dist2 array of at least k elements to store the squared distances, or NULL
+      \return the number of found entries. the result is sorted by distance.
+     */
+    template < typename Filter >
+    int findNearest( const Vector2D & point,
+                     const int k,
+                     const int groups,
+                     Filter filter,
+                     const Entry ** result,
+                     double * dist2 ) const
+      {
+          if ( k <= 0 )
+          {
+              return 0;
+          }
+
+          double best_dist2[CAPACITY];
+          int n = 0;
+
+          const auto scan_cell = [&]( const int cell )
+              {
+                  for ( int i = M_cell_start[cell]; i < M_cell_start[cell + 1]; ++i )
+                  {
+                      if ( ! ( M_entries[i].group_ & groups )
+                           || ! filter( M_entries[i] ) )
+                      {
+                          continue;
+                      }
+
+                      const double dx = M_x[i] - point.x;
+                      const double dy = M_y[i] - point.y;
+                      const double d2 = dx * dx + dy * dy;
+                      if ( n == k
+                           && d2 >= best_dist2[n - 1] )
+                      {
+                          continue;
+                      }
+
+                      // insertion into the sorted result
+                      int j = ( n < k ? n++ : n - 1 );
+                      while ( j > 0
+                              && best_dist2[j - 1] > d2 )
+                      {
+                          best_dist2[j] = best_dist2[j - 1];
+                          result[j] = result[j - 1];
+                          --j;
+                      }
+                      best_dist2[j] = d2;
+                      result[j] = &M_entries[i];
+                  }
+              };
+
+          const int cx = column( point.x );
+          const int cy = row( point.y );
+          const int max_ring = std::max( std::max( cx, COLUMNS - 1 - cx ),
+                                         std::max( cy, ROWS - 1 - cy ) );
+
+          // scan the cells ring by ring from the nearest cell
+          for ( int ring = 0; ring <= max_ring; ++ring )
+          {
+              const int c0 = cx - ring, c1 = cx + ring;
+              const int r0 = cy - ring, r1 = cy + ring;
+              const int c_min = std::max( 0, c0 ), c_max = std::min( COLUMNS - 1, c1 );
+
+              for ( int r = std::max( 0, r0 ); r <= std::min( ROWS - 1, r1 ); ++r )
+              {
+                  if ( r == r0 || r == r1 )
+                  {
+                      for ( int c = c_min; c <= c_max; ++c )
+                      {
+                          scan_cell( r * COLUMNS + c );
+                      }
+                  }
+                  else
+                  {
+                      if ( c0 >= 0 )
+                      {
+                          scan_cell( r * COLUMNS + c0 );
+                      }
+                      if ( c1 < COLUMNS )
+                      {
+                          scan_cell( r * COLUMNS + c1 );
+                      }
+                  }
+              }
+
+              if ( n == k )
+              {
+                  const double clearance = ringClearance( point, cx, cy, ring );
+                  if ( best_dist2[n - 1] <= clearance * clearance )
+                  {
+                      break;
+                  }
+              }
+          }
+
+          if ( dist2 )
+          {
+              std::copy( best_dist2, best_dist2 + n, dist2 );
+          }
+
+          return n;
+      }
+
+private:
+
+    /*!
+      \brief get the column index
+      \param x x coordinate
+      \return column index, clamped to the grid
+     */
+    static
+    int column( const double x )
+      {
+          const int c = static_cast< int >( std::floor( ( x - MIN_X ) / CELL_SIZE ) );
+          return std::min( std::max( c, 0 ), COLUMNS - 1 );
+      }
+
+    /*!
+      \brief get the row index
+      \param y y coordinate
+      \return row index, clamped to the grid
+     */
+    static
+    int row( const double y )
+      {
+          const int r = static_cast< int >( std::floor( ( y - MIN_Y ) / CELL_SIZE ) );
+          return std::min( std::max( r, 0 ), ROWS - 1 );
+      }
+
+    /*!
+      \brief get the minimum distance from the point to the cells outside of the ring
+      \param point base point
+      \param cx column of the center cell
+      \param cy row of the center cell
+      \param ring ring size
+      \return distance. the sides at the grid border are not considered.
+     */
+    static
+    double ringClearance( const Vector2D & point,
+                          const int cx,
+                          const int cy,
+                          const int ring );
+};
+
+}
+
+#endif
@@ -0,0 +1,194 @@
+// -*-c++-*-
+
+/*!
+  \file player_matcher.cpp
+  \brief seen-to-memory player assignment solver Source File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "player_matcher.h"
+
+#include <limits>
+#include <cassert>
+
+namespace {
+
+//! cost of leaving the row unmatched. greater than the sum of all feasible costs.
+const double UNMATCHED_COST = 1.0e4;
+//! cost of the infeasible pair
+const double INFEASIBLE_COST = 1.0e8;
+
+}
+
+namespace rcsc {
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+PlayerMatcher::PlayerMatcher()
+    : M_rows( 0 ),
+      M_cols( 0 )
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+PlayerMatcher::reset( const int rows,
+                      const int cols )
+{
+    assert( 0 <= rows && rows <= MAX_ROWS );
+    assert( 0 <= cols && cols <= MAX_COLS );
+
+    M_rows = rows;
+    M_cols = cols;
+
+    for ( int r = 0; r < rows; ++r )
+    {
+        for ( int c = 0; c < cols; ++c )
+        {
+            M_cost[r][c] = -1.0;
+        }
+        M_assignment[r] = -1;
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  Hungarian method with potentials, O(rows^2 * cols).
+  Each row has its own dummy column, so the problem is always feasible.
+*/
+void
+PlayerMatcher::solve()
+{
+    const double inf = std::numeric_limits< double >::max();
+    const int n = M_rows;
+    const int m = M_cols + M_rows;
+
+    for ( int i = 0; i <= n; ++i )
+    {
+        M_row_potential[i] = 0.0;
+    }
+
+    for ( int j = 0; j <= m; ++j )
+    {
+        M_col_potential[j] = 0.0;
+        M_col_owner[j] = 0;
+        M_prev_col[j] = 0;
+    }
+
+    for ( int i = 1; i <= n; ++i )
+    {
+        M_col_owner[0] = i;
+        int j0 = 0;
+
+        for ( int j = 0; j <= m; ++j )
+        {
+            M_min_slack[j] = inf;
+            M_visited[j] = false;
+        }
+
+        // grow the alternating tree until a free column is found
+        do
+        {
+            M_visited[j0] = true;
+            const int i0 = M_col_owner[j0];
+            double delta = inf;
+            int j1 = 0;
+
+            for ( int j = 1; j <= m; ++j )
+            {
+                if ( M_visited[j] )
+                {
+                    continue;
+                }
+
+                const double cost = ( j <= M_cols
+                                      ? ( M_cost[i0 - 1][j - 1] >= 0.0
+                                          ? M_cost[i0 - 1][j - 1]
+                                          : INFEASIBLE_COST )
+                                      : UNMATCHED_COST );
+                const double slack = cost - M_row_potential[i0] - M_col_potential[j];
+                if ( slack < M_min_slack[j] )
+                {
+                    M_min_slack[j] = slack;
+                    M_prev_col[j] = j0;
+                }
+
+                if ( M_min_slack[j] < delta )
+                {
+                    delta = M_min_slack[j];
+                    j1 = j;
+                }
+            }
+
+            for ( int j = 0; j <= m; ++j )
+            {
+                if ( M_visited[j] )
+                {
+                    M_row_potential[M_col_owner[j]] += delta;
+                    M_col_potential[j] -= delta;
+                }
+                else
+                {
+                    M_min_slack[j] -= delta;
+                }
+            }
+
+            j0 = j1;
+        }
+        while ( M_col_owner[j0] != 0 );
+
+        // flip the augmenting path
+        do
+        {
+            const int j1 = M_prev_col[j0];
+            M_col_owner[j0] = M_col_owner[j1];
+            j0 = j1;
+        }
+        while ( j0 != 0 );
+    }
+
+    for ( int j = 1; j <= M_cols; ++j )
+    {
+        const int i = M_col_owner[j];
+        if ( i != 0
+             && M_cost[i - 1][j - 1] >= 0.0 )
+        {
+            M_assignment[i - 1] = j - 1;
+        }
+    }
+}
+
+}
@@ -0,0 +1,123 @@
+// -*-c++-*-
+
+/*!
+  \file player_matcher.h
+  \brief seen-to-memory player assignment solver Header File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_PLAYER_PLAYER_MATCHER_H
+#define RCSC_PLAYER_PLAYER_MATCHER_H
+
+namespace rcsc {
+
+/*!
+  \class PlayerMatcher
+  \brief minimum cost assignment between the seen players and the remembered players.
+
+  Rows are the seen players and columns are the candidates in memory.
+  The Hungarian method finds the assignment that matches the largest
+  number of rows first, and then minimizes the sum of the costs. A row
+  that has no feasible column is left unmatched. All work arrays have a
+  fixed size, so solve() never allocates memory.
+*/
+class PlayerMatcher {
+public:
+
+    //! the maximum number of rows
+    static const int MAX_ROWS = 32;
+    //! the maximum number of columns
+    static const int MAX_COLS = 64;
+
+private:
+
+    //! the number of columns used by the solver, including one dummy column per row
+    static const int WORK_SIZE = MAX_COLS + MAX_ROWS + 1;
+
+    int M_rows; //!< the number of rows
+    int M_cols; //!< the number of columns
+    double M_cost[MAX_ROWS][MAX_COLS]; //!< cost matrix. negative value means infeasible.
+    int M_assignment[MAX_ROWS]; //!< solved column for each row, or -1
+
+    // work arrays of the Hungarian method. index 0 is a sentinel.
+    double M_row_potential[MAX_ROWS + 1];
+    double M_col_potential[WORK_SIZE];
+    double M_min_slack[WORK_SIZE];
+    int M_col_owner[WORK_SIZE];
+    int M_prev_col[WORK_SIZE];
+    bool M_visited[WORK_SIZE];
+
+    // not used
+    PlayerMatcher( const PlayerMatcher & ) = delete;
+    PlayerMatcher & operator=( const PlayerMatcher & ) = delete;
+
+public:
+
+    /*!
+      \brief create an empty problem
+     */
+    PlayerMatcher();
+
+    /*!
+      \brief start the new problem. all pairs are initialized as infeasible.
+      \param rows the number of rows. must not exceed MAX_ROWS.
+      \param cols the number of columns. must not exceed MAX_COLS.
+     */
+    void reset( const int rows,
+                const int cols );
+
+    /*!
+      \brief set the cost of the pair
+      \param row row index
+      \param col column index
+      \param cost non negative cost value. negative value means infeasible.
+     */
+    void setCost( const int row,
+                  const int col,
+                  const double cost )
+      {
+          M_cost[row][col] = cost;
+      }
+
+    /*!
+      \brief solve the assignment problem
+     */
+    void solve();
+
+    /*!
+      \brief get the solved column
+      \param row row index
+      \return column index, or -1 if the row is not matched
+     */
+    int assignment( const int row ) const
+      {
+          return M_assignment[row];
+      }
+};
+
+}
+
+#endif
@@ -41,6 +41,8 @@
 #include <rcsc/common/server_param.h>
 #include <rcsc/common/player_type.h>
 
+#include <cassert>
+
 // #define DEBUG_PRINT
 
 namespace rcsc {
@@ -49,7 +51,7 @@ int PlayerObject::S_pos_count_thr = 30;
 int PlayerObject::S_vel_count_thr = 5;
 int PlayerObject::S_face_count_thr = 2;
 
-int PlayerObject::S_player_count = 0;
+thread_local int PlayerObject::S_player_count = 0;
 
 /*-------------------------------------------------------------------*/
 /*!
@@ -167,10 +169,6 @@ void
 PlayerObject::update()
 {
     M_pos_history.push_front( M_pos );
-    if ( M_pos_history.size() > 100 )
-    {
-        M_pos_history.pop_back();
-    }
 
     if ( velValid() )
     {
@@ -502,4 +500,182 @@ PlayerObject::forget()
         = 1000;
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+PlayerObjectPool::PlayerObjectPool()
+    : M_free( 0 ),
+      M_used( 0 )
+{
+    for ( int i = 0; i < CAPACITY; ++i )
+    {
+        M_slots[i].prev_ = NPOS;
+        M_slots[i].next_ = ( i + 1 < CAPACITY ? i + 1 : NPOS );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+PlayerObjectPool::destroy( const int i )
+{
+    object( i ).~PlayerObject();
+    M_slots[i].prev_ = NPOS;
+    M_slots[i].next_ = M_free;
+    M_free = i;
+    --M_used;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+PlayerObjectList::iterator
+PlayerObjectList::erase( iterator pos )
+{
+    const int i = pos.M_index;
+    const int next = M_pool->next( i );
+
+    unlink( i );
+    M_pool->destroy( i );
+
+    return iterator( M_pool, next );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+PlayerObjectList::pop_back()
+{
+    const int i = M_back;
+
+    unlink( i );
+    M_pool->destroy( i );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+PlayerObjectList::clear()
+{
+    int i = M_front;
+    while ( i != PlayerObjectPool::NPOS )
+    {
+        const int next = M_pool->next( i );
+        M_pool->destroy( i );
+        i = next;
+    }
+
+    M_front = M_back = PlayerObjectPool::NPOS;
+    M_size = 0;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+PlayerObjectList::splice( const_iterator pos,
+                          PlayerObjectList & other,
+                          iterator it )
+{
+    assert( M_pool == other.M_pool );
+
+    other.unlink( it.M_index );
+    link( pos.M_index, it.M_index );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+PlayerObjectList::splice( const_iterator pos,
+                          PlayerObjectList & other )
+{
+    assert( M_pool == other.M_pool );
+
+    while ( ! other.empty() )
+    {
+        const int i = other.M_front;
+        other.unlink( i );
+        link( pos.M_index, i );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+PlayerObjectList::link( const int pos,
+                        const int i )
+{
+    const int prev = ( pos == PlayerObjectPool::NPOS
+                       ? M_back
+                       : M_pool->prev( pos ) );
+
+    M_pool->prev( i ) = prev;
+    M_pool->next( i ) = pos;
+
+    if ( prev == PlayerObjectPool::NPOS )
+    {
+        M_front = i;
+    }
+    else
+    {
+        M_pool->next( prev ) = i;
+    }
+
+    if ( pos == PlayerObjectPool::NPOS )
+    {
+        M_back = i;
+    }
+    else
+    {
+        M_pool->prev( pos ) = i;
+    }
+
+    ++M_size;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+void
+PlayerObjectList::unlink( const int i )
+{
+    const int prev = M_pool->prev( i );
+    const int next = M_pool->next( i );
+
+    if ( prev == PlayerObjectPool::NPOS )
+    {
+        M_front = next;
+    }
+    else
+    {
+        M_pool->next( prev ) = next;
+    }
+
+    if ( next == PlayerObjectPool::NPOS )
+    {
+        M_back = prev;
+    }
+    else
+    {
+        M_pool->prev( next ) = prev;
+    }
+
+    M_pool->prev( i ) = M_pool->next( i ) = PlayerObjectPool::NPOS;
+    --M_size;
+}
+
 }
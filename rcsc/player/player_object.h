@@ -33,6 +33,7 @@
 #define RCSC_PLAYER_PLAYER_OBJECT_H
 
 #include <rcsc/player/abstract_player_object.h>
+#include <rcsc/player/position_history.h>
 
 #include <rcsc/player/localization.h>
 #include <rcsc/player/fullstate_sensor.h>
@@ -42,10 +43,15 @@
 #include <rcsc/types.h>
 
 #include <vector>
-#include <list>
+#include <iterator>
+#include <utility>
+#include <new>
+#include <cstddef>
 
 namespace rcsc {
 
+class PlayerObjectList;
+
 /*!
   \class PlayerObject
   \brief observed player object class
@@ -55,7 +61,7 @@ class PlayerObject
 public:
 
     //! type of the player object instance container
-    typedef std::list< PlayerObject > List;
+    typedef PlayerObjectList List;
 
     //! type of the player object pointer container
     typedef std::vector< const PlayerObject * > Cont;
@@ -70,12 +76,12 @@ private:
     static int S_face_count_thr;
 
     //! the player observation count, used as the id value for each player object.
-    static int S_player_count;
+    static thread_local int S_player_count;
 
     int M_ghost_count; //!< count that this object is recognized as a ghost object.
     int M_tackle_count; //!< time count since the last tackle observation
 
-    std::list< Vector2D > M_pos_history;
+    PositionHistory M_pos_history; //!< estimated positions in the past cycles
 
 public:
 
@@ -190,7 +196,7 @@ public:
       \brief get the history of estimated position.
       \return position list. the front element is the position at the previous cycle.
      */
-    const std::list< Vector2D > & posHistory() const
+    const PositionHistory & posHistory() const
       {
           return M_pos_history;
       }
@@ -297,6 +303,374 @@ public:
 
 };
 
+/*-------------------------------------------------------------------*/
+/*!
+  \class PlayerObjectPool
+  \brief fixed capacity storage of the player object instances.
+
+  All PlayerObjectList instances of one world model share the same pool.
+  An object is constructed in a free slot and is never moved until it is
+  destroyed, so the address of the object can be used as a stable handle.
+  The lists link the slots by their indices, and no memory allocation
+  occurs after the pool is created.
+*/
+class PlayerObjectPool {
+public:
+
+    //! the number of slots. enough for 22 players, unknown players and temporary lists.
+    static const int CAPACITY = 64;
+    //! invalid slot index
+    static const int NPOS = -1;
+
+private:
+
+    //! object storage and the links
+    struct Slot {
+        alignas( PlayerObject ) unsigned char data_[sizeof( PlayerObject )]; //!< object storage
+        int prev_; //!< previous slot in the list
+        int next_; //!< next slot in the list, or in the free chain
+    };
+
+    Slot M_slots[CAPACITY]; //!< slot array
+    int M_free; //!< the first free slot
+    int M_used; //!< the number of constructed objects
+
+    // not used
+    PlayerObjectPool( const PlayerObjectPool & ) = delete;
+    PlayerObjectPool & operator=( const PlayerObjectPool & ) = delete;
+
+public:
+
+    /*!
+      \brief create the free chain
+     */
+    PlayerObjectPool();
+
+    /*!
+      \brief construct the new object in the free slot
+      \param args constructor arguments
+      \return slot index, or NPOS if no free slot.
+     */
+    template < typename... Args >
+    int create( Args &&... args )
+      {
+          if ( M_free == NPOS )
+          {
+              return NPOS;
+          }
+
+          const int i = M_free;
+          new ( M_slots[i].data_ ) PlayerObject( std::forward< Args >( args )... );
+          M_free = M_slots[i].next_;
+          M_slots[i].prev_ = NPOS;
+          M_slots[i].next_ = NPOS;
+          ++M_used;
+          return i;
+      }
+
+    /*!
+      \brief destroy the object and return the slot to the free chain
+      \param i slot index
+     */
+    void destroy( const int i );
+
+    /*!
+      \brief get the object in the slot
+      \param i slot index
+      \return reference to the object
+     */
+    PlayerObject & object( const int i )
+      {
+          return *std::launder( reinterpret_cast< PlayerObject * >( M_slots[i].data_ ) );
+      }
+
+    /*!
+      \brief get the link to the previous slot
+      \param i slot index
+      \return reference to the link
+     */
+    int & prev( const int i )
+      {
+          return M_slots[i].prev_;
+      }
+
+    /*!
+      \brief get the link to the next slot
+      \param i slot index
+      \return reference to the link
+     */
+    int & next( const int i )
+      {
+          return M_slots[i].next_;
+      }
+
+    /*!
+      \brief get the number of constructed objects
+      \return the number of constructed objects
+     */
+    int used() const
+      {
+          return M_used;
+      }
+};
+
+/*-------------------------------------------------------------------*/
+/*!
+  \class PlayerObjectList
+  \brief doubly linked list of the player objects in PlayerObjectPool.
+
+  The interface is a subset of std::list. splice() only relinks slots,
+  so the players can be moved between the lists that share the same pool
+  without copy. All end() iterators compare equal.
+*/
+class PlayerObjectList {
+public:
+
+    /*!
+      \class Iterator
+      \brief forward iterator
+     */
+    template < typename T >
+    class Iterator {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef PlayerObject value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef T * pointer;
+        typedef T & reference;
+
+    private:
+        friend class PlayerObjectList;
+        template < typename U > friend class Iterator;
+
+        PlayerObjectPool * M_pool; //!< storage
+        int M_index; //!< slot index
+
+    public:
+        Iterator()
+            : M_pool( nullptr ),
+              M_index( PlayerObjectPool::NPOS )
+          { }
+
+        Iterator( PlayerObjectPool * pool,
+                  const int index )
+            : M_pool( pool ),
+              M_index( index )
+          { }
+
+        // copy constructor, or conversion from iterator to const_iterator
+        Iterator( const Iterator< PlayerObject > & other )
+            : M_pool( other.M_pool ),
+              M_index( other.M_index )
+          { }
+
+        Iterator & operator=( const Iterator & ) = default;
+
+        reference operator*() const
+          {
+              return M_pool->object( M_index );
+          }
+
+        pointer operator->() const
+          {
+              return &( M_pool->object( M_index ) );
+          }
+
+        Iterator & operator++()
+          {
+              M_index = M_pool->next( M_index );
+              return *this;
+          }
+
+        Iterator operator++( int )
+          {
+              Iterator tmp = *this;
+              M_index = M_pool->next( M_index );
+              return tmp;
+          }
+
+        friend
+        bool operator==( const Iterator & lhs,
+                         const Iterator & rhs )
+          {
+              return lhs.M_index == rhs.M_index;
+          }
+
+        friend
+        bool operator!=( const Iterator & lhs,
+                         const Iterator & rhs )
+          {
+              return lhs.M_index != rhs.M_index;
+          }
+    };
+
+    typedef Iterator< PlayerObject > iterator;
+    typedef Iterator< const PlayerObject > const_iterator;
+
+private:
+
+    PlayerObjectPool * M_pool; //!< storage shared with other lists
+    int M_front; //!< the first slot
+    int M_back; //!< the last slot
+    std::size_t M_size; //!< the number of elements
+
+    // not used
+    PlayerObjectList( const PlayerObjectList & ) = delete;
+    PlayerObjectList & operator=( const PlayerObjectList & ) = delete;
+
+public:
+
+    /*!
+      \brief create an empty list
+      \param pool storage of the elements
+     */
+    explicit
+    PlayerObjectList( PlayerObjectPool & pool )
+        : M_pool( &pool ),
+          M_front( PlayerObjectPool::NPOS ),
+          M_back( PlayerObjectPool::NPOS ),
+          M_size( 0 )
+      { }
+
+    /*!
+      \brief destroy all elements
+     */
+    ~PlayerObjectList()
+      {
+          clear();
+      }
+
+    iterator begin() { return iterator( M_pool, M_front ); }
+    iterator end() { return iterator( M_pool, PlayerObjectPool::NPOS ); }
+    const_iterator begin() const { return const_iterator( M_pool, M_front ); }
+    const_iterator end() const { return const_iterator( M_pool, PlayerObjectPool::NPOS ); }
+
+    std::size_t size() const { return M_size; }
+    bool empty() const { return M_size == 0; }
+
+    PlayerObject & front() { return M_pool->object( M_front ); }
+    const PlayerObject & front() const { return M_pool->object( M_front ); }
+    PlayerObject & back() { return M_pool->object( M_back ); }
+    const PlayerObject & back() const { return M_pool->object( M_back ); }
+
+    /*!
+      \brief construct the new element at the end of the list
+      \param args constructor arguments
+      \return pointer to the new element, or nullptr if the pool is full.
+     */
+    template < typename... Args >
+    PlayerObject * emplace_back( Args &&... args )
+      {
+          const int i = M_pool->create( std::forward< Args >( args )... );
+          if ( i == PlayerObjectPool::NPOS )
+          {
+              return nullptr;
+          }
+
+          link( PlayerObjectPool::NPOS, i );
+          return &( M_pool->object( i ) );
+      }
+
+    /*!
+      \brief destroy the element
+      \param pos iterator to the element
+      \return iterator following the removed element
+     */
+    iterator erase( iterator pos );
+
+    /*!
+      \brief destroy the last element
+     */
+    void pop_back();
+
+    /*!
+      \brief destroy all elements
+     */
+    void clear();
+
+    /*!
+      \brief move the element from the other list
+      \param pos the element is inserted before this position
+      \param other the list that holds the element. must share the same pool.
+      \param it iterator to the moved element
+     */
+    void splice( const_iterator pos,
+                 PlayerObjectList & other,
+                 iterator it );
+
+    /*!
+      \brief move all elements from the other list
+      \param pos the elements are inserted before this position
+      \param other source list. must share the same pool.
+     */
+    void splice( const_iterator pos,
+                 PlayerObjectList & other );
+
+    /*!
+      \brief destroy all elements that satisfy the predicate
+      \param pred predicate function object
+     */
+    template < typename Predicate >
+    void remove_if( Predicate pred )
+      {
+          int i = M_front;
+          while ( i != PlayerObjectPool::NPOS )
+          {
+              const int next = M_pool->next( i );
+              if ( pred( M_pool->object( i ) ) )
+              {
+                  unlink( i );
+                  M_pool->destroy( i );
+              }
+              i = next;
+          }
+      }
+
+    /*!
+      \brief stable insertion sort. the elements are relinked without copy.
+      \param comp comparison function object
+     */
+    template < typename Compare >
+    void sort( Compare comp )
+      {
+          int i = M_front;
+          M_front = M_back = PlayerObjectPool::NPOS;
+
+          while ( i != PlayerObjectPool::NPOS )
+          {
+              const int next = M_pool->next( i );
+
+              // find the first sorted element that should follow i
+              int pos = M_back;
+              while ( pos != PlayerObjectPool::NPOS
+                      && comp( M_pool->object( i ), M_pool->object( pos ) ) )
+              {
+                  pos = M_pool->prev( pos );
+              }
+
+              --M_size;
+              link( pos == PlayerObjectPool::NPOS ? M_front : M_pool->next( pos ), i );
+              i = next;
+          }
+      }
+
+private:
+
+    /*!
+      \brief insert the slot into this list
+      \param pos the slot is inserted before this slot. NPOS means the end.
+      \param i inserted slot
+     */
+    void link( const int pos,
+               const int i );
+
+    /*!
+      \brief remove the slot from this list. the object is not destroyed.
+      \param i removed slot
+     */
+    void unlink( const int i );
+};
+
 }
 
 #endif
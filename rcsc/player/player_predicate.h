@@ -35,6 +35,9 @@
 
 #include <rcsc/player/abstract_player_object.h>
 #include <rcsc/player/world_model.h>
+#include <rcsc/geom/rect_2d.h>
+#include <rcsc/geom/circle_2d.h>
+#include <rcsc/geom/sector_2d.h>
 #include <rcsc/math_util.h>
 
 #include <memory>
@@ -82,6 +85,31 @@ public:
      */
     virtual
     Ptr clone() const = 0;
+
+    /*!
+      \brief get the rectangle that contains all the matched players.
+      WorldModel uses this rectangle to reduce the checked players.
+      \param rect pointer to the variable to store the result
+      \return true if the matched players are bounded.
+     */
+    virtual
+    bool boundingRect( Rect2D * rect ) const
+      {
+          (void)rect;
+          return false;
+      }
+
+protected:
+
+    /*!
+      \brief get the rectangle that means the empty region
+      \return rectangle far from the field
+     */
+    static
+    Rect2D empty_rect()
+      {
+          return Rect2D::from_corners( 1.0e6, 1.0e6, 1.0e6, 1.0e6 );
+      }
 };
 
 /*!
@@ -297,6 +325,38 @@ public:
       {
           return Ptr( new AndPlayerPredicate( M_predicates ) );
       }
+
+    /*!
+      \brief get the intersection of the bounded predicates.
+      \param rect pointer to the variable to store the result
+      \return true if at least one predicate is bounded.
+     */
+    bool boundingRect( Rect2D * rect ) const
+      {
+          bool bounded = false;
+          double l = -1.0e6, t = -1.0e6, r = 1.0e6, b = 1.0e6;
+
+          for ( const ConstPtr & pred : M_predicates )
+          {
+              Rect2D tmp;
+              if ( pred->boundingRect( &tmp ) )
+              {
+                  bounded = true;
+                  l = std::max( l, tmp.left() );
+                  t = std::max( t, tmp.top() );
+                  r = std::min( r, tmp.right() );
+                  b = std::min( b, tmp.bottom() );
+              }
+          }
+
+          if ( bounded )
+          {
+              *rect = ( l <= r && t <= b
+                        ? Rect2D::from_corners( l, t, r, b )
+                        : empty_rect() );
+          }
+          return bounded;
+      }
 };
 
 /*!
@@ -505,6 +565,39 @@ public:
       {
           return Ptr( new OrPlayerPredicate( M_predicates ) );
       }
+
+    /*!
+      \brief get the union of the bounded predicates.
+      \param rect pointer to the variable to store the result
+      \return true if all predicates are bounded.
+     */
+    bool boundingRect( Rect2D * rect ) const
+      {
+          if ( M_predicates.empty() )
+          {
+              return false;
+          }
+
+          double l = 1.0e6, t = 1.0e6, r = -1.0e6, b = -1.0e6;
+
+          for ( const ConstPtr & pred : M_predicates )
+          {
+              Rect2D tmp;
+              if ( ! pred->boundingRect( &tmp ) )
+              {
+                  return false;
+              }
+              l = std::min( l, tmp.left() );
+              t = std::min( t, tmp.top() );
+              r = std::max( r, tmp.right() );
+              b = std::max( b, tmp.bottom() );
+          }
+
+          *rect = ( l <= r && t <= b
+                    ? Rect2D::from_corners( l, t, r, b )
+                    : empty_rect() );
+          return true;
+      }
 };
 
 /*!
@@ -1037,6 +1130,17 @@ public:
       {
           return Ptr( new XCoordinateForwardPlayerPredicate( M_threshold ) );
       }
+
+    /*!
+      \brief get the half plane x >= threshold
+      \param rect pointer to the variable to store the result
+      \return always true
+     */
+    bool boundingRect( Rect2D * rect ) const
+      {
+          *rect = Rect2D::from_corners( M_threshold, -1.0e6, 1.0e6, 1.0e6 );
+          return true;
+      }
 };
 
 /*!
@@ -1079,6 +1183,17 @@ public:
       {
           return Ptr( new XCoordinateBackwardPlayerPredicate( M_threshold ) );
       }
+
+    /*!
+      \brief get the half plane x <= threshold
+      \param rect pointer to the variable to store the result
+      \return always true
+     */
+    bool boundingRect( Rect2D * rect ) const
+      {
+          *rect = Rect2D::from_corners( -1.0e6, -1.0e6, M_threshold, 1.0e6 );
+          return true;
+      }
 };
 
 /*!
@@ -1121,6 +1236,17 @@ public:
       {
           return Ptr( new YCoordinatePlusPlayerPredicate( M_threshold ) );
       }
+
+    /*!
+      \brief get the half plane y >= threshold
+      \param rect pointer to the variable to store the result
+      \return always true
+     */
+    bool boundingRect( Rect2D * rect ) const
+      {
+          *rect = Rect2D::from_corners( -1.0e6, M_threshold, 1.0e6, 1.0e6 );
+          return true;
+      }
 };
 
 /*!
@@ -1163,6 +1289,17 @@ public:
       {
           return Ptr( new YCoordinateMinusPlayerPredicate( M_threshold ) );
       }
+
+    /*!
+      \brief get the half plane y <= threshold
+      \param rect pointer to the variable to store the result
+      \return always true
+     */
+    bool boundingRect( Rect2D * rect ) const
+      {
+          *rect = Rect2D::from_corners( -1.0e6, -1.0e6, 1.0e6, M_threshold );
+          return true;
+      }
 };
 
 /*!
@@ -1255,6 +1392,19 @@ public:
       {
           return Ptr( new PointNearPlayerPredicate( M_base_point, M_threshold2 ) );
       }
+
+    /*!
+      \brief get the bounding rectangle of the circle
+      \param rect pointer to the variable to store the result
+      \return always true
+     */
+    bool boundingRect( Rect2D * rect ) const
+      {
+          const double r = std::sqrt( M_threshold2 );
+          *rect = Rect2D::from_corners( M_base_point.x - r, M_base_point.y - r,
+                                        M_base_point.x + r, M_base_point.y + r );
+          return true;
+      }
 };
 
 /*!
@@ -1474,6 +1624,68 @@ public:
       }
 };
 
+/*!
+  \brief get the bounding rectangle of the region. the default version for unsupported regions.
+  \return always false
+ */
+template< typename T >
+inline
+bool
+get_bounding_rect( const T &,
+                   Rect2D * )
+{
+    return false;
+}
+
+/*!
+  \brief get the bounding rectangle of the rectangle
+  \param region rectangle
+  \param rect pointer to the variable to store the result
+  \return always true
+ */
+inline
+bool
+get_bounding_rect( const Rect2D & region,
+                   Rect2D * rect )
+{
+    *rect = region;
+    return true;
+}
+
+/*!
+  \brief get the bounding rectangle of the circle
+  \param region circle
+  \param rect pointer to the variable to store the result
+  \return always true
+ */
+inline
+bool
+get_bounding_rect( const Circle2D & region,
+                   Rect2D * rect )
+{
+    const Vector2D & c = region.center();
+    const double r = region.radius();
+    *rect = Rect2D::from_corners( c.x - r, c.y - r, c.x + r, c.y + r );
+    return true;
+}
+
+/*!
+  \brief get the bounding rectangle of the sector
+  \param region sector
+  \param rect pointer to the variable to store the result
+  \return always true
+ */
+inline
+bool
+get_bounding_rect( const Sector2D & region,
+                   Rect2D * rect )
+{
+    const Vector2D & c = region.center();
+    const double r = region.radiusMax();
+    *rect = Rect2D::from_corners( c.x - r, c.y - r, c.x + r, c.y + r );
+    return true;
+}
+
 /*!
   \class ContainsPlayerPredicate
   \brief check if target player is in region
@@ -1513,6 +1725,16 @@ public:
       {
           return Ptr( new ContainsPlayerPredicate( M_region ) );
       }
+
+    /*!
+      \brief get the bounding rectangle of the region
+      \param rect pointer to the variable to store the result
+      \return true if the region type is supported
+     */
+    bool boundingRect( Rect2D * rect ) const
+      {
+          return get_bounding_rect( M_region, rect );
+      }
 };
 
 }
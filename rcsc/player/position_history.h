@@ -0,0 +1,218 @@
+// -*-c++-*-
+
+/*!
+  \file position_history.h
+  \brief fixed length position history Header File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_PLAYER_POSITION_HISTORY_H
+#define RCSC_PLAYER_POSITION_HISTORY_H
+
+#include <rcsc/geom/vector_2d.h>
+
+#include <iterator>
+#include <cstddef>
+
+namespace rcsc {
+
+/*!
+  \class PositionHistory
+  \brief fixed length ring buffer of the past positions.
+
+  The front element is the latest position. When the buffer is full,
+  the oldest position is overwritten. No memory allocation occurs after
+  the construction.
+*/
+class PositionHistory {
+public:
+
+    //! the maximum number of the recorded positions
+    static const std::size_t CAPACITY = 100;
+
+    /*!
+      \class const_iterator
+      \brief read only iterator from the latest position to the oldest one.
+     */
+    class const_iterator {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Vector2D value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const Vector2D * pointer;
+        typedef const Vector2D & reference;
+
+    private:
+        const PositionHistory * M_history; //!< container
+        std::size_t M_index; //!< distance from the front element
+
+    public:
+        const_iterator( const PositionHistory * history,
+                        const std::size_t index )
+            : M_history( history ),
+              M_index( index )
+          { }
+
+        reference operator*() const
+          {
+              return M_history->at( M_index );
+          }
+
+        pointer operator->() const
+          {
+              return &( M_history->at( M_index ) );
+          }
+
+        const_iterator & operator++()
+          {
+              ++M_index;
+              return *this;
+          }
+
+        const_iterator operator++( int )
+          {
+              const_iterator tmp = *this;
+              ++M_index;
+              return tmp;
+          }
+
+        bool operator==( const const_iterator & rhs ) const
+          {
+              return M_index == rhs.M_index;
+          }
+
+        bool operator!=( const const_iterator & rhs ) const
+          {
+              return M_index != rhs.M_index;
+          }
+    };
+
+private:
+
+    Vector2D M_data[CAPACITY]; //!< position buffer
+    std::size_t M_front; //!< the index of the latest position
+    std::size_t M_size; //!< the number of the recorded positions
+
+public:
+
+    /*!
+      \brief create an empty history
+     */
+    PositionHistory()
+        : M_front( 0 ),
+          M_size( 0 )
+      { }
+
+    /*!
+      \brief record the new position. the oldest one is dropped if full.
+      \param pos new position
+     */
+    void push_front( const Vector2D & pos )
+      {
+          M_front = ( M_front == 0 ? CAPACITY - 1 : M_front - 1 );
+          M_data[M_front] = pos;
+          if ( M_size < CAPACITY )
+          {
+              ++M_size;
+          }
+      }
+
+    /*!
+      \brief remove all positions
+     */
+    void clear()
+      {
+          M_size = 0;
+      }
+
+    /*!
+      \brief get the number of the recorded positions
+      \return the number of the recorded positions
+     */
+    std::size_t size() const
+      {
+          return M_size;
+      }
+
+    /*!
+      \brief check if no position is recorded
+      \return true if empty
+     */
+    bool empty() const
+      {
+          return M_size == 0;
+      }
+
+    /*!
+      \brief get the recorded position
+      \param i the number of steps back from the latest position
+      \return const reference to the position
+     */
+    const Vector2D & at( const std::size_t i ) const
+      {
+          return M_data[( M_front + i ) % CAPACITY];
+      }
+
+    /*!
+      \brief get the latest position
+      \return const reference to the position
+     */
+    const Vector2D & front() const
+      {
+          return M_data[M_front];
+      }
+
+    /*!
+      \brief get the oldest position
+      \return const reference to the position
+     */
+    const Vector2D & back() const
+      {
+          return at( M_size - 1 );
+      }
+
+    /*!
+      \brief get the iterator that points the latest position
+      \return const iterator
+     */
+    const_iterator begin() const
+      {
+          return const_iterator( this, 0 );
+      }
+
+    /*!
+      \brief get the iterator that points past the oldest position
+      \return const iterator
+     */
+    const_iterator end() const
+      {
+          return const_iterator( this, M_size );
+      }
+};
+
+}
+
+#endif
@@ -0,0 +1,216 @@
+// -*-c++-*-
+
+/*!
+  \file replay_profile.cpp
+  \brief per cycle profile of the offline replay Source File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "replay_profile.h"
+
+#include <algorithm>
+#include <iostream>
+#include <cstdio>
+#include <cinttypes>
+
+namespace rcsc {
+
+namespace {
+
+//! FNV-1a offset basis
+const std::uint64_t HASH_BASIS = 14695981039346656037ULL;
+//! FNV-1a prime
+const std::uint64_t HASH_PRIME = 1099511628211ULL;
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+ReplayProfile::Record::Record( const GameTime & time )
+    : time_( time ),
+      messages_( 0 ),
+      command_hash_( 0 )
+{
+    std::fill( msec_, msec_ + PHASE_SIZE, 0.0 );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+ReplayProfile::ReplayProfile( const GameTime * time )
+    : M_time( time )
+{
+    M_records.reserve( 6000 + 1 );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+ReplayProfile::Record &
+ReplayProfile::currentRecord()
+{
+    if ( M_records.empty()
+         || M_records.back().time_ != *M_time )
+    {
+        M_records.emplace_back( *M_time );
+    }
+
+    return M_records.back();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+ReplayProfile::accumulate( const Clock::time_point & now )
+{
+    if ( ! M_stack.empty() )
+    {
+        currentRecord().msec_[M_stack.back()]
+            += std::chrono::duration< double, std::milli >( now - M_start ).count();
+    }
+
+    M_start = now;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+ReplayProfile::begin( const Phase phase )
+{
+    accumulate( Clock::now() );
+    M_stack.push_back( phase );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+ReplayProfile::end()
+{
+    if ( M_stack.empty() )
+    {
+        return;
+    }
+
+    accumulate( Clock::now() );
+
+    if ( M_stack.back() == PARSE )
+    {
+        currentRecord().messages_ += 1;
+    }
+
+    M_stack.pop_back();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+ReplayProfile::addCommand( const char * msg,
+                           const std::size_t len )
+{
+    Record & record = currentRecord();
+
+    std::uint64_t h = ( record.command_hash_ == 0
+                        ? HASH_BASIS
+                        : record.command_hash_ );
+    for ( std::size_t i = 0; i < len; ++i )
+    {
+        h ^= static_cast< unsigned char >( msg[i] );
+        h *= HASH_PRIME;
+    }
+
+    record.command_hash_ = h;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::ostream &
+ReplayProfile::print( std::ostream & os ) const
+{
+    char buf[256];
+
+    os << "# cycle stopped messages parse[ms] world[ms] action[ms] command_hash\n";
+
+    double total[PHASE_SIZE] = { 0.0, 0.0, 0.0 };
+    double max_value[PHASE_SIZE] = { 0.0, 0.0, 0.0 };
+    std::uint64_t digest = HASH_BASIS;
+
+    for ( const Record & r : M_records )
+    {
+        snprintf( buf, sizeof( buf ),
+                  "%ld %ld %d %.4f %.4f %.4f %016" PRIx64 "\n",
+                  r.time_.cycle(), r.time_.stopped(), r.messages_,
+                  r.msec_[PARSE], r.msec_[WORLD], r.msec_[ACTION],
+                  r.command_hash_ );
+        os << buf;
+
+        for ( int i = 0; i < PHASE_SIZE; ++i )
+        {
+            total[i] += r.msec_[i];
+            max_value[i] = std::max( max_value[i], r.msec_[i] );
+        }
+
+        digest ^= r.command_hash_;
+        digest *= HASH_PRIME;
+    }
+
+    const double n = std::max< std::size_t >( 1, M_records.size() );
+
+    snprintf( buf, sizeof( buf ),
+              "# cycles %zu\n"
+              "# total parse %.3f world %.3f action %.3f [ms]\n"
+              "# mean parse %.4f world %.4f action %.4f [ms]\n"
+              "# max parse %.4f world %.4f action %.4f [ms]\n"
+              "# command_digest %016" PRIx64 "\n",
+              M_records.size(),
+              total[PARSE], total[WORLD], total[ACTION],
+              total[PARSE] / n, total[WORLD] / n, total[ACTION] / n,
+              max_value[PARSE], max_value[WORLD], max_value[ACTION],
+              digest );
+    os << buf;
+
+    return os << std::flush;
+}
+
+}
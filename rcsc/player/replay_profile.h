@@ -0,0 +1,196 @@
+// -*-c++-*-
+
+/*!
+  \file replay_profile.h
+  \brief per cycle profile of the offline replay Header File
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+
+#ifndef RCSC_PLAYER_REPLAY_PROFILE_H
+#define RCSC_PLAYER_REPLAY_PROFILE_H
+
+#include <rcsc/game_time.h>
+
+#include <vector>
+#include <chrono>
+#include <iosfwd>
+#include <cstddef>
+#include <cstdint>
+
+namespace rcsc {
+
+/*!
+  \class ReplayProfile
+  \brief per cycle processing time of the player agent.
+
+  The elapsed time is accumulated to the phase on the top of the phase
+  stack, so the world model update called in the message analysis is not
+  counted as the parse time. The commands composed in each cycle are
+  recorded as a hash value to detect the behavior changes between runs.
+*/
+class ReplayProfile {
+public:
+
+    //! measured phase
+    enum Phase {
+        PARSE, //!< server message analysis
+        WORLD, //!< world model update
+        ACTION, //!< action decision
+        PHASE_SIZE
+    };
+
+    /*!
+      \struct Record
+      \brief the profile of one cycle
+     */
+    struct Record {
+        GameTime time_; //!< game time
+        int messages_; //!< the number of analyzed messages
+        double msec_[PHASE_SIZE]; //!< elapsed milli seconds of each phase
+        std::uint64_t command_hash_; //!< hash value of the composed commands
+
+        /*!
+          \brief create an empty record
+          \param time game time
+         */
+        explicit
+        Record( const GameTime & time );
+    };
+
+    /*!
+      \class Scope
+      \brief measure the phase while this object exists.
+     */
+    class Scope {
+    private:
+        ReplayProfile * M_profile; //!< the profile instance. may be NULL.
+
+        // not used
+        Scope( const Scope & ) = delete;
+        Scope & operator=( const Scope & ) = delete;
+    public:
+        /*!
+          \brief start the phase
+          \param profile pointer to the profile. if NULL, nothing is measured.
+          \param phase measured phase
+         */
+        Scope( ReplayProfile * profile,
+               const Phase phase )
+            : M_profile( profile )
+          {
+              if ( M_profile )
+              {
+                  M_profile->begin( phase );
+              }
+          }
+
+        /*!
+          \brief end the phase
+         */
+        ~Scope()
+          {
+              if ( M_profile )
+              {
+                  M_profile->end();
+              }
+          }
+    };
+
+private:
+
+    typedef std::chrono::steady_clock Clock;
+
+    //! pointer to the current game time
+    const GameTime * M_time;
+
+    //! recorded cycles
+    std::vector< Record > M_records;
+
+    //! nested phases
+    std::vector< Phase > M_stack;
+
+    //! the time when the top phase is started or resumed
+    Clock::time_point M_start;
+
+    // not used
+    ReplayProfile() = delete;
+    ReplayProfile( const ReplayProfile & ) = delete;
+    ReplayProfile & operator=( const ReplayProfile & ) = delete;
+
+public:
+
+    /*!
+      \brief create an empty profile
+      \param time pointer to the game time variable of the agent
+     */
+    explicit
+    ReplayProfile( const GameTime * time );
+
+    /*!
+      \brief start the phase. the current phase is suspended.
+      \param phase started phase
+     */
+    void begin( const Phase phase );
+
+    /*!
+      \brief end the current phase. the suspended phase is resumed.
+     */
+    void end();
+
+    /*!
+      \brief record the composed command string
+      \param msg command string
+      \param len length of the string
+     */
+    void addCommand( const char * msg,
+                     const std::size_t len );
+
+    /*!
+      \brief get the recorded cycles
+      \return const reference to the record container
+     */
+    const std::vector< Record > & records() const
+      {
+          return M_records;
+      }
+
+    /*!
+      \brief print all records and the summary
+      \param os reference to the output stream
+      \return reference to the output stream
+     */
+    std::ostream & print( std::ostream & os ) const;
+
+private:
+
+    Record & currentRecord();
+    void accumulate( const Clock::time_point & now );
+};
+
+}
+
+#endif
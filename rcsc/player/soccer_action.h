@@ -45,7 +45,7 @@ class PlayerAgent;
 class AbstractAction {
 private:
     //! number of instances have been created
-    static long S_action_object_counter;
+    static thread_local long S_action_object_counter;
 
     //! object ID of this action
     long M_action_object_id;
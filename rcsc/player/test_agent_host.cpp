@@ -0,0 +1,380 @@
+// -*-c++-*-
+
+/*!
+  \file test_agent_host.cpp
+  \brief test code for rcsc::AgentHost
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "player_agent.h"
+
+#include <rcsc/common/agent_host.h>
+#include <rcsc/common/player_param.h>
+#include <rcsc/common/player_type.h>
+#include <rcsc/param/cmd_line_parser.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <cstring>
+
+#include <unistd.h>
+#include <poll.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+using rcsc::AgentHost;
+using rcsc::PlayerAgent;
+using rcsc::PlayerTypeSet;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+const int AGENT_SIZE = 3;
+const int PLAYER_TYPES = 3;
+
+/*-------------------------------------------------------------------*/
+/*!
+  \class TestPlayer
+  \brief player that does nothing
+ */
+class TestPlayer
+    : public PlayerAgent {
+protected:
+
+    void actionImpl() override
+      { }
+};
+
+/*-------------------------------------------------------------------*/
+/*!
+  \class DummyServer
+  \brief replies the init and parameter messages to each player.
+
+  The player_type messages are sent after a short delay, so that the
+  second player would connect during the handshake of the first player
+  if the players were started at once.
+ */
+class DummyServer {
+private:
+
+    int M_fd;
+    int M_port;
+
+    std::atomic< bool > M_stop;
+    std::thread M_thread;
+
+    std::mutex M_mutex;
+    std::vector< Clock::time_point > M_init_time; //!< the time when the init command is received
+    std::vector< Clock::time_point > M_param_time; //!< the time when the last parameter is sent
+
+public:
+
+    DummyServer()
+        : M_fd( -1 ),
+          M_port( 0 ),
+          M_stop( false )
+      {
+          M_fd = ::socket( AF_INET, SOCK_DGRAM, 0 );
+
+          struct sockaddr_in addr;
+          std::memset( &addr, 0, sizeof( addr ) );
+          addr.sin_family = AF_INET;
+          addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+          addr.sin_port = 0;
+
+          socklen_t len = sizeof( addr );
+          if ( M_fd != -1
+               && ::bind( M_fd, reinterpret_cast< struct sockaddr * >( &addr ), len ) == 0
+               && ::getsockname( M_fd, reinterpret_cast< struct sockaddr * >( &addr ), &len ) == 0 )
+          {
+              M_port = ntohs( addr.sin_port );
+              M_thread = std::thread( [this]() { run(); } );
+          }
+      }
+
+    ~DummyServer()
+      {
+          M_stop = true;
+          if ( M_thread.joinable() )
+          {
+              M_thread.join();
+          }
+          if ( M_fd != -1 )
+          {
+              ::close( M_fd );
+          }
+      }
+
+    int port() const
+      {
+          return M_port;
+      }
+
+    std::vector< Clock::time_point > initTime()
+      {
+          std::lock_guard< std::mutex > lock( M_mutex );
+          return M_init_time;
+      }
+
+    std::vector< Clock::time_point > paramTime()
+      {
+          std::lock_guard< std::mutex > lock( M_mutex );
+          return M_param_time;
+      }
+
+private:
+
+    void send( const std::string & msg,
+               const struct sockaddr_in & to )
+      {
+          ::sendto( M_fd, msg.c_str(), msg.length() + 1, 0,
+                    reinterpret_cast< const struct sockaddr * >( &to ), sizeof( to ) );
+      }
+
+    void sendPlayerTypes( const struct sockaddr_in & to )
+      {
+          for ( int id = 0; id < PLAYER_TYPES; ++id )
+          {
+              std::ostringstream player_type;
+              player_type << "(player_type (id " << id << ") (player_speed_max " << 1.05 + 0.01 * id << "))";
+              send( player_type.str(), to );
+          }
+
+          std::lock_guard< std::mutex > lock( M_mutex );
+          M_param_time.push_back( Clock::now() );
+      }
+
+    void run()
+      {
+          char buf[8192];
+
+          struct pollfd pfd;
+          pfd.fd = M_fd;
+          pfd.events = POLLIN;
+
+          // the players waiting for the player_type messages
+          std::vector< std::pair< Clock::time_point, struct sockaddr_in > > pending;
+
+          while ( ! M_stop )
+          {
+              for ( std::size_t i = 0; i < pending.size(); )
+              {
+                  if ( pending[i].first <= Clock::now() )
+                  {
+                      sendPlayerTypes( pending[i].second );
+                      pending.erase( pending.begin() + i );
+                  }
+                  else
+                  {
+                      ++i;
+                  }
+              }
+
+              if ( ::poll( &pfd, 1, 10 ) <= 0 )
+              {
+                  continue;
+              }
+
+              struct sockaddr_in from;
+              socklen_t from_len = sizeof( from );
+              const int n = ::recvfrom( M_fd, buf, sizeof( buf ) - 1, 0,
+                                        reinterpret_cast< struct sockaddr * >( &from ), &from_len );
+              if ( n <= 0 )
+              {
+                  continue;
+              }
+              buf[n] = '\0';
+
+              if ( std::strncmp( buf, "(init ", 6 ) != 0 )
+              {
+                  continue;
+              }
+
+              int unum = 0;
+              {
+                  std::lock_guard< std::mutex > lock( M_mutex );
+                  M_init_time.push_back( Clock::now() );
+                  unum = static_cast< int >( M_init_time.size() );
+              }
+
+              std::ostringstream init;
+              init << "(init l " << unum << " before_kick_off)";
+              send( init.str(), from );
+              send( "(server_param (goal_width 14.02) (player_speed_max 1.05))", from );
+
+              std::ostringstream player_param;
+              player_param << "(player_param (player_types " << PLAYER_TYPES << ") (pt_max 1))";
+              send( player_param.str(), from );
+
+              pending.push_back( std::make_pair( Clock::now() + std::chrono::milliseconds( 200 ), from ) );
+          }
+      }
+};
+
+}
+
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+
+class AgentHostTest
+    : public CPPUNIT_NS::TestFixture {
+
+    CPPUNIT_TEST_SUITE( AgentHostTest );
+    CPPUNIT_TEST( testHandshake );
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+
+    void testHandshake();
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( AgentHostTest );
+
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+AgentHostTest::testHandshake()
+{
+    DummyServer server;
+    CPPUNIT_ASSERT( server.port() != 0 );
+
+    const std::string port = std::to_string( server.port() );
+
+    AgentHost host;
+    std::vector< std::shared_ptr< TestPlayer > > players;
+
+    for ( int i = 0; i < AGENT_SIZE; ++i )
+    {
+        std::shared_ptr< TestPlayer > player( new TestPlayer() );
+
+        std::list< std::string > args;
+        args.push_back( "--team_name" ); args.push_back( "test" );
+        args.push_back( "--host" ); args.push_back( "127.0.0.1" );
+        args.push_back( "--port" ); args.push_back( port );
+        args.push_back( "--server_wait_seconds" ); args.push_back( "1" );
+
+        rcsc::CmdLineParser cmd_parser( args );
+        CPPUNIT_ASSERT( player->init( cmd_parser ) );
+        CPPUNIT_ASSERT( host.addAgent( player ) );
+
+        players.push_back( player );
+    }
+
+    host.run();
+
+    const std::vector< Clock::time_point > init_time = server.initTime();
+    const std::vector< Clock::time_point > param_time = server.paramTime();
+
+    CPPUNIT_ASSERT_EQUAL( static_cast< std::size_t >( AGENT_SIZE ), init_time.size() );
+    CPPUNIT_ASSERT_EQUAL( static_cast< std::size_t >( AGENT_SIZE ), param_time.size() );
+
+    // the other players are started after the first player received all parameters.
+    for ( int i = 1; i < AGENT_SIZE; ++i )
+    {
+        CPPUNIT_ASSERT( param_time[0] < init_time[i] );
+    }
+
+    CPPUNIT_ASSERT_EQUAL( PLAYER_TYPES, rcsc::PlayerParam::i().playerTypes() );
+    CPPUNIT_ASSERT( PlayerTypeSet::i().get( PLAYER_TYPES - 1 ) );
+
+    // the order of the other players is not fixed.
+    CPPUNIT_ASSERT_EQUAL( 1, players[0]->world().self().unum() );
+
+    std::vector< bool > assigned( AGENT_SIZE + 1, false );
+    for ( int i = 0; i < AGENT_SIZE; ++i )
+    {
+        const int unum = players[i]->world().self().unum();
+        CPPUNIT_ASSERT( 1 <= unum && unum <= AGENT_SIZE );
+        CPPUNIT_ASSERT( ! assigned[unum] );
+        assigned[unum] = true;
+
+        CPPUNIT_ASSERT( players[i]->world().self().playerTypePtr() );
+    }
+}
+
+
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+
+#include <cppunit/BriefTestProgressListener.h>
+//#include <cppunit/TextTestProgressListener.h>
+#include <cppunit/CompilerOutputter.h>
+//#include <cppunit/TextOutputter.h>
+//#include <cppunit/XmlOutputter.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/TestRunner.h>
+
+int
+main( int, char ** )
+{
+    // create the event manager and test controller
+    CPPUNIT_NS::TestResult controller;
+
+    // add a listner that collects test results
+    CPPUNIT_NS::TestResultCollector result;
+    controller.addListener( &result );
+
+    // add a listener that prints dots as test run.
+    CPPUNIT_NS::BriefTestProgressListener progress;
+    controller.addListener( &progress );
+
+    //CPPUNIT_NS::TextTestProgressListener textprog;
+    //controller.addListener( &textprog );
+
+    // add the top suite to the test runner.
+    CPPUNIT_NS::TestRunner runner;
+    runner.addTest( CPPUNIT_NS::TestFactoryRegistry::getRegistry().makeTest() );
+    runner.run( controller );
+
+    // output results in a compiler compatible format
+    CPPUNIT_NS::CompilerOutputter outputter( &result, CPPUNIT_NS::stdCOut() );
+    //CPPUNIT_NS::TextOutputter outputter( &result, CPPUNIT_NS::stdCOut() );
+    //CPPUNIT_NS::XmlOutputter outputter( &result, CPPUNIT_NS::stdCOut() );
+    outputter.write();
+
+    return result.wasSuccessful() ? 0 : 1;
+}
@@ -0,0 +1,253 @@
+// -*-c++-*-
+
+/*!
+  \file test_object_table.cpp
+  \brief test code for rcsc::ObjectTable
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "object_table.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <algorithm>
+#include <vector>
+#include <limits>
+
+using rcsc::ObjectTable;
+using rcsc::ViewWidth;
+
+namespace {
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief the binary search used by the original implementation
+ */
+bool
+search_table( const std::vector< ObjectTable::DataEntry > & table,
+              const double quant_dist,
+              double * mean_dist,
+              double * dist_error )
+{
+    std::vector< ObjectTable::DataEntry >::const_iterator
+        it = std::lower_bound( table.begin(),
+                               table.end(),
+                               ObjectTable::DataEntry( quant_dist - 0.001 ),
+                               []( const ObjectTable::DataEntry & lhs,
+                                   const ObjectTable::DataEntry & rhs )
+                               {
+                                   return lhs.M_seen_dist < rhs.M_seen_dist;
+                               } );
+    if ( it == table.end() )
+    {
+        return false;
+    }
+
+    *mean_dist = it->M_average;
+    *dist_error = it->M_error;
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief check if the lookup returns the same result as the binary search
+ */
+void
+check_equal( const std::vector< ObjectTable::DataEntry > & table,
+             const ObjectTable::DistanceLookup & lookup,
+             const double quant_dist )
+{
+    double search_mean = 0.0, search_error = 0.0;
+    double lookup_mean = 0.0, lookup_error = 0.0;
+
+    const bool search_result = search_table( table, quant_dist, &search_mean, &search_error );
+    const bool lookup_result = lookup.get( quant_dist, &lookup_mean, &lookup_error );
+
+    CPPUNIT_ASSERT_EQUAL( search_result, lookup_result );
+    if ( search_result )
+    {
+        CPPUNIT_ASSERT_EQUAL( search_mean, lookup_mean );
+        CPPUNIT_ASSERT_EQUAL( search_error, lookup_error );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief check all entries, the values between the entries and the values out of the table
+ */
+void
+check_table( const std::vector< ObjectTable::DataEntry > & table,
+             const ObjectTable::DistanceLookup & lookup )
+{
+    CPPUNIT_ASSERT( ! table.empty() );
+
+    for ( std::size_t i = 0; i < table.size(); ++i )
+    {
+        check_equal( table, lookup, table[i].M_seen_dist );
+
+        // values inside the quantization steps of the server
+        check_equal( table, lookup, table[i].M_seen_dist - 0.04 );
+        check_equal( table, lookup, table[i].M_seen_dist + 0.04 );
+
+        if ( i + 1 < table.size() )
+        {
+            check_equal( table, lookup, ( table[i].M_seen_dist + table[i + 1].M_seen_dist ) * 0.5 );
+        }
+    }
+
+    check_equal( table, lookup, -1.0 );
+    check_equal( table, lookup, table.back().M_seen_dist + 0.1 );
+    check_equal( table, lookup, table.back().M_seen_dist + 1000.0 );
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+
+class ObjectTableTest
+    : public CPPUNIT_NS::TestFixture {
+
+    CPPUNIT_TEST_SUITE( ObjectTableTest );
+    CPPUNIT_TEST( testStaticLookup );
+    CPPUNIT_TEST( testMovableLookup );
+    CPPUNIT_TEST( testIllegalDistance );
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+
+    ObjectTable M_table;
+
+public:
+
+    void testStaticLookup();
+    void testMovableLookup();
+    void testIllegalDistance();
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( ObjectTableTest );
+
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+ObjectTableTest::testStaticLookup()
+{
+    check_table( M_table.staticTable(), M_table.landmarkLookup( 17.0, ViewWidth::NORMAL ) );
+
+    const ViewWidth::Type widths[] = { ViewWidth::NARROW, ViewWidth::NORMAL, ViewWidth::WIDE };
+    for ( const ViewWidth::Type w : widths )
+    {
+        check_table( M_table.staticTableV18( w ), M_table.landmarkLookupV18( w ) );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+ObjectTableTest::testMovableLookup()
+{
+    check_table( M_table.movableTable(), M_table.movableLookup( 17.0, ViewWidth::NORMAL ) );
+
+    const ViewWidth::Type widths[] = { ViewWidth::NARROW, ViewWidth::NORMAL, ViewWidth::WIDE };
+    for ( const ViewWidth::Type w : widths )
+    {
+        check_table( M_table.movableTableV18( w ), M_table.movableLookupV18( w ) );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+ObjectTableTest::testIllegalDistance()
+{
+    double mean = 0.0, error = 0.0;
+
+    CPPUNIT_ASSERT( ! M_table.getDistanceRange( 18.0, ViewWidth::NORMAL, 1000.0, &mean, &error ) );
+    CPPUNIT_ASSERT( ! M_table.getLandmarkDistanceRange( 18.0, ViewWidth::NORMAL, 1000.0, &mean, &error ) );
+
+    // NaN is treated as the smallest distance
+    CPPUNIT_ASSERT( M_table.getDistanceRange( 18.0, ViewWidth::NORMAL,
+                                              std::numeric_limits< double >::quiet_NaN(),
+                                              &mean, &error ) );
+    CPPUNIT_ASSERT_EQUAL( M_table.movableTable().front().M_average, mean );
+}
+
+
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+
+#include <cppunit/BriefTestProgressListener.h>
+//#include <cppunit/TextTestProgressListener.h>
+#include <cppunit/CompilerOutputter.h>
+//#include <cppunit/TextOutputter.h>
+//#include <cppunit/XmlOutputter.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/TestRunner.h>
+
+int
+main( int, char ** )
+{
+    // create the event manager and test controller
+    CPPUNIT_NS::TestResult controller;
+
+    // add a listner that collects test results
+    CPPUNIT_NS::TestResultCollector result;
+    controller.addListener( &result );
+
+    // add a listener that prints dots as test run.
+    CPPUNIT_NS::BriefTestProgressListener progress;
+    controller.addListener( &progress );
+
+    //CPPUNIT_NS::TextTestProgressListener textprog;
+    //controller.addListener( &textprog );
+
+    // add the top suite to the test runner.
+    CPPUNIT_NS::TestRunner runner;
+    runner.addTest( CPPUNIT_NS::TestFactoryRegistry::getRegistry().makeTest() );
+    runner.run( controller );
+
+    // output results in a compiler compatible format
+    CPPUNIT_NS::CompilerOutputter outputter( &result, CPPUNIT_NS::stdCOut() );
+    //CPPUNIT_NS::TextOutputter outputter( &result, CPPUNIT_NS::stdCOut() );
+    //CPPUNIT_NS::XmlOutputter outputter( &result, CPPUNIT_NS::stdCOut() );
+    outputter.write();
+
+    return result.wasSuccessful() ? 0 : 1;
+}
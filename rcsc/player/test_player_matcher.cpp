@@ -0,0 +1,501 @@
+// -*-c++-*-
+
+/*!
+  \file test_player_matcher.cpp
+  \brief test code for rcsc::PlayerMatcher
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "player_matcher.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using rcsc::PlayerMatcher;
+
+namespace {
+
+const double EPS = 1.0e-6;
+
+typedef std::vector< std::vector< double > > CostMatrix;
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief the result of the assignment
+ */
+struct Result {
+    int matched_; //!< the number of matched rows
+    double cost_; //!< the sum of the costs of the matched pairs
+
+    Result()
+        : matched_( 0 ),
+          cost_( 0.0 )
+      { }
+
+    bool isBetterThan( const Result & other ) const
+      {
+          return ( matched_ > other.matched_
+                   || ( matched_ == other.matched_
+                        && cost_ < other.cost_ - EPS ) );
+      }
+};
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief search all assignments. each row is matched to an unused feasible column, or not matched.
+ */
+void
+brute_force( const CostMatrix & cost,
+             const int row,
+             std::vector< bool > & used,
+             const Result & current,
+             Result * best )
+{
+    if ( row == static_cast< int >( cost.size() ) )
+    {
+        if ( current.isBetterThan( *best ) )
+        {
+            *best = current;
+        }
+        return;
+    }
+
+    // leave this row unmatched
+    brute_force( cost, row + 1, used, current, best );
+
+    for ( std::size_t c = 0; c < used.size(); ++c )
+    {
+        if ( used[c]
+             || cost[row][c] < 0.0 )
+        {
+            continue;
+        }
+
+        Result next = current;
+        next.matched_ += 1;
+        next.cost_ += cost[row][c];
+
+        used[c] = true;
+        brute_force( cost, row + 1, used, next, best );
+        used[c] = false;
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief solve the problem by the matcher and check the validity of the assignment
+ */
+Result
+solve( PlayerMatcher & matcher,
+       const CostMatrix & cost,
+       const int cols )
+{
+    const int rows = static_cast< int >( cost.size() );
+
+    matcher.reset( rows, cols );
+    for ( int r = 0; r < rows; ++r )
+    {
+        for ( int c = 0; c < cols; ++c )
+        {
+            matcher.setCost( r, c, cost[r][c] );
+        }
+    }
+    matcher.solve();
+
+    Result result;
+    std::vector< bool > used( cols, false );
+    for ( int r = 0; r < rows; ++r )
+    {
+        const int c = matcher.assignment( r );
+        if ( c < 0 )
+        {
+            continue;
+        }
+
+        CPPUNIT_ASSERT( c < cols );
+        CPPUNIT_ASSERT( ! used[c] );
+        CPPUNIT_ASSERT( cost[r][c] >= 0.0 );
+
+        used[c] = true;
+        result.matched_ += 1;
+        result.cost_ += cost[r][c];
+    }
+
+    return result;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief check if the matcher gives the same result as the brute force search
+ */
+void
+check_brute_force( PlayerMatcher & matcher,
+                   const CostMatrix & cost,
+                   const int cols )
+{
+    Result expected;
+    std::vector< bool > used( cols, false );
+    brute_force( cost, 0, used, Result(), &expected );
+
+    const Result result = solve( matcher, cost, cols );
+
+    CPPUNIT_ASSERT_EQUAL( expected.matched_, result.matched_ );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( expected.cost_, result.cost_, EPS );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief create the random cost matrix. the pair is infeasible at the given probability.
+ */
+CostMatrix
+create_random_matrix( std::mt19937 & engine,
+                      const int rows,
+                      const int cols,
+                      const double infeasible_rate )
+{
+    std::uniform_real_distribution< double > cost_dist( 0.0, 100.0 );
+    std::bernoulli_distribution infeasible_dist( infeasible_rate );
+
+    CostMatrix cost( rows, std::vector< double >( cols, -1.0 ) );
+    for ( int r = 0; r < rows; ++r )
+    {
+        for ( int c = 0; c < cols; ++c )
+        {
+            if ( ! infeasible_dist( engine ) )
+            {
+                cost[r][c] = cost_dist( engine );
+            }
+        }
+    }
+
+    return cost;
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+
+class PlayerMatcherTest
+    : public CPPUNIT_NS::TestFixture {
+
+    CPPUNIT_TEST_SUITE( PlayerMatcherTest );
+    CPPUNIT_TEST( testEmpty );
+    CPPUNIT_TEST( testDummyColumns );
+    CPPUNIT_TEST( testInfeasible );
+    CPPUNIT_TEST( testRandom );
+    CPPUNIT_TEST( testMaxSize );
+    CPPUNIT_TEST_SUITE_END();
+
+private:
+
+    PlayerMatcher M_matcher;
+
+public:
+
+    void testEmpty();
+    void testDummyColumns();
+    void testInfeasible();
+    void testRandom();
+    void testMaxSize();
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( PlayerMatcherTest );
+
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+PlayerMatcherTest::testEmpty()
+{
+    M_matcher.reset( 0, 0 );
+    M_matcher.solve();
+
+    // no column. all rows are matched to the dummy columns.
+    M_matcher.reset( 3, 0 );
+    M_matcher.solve();
+    for ( int r = 0; r < 3; ++r )
+    {
+        CPPUNIT_ASSERT_EQUAL( -1, M_matcher.assignment( r ) );
+    }
+
+    // no row
+    M_matcher.reset( 0, 3 );
+    M_matcher.solve();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+PlayerMatcherTest::testDummyColumns()
+{
+    // more rows than columns. the cheapest two rows are matched.
+    {
+        CostMatrix cost = { { 5.0, 6.0 },
+                            { 1.0, 9.0 },
+                            { 7.0, 2.0 },
+                            { 8.0, 8.0 } };
+        const Result result = solve( M_matcher, cost, 2 );
+
+        CPPUNIT_ASSERT_EQUAL( 2, result.matched_ );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( 3.0, result.cost_, EPS );
+        CPPUNIT_ASSERT_EQUAL( -1, M_matcher.assignment( 0 ) );
+        CPPUNIT_ASSERT_EQUAL( 0, M_matcher.assignment( 1 ) );
+        CPPUNIT_ASSERT_EQUAL( 1, M_matcher.assignment( 2 ) );
+        CPPUNIT_ASSERT_EQUAL( -1, M_matcher.assignment( 3 ) );
+    }
+
+    // the number of matched rows has priority over the total cost.
+    {
+        CostMatrix cost = { { 0.0, 90.0 },
+                            { 1.0, -1.0 } };
+        const Result result = solve( M_matcher, cost, 2 );
+
+        CPPUNIT_ASSERT_EQUAL( 2, result.matched_ );
+        CPPUNIT_ASSERT_EQUAL( 1, M_matcher.assignment( 0 ) );
+        CPPUNIT_ASSERT_EQUAL( 0, M_matcher.assignment( 1 ) );
+    }
+
+    // more columns than rows. unused columns are left.
+    {
+        CostMatrix cost = { { 4.0, 3.0, 2.0, 1.0 } };
+        const Result result = solve( M_matcher, cost, 4 );
+
+        CPPUNIT_ASSERT_EQUAL( 1, result.matched_ );
+        CPPUNIT_ASSERT_EQUAL( 3, M_matcher.assignment( 0 ) );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+PlayerMatcherTest::testInfeasible()
+{
+    // all pairs are infeasible just after reset()
+    M_matcher.reset( 3, 3 );
+    M_matcher.solve();
+    for ( int r = 0; r < 3; ++r )
+    {
+        CPPUNIT_ASSERT_EQUAL( -1, M_matcher.assignment( r ) );
+    }
+
+    // the row without any feasible column is not matched.
+    {
+        CostMatrix cost = { { 2.0, -1.0, 3.0 },
+                            { -1.0, -1.0, -1.0 },
+                            { -1.0, 0.0, -1.0 } };
+        const Result result = solve( M_matcher, cost, 3 );
+
+        CPPUNIT_ASSERT_EQUAL( 2, result.matched_ );
+        CPPUNIT_ASSERT_EQUAL( 0, M_matcher.assignment( 0 ) );
+        CPPUNIT_ASSERT_EQUAL( -1, M_matcher.assignment( 1 ) );
+        CPPUNIT_ASSERT_EQUAL( 1, M_matcher.assignment( 2 ) );
+    }
+
+    // two rows compete for the only feasible column
+    {
+        CostMatrix cost = { { 5.0, -1.0 },
+                            { 4.0, -1.0 } };
+        const Result result = solve( M_matcher, cost, 2 );
+
+        CPPUNIT_ASSERT_EQUAL( 1, result.matched_ );
+        CPPUNIT_ASSERT_EQUAL( -1, M_matcher.assignment( 0 ) );
+        CPPUNIT_ASSERT_EQUAL( 0, M_matcher.assignment( 1 ) );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+PlayerMatcherTest::testRandom()
+{
+    std::mt19937 engine( 12345 );
+    std::uniform_int_distribution< int > size_dist( 0, 6 );
+
+    const double infeasible_rates[] = { 0.0, 0.3, 0.7 };
+
+    for ( const double rate : infeasible_rates )
+    {
+        for ( int i = 0; i < 1000; ++i )
+        {
+            const int rows = size_dist( engine );
+            const int cols = size_dist( engine );
+
+            check_brute_force( M_matcher,
+                               create_random_matrix( engine, rows, cols, rate ),
+                               cols );
+        }
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+PlayerMatcherTest::testMaxSize()
+{
+    std::mt19937 engine( 54321 );
+
+    // the full size problem whose optimal assignment is known.
+    // the pairs in the permutation are cheaper than any other pairs.
+    {
+        std::vector< int > perm( PlayerMatcher::MAX_COLS );
+        for ( int c = 0; c < PlayerMatcher::MAX_COLS; ++c )
+        {
+            perm[c] = c;
+        }
+        std::shuffle( perm.begin(), perm.end(), engine );
+
+        CostMatrix cost = create_random_matrix( engine,
+                                                PlayerMatcher::MAX_ROWS,
+                                                PlayerMatcher::MAX_COLS,
+                                                0.3 );
+        for ( int r = 0; r < PlayerMatcher::MAX_ROWS; ++r )
+        {
+            for ( int c = 0; c < PlayerMatcher::MAX_COLS; ++c )
+            {
+                if ( cost[r][c] >= 0.0 )
+                {
+                    cost[r][c] += 10.0;
+                }
+            }
+            cost[r][perm[r]] = 1.0;
+        }
+
+        const Result result = solve( M_matcher, cost, PlayerMatcher::MAX_COLS );
+
+        CPPUNIT_ASSERT_EQUAL( static_cast< int >( PlayerMatcher::MAX_ROWS ), result.matched_ );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( static_cast< double >( PlayerMatcher::MAX_ROWS ), result.cost_, EPS );
+        for ( int r = 0; r < PlayerMatcher::MAX_ROWS; ++r )
+        {
+            CPPUNIT_ASSERT_EQUAL( perm[r], M_matcher.assignment( r ) );
+        }
+    }
+
+    // the full rows compete for a few columns.
+    {
+        const int cols = 4;
+        CostMatrix cost = create_random_matrix( engine, PlayerMatcher::MAX_ROWS, cols, 0.0 );
+
+        const Result result = solve( M_matcher, cost, cols );
+
+        CPPUNIT_ASSERT_EQUAL( cols, result.matched_ );
+
+        // the optimal value does not change by the transposition,
+        // and the brute force search of the transposed problem is small.
+        CostMatrix transposed( cols, std::vector< double >( PlayerMatcher::MAX_ROWS ) );
+        for ( int r = 0; r < PlayerMatcher::MAX_ROWS; ++r )
+        {
+            for ( int c = 0; c < cols; ++c )
+            {
+                transposed[c][r] = cost[r][c];
+            }
+        }
+
+        Result expected;
+        std::vector< bool > used( PlayerMatcher::MAX_ROWS, false );
+        brute_force( transposed, 0, used, Result(), &expected );
+
+        CPPUNIT_ASSERT_EQUAL( expected.matched_, result.matched_ );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( expected.cost_, result.cost_, EPS );
+    }
+
+    // the small problems after the full size problem are not affected by the old values.
+    for ( int i = 0; i < 100; ++i )
+    {
+        CostMatrix cost = create_random_matrix( engine,
+                                                PlayerMatcher::MAX_ROWS,
+                                                PlayerMatcher::MAX_COLS,
+                                                0.5 );
+        solve( M_matcher, cost, PlayerMatcher::MAX_COLS );
+
+        check_brute_force( M_matcher,
+                           create_random_matrix( engine, 5, 5, 0.3 ),
+                           5 );
+    }
+}
+
+
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+
+#include <cppunit/BriefTestProgressListener.h>
+//#include <cppunit/TextTestProgressListener.h>
+#include <cppunit/CompilerOutputter.h>
+//#include <cppunit/TextOutputter.h>
+//#include <cppunit/XmlOutputter.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/TestRunner.h>
+
+int
+main( int, char ** )
+{
+    // create the event manager and test controller
+    CPPUNIT_NS::TestResult controller;
+
+    // add a listner that collects test results
+    CPPUNIT_NS::TestResultCollector result;
+    controller.addListener( &result );
+
+    // add a listener that prints dots as test run.
+    CPPUNIT_NS::BriefTestProgressListener progress;
+    controller.addListener( &progress );
+
+    //CPPUNIT_NS::TextTestProgressListener textprog;
+    //controller.addListener( &textprog );
+
+    // add the top suite to the test runner.
+    CPPUNIT_NS::TestRunner runner;
+    runner.addTest( CPPUNIT_NS::TestFactoryRegistry::getRegistry().makeTest() );
+    runner.run( controller );
+
+    // output results in a compiler compatible format
+    CPPUNIT_NS::CompilerOutputter outputter( &result, CPPUNIT_NS::stdCOut() );
+    //CPPUNIT_NS::TextOutputter outputter( &result, CPPUNIT_NS::stdCOut() );
+    //CPPUNIT_NS::XmlOutputter outputter( &result, CPPUNIT_NS::stdCOut() );
+    outputter.write();
+
+    return result.wasSuccessful() ? 0 : 1;
+}
@@ -0,0 +1,403 @@
+// -*-c++-*-
+
+/*!
+  \file test_visual_sensor.cpp
+  \brief test code for rcsc::VisualSensor
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "visual_sensor.h"
+
+#include <rcsc/game_time.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <charconv>
+#include <sstream>
+#include <string>
+
+using rcsc::GameTime;
+using rcsc::VisualSensor;
+
+namespace {
+
+/*-------------------------------------------------------------------*/
+/*!
+  \struct TestCase
+  \brief see message and its parsed result
+ */
+struct TestCase {
+    double version_; //!< protocol version
+    const char * message_; //!< see message
+    const char * expected_; //!< the result of the previous implementation
+};
+
+/*
+  The see messages are generated by visualsensorbench, and the expected
+  results are written by the list based implementation used until the
+  parser became allocation free. Each line is one seen object:
+    b dist dir has_vel dist_chng dir_chng
+    m|M id object_type dist dir  (M: behind markers)
+    l id dist dir
+    t|T|o|O|u unum goalie dist dir has_vel dist_chng dir_chng body face arm kicking tackle
+      (t: teammates, T: unknown teammates, o: opponents, O: unknown opponents, u: unknown players)
+ */
+const TestCase TEST_CASES[] = {
+    { 18.0,
+      "(see 376 ((f l b) 53.7 13) ((f p l b) 33.8 24) ((f g l b) 50 43) ((f b l 50) "
+      "53.6 7) ((f b l 40) 45.1 1) ((f b l 30) 37.3 -8) ((f b l 20) 30.9 -21) ((f b "
+      "l 10) 26.7 -39) ((f l b 10) 54.7 39) ((f l b 20) 55 28) ((f l b 30) 57.1 18) "
+      "((b) 21.3 -21 0.9 1) ((p \"HELIOS_base\" 1 goalie) 14.8 25 0.91 -0.3 -8 14) "
+      "((p \"HELIOS_base\" 5) 16.8 4 -0.78 0.2 -126 -7 -8) ((p \"HELIOS_base\") "
+      "22.4 -15) ((p) 41.8 31) ((p \"opponent\" 3) 17 -5 0.37 0.1 -23 53 k) ((p) "
+      "48.2 35) ((p \"opponent\" 7) 19.7 28 0.99 -0.5 39 27) ((p \"opponent\") 23 "
+      "-4) ((l r) 16 -74))",
+      "b 21.3 -21 1 0.9 1\n"
+      "m 34 2 26.7 -39\n"
+      "m 33 2 30.9 -21\n"
+      "m 11 2 33.8 24\n"
+      "m 32 2 37.3 -8\n"
+      "m 31 2 45.1 1\n"
+      "m 16 2 50 43\n"
+      "m 30 2 53.6 7\n"
+      "m 6 2 53.7 13\n"
+      "m 45 2 54.7 39\n"
+      "m 46 2 55 28\n"
+      "m 47 2 57.1 18\n"
+      "l 1 16 -74\n"
+      "t 1 1 14.8 25 1 0.91 -0.3 -8 14 -360 0 0\n"
+      "t 5 0 16.8 4 1 -0.78 0.2 -126 -7 -8 0 0\n"
+      "T -1 0 22.4 -15 0 0 0 -360 -360 -360 0 0\n"
+      "o 3 0 17 -5 1 0.37 0.1 -23 53 -360 1 0\n"
+      "o 7 0 19.7 28 1 0.99 -0.5 39 27 -360 0 0\n"
+      "O -1 0 23 -4 0 0 0 -360 -360 -360 0 0\n"
+      "u -1 0 41.8 31 0 0 0 -360 -360 -360 0 0\n"
+      "u -1 0 48.2 35 0 0 0 -360 -360 -360 0 0\n" },
+    { 18.0,
+      "(see 238 ((g l) 18 -5) ((f g l t) 15.9 18) ((f g l b) 22.2 -21) ((f l t 10) "
+      "20.8 28) ((f l 0) 22.5 2) ((f l b 10) 27.9 -18) ((f l b 20) 35.4 -30) ((f l "
+      "b 30) 43.9 -38) ((p \"opponent\" 1 goalie) 13 10 0.26 0.5 41 4 t))",
+      "m 15 2 15.9 18\n"
+      "m 0 0 18 -5\n"
+      "m 43 2 20.8 28\n"
+      "m 16 2 22.2 -21\n"
+      "m 44 2 22.5 2\n"
+      "m 45 2 27.9 -18\n"
+      "m 46 2 35.4 -30\n"
+      "m 47 2 43.9 -38\n"
+      "o 1 1 13 10 1 0.26 0.5 41 4 -360 0 1\n" },
+    { 18.0,
+      "(see 564 ((g r) 33.6 20) ((F) 1.5 -84) ((f r b) 67.6 21) ((f p r b) 55.8 38) "
+      "((f g r t) 26.6 19) ((f g r b) 40.6 21) ((f b r 30) 75.6 39) ((f b r 40) "
+      "73.4 31) ((f b r 50) 72.6 23) ((f r t 30) 7.4 -38) ((f r t 20) 15 -3) ((f r "
+      "t 10) 24.4 7) ((f r 0) 34.2 12) ((f r b 10) 44 14) ((f r b 20) 54 16) ((f r "
+      "b 30) 63.9 17) ((b) 56.1 30) ((p \"HELIOS_base\") 20 42) ((p) 59.1 40) ((p "
+      "\"opponent\" 11) 14.3 23 -0.36 -0.1 -142 76) ((l b) 95 -11))",
+      "b 56.1 30 0 0 0\n"
+      "m 48 2 7.4 -38\n"
+      "m 49 2 15 -3\n"
+      "m 50 2 24.4 7\n"
+      "m 17 2 26.6 19\n"
+      "m 1 0 33.6 20\n"
+      "m 51 2 34.2 12\n"
+      "m 18 2 40.6 21\n"
+      "m 52 2 44 14\n"
+      "m 53 2 54 16\n"
+      "m 14 2 55.8 38\n"
+      "m 54 2 63.9 17\n"
+      "m 8 2 67.6 21\n"
+      "m 40 2 72.6 23\n"
+      "m 39 2 73.4 31\n"
+      "m 38 2 75.6 39\n"
+      "M 55 3 1.5 -84\n"
+      "l 3 95 -11\n"
+      "T -1 0 20 42 0 0 0 -360 -360 -360 0 0\n"
+      "o 11 0 14.3 23 1 -0.36 -0.1 -142 76 -360 0 0\n"
+      "u -1 0 59.1 40 0 0 0 -360 -360 -360 0 0\n" },
+    { 5.0,
+      "(see 376 ((flag l b) 53.7 13) ((flag p l b) 33.8 24) ((flag g l b) 50 43) "
+      "((flag b l 50) 53.6 7) ((flag b l 40) 45.1 1) ((flag b l 30) 37.3 -8) ((flag "
+      "b l 20) 30.9 -21) ((flag b l 10) 26.7 -39) ((flag l b 10) 54.7 39) ((flag l "
+      "b 20) 55 28) ((flag l b 30) 57.1 18) ((ball) 21.3 -21 0.9 1) ((player "
+      "\"HELIOS_base\" 1 goalie) 14.8 25 0.91 -0.3 -8 14) ((player \"HELIOS_base\" "
+      "5) 16.8 4 -0.78 0.2 -126 -7 -8) ((player \"HELIOS_base\") 22.4 -15) "
+      "((player) 41.8 31) ((player \"opponent\" 3) 17 -5 0.37 0.1 -23 53 k) "
+      "((player) 48.2 35) ((player \"opponent\" 7) 19.7 28 0.99 -0.5 39 27) "
+      "((player \"opponent\") 23 -4) ((line r) 16 -74))",
+      "b 21.3 -21 1 0.9 1\n"
+      "m 34 2 26.7 -39\n"
+      "m 33 2 30.9 -21\n"
+      "m 11 2 33.8 24\n"
+      "m 32 2 37.3 -8\n"
+      "m 31 2 45.1 1\n"
+      "m 16 2 50 43\n"
+      "m 30 2 53.6 7\n"
+      "m 6 2 53.7 13\n"
+      "m 45 2 54.7 39\n"
+      "m 46 2 55 28\n"
+      "m 47 2 57.1 18\n"
+      "l 1 16 -74\n"
+      "t 1 1 14.8 25 1 0.91 -0.3 -8 14 -360 0 0\n"
+      "t 5 0 16.8 4 1 -0.78 0.2 -126 -7 -8 0 0\n"
+      "T -1 0 22.4 -15 0 0 0 -360 -360 -360 0 0\n"
+      "o 3 0 17 -5 1 0.37 0.1 -23 53 -360 1 0\n"
+      "o 7 0 19.7 28 1 0.99 -0.5 39 27 -360 0 0\n"
+      "O -1 0 23 -4 0 0 0 -360 -360 -360 0 0\n"
+      "u -1 0 41.8 31 0 0 0 -360 -360 -360 0 0\n"
+      "u -1 0 48.2 35 0 0 0 -360 -360 -360 0 0\n" },
+    { 5.0,
+      "(see 238 ((goal l) 18 -5) ((flag g l t) 15.9 18) ((flag g l b) 22.2 -21) "
+      "((flag l t 10) 20.8 28) ((flag l 0) 22.5 2) ((flag l b 10) 27.9 -18) ((flag "
+      "l b 20) 35.4 -30) ((flag l b 30) 43.9 -38) ((player \"opponent\" 1 goalie) "
+      "13 10 0.26 0.5 41 4 t))",
+      "m 15 2 15.9 18\n"
+      "m 0 0 18 -5\n"
+      "m 43 2 20.8 28\n"
+      "m 16 2 22.2 -21\n"
+      "m 44 2 22.5 2\n"
+      "m 45 2 27.9 -18\n"
+      "m 46 2 35.4 -30\n"
+      "m 47 2 43.9 -38\n"
+      "o 1 1 13 10 1 0.26 0.5 41 4 -360 0 1\n" },
+    { 5.0,
+      "(see 564 ((goal r) 33.6 20) ((Flag) 1.5 -84) ((flag r b) 67.6 21) ((flag p r "
+      "b) 55.8 38) ((flag g r t) 26.6 19) ((flag g r b) 40.6 21) ((flag b r 30) "
+      "75.6 39) ((flag b r 40) 73.4 31) ((flag b r 50) 72.6 23) ((flag r t 30) 7.4 "
+      "-38) ((flag r t 20) 15 -3) ((flag r t 10) 24.4 7) ((flag r 0) 34.2 12) "
+      "((flag r b 10) 44 14) ((flag r b 20) 54 16) ((flag r b 30) 63.9 17) ((ball) "
+      "56.1 30) ((player \"HELIOS_base\") 20 42) ((player) 59.1 40) ((player "
+      "\"opponent\" 11) 14.3 23 -0.36 -0.1 -142 76) ((line b) 95 -11))",
+      "b 56.1 30 0 0 0\n"
+      "m 48 2 7.4 -38\n"
+      "m 49 2 15 -3\n"
+      "m 50 2 24.4 7\n"
+      "m 17 2 26.6 19\n"
+      "m 1 0 33.6 20\n"
+      "m 51 2 34.2 12\n"
+      "m 18 2 40.6 21\n"
+      "m 52 2 44 14\n"
+      "m 53 2 54 16\n"
+      "m 14 2 55.8 38\n"
+      "m 54 2 63.9 17\n"
+      "m 8 2 67.6 21\n"
+      "m 40 2 72.6 23\n"
+      "m 39 2 73.4 31\n"
+      "m 38 2 75.6 39\n"
+      "M 55 3 1.5 -84\n"
+      "l 3 95 -11\n"
+      "T -1 0 20 42 0 0 0 -360 -360 -360 0 0\n"
+      "o 11 0 14.3 23 1 -0.36 -0.1 -142 76 -360 0 0\n"
+      "u -1 0 59.1 40 0 0 0 -360 -360 -360 0 0\n" },
+};
+
+const char * TEAM_NAME = "HELIOS_base";
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief convert the value to the shortest string that can be read back
+ */
+std::string
+to_string( const double value )
+{
+    char buf[32];
+    const std::to_chars_result result = std::to_chars( buf, buf + sizeof( buf ), value );
+    return std::string( buf, result.ptr );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+print_markers( std::ostream & os,
+               const char * tag,
+               const VisualSensor::MarkerCont & markers )
+{
+    for ( const VisualSensor::MarkerT & m : markers )
+    {
+        os << tag << ' ' << m.id_ << ' ' << m.object_type_
+           << ' ' << to_string( m.dist_ ) << ' ' << to_string( m.dir_ ) << '\n';
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+print_players( std::ostream & os,
+               const char * tag,
+               const VisualSensor::PlayerCont & players )
+{
+    for ( const VisualSensor::PlayerT & p : players )
+    {
+        os << tag << ' ' << p.unum_ << ' ' << p.goalie_
+           << ' ' << to_string( p.dist_ ) << ' ' << to_string( p.dir_ )
+           << ' ' << p.has_vel_ << ' ' << to_string( p.dist_chng_ ) << ' ' << to_string( p.dir_chng_ )
+           << ' ' << to_string( p.body_ ) << ' ' << to_string( p.face_ ) << ' ' << to_string( p.arm_ )
+           << ' ' << p.kicking_ << ' ' << p.tackle_ << '\n';
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief print the parsed result in the format of TEST_CASES
+ */
+std::string
+print_result( const VisualSensor & sensor )
+{
+    std::ostringstream os;
+
+    for ( const VisualSensor::BallT & b : sensor.balls() )
+    {
+        os << "b " << to_string( b.dist_ ) << ' ' << to_string( b.dir_ )
+           << ' ' << b.has_vel_ << ' ' << to_string( b.dist_chng_ ) << ' ' << to_string( b.dir_chng_ ) << '\n';
+    }
+
+    print_markers( os, "m", sensor.markers() );
+    print_markers( os, "M", sensor.behindMarkers() );
+
+    for ( const VisualSensor::LineT & l : sensor.lines() )
+    {
+        os << "l " << l.id_ << ' ' << to_string( l.dist_ ) << ' ' << to_string( l.dir_ ) << '\n';
+    }
+
+    print_players( os, "t", sensor.teammates() );
+    print_players( os, "T", sensor.unknownTeammates() );
+    print_players( os, "o", sensor.opponents() );
+    print_players( os, "O", sensor.unknownOpponents() );
+    print_players( os, "u", sensor.unknownPlayers() );
+
+    return os.str();
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+
+class VisualSensorTest
+    : public CPPUNIT_NS::TestFixture {
+
+    CPPUNIT_TEST_SUITE( VisualSensorTest );
+    CPPUNIT_TEST( testParse );
+    CPPUNIT_TEST( testReuse );
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+
+    void testParse();
+    void testReuse();
+};
+
+
+CPPUNIT_TEST_SUITE_REGISTRATION( VisualSensorTest );
+
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+VisualSensorTest::testParse()
+{
+    long cycle = 0;
+    for ( const TestCase & t : TEST_CASES )
+    {
+        VisualSensor sensor;
+        sensor.parse( t.message_, TEAM_NAME, t.version_, GameTime( ++cycle, 0 ) );
+        CPPUNIT_ASSERT_EQUAL( std::string( t.expected_ ), print_result( sensor ) );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+VisualSensorTest::testReuse()
+{
+    // the containers reused by the next message must not keep the old data.
+    VisualSensor sensor;
+    long cycle = 0;
+    for ( int i = 0; i < 2; ++i )
+    {
+        for ( const TestCase & t : TEST_CASES )
+        {
+            sensor.parse( t.message_, TEAM_NAME, t.version_, GameTime( ++cycle, 0 ) );
+            CPPUNIT_ASSERT_EQUAL( std::string( t.expected_ ), print_result( sensor ) );
+        }
+    }
+}
+
+
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+/*-------------------------------------------------------------------*/
+
+#include <cppunit/BriefTestProgressListener.h>
+//#include <cppunit/TextTestProgressListener.h>
+#include <cppunit/CompilerOutputter.h>
+//#include <cppunit/TextOutputter.h>
+//#include <cppunit/XmlOutputter.h>
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/TestResult.h>
+#include <cppunit/TestResultCollector.h>
+#include <cppunit/TestRunner.h>
+
+int
+main( int, char ** )
+{
+    // create the event manager and test controller
+    CPPUNIT_NS::TestResult controller;
+
+    // add a listner that collects test results
+    CPPUNIT_NS::TestResultCollector result;
+    controller.addListener( &result );
+
+    // add a listener that prints dots as test run.
+    CPPUNIT_NS::BriefTestProgressListener progress;
+    controller.addListener( &progress );
+
+    //CPPUNIT_NS::TextTestProgressListener textprog;
+    //controller.addListener( &textprog );
+
+    // add the top suite to the test runner.
+    CPPUNIT_NS::TestRunner runner;
+    runner.addTest( CPPUNIT_NS::TestFactoryRegistry::getRegistry().makeTest() );
+    runner.run( controller );
+
+    // output results in a compiler compatible format
+    CPPUNIT_NS::CompilerOutputter outputter( &result, CPPUNIT_NS::stdCOut() );
+    //CPPUNIT_NS::TextOutputter outputter( &result, CPPUNIT_NS::stdCOut() );
+    //CPPUNIT_NS::XmlOutputter outputter( &result, CPPUNIT_NS::stdCOut() );
+    outputter.write();
+
+    return result.wasSuccessful() ? 0 : 1;
+}
@@ -44,6 +44,8 @@
 
 
 #include <vector>
+#include <algorithm>
+#include <limits>
 #include <iostream>
 #include <cstring>
 #include <cmath>
@@ -71,24 +73,6 @@ const double ViewGridMap::GRID_RADIUS = ViewGridMap::GRID_LENGTH*0.5 * std::sqrt
 
 namespace {
 
-inline
-int
-grid_x_index( const double x )
-{
-    int ix = static_cast< int >( std::ceil( ( x + ViewGridMap::PITCH_MAX_X )
-                                            / ViewGridMap::GRID_LENGTH ) );
-    return bound( 0, ix, ViewGridMap::GRID_X_SIZE );
-}
-
-inline
-int
-grid_y_index( const double y )
-{
-    int iy = static_cast< int >( std::ceil( ( y + ViewGridMap::PITCH_MAX_Y )
-                                            / ViewGridMap::GRID_LENGTH ) );
-    return bound( 0, iy, ViewGridMap::GRID_Y_SIZE );
-}
-
 inline
 int
 grid_index( const Vector2D & pos )
@@ -103,21 +87,68 @@ grid_index( const Vector2D & pos )
     return ix * ViewGridMap::GRID_Y_SIZE + iy;
 }
 
+/*!
+  \brief get the y-index range of the cells whose center may be in the y range
+  \param min_y minimum y coordinate
+  \param max_y maximum y coordinate
+  \param first variable pointer to store the first index
+  \param last variable pointer to store the last index
+  \return true if the range is not empty
+ */
 inline
-Vector2D
-grid_center( const int ix,
-             const int iy )
+bool
+grid_y_range( const double min_y,
+              const double max_y,
+              int * first,
+              int * last )
 {
-    return Vector2D( ix * ViewGridMap::GRID_LENGTH - ViewGridMap::PITCH_MAX_X,
-                     iy * ViewGridMap::GRID_LENGTH - ViewGridMap::PITCH_MAX_Y );
+    // one cell margin to absorb the rounding errors. the bounds are clamped before the cast.
+    const double lo = std::floor( ( min_y + ViewGridMap::PITCH_MAX_Y ) / ViewGridMap::GRID_LENGTH ) - 1.0;
+    const double hi = std::ceil( ( max_y + ViewGridMap::PITCH_MAX_Y ) / ViewGridMap::GRID_LENGTH ) + 1.0;
+
+    *first = static_cast< int >( std::max( 0.0, lo ) );
+    *last = static_cast< int >( std::min( static_cast< double >( ViewGridMap::GRID_Y_SIZE - 1 ), hi ) );
+
+    return *first <= *last;
 }
 
+/*!
+  \brief get the range of the relative y coordinate inside the cone on the vertical line
+  \param dx relative x coordinate of the vertical line
+  \param left unit vector of the left edge of the cone
+  \param right unit vector of the right edge of the cone
+  \param min_dy variable pointer to store the minimum relative y coordinate
+  \param max_dy variable pointer to store the maximum relative y coordinate
+  \return true if the range is not empty
+
+  The cone width must be less than 180 degree. A relative point (dx, dy) is
+  inside the cone if left x (dx, dy) > 0 and (dx, dy) x right > 0, and both
+  conditions are linear in dy.
+ */
 inline
-Vector2D
-grid_center( const int idx )
+bool
+cone_y_range( const double dx,
+              const Vector2D & left,
+              const Vector2D & right,
+              double * min_dy,
+              double * max_dy )
 {
-    return grid_center( idx / ViewGridMap::GRID_Y_SIZE,
-                        idx % ViewGridMap::GRID_Y_SIZE );
+    double lo = -std::numeric_limits< double >::max();
+    double hi = +std::numeric_limits< double >::max();
+
+    // left.x * dy > left.y * dx
+    if ( left.x > 0.0 ) lo = std::max( lo, left.y * dx / left.x );
+    else if ( left.x < 0.0 ) hi = std::min( hi, left.y * dx / left.x );
+    else if ( left.y * dx >= 0.0 ) return false;
+
+    // right.x * dy < right.y * dx
+    if ( right.x > 0.0 ) hi = std::min( hi, right.y * dx / right.x );
+    else if ( right.x < 0.0 ) lo = std::max( lo, right.y * dx / right.x );
+    else if ( right.y * dx <= 0.0 ) return false;
+
+    *min_dy = lo;
+    *max_dy = hi;
+    return lo <= hi;
 }
 
 }
@@ -130,17 +161,19 @@ grid_center( const int idx )
 
 */
 ViewGridMap::ViewGridMap()
+    : M_seen_count( GRID_X_SIZE * GRID_Y_SIZE, 0 )
 {
-    M_grid_map.reserve( GRID_X_SIZE * GRID_Y_SIZE );
-
+    M_center_x.reserve( GRID_X_SIZE );
     for ( int x = 0; x < GRID_X_SIZE; ++x )
     {
-        for ( int y = 0; y < GRID_Y_SIZE; ++y )
-        {
-            M_grid_map.emplace_back( grid_center( x, y ) );
-        }
+        M_center_x.push_back( x * GRID_LENGTH - PITCH_MAX_X );
     }
 
+    M_center_y.reserve( GRID_Y_SIZE );
+    for ( int y = 0; y < GRID_Y_SIZE; ++y )
+    {
+        M_center_y.push_back( y * GRID_LENGTH - PITCH_MAX_Y );
+    }
 }
 
 /*-------------------------------------------------------------------*/
@@ -159,9 +192,12 @@ ViewGridMap::~ViewGridMap()
 void
 ViewGridMap::incrementAll()
 {
-    for ( Grid & p : M_grid_map )
+    // contiguous int array. the compiler generates the vector add.
+    int * count = M_seen_count.data();
+    const std::size_t size = M_seen_count.size();
+    for ( std::size_t i = 0; i < size; ++i )
     {
-        p.seen_count_ += 1;
+        count[i] += 1;
     }
 }
 
@@ -173,7 +209,7 @@ void
 ViewGridMap::update( const GameTime & time,
                      const ViewArea & view_area )
 {
-    static GameTime s_update_time( 0, 0 );
+    thread_local GameTime s_update_time( 0, 0 );
 
     if ( s_update_time == time )
     {
@@ -195,31 +231,69 @@ ViewGridMap::update( const GameTime & time,
     const AngleDeg right_angle = view_area.angle() + view_area.viewWidth() * 0.5 - 2.0;
 
     static const double VISIBLE_DIST = ServerParam::i().visibleDistance() - 0.5;
+    static const double VISIBLE_DIST2 = VISIBLE_DIST * VISIBLE_DIST;
+
+    const Vector2D & origin = view_area.origin();
+    const Vector2D left = Vector2D::polar2vector( 1.0, left_angle );
+    const Vector2D right = Vector2D::polar2vector( 1.0, right_angle );
 
-    for ( Grid & p : M_grid_map )
+    int visited = 0;
+
+    for ( int ix = 0; ix < GRID_X_SIZE; ++ix )
     {
-        const double dist = view_area.origin().dist( p.center_ );
-        if ( dist < VISIBLE_DIST )
+        const double dx = M_center_x[ix] - origin.x;
+
+        //
+        // the y range covered by the visible circle or the view cone
+        //
+        double min_dy = +std::numeric_limits< double >::max();
+        double max_dy = -std::numeric_limits< double >::max();
+
+        if ( std::fabs( dx ) < VISIBLE_DIST )
         {
-            p.seen_count_ = 0;
+            const double h = std::sqrt( VISIBLE_DIST2 - dx * dx );
+            min_dy = -h;
+            max_dy = +h;
         }
-        else
+
+        double cone_min_dy, cone_max_dy;
+        if ( cone_y_range( dx, left, right, &cone_min_dy, &cone_max_dy ) )
         {
-            const AngleDeg angle = ( p.center_ - view_area.origin() ).th();
-            if ( angle.isRightOf( left_angle )
-                 && angle.isLeftOf( right_angle ) )
-            {
-                p.seen_count_ = 0;
-            }
+            min_dy = std::min( min_dy, cone_min_dy );
+            max_dy = std::max( max_dy, cone_max_dy );
         }
 
+        int first, last;
+        if ( min_dy > max_dy
+             || ! grid_y_range( origin.y + min_dy, origin.y + max_dy, &first, &last ) )
+        {
+            continue;
+        }
+
+        //
+        // exact test for the cells in the range
+        //
+        int * count = M_seen_count.data() + ix * GRID_Y_SIZE;
+        const double dx2 = dx * dx;
+        for ( int iy = first; iy <= last; ++iy )
+        {
+            const double dy = M_center_y[iy] - origin.y;
+            const bool visible = ( dx2 + dy * dy < VISIBLE_DIST2
+                                   || ( left.x * dy - left.y * dx > 0.0
+                                        && dx * right.y - dy * right.x > 0.0 ) );
+            count[iy] = ( visible ? 0 : count[iy] );
+        }
+        visited += last - first + 1;
     }
 
 #ifdef DEBUG_PROFILE
     dlog.addText( Logger::WORLD,
-                  __FILE__" (update) PROFILE elapsed %f [ms] grid_size=%d",
+                  __FILE__" (update) PROFILE elapsed %f [ms] grid_size=%d visited=%d",
                   timer.elapsedReal(),
-                  M_grid_map.size() );
+                  static_cast< int >( M_seen_count.size() ),
+                  visited );
+#else
+    (void)visited;
 #endif
 }
 
@@ -232,7 +306,7 @@ ViewGridMap::seenCount( const Vector2D & pos ) const
 {
     try
     {
-        return M_grid_map.at( grid_index( pos ) ).seen_count_;
+        return M_seen_count.at( grid_index( pos ) );
     }
     catch ( std::exception & e )
     {
@@ -243,18 +317,154 @@ ViewGridMap::seenCount( const Vector2D & pos ) const
     }
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+std::vector< ViewGridMap::Grid >
+ViewGridMap::gridMap() const
+{
+    std::vector< Grid > grid_map;
+    grid_map.reserve( M_seen_count.size() );
+
+    for ( int ix = 0; ix < GRID_X_SIZE; ++ix )
+    {
+        for ( int iy = 0; iy < GRID_Y_SIZE; ++iy )
+        {
+            grid_map.emplace_back( gridCenter( ix, iy ) );
+            grid_map.back().seen_count_ = M_seen_count[ix * GRID_Y_SIZE + iy];
+        }
+    }
+
+    return grid_map;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+int
+ViewGridMap::oldestSeenCount( const Vector2D & origin,
+                              const AngleDeg & left_angle,
+                              const AngleDeg & right_angle,
+                              const double max_dist,
+                              Vector2D * oldest_pos ) const
+{
+    double width = ( right_angle - left_angle ).degree();
+    if ( width <= 0.0 ) width += 360.0;
+
+    int oldest_index = -1;
+    int oldest_count = -1;
+
+    // split the sector so that each part can be treated as a convex cone.
+    const int divs = static_cast< int >( width / 120.0 ) + 1;
+    const double step = width / divs;
+    for ( int i = 0; i < divs; ++i )
+    {
+        int index = -1;
+        const int count = oldestSeenCountConvex( origin,
+                                                 left_angle + step * i,
+                                                 left_angle + step * ( i + 1 ),
+                                                 max_dist,
+                                                 &index );
+        if ( count > oldest_count )
+        {
+            oldest_count = count;
+            oldest_index = index;
+        }
+    }
+
+    if ( oldest_pos
+         && oldest_index >= 0 )
+    {
+        *oldest_pos = gridCenter( oldest_index / GRID_Y_SIZE,
+                                  oldest_index % GRID_Y_SIZE );
+    }
+
+    return oldest_count;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+int
+ViewGridMap::oldestSeenCountConvex( const Vector2D & origin,
+                                    const AngleDeg & left_angle,
+                                    const AngleDeg & right_angle,
+                                    const double max_dist,
+                                    int * oldest_index ) const
+{
+    const Vector2D left = Vector2D::polar2vector( 1.0, left_angle );
+    const Vector2D right = Vector2D::polar2vector( 1.0, right_angle );
+    const double max_dist2 = max_dist * max_dist;
+
+    const int first_x = static_cast< int >( std::max( 0.0,
+                                                      std::floor( ( origin.x - max_dist + PITCH_MAX_X ) / GRID_LENGTH ) ) );
+    const int last_x = static_cast< int >( std::min( static_cast< double >( GRID_X_SIZE - 1 ),
+                                                     std::ceil( ( origin.x + max_dist + PITCH_MAX_X ) / GRID_LENGTH ) ) );
+
+    int oldest_count = -1;
+
+    for ( int ix = first_x; ix <= last_x; ++ix )
+    {
+        const double dx = M_center_x[ix] - origin.x;
+        if ( std::fabs( dx ) >= max_dist )
+        {
+            continue;
+        }
+
+        double min_dy, max_dy;
+        if ( ! cone_y_range( dx, left, right, &min_dy, &max_dy ) )
+        {
+            continue;
+        }
+
+        const double h = std::sqrt( max_dist2 - dx * dx );
+        min_dy = std::max( min_dy, -h );
+        max_dy = std::min( max_dy, +h );
+
+        int first, last;
+        if ( min_dy > max_dy
+             || ! grid_y_range( origin.y + min_dy, origin.y + max_dy, &first, &last ) )
+        {
+            continue;
+        }
+
+        const int * count = M_seen_count.data() + ix * GRID_Y_SIZE;
+        const double dx2 = dx * dx;
+        for ( int iy = first; iy <= last; ++iy )
+        {
+            const double dy = M_center_y[iy] - origin.y;
+            if ( count[iy] > oldest_count
+                 && dx2 + dy * dy < max_dist2
+                 && left.x * dy - left.y * dx > 0.0
+                 && dx * right.y - dy * right.x > 0.0 )
+            {
+                oldest_count = count[iy];
+                *oldest_index = ix * GRID_Y_SIZE + iy;
+            }
+        }
+    }
+
+    return oldest_count;
+}
+
 /*-------------------------------------------------------------------*/
 void
 ViewGridMap::debugOutput() const
 {
-    for ( const Grid & p : M_grid_map )
+    for ( int ix = 0; ix < GRID_X_SIZE; ++ix )
     {
-        const int col = std::max( 0, 255 - p.seen_count_ * 20 );
-        dlog.addRect( Logger::WORLD,
-                      p.center_.x - GRID_LENGTH*0.05, p.center_.y - GRID_LENGTH*0.05,
-                      GRID_LENGTH*0.1, GRID_LENGTH*0.1,
-                      col, col, col,
-                      true );
+        for ( int iy = 0; iy < GRID_Y_SIZE; ++iy )
+        {
+            const int col = std::max( 0, 255 - M_seen_count[ix * GRID_Y_SIZE + iy] * 20 );
+            dlog.addRect( Logger::WORLD,
+                          M_center_x[ix] - GRID_LENGTH*0.05, M_center_y[iy] - GRID_LENGTH*0.05,
+                          GRID_LENGTH*0.1, GRID_LENGTH*0.1,
+                          col, col, col,
+                          true );
+        }
     }
 }
 
@@ -33,9 +33,9 @@
 #define RCSC_PLAYER_VIEW_GRID_MAP_H
 
 #include <rcsc/geom/vector_2d.h>
+#include <rcsc/geom/angle_deg.h>
 
 #include <vector>
-#include <utility>
 
 namespace rcsc {
 
@@ -45,13 +45,35 @@ class ViewArea;
 /*!
   \class ViewGridMap
   \brief grid map that stores field accuracy information
+
+  The seen counts of all cells are stored in one flat array in the order of
+  [x][y], and the coordinates of the cell centers are stored in the separated
+  arrays for each axis. The update by the see information only visits the
+  y-index range of each column that may be covered by the view cone, so that
+  the cells outside of the view cone are never touched.
  */
 class ViewGridMap {
+private:
+
+    //! seen count of each cell. index: ix * GRID_Y_SIZE + iy
+    std::vector< int > M_seen_count;
+
+    //! x coordinate of the cell centers. index: ix
+    std::vector< double > M_center_x;
+
+    //! y coordinate of the cell centers. index: iy
+    std::vector< double > M_center_y;
+
 public:
 
+    /*!
+      \struct Grid
+      \brief cell data used by the old interface
+      \deprecated use seenCounts() and gridCenter().
+     */
     struct Grid {
-        const rcsc::Vector2D center_;
-        int seen_count_;
+        const rcsc::Vector2D center_; //!< center point of the cell
+        int seen_count_; //!< count since last observation
 
         Grid() = delete;
 
@@ -59,15 +81,9 @@ public:
         Grid( const rcsc::Vector2D & center )
             : center_( center ),
               seen_count_( 0 )
-        { }
+          { }
     };
 
-private:
-
-    std::vector< Grid > M_grid_map;
-
-public:
-
     static const double GRID_LENGTH;
 
     static const double PITCH_MAX_X;
@@ -103,9 +119,25 @@ public:
     void update( const GameTime & time,
                  const ViewArea & view_area );
 
-    const std::vector< Grid > & gridMap() const
+    /*!
+      \brief get the seen counts of all cells
+      \return const reference to the flat array. index: ix * GRID_Y_SIZE + iy
+     */
+    const std::vector< int > & seenCounts() const
     {
-        return M_grid_map;
+        return M_seen_count;
+    }
+
+    /*!
+      \brief get the center point of the cell
+      \param ix x-index of the cell
+      \param iy y-index of the cell
+      \return center point of the cell
+     */
+    Vector2D gridCenter( const int ix,
+                         const int iy ) const
+    {
+        return Vector2D( M_center_x[ix], M_center_y[iy] );
     }
 
     /*!
@@ -115,11 +147,52 @@ public:
      */
     int seenCount( const Vector2D & pos ) const;
 
+    /*!
+      \brief create the copy of all cells in the old format
+      \return cell container. index: ix * GRID_Y_SIZE + iy
+      \deprecated use seenCounts() and gridCenter().
+      The container is created each time this method is called.
+     */
+    [[deprecated( "use seenCounts() and gridCenter()" )]]
+    std::vector< Grid > gridMap() const;
+
+    /*!
+      \brief find the oldest seen cell in the sector
+      \param origin the origin point of the sector
+      \param left_angle the left limit of the sector
+      \param right_angle the right limit of the sector. the sector is the clockwise range from left_angle.
+      \param max_dist the radius of the sector
+      \param oldest_pos variable pointer to store the center of the found cell (can be NULL)
+      \return the maximum seen count in the sector, or -1 if no cell is found
+     */
+    int oldestSeenCount( const Vector2D & origin,
+                         const AngleDeg & left_angle,
+                         const AngleDeg & right_angle,
+                         const double max_dist,
+                         Vector2D * oldest_pos = nullptr ) const;
+
     /*!
       \brief output the debug data
      */
     void debugOutput() const;
 
+private:
+
+    /*!
+      \brief find the oldest seen cell in the sector whose width is less than 180 degree
+      \param origin the origin point of the sector
+      \param left_angle the left limit of the sector
+      \param right_angle the right limit of the sector
+      \param max_dist the radius of the sector
+      \param oldest_index variable pointer to store the index of the found cell
+      \return the maximum seen count in the sector, or -1 if no cell is found
+     */
+    int oldestSeenCountConvex( const Vector2D & origin,
+                               const AngleDeg & left_angle,
+                               const AngleDeg & right_angle,
+                               const double max_dist,
+                               int * oldest_index ) const;
+
 };
 
 }
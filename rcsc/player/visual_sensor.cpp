@@ -36,37 +36,16 @@
 #include "visual_sensor.h"
 
 #include <rcsc/common/logger.h>
+#include <rcsc/common/sexp_cursor.h>
 
 #include <iterator>
 #include <algorithm>
 #include <limits> // std::numeric_limits
-#include <cstdlib>
 #include <cstring>
-#include <cmath> // HUGE_VAL
+#include <cstdint>
 
 namespace rcsc {
 
-/*-------------------------------------------------------------------*/
-
-/*!
-  \struct SeenDistCmp
-  \brief functor to compare seen distance of observed object
-*/
-struct SeenDistCmp {
-    /*!
-      \brief operation function
-      \param lhs left hand side variable
-      \param rhs right hand side variable
-      \return compared result
-     */
-    bool operator()( const VisualSensor::PolarT & lhs,
-                     const VisualSensor::PolarT & rhs ) const
-      {
-          return lhs.dist_ < rhs.dist_;
-      }
-};
-
-
 /*-------------------------------------------------------------------*/
 /*!
   \brief stream operator
@@ -158,6 +137,227 @@ operator<<( std::ostream & os,
 
 /*-------------------------------------------------------------------*/
 
+namespace {
+
+/*!
+  \brief marker names in the order of MarkerID.
+  The old protocol names ("flag ...", "goal ...") are converted to these
+  names by replacing the first word with its first character.
+*/
+constexpr const char * MARKER_NAMES[] = {
+    "g l", "g r",
+
+    "f c",
+    "f c t", "f c b",
+    "f l t", "f l b",
+    "f r t", "f r b",
+
+    "f p l t", "f p l c", "f p l b",
+    "f p r t", "f p r c", "f p r b",
+
+    "f g l t", "f g l b",
+    "f g r t", "f g r b",
+
+    "f t l 50", "f t l 40", "f t l 30", "f t l 20", "f t l 10",
+    "f t 0",
+    "f t r 10", "f t r 20", "f t r 30", "f t r 40", "f t r 50",
+
+    "f b l 50", "f b l 40", "f b l 30", "f b l 20", "f b l 10",
+    "f b 0",
+    "f b r 10", "f b r 20", "f b r 30", "f b r 40", "f b r 50",
+
+    "f l t 30", "f l t 20", "f l t 10",
+    "f l 0",
+    "f l b 10", "f l b 20", "f l b 30",
+
+    "f r t 30", "f r t 20", "f r t 10",
+    "f r 0",
+    "f r b 10", "f r b 20", "f r b 30",
+};
+
+static_assert( sizeof( MARKER_NAMES ) / sizeof( MARKER_NAMES[0] ) == Marker_Unknown,
+               "MARKER_NAMES must cover all MarkerID values." );
+
+//! the number of bits of the marker hash value
+constexpr int MARKER_HASH_BITS = 8;
+//! the size of the marker hash table
+constexpr std::size_t MARKER_HASH_SIZE = std::size_t( 1 ) << MARKER_HASH_BITS;
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief get the length of the null terminated string at compile time
+  \param str string
+  \return length of the string
+*/
+constexpr
+std::size_t
+const_strlen( const char * str )
+{
+    std::size_t len = 0;
+    while ( str[len] != '\0' ) ++len;
+    return len;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief FNV-1a hash of the marker name
+  \param seed initial hash value
+  \param type the first character of the marker name
+  \param rest the marker name after the first word
+  \param len length of rest
+  \return hash value in [0, MARKER_HASH_SIZE)
+*/
+constexpr
+std::size_t
+marker_hash( const std::uint32_t seed,
+             const char type,
+             const char * rest,
+             const std::size_t len )
+{
+    constexpr std::uint32_t HASH_PRIME = 16777619u;
+
+    std::uint32_t h = ( seed ^ static_cast< unsigned char >( type ) ) * HASH_PRIME;
+    for ( std::size_t i = 0; i < len; ++i )
+    {
+        h = ( h ^ static_cast< unsigned char >( rest[i] ) ) * HASH_PRIME;
+    }
+    return h >> ( 32 - MARKER_HASH_BITS );
+}
+
+/*!
+  \struct MarkerHashTable
+  \brief perfect hash table of the marker names
+*/
+struct MarkerHashTable {
+    std::uint32_t seed_; //!< hash seed without any collision
+    std::uint8_t ids_[MARKER_HASH_SIZE]; //!< MarkerID for each hash value, Marker_Unknown if empty
+};
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief search the hash seed that maps all marker names to the different slots
+  \return the created table. seed_ is 0 if no seed is found.
+*/
+constexpr
+MarkerHashTable
+create_marker_hash_table()
+{
+    MarkerHashTable table = {};
+
+    for ( std::uint32_t seed = 2166136261u; seed < 2166136261u + 100000u; ++seed )
+    {
+        for ( std::size_t i = 0; i < MARKER_HASH_SIZE; ++i )
+        {
+            table.ids_[i] = Marker_Unknown;
+        }
+
+        bool collided = false;
+        for ( int id = 0; id < Marker_Unknown; ++id )
+        {
+            const char * name = MARKER_NAMES[id];
+            const std::size_t h = marker_hash( seed, name[0], name + 1, const_strlen( name + 1 ) );
+            if ( table.ids_[h] != Marker_Unknown )
+            {
+                collided = true;
+                break;
+            }
+            table.ids_[h] = static_cast< std::uint8_t >( id );
+        }
+
+        if ( ! collided )
+        {
+            table.seed_ = seed;
+            return table;
+        }
+    }
+
+    table.seed_ = 0;
+    return table;
+}
+
+constexpr MarkerHashTable MARKER_HASH_TABLE = create_marker_hash_table();
+
+static_assert( MARKER_HASH_TABLE.seed_ != 0,
+               "No perfect hash seed for the marker names." );
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief get the marker id from the name bytes
+  \param type the first character of the marker name
+  \param rest the marker name after the first word
+  \param len length of rest
+  \return marker id. Marker_Unknown if the name is not a marker name.
+*/
+inline
+MarkerID
+find_marker_id( const char type,
+                const char * rest,
+                const std::size_t len )
+{
+    const int id = MARKER_HASH_TABLE.ids_[marker_hash( MARKER_HASH_TABLE.seed_, type, rest, len )];
+    if ( id == Marker_Unknown )
+    {
+        return Marker_Unknown;
+    }
+
+    const char * name = MARKER_NAMES[id];
+    if ( name[0] != type
+         || std::strncmp( name + 1, rest, len ) != 0
+         || name[len + 1] != '\0' )
+    {
+        return Marker_Unknown;
+    }
+
+    return static_cast< MarkerID >( id );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief get the head of the remaining message for the error message
+  \param cursor cursor on the message
+  \return at most 16 characters from the current position
+*/
+std::string
+error_string( const SExpCursor & cursor )
+{
+    return std::string( cursor.pos(),
+                        std::min< std::ptrdiff_t >( 16, cursor.end() - cursor.pos() ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief sort the seen objects by distance without any memory allocation.
+  The order of the objects with the same distance is kept.
+  \param objects container of the seen objects
+*/
+template < typename Cont >
+void
+sort_by_dist( Cont & objects )
+{
+    const std::size_t size = objects.size();
+    for ( std::size_t i = 1; i < size; ++i )
+    {
+        if ( ! ( objects[i].dist_ < objects[i - 1].dist_ ) )
+        {
+            continue;
+        }
+
+        typename Cont::value_type tmp = objects[i];
+        std::size_t j = i;
+        while ( j > 0
+                && tmp.dist_ < objects[j - 1].dist_ )
+        {
+            objects[j] = objects[j - 1];
+            --j;
+        }
+        objects[j] = tmp;
+    }
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+
 const double VisualSensor::DIST_ERR = std::numeric_limits< double >::max();
 const double VisualSensor::DIR_ERR = -360;
 
@@ -169,138 +369,17 @@ VisualSensor::VisualSensor()
     : M_time( -1, 0 ),
       M_their_team_name( "" )
 {
-    using namespace rcsc;
-    typedef std::pair< std::string, MarkerID > MarkerPair;
-
-    M_marker_map.insert( MarkerPair( "g l", Goal_L ) );
-    M_marker_map.insert( MarkerPair( "g r", Goal_R ) );
-
-    M_marker_map.insert( MarkerPair( "f c", Flag_C ) );
-    M_marker_map.insert( MarkerPair( "f c t", Flag_CT ) );
-    M_marker_map.insert( MarkerPair( "f c b", Flag_CB ) );
-    M_marker_map.insert( MarkerPair( "f l t", Flag_LT ) );
-    M_marker_map.insert( MarkerPair( "f l b", Flag_LB ) );
-    M_marker_map.insert( MarkerPair( "f r t", Flag_RT ) );
-    M_marker_map.insert( MarkerPair( "f r b", Flag_RB ) );
-
-    M_marker_map.insert( MarkerPair( "f p l t", Flag_PLT ) );
-    M_marker_map.insert( MarkerPair( "f p l c", Flag_PLC ) );
-    M_marker_map.insert( MarkerPair( "f p l b", Flag_PLB ) );
-    M_marker_map.insert( MarkerPair( "f p r t", Flag_PRT ) );
-    M_marker_map.insert( MarkerPair( "f p r c", Flag_PRC ) );
-    M_marker_map.insert( MarkerPair( "f p r b", Flag_PRB ) );
-
-    M_marker_map.insert( MarkerPair( "f g l t", Flag_GLT ) );
-    M_marker_map.insert( MarkerPair( "f g l b", Flag_GLB ) );
-    M_marker_map.insert( MarkerPair( "f g r t", Flag_GRT ) );
-    M_marker_map.insert( MarkerPair( "f g r b", Flag_GRB ) );
-
-    M_marker_map.insert( MarkerPair( "f t l 50", Flag_TL50 ) );
-    M_marker_map.insert( MarkerPair( "f t l 40", Flag_TL40 ) );
-    M_marker_map.insert( MarkerPair( "f t l 30", Flag_TL30 ) );
-    M_marker_map.insert( MarkerPair( "f t l 20", Flag_TL20 ) );
-    M_marker_map.insert( MarkerPair( "f t l 10", Flag_TL10 ) );
-    M_marker_map.insert( MarkerPair( "f t 0", Flag_T0 ) );
-    M_marker_map.insert( MarkerPair( "f t r 10", Flag_TR10 ) );
-    M_marker_map.insert( MarkerPair( "f t r 20", Flag_TR20 ) );
-    M_marker_map.insert( MarkerPair( "f t r 30", Flag_TR30 ) );
-    M_marker_map.insert( MarkerPair( "f t r 40", Flag_TR40 ) );
-    M_marker_map.insert( MarkerPair( "f t r 50", Flag_TR50 ) );
-
-    M_marker_map.insert( MarkerPair( "f b l 50", Flag_BL50 ) );
-    M_marker_map.insert( MarkerPair( "f b l 40", Flag_BL40 ) );
-    M_marker_map.insert( MarkerPair( "f b l 30", Flag_BL30 ) );
-    M_marker_map.insert( MarkerPair( "f b l 20", Flag_BL20 ) );
-    M_marker_map.insert( MarkerPair( "f b l 10", Flag_BL10 ) );
-    M_marker_map.insert( MarkerPair( "f b 0", Flag_B0 ) );
-    M_marker_map.insert( MarkerPair( "f b r 10", Flag_BR10 ) );
-    M_marker_map.insert( MarkerPair( "f b r 20", Flag_BR20 ) );
-    M_marker_map.insert( MarkerPair( "f b r 30", Flag_BR30 ) );
-    M_marker_map.insert( MarkerPair( "f b r 40", Flag_BR40 ) );
-    M_marker_map.insert( MarkerPair( "f b r 50", Flag_BR50 ) );
-
-    M_marker_map.insert( MarkerPair( "f l t 30", Flag_LT30 ) );
-    M_marker_map.insert( MarkerPair( "f l t 20", Flag_LT20 ) );
-    M_marker_map.insert( MarkerPair( "f l t 10", Flag_LT10 ) );
-    M_marker_map.insert( MarkerPair( "f l 0", Flag_L0 ) );
-    M_marker_map.insert( MarkerPair( "f l b 10", Flag_LB10 ) );
-    M_marker_map.insert( MarkerPair( "f l b 20", Flag_LB20 ) );
-    M_marker_map.insert( MarkerPair( "f l b 30", Flag_LB30 ) );
-
-    M_marker_map.insert( MarkerPair( "f r t 30", Flag_RT30 ) );
-    M_marker_map.insert( MarkerPair( "f r t 20", Flag_RT20 ) );
-    M_marker_map.insert( MarkerPair( "f r t 10", Flag_RT10 ) );
-    M_marker_map.insert( MarkerPair( "f r 0", Flag_R0 ) );
-    M_marker_map.insert( MarkerPair( "f r b 10", Flag_RB10 ) );
-    M_marker_map.insert( MarkerPair( "f r b 20", Flag_RB20 ) );
-    M_marker_map.insert( MarkerPair( "f r b 30", Flag_RB30 ) );
-
-    ///////////////////////////////////////////////////////////////////////
-    ///////////////////////////////////////////////////////////////////////
-    ///////////////////////////////////////////////////////////////////////
-
-    M_marker_map_old.insert( MarkerPair( "goal l", Goal_L ) );
-    M_marker_map_old.insert( MarkerPair( "goal r", Goal_R ) );
-
-    M_marker_map_old.insert( MarkerPair( "flag c", Flag_C ) );
-    M_marker_map_old.insert( MarkerPair( "flag c t", Flag_CT ) );
-    M_marker_map_old.insert( MarkerPair( "flag c b", Flag_CB ) );
-    M_marker_map_old.insert( MarkerPair( "flag l t", Flag_LT ) );
-    M_marker_map_old.insert( MarkerPair( "flag l b", Flag_LB ) );
-    M_marker_map_old.insert( MarkerPair( "flag r t", Flag_RT ) );
-    M_marker_map_old.insert( MarkerPair( "flag r b", Flag_RB ) );
-
-    M_marker_map_old.insert( MarkerPair( "flag p l t", Flag_PLT ) );
-    M_marker_map_old.insert( MarkerPair( "flag p l c", Flag_PLC ) );
-    M_marker_map_old.insert( MarkerPair( "flag p l b", Flag_PLB ) );
-    M_marker_map_old.insert( MarkerPair( "flag p r t", Flag_PRT ) );
-    M_marker_map_old.insert( MarkerPair( "flag p r c", Flag_PRC ) );
-    M_marker_map_old.insert( MarkerPair( "flag p r b", Flag_PRB ) );
-
-    M_marker_map_old.insert( MarkerPair( "flag g l t", Flag_GLT ) );
-    M_marker_map_old.insert( MarkerPair( "flag g l b", Flag_GLB ) );
-    M_marker_map_old.insert( MarkerPair( "flag g r t", Flag_GRT ) );
-    M_marker_map_old.insert( MarkerPair( "flag g r b", Flag_GRB ) );
-
-    M_marker_map_old.insert( MarkerPair( "flag t l 50", Flag_TL50 ) );
-    M_marker_map_old.insert( MarkerPair( "flag t l 40", Flag_TL40 ) );
-    M_marker_map_old.insert( MarkerPair( "flag t l 30", Flag_TL30 ) );
-    M_marker_map_old.insert( MarkerPair( "flag t l 20", Flag_TL20 ) );
-    M_marker_map_old.insert( MarkerPair( "flag t l 10", Flag_TL10 ) );
-    M_marker_map_old.insert( MarkerPair( "flag t 0", Flag_T0 ) );
-    M_marker_map_old.insert( MarkerPair( "flag t r 10", Flag_TR10 ) );
-    M_marker_map_old.insert( MarkerPair( "flag t r 20", Flag_TR20 ) );
-    M_marker_map_old.insert( MarkerPair( "flag t r 30", Flag_TR30 ) );
-    M_marker_map_old.insert( MarkerPair( "flag t r 40", Flag_TR40 ) );
-    M_marker_map_old.insert( MarkerPair( "flag t r 50", Flag_TR50 ) );
-
-    M_marker_map_old.insert( MarkerPair( "flag b l 50", Flag_BL50 ) );
-    M_marker_map_old.insert( MarkerPair( "flag b l 40", Flag_BL40 ) );
-    M_marker_map_old.insert( MarkerPair( "flag b l 30", Flag_BL30 ) );
-    M_marker_map_old.insert( MarkerPair( "flag b l 20", Flag_BL20 ) );
-    M_marker_map_old.insert( MarkerPair( "flag b l 10", Flag_BL10 ) );
-    M_marker_map_old.insert( MarkerPair( "flag b 0", Flag_B0 ) );
-    M_marker_map_old.insert( MarkerPair( "flag b r 10", Flag_BR10 ) );
-    M_marker_map_old.insert( MarkerPair( "flag b r 20", Flag_BR20 ) );
-    M_marker_map_old.insert( MarkerPair( "flag b r 30", Flag_BR30 ) );
-    M_marker_map_old.insert( MarkerPair( "flag b r 40", Flag_BR40 ) );
-    M_marker_map_old.insert( MarkerPair( "flag b r 50", Flag_BR50 ) );
-
-    M_marker_map_old.insert( MarkerPair( "flag l t 30", Flag_LT30 ) );
-    M_marker_map_old.insert( MarkerPair( "flag l t 20", Flag_LT20 ) );
-    M_marker_map_old.insert( MarkerPair( "flag l t 10", Flag_LT10 ) );
-    M_marker_map_old.insert( MarkerPair( "flag l 0", Flag_L0 ) );
-    M_marker_map_old.insert( MarkerPair( "flag l b 10", Flag_LB10 ) );
-    M_marker_map_old.insert( MarkerPair( "flag l b 20", Flag_LB20 ) );
-    M_marker_map_old.insert( MarkerPair( "flag l b 30", Flag_LB30 ) );
-
-    M_marker_map_old.insert( MarkerPair( "flag r t 30", Flag_RT30 ) );
-    M_marker_map_old.insert( MarkerPair( "flag r t 20", Flag_RT20 ) );
-    M_marker_map_old.insert( MarkerPair( "flag r t 10", Flag_RT10 ) );
-    M_marker_map_old.insert( MarkerPair( "flag r 0", Flag_R0 ) );
-    M_marker_map_old.insert( MarkerPair( "flag r b 10", Flag_RB10 ) );
-    M_marker_map_old.insert( MarkerPair( "flag r b 20", Flag_RB20 ) );
-    M_marker_map_old.insert( MarkerPair( "flag r b 30", Flag_RB30 ) );
+    M_balls.reserve( 1 );
+
+    M_markers.reserve( MARKER_CAPACITY );
+    M_behind_markers.reserve( MARKER_CAPACITY );
+    M_lines.reserve( LINE_CAPACITY );
+
+    M_teammates.reserve( PLAYER_CAPACITY );
+    M_unknown_teammates.reserve( PLAYER_CAPACITY );
+    M_opponents.reserve( PLAYER_CAPACITY );
+    M_unknown_opponents.reserve( PLAYER_CAPACITY );
+    M_unknown_players.reserve( PLAYER_CAPACITY );
 }
 
 /*-------------------------------------------------------------------*/
@@ -323,6 +402,8 @@ VisualSensor::parse( const char * msg,
     // clear old data
     clearAll();
 
+    const char * const msg_end = msg + std::strlen( msg );
+
     ObjectType object_type;
 
     MarkerT seen_marker;
@@ -362,7 +443,7 @@ VisualSensor::parse( const char * msg,
              || object_type == Obj_Goal )
         {
             seen_marker.object_type_ = object_type;
-            if ( parseMarker( msg, version, &seen_marker ) )
+            if ( parseMarker( SExpCursor( msg, msg_end ), version, &seen_marker ) )
             {
                 M_markers.push_back( seen_marker );
             }
@@ -373,7 +454,7 @@ VisualSensor::parse( const char * msg,
                   || object_type == Obj_Goal_Behind )
         {
             seen_marker.object_type_ = object_type;
-            if ( parseMarker( msg, version, &seen_marker ) )
+            if ( parseMarker( SExpCursor( msg, msg_end ), version, &seen_marker ) )
             {
                 M_behind_markers.push_back( seen_marker );
             }
@@ -382,7 +463,7 @@ VisualSensor::parse( const char * msg,
         // player
         else if ( object_type == Obj_Player )
         {
-            switch ( parsePlayer( msg, team_name, &seen_player ) ) {
+            switch ( parsePlayer( SExpCursor( msg, msg_end ), team_name, &seen_player ) ) {
             case Player_Teammate:
                 M_teammates.push_back( seen_player );
                 break;
@@ -410,7 +491,7 @@ VisualSensor::parse( const char * msg,
         // line
         else if ( object_type == Obj_Line )
         {
-            if ( parseLine( msg, version, &seen_line ) )
+            if ( parseLine( SExpCursor( msg, msg_end ), version, &seen_line ) )
             {
                 M_lines.push_back( seen_line );
             }
@@ -419,7 +500,7 @@ VisualSensor::parse( const char * msg,
         // ball
         else if ( object_type == Obj_Ball )
         {
-            if ( parseBall( msg, &seen_ball ) )
+            if ( parseBall( SExpCursor( msg, msg_end ), &seen_ball ) )
             {
                 M_balls.push_back( seen_ball );
             }
@@ -438,17 +519,17 @@ VisualSensor::parse( const char * msg,
 
 
     // sort by distance
-    M_teammates.sort( SeenDistCmp() );
-    M_unknown_teammates.sort( SeenDistCmp() );
-    M_opponents.sort( SeenDistCmp() );
-    M_unknown_opponents.sort( SeenDistCmp() );
-    M_unknown_players.sort( SeenDistCmp() );
+    sort_by_dist( M_teammates );
+    sort_by_dist( M_unknown_teammates );
+    sort_by_dist( M_opponents );
+    sort_by_dist( M_unknown_opponents );
+    sort_by_dist( M_unknown_players );
 
-    M_markers.sort( SeenDistCmp() );
-    M_behind_markers.sort( SeenDistCmp() );
+    sort_by_dist( M_markers );
+    sort_by_dist( M_behind_markers );
 
     // line sort is very important !!
-    M_lines.sort( SeenDistCmp() );
+    sort_by_dist( M_lines );
 
 #if 0
     dlog.addText( Logger::SENSOR,
@@ -477,10 +558,12 @@ VisualSensor::parse( const char * msg,
 
 */
 bool
-VisualSensor::parseMarker( const char * tok,
+VisualSensor::parseMarker( SExpCursor cursor,
                            const double version,
                            MarkerT * info )
 {
+    const char * tok = cursor.pos();
+
     // get marker id
     if ( info->object_type_ == Obj_Marker_Behind
          || info->object_type_ == Obj_Goal_Behind )
@@ -492,32 +575,22 @@ VisualSensor::parseMarker( const char * tok,
         // skip to first of object name
         while ( *tok == '(' ) ++tok; // skip to first identifier
 
-        // get marker name
-        int i = 0;
-        std::string marker_name;
-        while ( *( tok + i ) != ')' )
-        {
-            marker_name += *( tok + i );
-            ++i;
-        }
+        // get the first word and the rest of marker name
+        const char * word_end = tok;
+        while ( *word_end != ' ' && *word_end != ')' && *word_end != '\0' ) ++word_end;
+        const char * name_end = word_end;
+        while ( *name_end != ')' && *name_end != '\0' ) ++name_end;
 
         // search marker id
+        // "f ..." and "g ..." since version 6, "flag ..." and "goal ..." in old versions
         info->id_ = Marker_Unknown;
-        if ( version >= 6.0 )
-        {
-            MarkerMap::const_iterator it = M_marker_map.find( marker_name );
-            if ( it != M_marker_map.end() )
-            {
-                info->id_ = it->second;
-            }
-        }
-        else
+        if ( version >= 6.0
+             ? word_end - tok == 1
+             : ( word_end - tok == 4
+                 && ( std::strncmp( tok, "flag", 4 ) == 0
+                      || std::strncmp( tok, "goal", 4 ) == 0 ) ) )
         {
-            MarkerMap::const_iterator it = M_marker_map_old.find( marker_name );
-            if ( it != M_marker_map_old.end() )
-            {
-                info->id_ = it->second;
-            }
+            info->id_ = find_marker_id( *tok, word_end, name_end - word_end );
         }
 
         if ( info->id_ == Marker_Unknown )
@@ -530,37 +603,31 @@ VisualSensor::parseMarker( const char * tok,
     }
 
     // skip object name
-    while ( *tok != ')' ) ++tok; // skip all object name
-    tok += 2; // skip paren & space
-
-    char *next;
+    cursor.skipTo( ')' ); // skip all object name
+    cursor.consume( ')' );
 
     // read dist
-    info->dist_ = std::strtod( tok, &next );
-    if ( info->dist_ == -HUGE_VAL
-         || info->dist_ == HUGE_VAL )
+    if ( ! cursor.readDouble( info->dist_ ) )
     {
         std::cerr << "VisualSensor::parseMarker. distance read error.["
-                  << std::string( tok, 16 ) << "]"
+                  << error_string( cursor ) << "]"
                   << std::endl;
         return false;
     }
-    tok = next;
 
     // check view quality
-    if ( *tok == ')' )
+    cursor.skipSpace();
+    if ( cursor.peek() == ')' )
     {
         //std::cerr << "VisualSensor:: parseMarker: view quality is LOW ??\n";
         return false;
     }
 
     // read dir
-    info->dir_ = std::strtod( tok, NULL );
-    if ( info->dir_ == -HUGE_VAL
-         || info->dir_ == HUGE_VAL )
+    if ( ! cursor.readDouble( info->dir_ ) )
     {
         std::cerr << "VisualSensor::parseMarker: dir read error.["
-                  << std::string( tok, 16 ) << "]"
+                  << error_string( cursor ) << "]"
                   << std::endl;
         return false;
     }
@@ -574,65 +641,17 @@ VisualSensor::parseMarker( const char * tok,
 
 */
 bool
-VisualSensor::parseLine( const char * tok,
+VisualSensor::parseLine( SExpCursor cursor,
                          const double & version,
                          LineT * info )
 {
-#if 0
     // ((l <side>) <dist> <dir>))
     // ((L <side>) <dist> <dir>))
     // ((line <side>) <dist> <dir>))
     // ((Line <side>) <dist> <dir>))
 
-    char id[8];
-    char side;
-    int n_read = 0;
-    if ( std::sscanf( tok, " ( ( %[^ ] %c ) %lf %lf ) %n",
-                      id, &side,
-                      &(info->dist_),
-                      &(info->dir_),
-                      &n_read  ) == 4 )
-    {
-        // high quality line
-    }
-    else if ( std::sscanf( tok, " ( ( %[^ ] %c) %lf ) %n",
-                           id, &side,
-                           &(info->dir_),
-                           &n_read ) == 3 )
-    {
-        // low quality line
-    }
-    else
-    {
-        std::cerr << "Unsupported line message "
-                  << std::string( tok, 16 ) << std::endl;
-        info->id_ = Line_Unknown;
-        return false;
-    }
-
-    switch ( side ) {
-    case 'l':
-        info->id_ = Line_Left;
-        break;
-    case 'r':
-        info->id_ = Line_Right;
-        break;
-    case 't':
-        info->id_ = Line_Top;
-        break;
-    case 'b':
-        info->id_ = Line_Bottom;
-        break;
-    default:
-        std::cerr << "Unknown line type [" << *( tok + 2 ) << "]"
-                  << std::endl;
-        info->id_ = Line_Unknown;
-        return false;
-    }
-
-    return true;
+    const char * tok = cursor.pos();
 
-#else
     // skip to first of object name
     while ( *tok == '(' ) ++tok;
 
@@ -660,43 +679,36 @@ VisualSensor::parseLine( const char * tok,
     }
 
     // skip object name
-    while ( *tok != ')' ) ++tok; // skip all object name
-    tok += 2; // skip paren & space
-
-    char *next;
+    cursor.skipTo( ')' ); // skip all object name
+    cursor.consume( ')' );
 
     // read dist
-    info->dist_ = std::strtod( tok, &next );
-    if ( info->dist_ == -HUGE_VAL
-         || info->dist_ == HUGE_VAL )
+    if ( ! cursor.readDouble( info->dist_ ) )
     {
         std::cerr << "VisualSensor:: parseLine: distance read error.["
-                  << std::string( tok, 16 ) << "]"
+                  << error_string( cursor ) << "]"
                   << std::endl;
         return false;
     }
-    tok = next;
 
     // check view quality
-    if ( *tok == ')' )
+    cursor.skipSpace();
+    if ( cursor.peek() == ')' )
     {
         //std::cerr << "VisualSensor:: parseLine: view quality is LOW ??\n";
         return false;
     }
 
     // read dir
-    info->dir_ = std::strtod( tok, NULL );
-    if ( info->dir_ == -HUGE_VAL
-         || info->dir_== HUGE_VAL )
+    if ( ! cursor.readDouble( info->dir_ ) )
     {
         std::cerr << "VisualSensor::parseLine: dirread error.["
-                  << std::string( tok, 16 ) << "]"
+                  << error_string( cursor ) << "]"
                   << std::endl;;
         return false;
     }
 
     return true;
-#endif
 }
 
 /*-------------------------------------------------------------------*/
@@ -704,66 +716,55 @@ VisualSensor::parseLine( const char * tok,
 
 */
 bool
-VisualSensor::parseBall( const char * tok,
+VisualSensor::parseBall( SExpCursor cursor,
                          BallT * info )
 {
     // skip all object name
-    while ( *tok != ')' ) ++tok;
-    tok += 2; // skip space & paren
-
-    char *next;
+    cursor.skipTo( ')' );
+    cursor.consume( ')' );
 
     // read dist
-    info->dist_ = std::strtod( tok, &next );
-    if ( info->dist_ == -HUGE_VAL
-         || info->dist_ == HUGE_VAL )
+    if ( ! cursor.readDouble( info->dist_ ) )
     {
         std::cerr << "VisualSensor::parseBall: distance read error.["
-                  << std::string( tok, 16 ) << "]"
+                  << error_string( cursor ) << "]"
                   << std::endl;
         return false;
     }
-    tok = next;
 
     // check view quality
-    if ( *tok == ')' )
+    cursor.skipSpace();
+    if ( cursor.peek() == ')' )
     {
         //std::cerr << "VisualSensor:: parseBall: view quality is LOW ??\n";
         return false;
     }
 
     // read dir
-    info->dir_ = std::strtod( tok, &next );
-    if ( info->dir_ == -HUGE_VAL
-         || info->dir_ == HUGE_VAL )
+    if ( ! cursor.readDouble( info->dir_ ) )
     {
         std::cerr << "VisualSensor::parseBall: dir read error. ["
-                  << std::string( tok, 16 ) << "]"
+                  << error_string( cursor ) << "]"
                   << std::endl;
         return false;
     }
-    tok = next;
 
     // read velocity info. order is dist_chg -> dir_chg
-    if ( *tok != ')' )
+    cursor.skipSpace();
+    if ( cursor.peek() != ')' )
     {
-        info->dist_chng_ = std::strtod( tok, &next );
-        tok = next;
-        info->dir_chng_ = std::strtod( tok, NULL );
-        info->has_vel_ = true;
-        if ( info->dist_chng_ == -HUGE_VAL
-             || info->dist_chng_ == HUGE_VAL
-             || info->dir_chng_ == -HUGE_VAL
-             || info->dir_chng_ == HUGE_VAL )
+        if ( ! cursor.readDouble( info->dist_chng_ )
+             || ! cursor.readDouble( info->dir_chng_ ) )
         {
             std::cerr << "VisualSensor:: parseBall. chng read error.["
-                      << std::string( tok, 16 ) << "]"
+                      << error_string( cursor ) << "]"
                       << std::endl;
             info->dist_chng_ = 0.0;
             info->dir_chng_ = 0.0;
             info->has_vel_ = false;
             return false;
         }
+        info->has_vel_ = true;
     }
 
     return true;
@@ -774,12 +775,14 @@ VisualSensor::parseBall( const char * tok,
 
 */
 VisualSensor::PlayerInfoType
-VisualSensor::parsePlayer( const char * tok,
+VisualSensor::parsePlayer( SExpCursor cursor,
                            const std::string & team_name,
                            PlayerT * info )
 {
     PlayerInfoType result_type = Player_Illegal;
 
+    const char * tok = cursor.pos();
+
     // skip to first of object name
     while ( *tok == '(' ) ++tok;
 
@@ -827,7 +830,11 @@ VisualSensor::parsePlayer( const char * tok,
     if ( n_space > 1 )
     {
         while ( *tok != ' ' ) ++tok;
-        info->unum_ = std::atoi( tok );
+        SExpCursor unum_cursor( tok, cursor.end() );
+        if ( ! unum_cursor.readInt( info->unum_ ) )
+        {
+            info->unum_ = 0;
+        }
         // we can get all player identifier
         result_type = ( result_type == Player_Unknown_Teammate
                         ? Player_Teammate
@@ -870,176 +877,110 @@ VisualSensor::parsePlayer( const char * tok,
         if ( *( tok + i ) == ' ' ) ++n_space;
     }
 
-    char *next;
+    if ( n_space < 2
+         || 8 < n_space )
+    {
+        //std::cerr << "ViewQuality is Low ?? Unexpected player see info pattern\n   ["
+        //          << tok << "]" << std::endl;
+        return Player_Low_Mode;
+    }
 
-    // read each value on each pattern
+    SExpCursor values( tok, cursor.end() );
 
-    // <DIST> <DIR> <DISTCH> <DIRCH> <BODY> <HEAD> <POINTDIR> <TACKLE>
-    if ( n_space == 8 )
+    // all patterns start with <DIST> <DIR>
+    if ( ! values.readDouble( info->dist_ )
+         || ! values.readDouble( info->dir_ )
+         || info->dist_ < 0.0 )
     {
-        info->dist_ = std::strtod( tok, &next ); tok = next;
-        info->dir_  = std::strtod( tok, &next ); tok = next;
-        info->dist_chng_ = std::strtod( tok, &next ); tok = next;
-        info->dir_chng_  = std::strtod( tok, &next ); tok = next;
-        info->body_ = std::strtod( tok, &next ); tok = next;
-        info->face_ = std::strtod( tok, &next ); tok = next;
-        info->arm_ = std::strtod( tok, &next ); tok = next;
-        info->has_vel_ = true;
-        if ( *(tok + 1) == 'k' ) info->kicking_ = true;
-        if ( *(tok + 1) == 't' ) info->tackle_ = true;
+        std::cerr << "VisualSensor::parsePlayer. polar value error."
+                  << " dist=" << info->dist_ << " dir=" << info->dir_
+                  << std::endl;
+        return Player_Illegal;
     }
+
+    // read each value on each pattern
+    // if the value cannot be read, the error value set by reset() is kept.
+
+    // <DIST> <DIR> <DISTCH> <DIRCH> <BODY> <HEAD> <POINTDIR> <TACKLE>
     // <DIST> <DIR> <DISTCH> <DIRCH> <BODY> <HEAD> <POINTDIR>
     // <DIST> <DIR> <DISTCH> <DIRCH> <BODY> <HEAD> <TACKLE>
-    else if ( n_space == 7 )
+    // <DIST> <DIR> <DISTCH> <DIRCH> <BODY> <HEAD>
+    // <DIST> <DIR> <DISTCH> <DIRCH> <BODY>
+    if ( n_space >= 5 )
     {
-        info->dist_ = std::strtod( tok, &next ); tok = next;
-        info->dir_  = std::strtod( tok, &next ); tok = next;
-        info->dist_chng_ = std::strtod( tok, &next ); tok = next;
-        info->dir_chng_  = std::strtod( tok, &next ); tok = next;
-        info->body_ = std::strtod( tok, &next ); tok = next;
-        info->face_ = std::strtod( tok, &next ); tok = next;
-        info->has_vel_ = true;
-        if ( *(tok + 1) == 'k' )
+        if ( values.readDouble( info->dist_chng_ )
+             && values.readDouble( info->dir_chng_ ) )
         {
-            info->kicking_ = true;
+            info->has_vel_ = true;
         }
-        else if ( *(tok + 1) == 't' )
+        else
         {
-            info->tackle_ = true;
+            std::cerr << "VisualSensor::parsePlayer. chng value error"
+                      << std::endl;
+            info->dist_chng_
+                = info->dir_chng_
+                = 0.0;
         }
-        else
+
+        if ( ! values.readDouble( info->body_ ) )
         {
-            info->arm_ = std::strtod( tok, NULL );
+            std::cerr << "VisualSensor::parsePlayer. body value error"
+                      << std::endl;
         }
-    }
-    // <DIST> <DIR> <DISTCH> <DIRCH> <BODY> <HEAD>
-    else if ( n_space == 6 )
-    {
-        info->dist_ = std::strtod( tok, &next ); tok = next;
-        info->dir_  = std::strtod( tok, &next ); tok = next;
-        info->dist_chng_ = std::strtod( tok, &next ); tok = next;
-        info->dir_chng_  = std::strtod( tok, &next ); tok = next;
-        info->body_ = std::strtod( tok, &next ); tok = next;
-        info->face_ = std::strtod( tok, NULL );
-        info->has_vel_ = true;
-    }
-    // <DIST> <DIR> <DISTCH> <DIRCH> <BODY>
-    else if ( n_space == 5 )
-    {
-        info->dist_ = std::strtod( tok, &next ); tok = next;
-        info->dir_  = std::strtod( tok, &next ); tok = next;
-        info->dist_chng_ = std::strtod( tok, &next ); tok = next;
-        info->dir_chng_  = std::strtod( tok, &next ); tok = next;
-        info->body_ = std::strtod( tok, NULL );
-        info->face_ = 0.0;
-        info->has_vel_ = true;
-    }
-    // <DIST> <DIR> <DISTCH> <DIRCH>
-    // <DIST> <DIR> <POINTDIR> <TACKLE>
-    else if ( n_space == 4 )
-    {
-        info->dist_ = std::strtod( tok, &next ); tok = next;
-        info->dir_  = std::strtod( tok, &next ); tok = next;
-        double tmp = std::strtod( tok, &next ); tok = next;
-        if ( *(tok + 1) == 'k' )
+
+        if ( n_space == 5 )
         {
-            info->arm_ = tmp;
-            info->kicking_ = true;
+            info->face_ = 0.0;
         }
-        else if ( *(tok + 1) == 't' )
+        else if ( ! values.readDouble( info->face_ ) )
         {
-            info->arm_ = tmp;
-            info->tackle_ = true;
+            std::cerr << "VisualSensor::parsePlayer. neck value error"
+                      << std::endl;
         }
-        else
+
+        if ( n_space == 8 )
         {
-            info->dist_chng_ = tmp;
-            info->dir_chng_ = std::strtod( tok, NULL );
+            values.readDouble( info->arm_ );
         }
     }
-    // <DIST> <DIR> <POINTDIR>
-    // <DIST> <DIR> <TACKLE>
-    else if ( n_space == 3 )
+    // <DIST> <DIR> <DISTCH> <DIRCH>
+    // <DIST> <DIR> <POINTDIR> <TACKLE>
+    else if ( n_space == 4 )
     {
-        info->dist_ = std::strtod( tok, &next ); tok = next;
-        info->dir_  = std::strtod( tok, &next ); tok = next;
-        if ( *(tok + 1) == 'k' )
-        {
-            info->kicking_ = true;
-        }
-        else if ( *(tok + 1) == 't' )
+        double tmp = 0.0;
+        values.readDouble( tmp );
+        values.skipSpace();
+        if ( values.peek() == 'k'
+             || values.peek() == 't' )
         {
-            info->tackle_ = true;
+            info->arm_ = tmp;
         }
         else
         {
-            info->arm_ = std::strtod( tok, NULL );
+            info->dist_chng_ = tmp;
+            values.readDouble( info->dir_chng_ );
         }
     }
-    // <DIST> <DIR>
-    else if ( n_space == 2 )
-    {
-        info->dist_ = std::strtod( tok, &next ); tok = next;
-        info->dir_  = std::strtod( tok, NULL );
-    }
-    else
-    {
-        //std::cerr << "ViewQuality is Low ?? Unexpected player see info pattern\n   ["
-        //          << tok << "]" << std::endl;
-        return Player_Low_Mode;
-    }
 
-    // check error
-    if ( info->dist_ < 0.0
-         || info->dist_ == -HUGE_VAL
-         || info->dist_ == HUGE_VAL
-         || info->dir_ == -HUGE_VAL
-         || info->dir_ == HUGE_VAL )
+    // <POINTDIR> or <TACKLE|KICK> at the last
+    if ( n_space == 3
+         || n_space == 7
+         || n_space == 8 )
     {
-        std::cerr << "VisualSensor::parsePlayer. polar value error."
-                  << " dist=" << info->dist_ << " dir=" << info->dir_
-                  << std::endl;
-        return Player_Illegal;
-    }
-
-    if ( info->has_vel_
-         && ( info->dist_chng_ == -HUGE_VAL
-              || info->dist_chng_ == HUGE_VAL
-              || info->dir_chng_ == -HUGE_VAL
-              || info->dir_chng_ == HUGE_VAL )
-         )
-    {
-        std::cerr << "VisualSensor::parsePlayer. chng value error"
-                  << std::endl;
-        info->dist_chng_
-            = info->dir_chng_
-            = 0.0;
-        info->has_vel_ = false;
-    }
-
-    if ( info->body_ == -HUGE_VAL
-         || info->body_ == HUGE_VAL )
-    {
-        std::cerr << "VisualSensor::parsePlayer. body value error"
-                  << std::endl;
-        info->body_ = DIR_ERR;
-    }
-
-    if ( info->face_ == -HUGE_VAL
-         || info->face_ == HUGE_VAL )
-    {
-        std::cerr << "VisualSensor::parsePlayer. neck value error"
-                  << std::endl;
-        info->face_ = DIR_ERR;
+        values.skipSpace();
+        if ( n_space != 8
+             && values.peek() != 'k'
+             && values.peek() != 't'
+             && ! values.readDouble( info->arm_ ) )
+        {
+            std::cerr << "VisualSensor::parsePlayer. point value error"
+                      << std::endl;
+        }
     }
 
-    if ( info->arm_ == -HUGE_VAL
-         || info->arm_ == HUGE_VAL )
-    {
-        std::cerr << "VisualSensor::parsePlayer. point value error"
-                  << std::endl;
-        info->arm_ = DIR_ERR;
-    }
+    values.skipSpace();
+    if ( values.peek() == 'k' ) info->kicking_ = true;
+    if ( values.peek() == 't' ) info->tackle_ = true;
 
     return result_type;
 }
@@ -35,14 +35,15 @@
 #include <rcsc/game_time.h>
 #include <rcsc/types.h>
 
-#include <unordered_map>
-#include <list>
 #include <vector>
 #include <string>
 #include <iostream>
+#include <cstddef>
 
 namespace rcsc {
 
+class SExpCursor;
+
 /*!
   \class VisualSensor
   \brief player's parsed visual info holder
@@ -251,12 +252,17 @@ public:
           }
     };
 
-    typedef std::unordered_map< std::string, MarkerID > MarkerMap;
-
     typedef std::vector< BallT > BallCont; //!< observed ball container
-    typedef std::list< MarkerT > MarkerCont; //!< observed marker container
-    typedef std::list< LineT > LineCont; //!< observed line container
-    typedef std::list< PlayerT > PlayerCont; //!< observed player container
+    typedef std::vector< MarkerT > MarkerCont; //!< observed marker container
+    typedef std::vector< LineT > LineCont; //!< observed line container
+    typedef std::vector< PlayerT > PlayerCont; //!< observed player container
+
+    //! the reserved capacity of the marker containers. (the number of markers)
+    static const std::size_t MARKER_CAPACITY = Marker_Unknown;
+    //! the reserved capacity of the line container
+    static const std::size_t LINE_CAPACITY = Line_Unknown;
+    //! the reserved capacity of each player container
+    static const std::size_t PLAYER_CAPACITY = 22;
 
 private:
 
@@ -264,11 +270,6 @@ private:
 
     std::string M_their_team_name; //!< seen opponent team name
 
-    //! marker ID map
-    MarkerMap M_marker_map;
-    //! marker ID map, old name
-    MarkerMap M_marker_map_old;
-
     BallCont M_balls; //!< seen ball
     MarkerCont M_markers; //!< seen markers
     MarkerCont M_behind_markers; //!< seen behind markers
@@ -283,7 +284,11 @@ private:
 public:
 
     /*!
-      \brief create marker map
+      \brief reserve the capacity of all containers.
+
+      The containers are cleared, but never released, before each parsing
+      process. Therefore, no memory is allocated in the see message parsing
+      unless the number of seen objects exceeds the reserved capacity.
     */
     VisualSensor();
 
@@ -423,47 +428,47 @@ private:
 
     /*!
       \brief parse marker flag info
-      \param tok pointer to the top of object info
+      \param cursor cursor at the top of object info
       \param version rcssserver protocol version
       \param info pointer to the varialbe to store the data.
 
       get positional data from object info token
     */
-    bool parseMarker( const char * tok,
+    bool parseMarker( SExpCursor cursor,
                       const double version,
                       MarkerT * info );
 
     /*!
       \brief parse line info
-      \param tok pointer to the top of object info
+      \param cursor cursor at the top of object info
       \param version rcssserver protocol version
       \param info pointer to the varialbe to store the data.
 
       get positional data from object info token
     */
-    bool parseLine( const char * tok,
+    bool parseLine( SExpCursor cursor,
                     const double & version,
                     LineT * info );
 
     /*!
       \brief parse line info
-      \param tok pointer to the top of object info
+      \param cursor cursor at the top of object info
       \param info pointer to the varialbe to store the data.
 
       get positional data from object info token
     */
-    bool parseBall( const char * tok,
+    bool parseBall( SExpCursor cursor,
                     BallT * info );
 
     /*!
       \brief parse player info
-      \param tok pointer to the top of object info
+      \param cursor cursor at the top of object info
       \param team_name our team name
       \param info pointer to the varialbe to store the data.
 
       get positional data from object info token
     */
-    PlayerInfoType parsePlayer( const char * tok,
+    PlayerInfoType parsePlayer( SExpCursor cursor,
                                 const std::string & team_name,
                                 PlayerT * info );
 
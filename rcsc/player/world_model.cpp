@@ -43,6 +43,7 @@
 #include "debug_client.h"
 #include "penalty_kick_state.h"
 #include "player_command.h"
+#include "player_matcher.h"
 #include "player_predicate.h"
 
 #include <rcsc/common/audio_memory.h>
@@ -338,6 +339,79 @@ struct PlayerPtrBallDistSorter {
       }
 };
 
+/*-------------------------------------------------------------------*/
+/*!
+  \brief get the matching distance between the seen player and the player in memory
+  \param old_player player in memory
+  \param player localized seen player
+  \param heard_if_same_count if true, the heard position is also used when
+  its accuracy count is same as the seen one.
+  \return distance, or negative value if the player in memory could not
+  move to the seen position.
+*/
+inline
+double
+get_matching_dist( const PlayerObject & old_player,
+                   const Localization::PlayerT & player,
+                   const bool heard_if_same_count )
+{
+    const double dash_noise = 1.0 + ServerParam::i().playerRand();
+    const double self_error = 0.5 * 2.0;
+
+    int count = old_player.seenPosCount();
+    Vector2D old_pos = old_player.seenPos();
+    double heard_error = 0.0;
+    if ( old_player.heardPosCount() < old_player.seenPosCount()
+         || ( heard_if_same_count
+              && old_player.heardPosCount() == old_player.seenPosCount() ) )
+    {
+        count = old_player.heardPosCount();
+        old_pos = old_player.heardPos();
+        heard_error = 2.0;
+    }
+
+    const double d = player.pos_.dist( old_pos );
+
+    // TODO: inertia movement should be considered.
+    if ( d >= 100.0
+         || d > ( old_player.playerTypePtr()->realSpeedMax() * dash_noise * count
+                  + heard_error
+                  + self_error
+                  + player.dist_error_ * 2.0 ) )
+    {
+        return -1.0;
+    }
+
+    return d;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief check if the player is already matched to one of the seen players
+  \param p checked player
+  \param matched matched players
+  \param matched_list list of the matched players. nullptr means not matched.
+  \param size the number of checked seen players
+  \return true if already matched
+*/
+inline
+bool
+is_matched( const PlayerObject * p,
+            const PlayerObject::List::iterator * matched,
+            PlayerObject::List * const * matched_list,
+            const int size )
+{
+    for ( int i = 0; i < size; ++i )
+    {
+        if ( matched_list[i]
+             && &*matched[i] == p )
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
 }
 
 
@@ -371,6 +445,10 @@ WorldModel::WorldModel()
       M_valid( true ),
       M_self(),
       M_ball(),
+      M_player_pool( new PlayerObjectPool() ),
+      M_teammates( *M_player_pool ),
+      M_opponents( *M_player_pool ),
+      M_unknown_players( *M_player_pool ),
       M_our_goalie_unum( Unum_Unknown ),
       M_their_goalie_unum( Unum_Unknown ),
       M_offside_line_x( 0.0 ),
@@ -399,6 +477,15 @@ WorldModel::WorldModel()
 {
     assert( M_penalty_kick_state );
 
+    // the player references are rebuilt every cycle without reallocation.
+    M_teammates_from_self.reserve( PlayerObjectPool::CAPACITY );
+    M_opponents_from_self.reserve( PlayerObjectPool::CAPACITY );
+    M_teammates_from_ball.reserve( PlayerObjectPool::CAPACITY );
+    M_opponents_from_ball.reserve( PlayerObjectPool::CAPACITY );
+    M_all_players.reserve( PlayerObjectPool::CAPACITY + 1 );
+    M_our_players.reserve( PlayerObjectPool::CAPACITY + 1 );
+    M_their_players.reserve( PlayerObjectPool::CAPACITY );
+
     for ( int i = 0; i < 11; ++i )
     {
         M_our_recovery[i] = 1.0;
@@ -478,7 +565,8 @@ WorldModel::init( const std::string & teamname,
         M_their_player_type[i] = Hetero_Default;
     }
 
-    PlayerTypeSet::instance().resetDefaultType();
+    // the default type is reset only when the server_param message is
+    // analyzed for the first time in the process (see PlayerAgent).
     M_self.setPlayerType( Hetero_Default );
 
     return true;
@@ -855,6 +943,7 @@ WorldModel::update( const ActionEffector & act,
     M_all_players.clear();
     M_our_players.clear();
     M_their_players.clear();
+    M_player_grid.clear();
 
     for ( int i = 0; i < 12; ++i )
     {
@@ -1376,8 +1465,14 @@ WorldModel::updateAfterFullstate( const FullstateSensor & fullstate,
         if ( ! player )
         {
             // create new player object
-            M_teammates.push_back( PlayerObject() );
-            player = &(M_teammates.back());
+            reservePlayerSlots( 1 );
+            player = M_teammates.emplace_back();
+            if ( ! player )
+            {
+                dlog.addText( Logger::WORLD,
+                              __FILE__" (updateAfterFullstate) player pool is full." );
+                continue;
+            }
         }
 #ifdef DEBUG_PRINT
         dlog.addText( Logger::WORLD,
@@ -1422,8 +1517,14 @@ WorldModel::updateAfterFullstate( const FullstateSensor & fullstate,
 
         if ( ! player )
         {
-            M_opponents.push_back( PlayerObject() );
-            player = &(M_opponents.back());
+            reservePlayerSlots( 1 );
+            player = M_opponents.emplace_back();
+            if ( ! player )
+            {
+                dlog.addText( Logger::WORLD,
+                              __FILE__" (updateAfterFullstate) player pool is full." );
+                continue;
+            }
         }
 
 #ifdef DEBUG_PRINT
@@ -1757,8 +1858,14 @@ WorldModel::updateGoalieByHear()
                       " add new goalie. heard_pos=(%.1f %.1f)",
                       heard_pos.x, heard_pos.y );
 #endif
-        M_opponents.push_back( PlayerObject() );
-        goalie = &(M_opponents.back());
+        reservePlayerSlots( 1 );
+        goalie = M_opponents.emplace_back();
+        if ( ! goalie )
+        {
+            dlog.addText( Logger::WORLD,
+                          __FILE__" (updateGoalieByHear) player pool is full." );
+            return;
+        }
         goalie->updateByHear( theirSide(),
                               theirGoalieUnum(),
                               true,
@@ -1925,15 +2032,13 @@ WorldModel::updatePlayerByHear()
                           heard_player.body_,
                           heard_player.stamina_ );
 #endif
-            if ( side == ourSide() )
+            reservePlayerSlots( 1 );
+            target_player = players.emplace_back();
+            if ( ! target_player )
             {
-                M_teammates.push_back( PlayerObject() );
-                target_player = &( M_teammates.back() );
-            }
-            else
-            {
-                M_opponents.push_back( PlayerObject() );
-                target_player = &( M_opponents.back() );
+                dlog.addText( Logger::WORLD,
+                              __FILE__" (updatePlayerByHear) player pool is full." );
+                continue;
             }
 
             target_player->updateByHear( side,
@@ -2767,9 +2872,9 @@ WorldModel::localizePlayers( const VisualSensor & see )
     //   after loop, copy from temporary to memory again
 
     // temporary data list
-    PlayerObject::List new_teammates;
-    PlayerObject::List new_opponents;
-    PlayerObject::List new_unknown_players;
+    PlayerObject::List new_teammates( *M_player_pool );
+    PlayerObject::List new_opponents( *M_player_pool );
+    PlayerObject::List new_unknown_players( *M_player_pool );
 
     const Vector2D MYPOS = self().pos();
     const Vector2D MYVEL = self().vel();
@@ -2817,173 +2922,89 @@ WorldModel::localizePlayers( const VisualSensor & see )
 #endif
 
     //
-    // opponent (side & unum)
+    // localize all seen players
     //
-    for ( const VisualSensor::PlayerT & p : see.opponents() )
-    {
-        Localization::PlayerT player;
-        if ( ! M_localize->localizePlayer( *this,
-                                           p,
-                                           MY_FACE, MY_FACE_ERR, MYPOS, MYVEL,
-                                           &player ) )
-        {
-#ifdef DEBUG_PRINT_PLAYER_UPDATE
-            dlog.addText( Logger::WORLD,
-                          "(localizePlayers) failed opponent %d",
-                          player.unum_ );
-#endif
-            continue;
-        }
 
-#ifdef DEBUG_PRINT_PLAYER_UPDATE
-        dlog.addText( Logger::WORLD,
-                      "(localizePlayers)"
-                      " opponent %d pos=(%.2f, %.2f) vel=(%.2f, %.2f)",
-                      player.unum_,
-                      player.pos_.x, player.pos_.y,
-                      player.vel_.x, player.vel_.y );
-#endif
-        // matching, splice or create
-        checkTeamPlayer( theirSide(),
-                         player,
-                         M_opponents,
-                         M_unknown_players,
-                         new_opponents );
-    }
+    Localization::PlayerT seen_opponents[PlayerMatcher::MAX_ROWS];
+    Localization::PlayerT seen_teammates[PlayerMatcher::MAX_ROWS];
+    Localization::PlayerT seen_unknown_players[PlayerMatcher::MAX_ROWS];
+    int n_seen_opponents = 0;
+    int n_seen_teammates = 0;
+    int n_seen_unknown_players = 0;
 
-    //
-    // unknown opponent (no uniform number)
-    //
-    for ( const VisualSensor::PlayerT & p : see.unknownOpponents() )
-    {
-        Localization::PlayerT player;
-        if ( ! M_localize->localizePlayer( *this,
-                                           p,
-                                           MY_FACE, MY_FACE_ERR, MYPOS, MYVEL,
-                                           &player ) )
+    const auto localize = [&]( const VisualSensor::PlayerCont & from,
+                               Localization::PlayerT * to,
+                               int & size )
         {
-#ifdef DEBUG_PRINT_PLAYER_UPDATE
-            dlog.addText( Logger::WORLD,
-                          "(localizePlayers) failed unknown opponent" );
-#endif
-            continue;
-        }
+            for ( const VisualSensor::PlayerT & p : from )
+            {
+                if ( size >= PlayerMatcher::MAX_ROWS )
+                {
+                    dlog.addText( Logger::WORLD,
+                                  __FILE__" (localizePlayers) too many seen players" );
+                    break;
+                }
 
+                if ( M_localize->localizePlayer( *this,
+                                                 p,
+                                                 MY_FACE, MY_FACE_ERR, MYPOS, MYVEL,
+                                                 &to[size] ) )
+                {
 #ifdef DEBUG_PRINT_PLAYER_UPDATE
-        dlog.addText( Logger::WORLD,
-                      "(localizePlayers)"
-                      " unknown opponent pos=(%.2f, %.2f)",
-                      player.pos_.x, player.pos_.y );
+                    dlog.addText( Logger::WORLD,
+                                  "(localizePlayers) seen unum=%d pos=(%.2f, %.2f)",
+                                  to[size].unum_,
+                                  to[size].pos_.x, to[size].pos_.y );
 #endif
-        // matching, splice or create
-        checkTeamPlayer( theirSide(),
-                         player,
-                         M_opponents,
-                         M_unknown_players,
-                         new_opponents );
-    }
-
-    //
-    // teammate (side & unum)
-    //
-    for ( const VisualSensor::PlayerT & p : see.teammates() )
-    {
-        Localization::PlayerT player;
-        if ( ! M_localize->localizePlayer( *this,
-                                           p,
-                                           MY_FACE, MY_FACE_ERR, MYPOS, MYVEL,
-                                           &player ) )
-        {
+                    ++size;
+                }
 #ifdef DEBUG_PRINT_PLAYER_UPDATE
-            dlog.addText( Logger::WORLD,
-                          __FILE__" (localizePlayers) failed teammate %d",
-                          player.unum_ );
+                else
+                {
+                    dlog.addText( Logger::WORLD,
+                                  "(localizePlayers) failed. unum=%d",
+                                  p.unum_ );
+                }
 #endif
-            continue;
-        }
+            }
+        };
 
-#ifdef DEBUG_PRINT_PLAYER_UPDATE
-        dlog.addText( Logger::WORLD,
-                      "(localizePlayers)"
-                      " teammate %d pos=(%.2f, %.2f) vel=(%.2f, %.2f)",
-                      player.unum_,
-                      player.pos_.x, player.pos_.y,
-                      player.vel_.x, player.vel_.y );
-#endif
-        // matching, splice or create
-        checkTeamPlayer( ourSide(),
-                         player,
-                         M_teammates,
-                         M_unknown_players,
-                         new_teammates );
-    }
+    localize( see.opponents(), seen_opponents, n_seen_opponents );
+    localize( see.unknownOpponents(), seen_opponents, n_seen_opponents );
+    localize( see.teammates(), seen_teammates, n_seen_teammates );
+    localize( see.unknownTeammates(), seen_teammates, n_seen_teammates );
+    localize( see.unknownPlayers(), seen_unknown_players, n_seen_unknown_players );
 
     //
-    // unknown teammate (no uniform number)
+    // matching, splice or create
     //
-    for ( const VisualSensor::PlayerT & p : see.unknownTeammates() )
-    {
-        Localization::PlayerT player;
-        if ( ! M_localize->localizePlayer( *this,
-                                           p,
-                                           MY_FACE, MY_FACE_ERR, MYPOS, MYVEL,
-                                           &player ) )
-        {
-#ifdef DEBUG_PRINT_PLAYER_UPDATE
-            dlog.addText( Logger::WORLD,
-                          "(localizePlayers) failed uunknown teammate" );
-#endif
-            continue;
-        }
 
-#ifdef DEBUG_PRINT_PLAYER_UPDATE
-        dlog.addText( Logger::WORLD,
-                      "(localizePlayers)"
-                      " unknown teammate pos=(%.2f, %.2f)",
-                      player.pos_.x, player.pos_.y );
-#endif
-        // matching, splice or create
-        checkTeamPlayer( ourSide(),
-                         player,
+    // all seen players may be new ones. make room in advance,
+    // because the old players must not be removed during the matching.
+    reservePlayerSlots( n_seen_opponents + n_seen_teammates + n_seen_unknown_players );
+
+    PlayerMatcher matcher;
+
+    matchTeamPlayers( theirSide(),
+                      seen_opponents, n_seen_opponents,
+                      M_opponents,
+                      M_unknown_players,
+                      new_opponents,
+                      matcher );
+    matchTeamPlayers( ourSide(),
+                      seen_teammates, n_seen_teammates,
+                      M_teammates,
+                      M_unknown_players,
+                      new_teammates,
+                      matcher );
+    matchUnknownPlayers( seen_unknown_players, n_seen_unknown_players,
                          M_teammates,
+                         M_opponents,
                          M_unknown_players,
-                         new_teammates );
-    }
-
-    //
-    // unknown player
-    //
-    for ( const VisualSensor::PlayerT & p : see.unknownPlayers() )
-    {
-        Localization::PlayerT player;
-        // localize
-        if ( ! M_localize->localizePlayer( *this,
-                                           p,
-                                           MY_FACE, MY_FACE_ERR, MYPOS, MYVEL,
-                                           &player ) )
-        {
-#ifdef DEBUG_PRINT_PLAYER_UPDATE
-            dlog.addText( Logger::WORLD,
-                          __FILE__" (localizePlayers) failed unknown player" );
-#endif
-            continue;
-        }
-
-#ifdef DEBUG_PRINT_PLAYER_UPDATE
-        dlog.addText( Logger::WORLD,
-                      "(localizePlayers)"
-                      " unknown player: pos=(%.2f, %.2f)",
-                      player.pos_.x, player.pos_.y );
-#endif
-        // matching, splice or create
-        checkUnknownPlayer( player,
-                            M_teammates,
-                            M_opponents,
-                            M_unknown_players,
-                            new_teammates,
-                            new_opponents,
-                            new_unknown_players );
-    }
+                         new_teammates,
+                         new_opponents,
+                         new_unknown_players,
+                         matcher );
 
     //////////////////////////////////////////////////////////////////
     // splice temporary seen players to memory list
@@ -2999,29 +3020,31 @@ WorldModel::localizePlayers( const VisualSensor & see )
     //////////////////////////////////////////////////////////////////
     // create team member pointer vector for sort
 
-    std::vector< PlayerObject * > all_teammates_ptr;
-    std::vector< PlayerObject * > all_opponents_ptr;
+    // the pool size bounds the number of players, so no allocation is needed.
+
+    PlayerObject * all_teammates_ptr[PlayerObjectPool::CAPACITY];
+    PlayerObject * all_opponents_ptr[PlayerObjectPool::CAPACITY];
 
-    all_teammates_ptr.reserve( M_teammates.size() );
+    int teammate_count = 0;
     for ( PlayerObject & p : M_teammates )
     {
-        all_teammates_ptr.push_back( &p );
+        all_teammates_ptr[teammate_count++] = &p;
     }
 
-    all_opponents_ptr.reserve( M_opponents.size() );
+    int opponent_count = 0;
     for ( PlayerObject & p : M_opponents )
     {
-        all_opponents_ptr.push_back( &p );
+        all_opponents_ptr[opponent_count++] = &p;
     }
 
 
     /////////////////////////////////////////////////////////////////
     // sort by accuracy count
-    std::sort( all_teammates_ptr.begin(),
-               all_teammates_ptr.end(),
+    std::sort( all_teammates_ptr,
+               all_teammates_ptr + teammate_count,
                PlayerPtrAccuracySorter() );
-    std::sort( all_opponents_ptr.begin(),
-               all_opponents_ptr.end(),
+    std::sort( all_opponents_ptr,
+               all_opponents_ptr + opponent_count,
                PlayerPtrAccuracySorter() );
     M_unknown_players.sort( PlayerCountSorter() );
 
@@ -3030,38 +3053,32 @@ WorldModel::localizePlayers( const VisualSensor & see )
     // if overflow is detected, player is removed based on confidence value
 
     // remove from teammates
-    int teammate_count = all_teammates_ptr.size();
     while ( teammate_count > 11 - 1 )
     {
         // reset least confidence value player
+        PlayerObject * p = all_teammates_ptr[teammate_count - 1];
 #ifdef DEBUG_PRINT_PLAYER_UPDATE
         dlog.addText( Logger::WORLD,
                       __FILE__" (localizePlayers)"
                       " erase overflow teammate, %d pos=(%.2f, %.2f)",
-                      all_teammates_ptr.back()->unum(),
-                      all_teammates_ptr.back()->pos().x,
-                      all_teammates_ptr.back()->pos().y );
+                      p->unum(), p->pos().x, p->pos().y );
 #endif
-        all_teammates_ptr.back()->forget();
-        all_teammates_ptr.pop_back();
+        p->forget();
         --teammate_count;
     }
 
     // remove from not-teammates
-    int opponent_count = all_opponents_ptr.size();
     while ( opponent_count > 11 )
     {
         // reset least confidence value player
+        PlayerObject * p = all_opponents_ptr[opponent_count - 1];
 #ifdef DEBUG_PRINT_PLAYER_UPDATE
         dlog.addText( Logger::WORLD,
                       __FILE__" (localizePlayers)"
                       " erase overflow opponent, %d pos=(%.2f, %.2f)",
-                      all_opponents_ptr.back()->unum(),
-                      all_opponents_ptr.back()->pos().x,
-                      all_opponents_ptr.back()->pos().y );
+                      p->unum(), p->pos().x, p->pos().y );
 #endif
-        all_opponents_ptr.back()->forget();
-        all_opponents_ptr.pop_back();
+        p->forget();
         --opponent_count;
     }
 
@@ -3112,266 +3129,193 @@ WorldModel::localizePlayers( const VisualSensor & see )
 /*!
 
  */
-void
-WorldModel::checkTeamPlayer( const SideID side,
-                             const Localization::PlayerT & player,
-                             PlayerObject::List & old_known_players,
-                             PlayerObject::List & old_unknown_players,
-                             PlayerObject::List & new_known_players )
+bool
+WorldModel::reservePlayerSlots( const int n )
 {
-    // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!! //
-    //  if matched player is found, that player is removed from old list
-    //  and updated data is splice to new container
-    // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!! //
-
-    //////////////////////////////////////////////////////////////////
-    // pre check
-    // unum is seen -> search the player that has the same uniform number
-    if ( player.unum_ != Unum_Unknown )
+    while ( PlayerObjectPool::CAPACITY - M_player_pool->used() < n
+            && ! M_unknown_players.empty() )
     {
-        // search from old unum known players
-        for ( PlayerObject::List::iterator it = old_known_players.begin(), end = old_known_players.end();
+        PlayerObject::List::iterator stalest = M_unknown_players.begin();
+        for ( PlayerObject::List::iterator it = M_unknown_players.begin(), end = M_unknown_players.end();
               it != end;
               ++it )
         {
-            if ( it->unum() == player.unum_ )
+            if ( it->posCount() > stalest->posCount() )
             {
-#ifdef DEBUG_PRINT_PLAYER_UPDATE
-                dlog.addText( Logger::WORLD,
-                              "(checkTeamPlayer)"
-                              " >>> matched!"
-                              " unum = %d pos =(%.1f %.1f)",
-                              player.unum_, player.pos_.x, player.pos_.y );
-#endif
-                it->updateBySee( side, player );
-                new_known_players.splice( new_known_players.end(),
-                                          old_known_players,
-                                          it );
-                return; // success!!
+                stalest = it;
             }
         }
+
+        dlog.addText( Logger::WORLD,
+                      __FILE__" (reservePlayerSlots) player pool is full."
+                      " remove unknown player (%.1f %.1f) count=%d",
+                      stalest->pos().x, stalest->pos().y, stalest->posCount() );
+        M_unknown_players.erase( stalest );
     }
 
-    //////////////////////////////////////////////////////////////////
-    // find nearest player
+    return PlayerObjectPool::CAPACITY - M_player_pool->used() >= n;
+}
 
-    const double dash_noise = 1.0 + ServerParam::i().playerRand();
-    const double self_error = 0.5 * 2.0;
+/*-------------------------------------------------------------------*/
+/*!
 
-    double min_team_dist = 10.0 * 10.0;
-    double min_unknown_dist = 10.0 * 10.0;
+ */
+void
+WorldModel::matchTeamPlayers( const SideID side,
+                              const Localization::PlayerT * seen,
+                              const int size,
+                              PlayerObject::List & old_known_players,
+                              PlayerObject::List & old_unknown_players,
+                              PlayerObject::List & new_known_players,
+                              PlayerMatcher & matcher )
+{
+    // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!! //
+    //  if matched player is found, that player is removed from old list
+    //  and updated data is splice to new container
+    // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!! //
 
-    PlayerObject::List::iterator candidate_team = old_known_players.end();
-    PlayerObject::List::iterator candidate_unknown = old_unknown_players.end();
+    PlayerObject::List::iterator matched[PlayerMatcher::MAX_ROWS];
+    PlayerObject::List * matched_list[PlayerMatcher::MAX_ROWS];
 
     //////////////////////////////////////////////////////////////////
-    // search from old same team players
-    for ( PlayerObject::List::iterator it = old_known_players.begin(), end = old_known_players.end();
-          it != end;
-          ++it )
+    // pre check
+    // unum is seen -> the player that has the same uniform number is matched
+    for ( int i = 0; i < size; ++i )
     {
-        if ( player.unum_ != Unum_Unknown
-             && it->unum() != Unum_Unknown
-             && it->unum() != player.unum_ )
+        matched_list[i] = nullptr;
+
+        if ( seen[i].unum_ == Unum_Unknown )
         {
-            // unum is seen
-            // and it does not match with old player's unum.
-#ifdef DEBUG_PRINT_PLAYER_UPDATE_DETAIL
-            dlog.addText( Logger::WORLD,
-                          __FILE__" (checkTeamPlayer)"
-                          "___ known player: unum is not match."
-                          " seen unum = %d, old_unum = %d",
-                          player.unum_, it->unum() );
-#endif
             continue;
         }
 
-        int count = it->seenPosCount();
-        Vector2D old_pos = it->seenPos();
-        double heard_error = 0.0;
-        if ( it->heardPosCount() < it->seenPosCount() )
+        for ( PlayerObject::List::iterator it = old_known_players.begin(), end = old_known_players.end();
+              it != end;
+              ++it )
         {
-            count = it->heardPosCount();
-            old_pos = it->heardPos();
-            heard_error = 2.0;
+            if ( it->unum() == seen[i].unum_
+                 && ! is_matched( &*it, matched, matched_list, i ) )
+            {
+                matched[i] = it;
+                matched_list[i] = &old_known_players;
+                break;
+            }
         }
+    }
 
-        const double d = player.pos_.dist( old_pos );
+    //////////////////////////////////////////////////////////////////
+    // rows: the rest seen players
+    // columns: old same team players and old unknown players
 
-        if ( d > ( it->playerTypePtr()->realSpeedMax() * dash_noise * count
-                   + heard_error
-                   + self_error
-                   + player.dist_error_ * 2.0 ) )
+    int rows[PlayerMatcher::MAX_ROWS];
+    int n_rows = 0;
+    for ( int i = 0; i < size; ++i )
+    {
+        if ( ! matched_list[i] )
         {
-            // TODO: inertia movement should be considered.
-#ifdef DEBUG_PRINT_PLAYER_UPDATE_DETAIL
-            dlog.addText( Logger::WORLD,
-                          "(checkTeamPlayer)"
-                          "___ known player: dist over."
-                          " dist=%.2f > buf=%.2f"
-                          " seen_pos(%.1f %.1f) old_pos(%.1f %.1f)",
-                          d,
-                          it->playerTypePtr()->realSpeedMax() * dash_noise * count
-                          + heard_error
-                          + self_error
-                          + player.dist_error_ * 2.0,
-                          player.pos_.x, player.pos_.y,
-                          it->pos().x, it->pos().y );
-#endif
-            continue;
-        }
-
-        if ( d < min_team_dist )
-        {
-#ifdef DEBUG_PRINT_PLAYER_UPDATE_DETAIL
-            dlog.addText( Logger::WORLD,
-                          "(checkTeamPlayer)"
-                          "___ known player: update."
-                          " dist=%.2f < min_team_dist=%.2f"
-                          " seen_pos(%.1f %.1f) old_pos(%.1f %.1f)",
-                          d,
-                          min_team_dist,
-                          player.pos_.x, player.pos_.y,
-                          it->pos().x, it->pos().y );
-#endif
-            min_team_dist = d;
-            candidate_team = it;
+            rows[n_rows++] = i;
         }
     }
 
-    //////////////////////////////////////////////////////////////////
-    // search from unknown players
-    for ( PlayerObject::List::iterator it = old_unknown_players.begin(),
-              end = old_unknown_players.end();
-          it != end;
+    PlayerObject::List::iterator cols[PlayerMatcher::MAX_COLS];
+    PlayerObject::List * col_list[PlayerMatcher::MAX_COLS];
+    int n_cols = 0;
+    for ( PlayerObject::List::iterator it = old_known_players.begin(), end = old_known_players.end();
+          it != end && n_cols < PlayerMatcher::MAX_COLS;
           ++it )
     {
-        int count = it->seenPosCount();
-        Vector2D old_pos = it->seenPos();
-        double heard_error = 0.0;
-        if ( it->heardPosCount() < it->seenPosCount() )
+        if ( ! is_matched( &*it, matched, matched_list, size ) )
         {
-            count = it->heardPosCount();
-            old_pos = it->heardPos();
-            heard_error = 2.0;
+            cols[n_cols] = it;
+            col_list[n_cols] = &old_known_players;
+            ++n_cols;
         }
+    }
+    for ( PlayerObject::List::iterator it = old_unknown_players.begin(), end = old_unknown_players.end();
+          it != end && n_cols < PlayerMatcher::MAX_COLS;
+          ++it )
+    {
+        cols[n_cols] = it;
+        col_list[n_cols] = &old_unknown_players;
+        ++n_cols;
+    }
 
-        const double d = player.pos_.dist( old_pos );
+    //////////////////////////////////////////////////////////////////
+    // solve the assignment that minimizes the total distance
 
-        if ( d > ( it->playerTypePtr()->realSpeedMax() * dash_noise * count
-                   + heard_error
-                   + self_error
-                   + player.dist_error_ * 2.0 ) )
+    matcher.reset( n_rows, n_cols );
+    for ( int r = 0; r < n_rows; ++r )
+    {
+        const Localization::PlayerT & player = seen[rows[r]];
+        for ( int c = 0; c < n_cols; ++c )
         {
-            // TODO: inertia movement should be considered.
-#ifdef DEBUG_PRINT_PLAYER_UPDATE_DETAIL
-            dlog.addText( Logger::WORLD,
-                          "(checkTeamPlayer)"
-                          "__ unknown player: dist over. "
-                          "dist=%.2f > buf=%.2f"
-                          " seen_pos(%.1f %.1f) old_pos(%.1f %.1f)",
-                          d,
-                          it->playerTypePtr()->realSpeedMax() * dash_noise * count
-                          + heard_error
-                          + self_error
-                          + player.dist_error_ * 2.0,
-                          player.pos_.x, player.pos_.y,
-                          old_pos.x, old_pos.y );
-#endif
-            continue;
+            if ( player.unum_ != Unum_Unknown
+                 && cols[c]->unum() != Unum_Unknown
+                 && cols[c]->unum() != player.unum_ )
+            {
+                // unum is seen
+                // and it does not match with old player's unum.
+                continue;
+            }
+
+            matcher.setCost( r, c, get_matching_dist( *cols[c], player, false ) );
         }
+    }
+    matcher.solve();
 
-        if ( d < min_unknown_dist )
+    for ( int r = 0; r < n_rows; ++r )
+    {
+        const int c = matcher.assignment( r );
+        if ( c >= 0 )
         {
-#ifdef DEBUG_PRINT_PLAYER_UPDATE_DETAIL
-            dlog.addText( Logger::WORLD,
-                          "(checkTeamPlayer)"
-                          "__ unknown player: update. "
-                          " dist=%.2f < min_unknown_dist=%.2f"
-                          " seen_pos(%.1f %.1f) old_pos(%.1f %.1f)",
-                          d,
-                          min_unknown_dist,
-                          player.pos_.x, player.pos_.y,
-                          old_pos.x, old_pos.y );
-#endif
-            min_unknown_dist = d;
-            candidate_unknown = it;
+            matched[rows[r]] = cols[c];
+            matched_list[rows[r]] = col_list[c];
         }
     }
 
-    PlayerObject::List::iterator candidate = old_unknown_players.end();
-    PlayerObject::List * target_list = nullptr;
-#ifdef DEBUG_PRINT_PLAYER_UPDATE
-    double min_dist = 1000.0;
-#endif
+    //////////////////////////////////////////////////////////////////
+    // update & splice to new list in the seen order
 
-    if ( candidate_team != old_known_players.end()
-         && min_team_dist < min_unknown_dist )
+    for ( int i = 0; i < size; ++i )
     {
-        candidate = candidate_team;
-        target_list = &old_known_players;
+        const Localization::PlayerT & player = seen[i];
 
+        if ( matched_list[i] )
+        {
 #ifdef DEBUG_PRINT_PLAYER_UPDATE
-        min_dist = min_team_dist;
-        dlog.addText( Logger::WORLD,
-                      "(checkTeamPlayer)"
-                      ">>> %d (%.1f %.1f)"
-                      " -> %s player %d %s (%.2f, %.2f) dist=%.2f",
-                      player.unum_,
-                      player.pos_.x, player.pos_.y,
-                      side_str( candidate->side() ),
-                      candidate->unum(),
-                      ( candidate->goalie() ? "goalie" : "field" ),
-                      candidate->pos().x, candidate->pos().y,
-                      min_dist );
-#endif
-    }
+            dlog.addText( Logger::WORLD,
+                          "(matchTeamPlayers)"
+                          ">>> %d (%.1f %.1f) -> %s player %d (%.2f, %.2f)",
+                          player.unum_,
+                          player.pos_.x, player.pos_.y,
+                          side_str( matched[i]->side() ),
+                          matched[i]->unum(),
+                          matched[i]->pos().x, matched[i]->pos().y );
+#endif
+            matched[i]->updateBySee( side, player );
+            new_known_players.splice( new_known_players.end(),
+                                      *matched_list[i],
+                                      matched[i] );
+            continue;
+        }
 
-    if ( candidate_unknown != old_unknown_players.end()
-         && min_unknown_dist < min_team_dist )
-    {
-        candidate = candidate_unknown;
-        target_list = &old_unknown_players;
+        //
+        // not found -> generate new player
+        //
 
 #ifdef DEBUG_PRINT_PLAYER_UPDATE
-        min_dist = min_unknown_dist;
         dlog.addText( Logger::WORLD,
-                      "(checkTeamPlayer)"
-                      ">>> %d (%.1f %.1f)"
-                      " -> unknown player (%.2f, %.2f) dist=%.2f",
-                      player.unum_,
-                      player.pos_.x, player.pos_.y,
-                      candidate->pos().x, candidate->pos().y,
-                      min_dist );
+                      "(matchTeamPlayers)"
+                      " XXX unmatch. generate new known player pos=(%.2f, %.2f)",
+                      player.pos_.x, player.pos_.y );
 #endif
+        if ( ! new_known_players.emplace_back( side, player ) )
+        {
+            dlog.addText( Logger::WORLD,
+                          "(matchTeamPlayers) player pool is full. (%.1f %.1f) is ignored.",
+                          player.pos_.x, player.pos_.y );
+        }
     }
-
-    if ( candidate != old_unknown_players.end()
-         && target_list )
-    {
-        // update & splice to new list
-        candidate->updateBySee( side, player );
-
-        new_known_players.splice( new_known_players.end(),
-                                  *target_list,
-                                  candidate );
-        return;
-    }
-
-    //
-    // not found -> generate new player
-    //
-
-#ifdef DEBUG_PRINT_PLAYER_UPDATE
-    dlog.addText( Logger::WORLD,
-                  "(checkTeamPlayer)"
-                  " XXX unmatch. min_dist= %.2f"
-                  " generate new known player pos=(%.2f, %.2f)",
-                  min_dist,
-                  player.pos_.x, player.pos_.y );
-#endif
-
-    new_known_players.emplace_back( side, player );
 }
 
 /*-------------------------------------------------------------------*/
@@ -3379,308 +3323,112 @@ WorldModel::checkTeamPlayer( const SideID side,
 
  */
 void
-WorldModel::checkUnknownPlayer( const Localization::PlayerT & player,
-                                PlayerObject::List & old_teammates,
-                                PlayerObject::List & old_opponents,
-                                PlayerObject::List & old_unknown_players,
-                                PlayerObject::List & new_teammates,
-                                PlayerObject::List & new_opponents,
-                                PlayerObject::List & new_unknown_players )
+WorldModel::matchUnknownPlayers( const Localization::PlayerT * seen,
+                                 const int size,
+                                 PlayerObject::List & old_teammates,
+                                 PlayerObject::List & old_opponents,
+                                 PlayerObject::List & old_unknown_players,
+                                 PlayerObject::List & new_teammates,
+                                 PlayerObject::List & new_opponents,
+                                 PlayerObject::List & new_unknown_players,
+                                 PlayerMatcher & matcher )
 {
     // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!! //
     //  if matched player is found, that player is removed from old list
     //  and updated data is splice to new container
     // !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!! //
 
-    // matching start
-    // search the nearest player
-
-    double min_opponent_dist = 100.0;
-    double min_teammate_dist = 100.0;
-    double min_unknown_dist = 100.0;
-
-    PlayerObject::List::iterator candidate_opponent = old_opponents.end();
-    PlayerObject::List::iterator candidate_teammate = old_teammates.end();
-    PlayerObject::List::iterator candidate_unknown = old_unknown_players.end();
-
-    const double dash_noise = 1.0 + ServerParam::i().playerRand();
-    const double self_error = 0.5 * 2.0;
-
     //////////////////////////////////////////////////////////////////
-    // search from old opponents
-    for ( PlayerObject::List::iterator it = old_opponents.begin(), end = old_opponents.end();
-          it != end;
-          ++it )
-    {
-        int count = it->seenPosCount();
-        Vector2D old_pos = it->seenPos();
-        double heard_error = 0.0;
-        if ( it->heardPosCount() < it->seenPosCount() )
-        {
-            count = it->heardPosCount();
-            old_pos = it->heardPos();
-            heard_error = 2.0;
-        }
+    // rows: seen players
+    // columns: all old players
 
-        const double d = player.pos_.dist( old_pos );
+    PlayerObject::List::iterator cols[PlayerMatcher::MAX_COLS];
+    PlayerObject::List * col_list[PlayerMatcher::MAX_COLS];
+    int n_cols = 0;
 
-        if ( d > ( it->playerTypePtr()->realSpeedMax() * dash_noise * count
-                   + heard_error
-                   + self_error
-                   + player.dist_error_ * 2.0 ) )
+    for ( PlayerObject::List * old_list : { &old_opponents, &old_teammates, &old_unknown_players } )
+    {
+        for ( PlayerObject::List::iterator it = old_list->begin(), end = old_list->end();
+              it != end && n_cols < PlayerMatcher::MAX_COLS;
+              ++it )
         {
-#ifdef DEBUG_PRINT_PLAYER_UPDATE_DETAIL
-            dlog.addText( Logger::WORLD,
-                          "(checkUnknownPlayer)"
-                          "__ opp %d: dist over."
-                          " dist=%.2f > buf=%.2f"
-                          " seen_pos(%.1f %.1f) old_pos(%.1f %.1f)",
-                          it->unum(),
-                          d,
-                          it->playerTypePtr()->realSpeedMax() * dash_noise * count
-                          + heard_error
-                          + self_error
-                          + player.dist_error_ * 2.0,
-                          player.pos_.x, player.pos_.y,
-                          old_pos.x, old_pos.y );
-#endif
-            continue;
-        }
-
-        if ( d < min_opponent_dist )
-        {
-#ifdef DEBUG_PRINT_PLAYER_UPDATE_DETAIL
-            dlog.addText( Logger::WORLD,
-                          "(checkUnknownPlayer)"
-                          "__ opp player: update."
-                          " dist=%.2f < min_opp_dist=%.2f"
-                          " seen_pos(%.1f %.1f) old_pos(%.1f %.1f)",
-                          d,
-                          min_opponent_dist,
-                          player.pos_.x, player.pos_.y,
-                          old_pos.x, old_pos.y );
-#endif
-            min_opponent_dist = d;
-            candidate_opponent = it;
+            cols[n_cols] = it;
+            col_list[n_cols] = old_list;
+            ++n_cols;
         }
     }
 
     //////////////////////////////////////////////////////////////////
-    // search from old teammates
-    for ( PlayerObject::List::iterator it = old_teammates.begin(), end = old_teammates.end();
-          it != end;
-          ++it )
-    {
-        int count = it->seenPosCount();
-        Vector2D old_pos = it->seenPos();
-        double heard_error = 0.0;
-        if ( it->heardPosCount() <= it->seenPosCount() )
-        {
-            count = it->heardPosCount();
-            old_pos = it->heardPos();
-            heard_error = 2.0;
-        }
+    // solve the assignment that minimizes the total distance
 
-        const double d = player.pos_.dist( old_pos );
-
-        if ( d > ( it->playerTypePtr()->realSpeedMax() * dash_noise * count
-                   + heard_error
-                   + self_error
-                   + player.dist_error_ * 2.0 ) )
-        {
-#ifdef DEBUG_PRINT_PLAYER_UPDATE_DETAIL
-            dlog.addText( Logger::WORLD,
-                          "(checkUnknownPlayer)"
-                          "__ our %d: dist over."
-                          " dist=%.2f > buf=%.2f"
-                          " seen_pos(%.1f %.1f) old_pos(%.1f %.1f)",
-                          it->unum(),
-                          d,
-                          it->playerTypePtr()->realSpeedMax() * dash_noise * count
-                          + heard_error
-                          + self_error
-                          + player.dist_error_ * 2.0,
-                          player.pos_.x, player.pos_.y,
-                          old_pos.x, old_pos.y );
-#endif
-            continue;
-        }
-
-        if ( d < min_teammate_dist )
+    matcher.reset( size, n_cols );
+    for ( int r = 0; r < size; ++r )
+    {
+        for ( int c = 0; c < n_cols; ++c )
         {
-#ifdef DEBUG_PRINT_PLAYER_UPDATE_DETAIL
-            dlog.addText( Logger::WORLD,
-                          "(checkUnknownPlayer)"
-                          "__ our player: update."
-                          " dist=%.2f < min_our_dist=%.2f"
-                          " seen_pos(%.1f %.1f) old_pos(%.1f %.1f)",
-                          d,
-                          min_teammate_dist,
-                          player.pos_.x, player.pos_.y,
-                          old_pos.x, old_pos.y );
-#endif
-            min_teammate_dist = d;
-            candidate_teammate = it;
+            matcher.setCost( r, c, get_matching_dist( *cols[c], seen[r],
+                                                      col_list[c] == &old_teammates ) );
         }
     }
+    matcher.solve();
 
     //////////////////////////////////////////////////////////////////
-    // search from old unknown players
-    for ( PlayerObject::List::iterator it = old_unknown_players.begin(), end = old_unknown_players.end();
-          it != end;
-          ++it )
-    {
-        int count = it->seenPosCount();
-        Vector2D old_pos = it->seenPos();
-        double heard_error = 0.0;
-        if ( it->heardPosCount() < it->seenPosCount() )
-        {
-            count = it->heardPosCount();
-            old_pos = it->heardPos();
-            heard_error = 2.0;
-        }
+    // update & splice to new list in the seen order
 
-        const double d = player.pos_.dist( old_pos );
+    for ( int r = 0; r < size; ++r )
+    {
+        const Localization::PlayerT & player = seen[r];
+        const int c = matcher.assignment( r );
 
-        if ( d > ( it->playerTypePtr()->realSpeedMax() * dash_noise * count
-                   + heard_error
-                   + self_error
-                   + player.dist_error_ * 2.0 ) )
+        if ( c >= 0 )
         {
-#ifdef DEBUG_PRINT_PLAYER_UPDATE_DETAIL
+            PlayerObject::List * new_list = &new_unknown_players;
+            SideID side = NEUTRAL;
+            if ( col_list[c] == &old_teammates )
+            {
+                new_list = &new_teammates;
+                side = ourSide();
+            }
+            else if ( col_list[c] == &old_opponents )
+            {
+                new_list = &new_opponents;
+                side = theirSide();
+            }
+
+#ifdef DEBUG_PRINT_PLAYER_UPDATE
             dlog.addText( Logger::WORLD,
-                          "(checkUnknownPlayer)"
-                          "__ unknown player: dist over."
-                          " dist=%.2f > buf=%.2f"
-                          " seen_pos(%.1f %.1f) old_pos(%.1f %.1f)",
-                          d,
-                          it->playerTypePtr()->realSpeedMax() * dash_noise * count
-                          + heard_error
-                          + self_error
-                          + player.dist_error_ * 2.0,
+                          "(matchUnknownPlayers)"
+                          ">>> (%.1f %.1f) -> %s player %d (%.1f %.1f)",
                           player.pos_.x, player.pos_.y,
-                          old_pos.x, old_pos.y );
-#endif
+                          side_str( side ),
+                          cols[c]->unum(),
+                          cols[c]->pos().x, cols[c]->pos().y );
+#endif
+            cols[c]->updateBySee( side, player );
+            new_list->splice( new_list->end(),
+                              *col_list[c],
+                              cols[c] );
             continue;
         }
 
-        if ( d < min_unknown_dist )
-        {
+        //////////////////////////////////////////////////////////////////
+        // generate new player
 #ifdef DEBUG_PRINT_PLAYER_UPDATE_DETAIL
-            dlog.addText( Logger::WORLD,
-                          "(checkUnknownPlayer)"
-                          "__ unknown player: update."
-                          " dist=%.2f < min_unknown_dist=%.2f"
-                          " seen_pos(%.1f %.1f) old_pos(%.1f %.1f)",
-                          d,
-                          min_unknown_dist,
-                          player.pos_.x, player.pos_.y,
-                          old_pos.x, old_pos.y );
-#endif
-            min_unknown_dist = d;
-            candidate_unknown = it;
-        }
-    }
-
-    PlayerObject::List::iterator candidate = old_unknown_players.end();;
-    PlayerObject::List * new_list = nullptr;
-    PlayerObject::List * old_list = nullptr;
-    SideID side = NEUTRAL;
-#ifdef DEBUG_PRINT_PLAYER_UPDATE
-    double min_dist = 1000.0;
-#endif
-
-    if ( candidate_teammate != old_teammates.end()
-         && min_teammate_dist < min_opponent_dist
-         && min_teammate_dist < min_unknown_dist )
-    {
-        candidate = candidate_teammate;
-        new_list = &new_teammates;
-        old_list = &old_teammates;
-        side = ourSide();
-
-#ifdef DEBUG_PRINT_PLAYER_UPDATE
-        min_dist = min_teammate_dist;
         dlog.addText( Logger::WORLD,
-                      "(checkUnknownPlayer)"
-                      ">>> (%.1f %.1f) -> teammate %d (%.1f %.1f) dist=%.2f",
-                      player.pos_.x, player.pos_.y,
-                      candidate->unum(),
-                      candidate->pos().x, candidate->pos().y,
-                      min_dist );
-#endif
-    }
-
-    if ( candidate_opponent != old_opponents.end()
-         //&& min_opponent_dist * 0.5 - 3.0 < min_teammate_dist
-         && min_opponent_dist < min_teammate_dist
-         && min_opponent_dist < min_unknown_dist )
-    {
-        candidate = candidate_opponent;
-        new_list = &new_opponents;
-        old_list = &old_opponents;
-        side = theirSide();
-
-#ifdef DEBUG_PRINT_PLAYER_UPDATE
-        min_dist = min_opponent_dist;
-        dlog.addText( Logger::WORLD,
-                      "(checkUnknownPlayer)"
-                      ">>> (%.1f %.1f) -> opponent %d (%.1f %.1f) dist=%.2f",
-                      player.pos_.x, player.pos_.y,
-                      candidate->unum(),
-                      candidate->pos().x, candidate->pos().y,
-                      min_dist );
+                      "(matchUnknownPlayers)"
+                      " XXX unmatch. dist_error=%f"
+                      " generate new unknown player. pos=(%.2f, %.2f)",
+                      player.dist_error_,
+                      player.pos_.x, player.pos_.y );
 #endif
-    }
-
-    if ( candidate_unknown != old_unknown_players.end()
-         //&& min_unknown_dist * 0.5 - 3.0 < min_teammate_dist
-         && min_unknown_dist < min_teammate_dist
-         && min_unknown_dist < min_opponent_dist )
-    {
-        candidate = candidate_unknown;
-        new_list = &new_unknown_players;
-        old_list = &old_unknown_players;
-        side = NEUTRAL;
 
-#ifdef DEBUG_PRINT_PLAYER_UPDATE_DETAIL
-        min_dist = min_unknown_dist;
-        dlog.addText( Logger::WORLD,
-                      "(checkUnknownPlayer)"
-                      ">>> (%.1f %.1f) -> unknown (%.1f %.1f) dist=%.2f",
-                      player.pos_.x, player.pos_.y,
-                      candidate->pos().x, candidate->pos().y,
-                      min_dist );
-#endif
-    }
-
-
-    //////////////////////////////////////////////////////////////////
-    // check player movable radius
-    if ( candidate != old_unknown_players.end()
-         && new_list
-         && old_list )
-    {
-        // update & splice to new list
-        candidate->updateBySee( side, player );
-        new_list->splice( new_list->end(),
-                          *old_list,
-                          candidate );
-        return;
+        if ( ! new_unknown_players.emplace_back( NEUTRAL, player ) )
+        {
+            dlog.addText( Logger::WORLD,
+                          "(matchUnknownPlayers) player pool is full. (%.1f %.1f) is ignored.",
+                          player.pos_.x, player.pos_.y );
+        }
     }
-
-    //////////////////////////////////////////////////////////////////
-    // generate new player
-#ifdef DEBUG_PRINT_PLAYER_UPDATE_DETAIL
-    dlog.addText( Logger::WORLD,
-                  "(checkUnknownPlayer)"
-                  " XXX unmatch. dist_error=%f"
-                  " generate new unknown player. pos=(%.2f, %.2f)",
-                  player.dist_error_,
-                  player.pos_.x, player.pos_.y );
-#endif
-
-    new_unknown_players.emplace_back( NEUTRAL, player );
 }
 
 /*-------------------------------------------------------------------*/
@@ -3925,6 +3673,27 @@ WorldModel::updatePlayerStateCache()
 
     }
 
+    //
+    // create spatial index
+    //
+    {
+        int index = 0;
+        M_player_grid.add( &M_self, index++, PlayerGrid::SELF );
+        for ( const PlayerObject & t : M_teammates )
+        {
+            M_player_grid.add( &t, index++, PlayerGrid::TEAMMATE );
+        }
+        for ( const PlayerObject & o : M_opponents )
+        {
+            M_player_grid.add( &o, index++, PlayerGrid::OPPONENT );
+        }
+        for ( const PlayerObject & u : M_unknown_players )
+        {
+            M_player_grid.add( &u, -1, PlayerGrid::UNKNOWN );
+        }
+        M_player_grid.build();
+    }
+
     //
     // update kickable player
     //
@@ -4169,9 +3938,9 @@ WorldModel::estimateTheirGoalie()
 void
 WorldModel::estimateMaybeKickableTeammate()
 {
-    static GameTime s_update_time( -1, 0 );
-    static int s_previous_teammate_step = 1000;
-    static GameTime s_previous_time( -1, 0 );
+    thread_local GameTime s_update_time( -1, 0 );
+    thread_local int s_previous_teammate_step = 1000;
+    thread_local GameTime s_previous_time( -1, 0 );
 
     if ( s_update_time == this->time() )
     {
@@ -5377,7 +5146,7 @@ WorldModel::checkGhost( const ViewArea & varea )
     // players
 
     {
-        std::list< PlayerObject >::iterator it = M_teammates.begin();
+        PlayerObject::List::iterator it = M_teammates.begin();
         while ( it != M_teammates.end() )
         {
             if ( it->posCount() > 0
@@ -5409,7 +5178,7 @@ WorldModel::checkGhost( const ViewArea & varea )
     }
 
     {
-        std::list< PlayerObject >::iterator it = M_opponents.begin();
+        PlayerObject::List::iterator it = M_opponents.begin();
         while ( it != M_opponents.end() )
         {
             if ( it->posCount() > 0
@@ -5439,7 +5208,7 @@ WorldModel::checkGhost( const ViewArea & varea )
     }
 
     {
-        std::list< PlayerObject >::iterator it = M_unknown_players.begin();
+        PlayerObject::List::iterator it = M_unknown_players.begin();
         while ( it != M_unknown_players.end() )
         {
             if ( it->posCount() > 0
@@ -5642,13 +5411,7 @@ WorldModel::getPlayers( const PlayerPredicate * predicate ) const
 
     if ( ! predicate ) return rval;
 
-    for( const AbstractPlayerObject * p : allPlayers() )
-    {
-        if ( (*predicate)( *p ) )
-        {
-            rval.push_back( p );
-        }
-    }
+    findPlayers( *predicate, &rval );
 
     delete predicate;
     return rval;
@@ -5665,13 +5428,7 @@ WorldModel::getPlayers( std::shared_ptr< const PlayerPredicate > predicate ) con
 
     if ( ! predicate ) return rval;
 
-    for ( const AbstractPlayerObject * p : allPlayers() )
-    {
-        if ( (*predicate)( *p ) )
-        {
-            rval.push_back( p );
-        }
-    }
+    findPlayers( *predicate, &rval );
 
     return rval;
 }
@@ -5686,13 +5443,7 @@ WorldModel::getPlayers( AbstractPlayerObject::Cont & cont,
 {
     if ( ! predicate ) return;
 
-    for ( const AbstractPlayerObject * p : allPlayers() )
-    {
-        if ( (*predicate)( *p ) )
-        {
-            cont.push_back( p );
-        }
-    }
+    findPlayers( *predicate, &cont );
 
     delete predicate;
 }
@@ -5708,13 +5459,7 @@ WorldModel::getPlayers( AbstractPlayerObject::Cont & cont,
 {
     if ( ! predicate ) return;
 
-    for ( const AbstractPlayerObject * p : allPlayers() )
-    {
-        if ( (*predicate)( *p ) )
-        {
-            cont.push_back( p );
-        }
-    }
+    findPlayers( *predicate, &cont );
 }
 
 /*-------------------------------------------------------------------*/
@@ -5724,17 +5469,9 @@ WorldModel::getPlayers( AbstractPlayerObject::Cont & cont,
 size_t
 WorldModel::countPlayer( const PlayerPredicate * predicate ) const
 {
-    size_t count = 0;
-
-    if ( ! predicate ) return count;
+    if ( ! predicate ) return 0;
 
-    for ( const AbstractPlayerObject * p : allPlayers() )
-    {
-        if ( (*predicate)( *p ) )
-        {
-            ++count;
-        }
-    }
+    const size_t count = findPlayers( *predicate, nullptr );
 
     delete predicate;
     return count;
@@ -5746,15 +5483,48 @@ WorldModel::countPlayer( const PlayerPredicate * predicate ) const
  */
 size_t
 WorldModel::countPlayer( std::shared_ptr< const PlayerPredicate > predicate ) const
+{
+    if ( ! predicate ) return 0;
+
+    const size_t count = findPlayers( *predicate, nullptr );
+
+    return count;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+size_t
+WorldModel::findPlayers( const PlayerPredicate & predicate,
+                         AbstractPlayerObject::Cont * result ) const
 {
     size_t count = 0;
 
-    if ( ! predicate ) return count;
+    Rect2D rect;
+    if ( predicate.boundingRect( &rect ) )
+    {
+        // check only the players around the region, in the order of allPlayers()
+        int indices[PlayerGrid::CAPACITY];
+        const int n = findPlayerIndicesIn( rect, indices );
+        for ( int i = 0; i < n; ++i )
+        {
+            const AbstractPlayerObject * p = M_all_players[indices[i]];
+            if ( predicate( *p ) )
+            {
+                if ( result ) result->push_back( p );
+                ++count;
+            }
+        }
+
+        return count;
+    }
 
-    for ( const AbstractPlayerObject * p : allPlayers() )
+    for ( const AbstractPlayerObject * p : M_all_players )
     {
-        if ( (*predicate)( *p ) )
+        if ( predicate( *p ) )
         {
+            if ( result ) result->push_back( p );
             ++count;
         }
     }
@@ -5762,6 +5532,23 @@ WorldModel::countPlayer( std::shared_ptr< const PlayerPredicate > predicate ) co
     return count;
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+int
+WorldModel::findPlayerIndicesIn( const Rect2D & rect,
+                                 int * indices ) const
+{
+    // a small margin for the rounding error of the region boundary
+    const double eps = 1.0e-3;
+    return M_player_grid.findIndicesIn( Rect2D::from_corners( rect.left() - eps,
+                                                              rect.top() - eps,
+                                                              rect.right() + eps,
+                                                              rect.bottom() + eps ),
+                                        indices );
+}
+
 /*-------------------------------------------------------------------*/
 /*!
 
@@ -5852,4 +5639,37 @@ WorldModel::getPlayerNearestTo( const Vector2D & point,
     return result;
 }
 
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+const PlayerObject *
+WorldModel::getPlayerNearestTo( const Vector2D & point,
+                                const int groups,
+                                const int count_thr,
+                                double * dist_to_point ) const
+{
+    const PlayerGrid::Entry * entry = nullptr;
+    double d2 = 0.0;
+
+    // self is never included in the groups, so the entry is always PlayerObject.
+    if ( M_player_grid.findNearest( point, 1, groups & ~PlayerGrid::SELF,
+                                    [&]( const PlayerGrid::Entry & e )
+                                    {
+                                        return e.player_->posCount() <= count_thr;
+                                    },
+                                    &entry, &d2 ) == 0
+         || d2 >= 40000.0 )
+    {
+        return nullptr;
+    }
+
+    if ( dist_to_point )
+    {
+        *dist_to_point = std::sqrt( d2 );
+    }
+
+    return static_cast< const PlayerObject * >( entry->player_ );
+}
+
 }
@@ -35,6 +35,7 @@
 #include <rcsc/player/self_object.h>
 #include <rcsc/player/ball_object.h>
 #include <rcsc/player/player_object.h>
+#include <rcsc/player/player_grid.h>
 #include <rcsc/player/view_area.h>
 #include <rcsc/player/view_grid_map.h>
 #include <rcsc/player/intercept_table.h>
@@ -56,7 +57,9 @@ class BodySensor;
 class FullstateSensor;
 class Localization;
 class PenaltyKickState;
+class PlayerMatcher;
 class PlayerPredicate;
+template < typename Derived > class PlayerFilter;
 class PlayerType;
 class VisualSensor;
 
@@ -117,6 +120,7 @@ private:
     SelfObject M_self; //!< self object
     BallObject M_ball; //!< current ball object
     BallObject M_prev_ball; //!< ball object in the previous cycle
+    std::unique_ptr< PlayerObjectPool > M_player_pool; //!< storage of all player object instances
     PlayerObject::List M_teammates; //!< teammmates instance. at least, the side information is observed
     PlayerObject::List M_opponents; //!< opponents instance. at least, the side information is observed
     PlayerObject::List M_unknown_players; //!< unknown players instance
@@ -136,6 +140,8 @@ private:
     AbstractPlayerObject::Cont M_our_players; //!< all teammates pointers includes self
     AbstractPlayerObject::Cont M_their_players; //!< all opponents pointers includes unknown
 
+    PlayerGrid M_player_grid; //!< spatial index of all players, includes unknown players
+
     AbstractPlayerObject * M_our_player_array[12]; //!< unum known teammates (include self)
     AbstractPlayerObject * M_their_player_array[12]; //!< unum known opponents (exclude unknown player)
 
@@ -497,36 +503,51 @@ private:
     void localizePlayers( const VisualSensor & see );
 
     /*!
-      \brief check player that has team info
+      \brief remove the stalest unknown players until the player pool has enough free slots
+      \param n the number of required free slots
+      \return true if n slots are available
+    */
+    bool reservePlayerSlots( const int n );
+
+    /*!
+      \brief match the seen players that have team info to the players in memory
       \param side seen side info
-      \param player localized info
+      \param seen localized seen players
+      \param size the number of seen players
       \param old_known_players old team known players
       \param old_unknown_players previous unknown players
       \param new_known_players new team known players
+      \param matcher assignment solver
     */
-    void checkTeamPlayer( const SideID side,
-                          const Localization::PlayerT & player,
-                          PlayerObject::List & old_known_players,
-                          PlayerObject::List & old_unknown_players,
-                          PlayerObject::List & new_known_players );
+    void matchTeamPlayers( const SideID side,
+                           const Localization::PlayerT * seen,
+                           const int size,
+                           PlayerObject::List & old_known_players,
+                           PlayerObject::List & old_unknown_players,
+                           PlayerObject::List & new_known_players,
+                           PlayerMatcher & matcher );
 
     /*!
-      \brief check player that has no identifier. matching to unknown players
-      \param player localized info
+      \brief match the seen players that have no identifier to the players in memory
+      \param seen localized seen players
+      \param size the number of seen players
       \param old_teammates previous seen teammates
       \param old_opponents previous seen opponents
       \param old_unknown_players previous seen unknown player
       \param new_teammates current seen teammates
       \param new_opponents current seen opponents
       \param new_unknown_players current seen unknown players
+      \param matcher assignment solver
     */
-    void checkUnknownPlayer( const Localization::PlayerT & player,
-                             PlayerObject::List & old_teammates,
-                             PlayerObject::List & old_opponent,
-                             PlayerObject::List & old_unknown_players,
-                             PlayerObject::List & new_teammates,
-                             PlayerObject::List & new_opponents,
-                             PlayerObject::List & new_unknown_players );
+    void matchUnknownPlayers( const Localization::PlayerT * seen,
+                              const int size,
+                              PlayerObject::List & old_teammates,
+                              PlayerObject::List & old_opponents,
+                              PlayerObject::List & old_unknown_players,
+                              PlayerObject::List & new_teammates,
+                              PlayerObject::List & new_opponents,
+                              PlayerObject::List & new_unknown_players,
+                              PlayerMatcher & matcher );
 
     /*!
       \brief set collision effect with ball
@@ -835,6 +856,12 @@ public:
      */
     const AbstractPlayerObject::Cont & theirPlayers() const { return M_their_players; }
 
+    /*!
+      \brief get the spatial index of the players. updated with allPlayers().
+      \return const reference to the player grid.
+     */
+    const PlayerGrid & playerGrid() const { return M_player_grid; }
+
     //////////////////////////////////////////////////////////
 
     /*!
@@ -1315,6 +1342,34 @@ public:
      */
     size_t countPlayer( std::shared_ptr< const PlayerPredicate > predicate ) const;
 
+    /*!
+      \brief get the new container of AbstractPlayer matched with the filter expression.
+      This method is defined in player_filter.h.
+      \param filter filter expression object.
+      \return container of AbstractPlayer pointer.
+     */
+    template < typename Filter >
+    AbstractPlayerObject::Cont getPlayers( const PlayerFilter< Filter > & filter ) const;
+
+    /*!
+      \brief get the players matched with the filter expression.
+      This method is defined in player_filter.h.
+      \param result reference to the result variable
+      \param filter filter expression object.
+     */
+    template < typename Filter >
+    void getPlayers( AbstractPlayerObject::Cont & result,
+                     const PlayerFilter< Filter > & filter ) const;
+
+    /*!
+      \brief get the number of players matched with the filter expression.
+      This method is defined in player_filter.h.
+      \param filter filter expression object.
+      \return number of players.
+     */
+    template < typename Filter >
+    size_t countPlayer( const PlayerFilter< Filter > & filter ) const;
+
     /*!
       \brief get a goalie teammate (include self)
       \return if found pointer to goalie object, otherwise NULL
@@ -1329,6 +1384,25 @@ public:
 
 private:
 
+    /*!
+      \brief find the players matched with the predicate.
+      the spatial index is used if the predicate has the bounding rectangle.
+      \param predicate predicate object for the player condition matching.
+      \param result pointer to the result variable, or NULL to count only.
+      \return number of matched players.
+     */
+    size_t findPlayers( const PlayerPredicate & predicate,
+                        AbstractPlayerObject::Cont * result ) const;
+
+    /*!
+      \brief get the indices in allPlayers() of the players around the rectangle.
+      \param rect checked rectangle
+      \param indices array of PlayerGrid::CAPACITY elements to store the result
+      \return number of found players. the result is sorted in ascending order.
+     */
+    int findPlayerIndicesIn( const Rect2D & rect,
+                             int * indices ) const;
+
     /*!
       \brief get player pointer nearest to point (excludes self)
       \param point considered point
@@ -1343,6 +1417,20 @@ private:
                                              const int count_thr,
                                              double * dist_to_point ) const;
 
+    /*!
+      \brief get player pointer nearest to point by the spatial index (excludes self)
+      \param point considered point
+      \param groups PlayerGrid::Group flags of the target players
+      \param count_thr confidence count threshold
+      \param dist_to_point variable pointer to store the distance
+      from retuned player to point
+      \return if found, pointer to player object, othewise NULL
+     */
+    const PlayerObject * getPlayerNearestTo( const Vector2D & point,
+                                             const int groups,
+                                             const int count_thr,
+                                             double * dist_to_point ) const;
+
     /*!
       \brief get the distance from input point to the nearest player
       \param players target players
@@ -1371,7 +1459,7 @@ public:
                                      const int count_thr ) const
       {
           double d = DIST_TOO_FAR;
-          const PlayerObject * p = getPlayerNearestTo( point, teammatesFromSelf(), count_thr, &d );
+          const PlayerObject * p = getPlayerNearestTo( point, PlayerGrid::TEAMMATE, count_thr, &d );
           return ( p ? d : DIST_TOO_FAR );
       }
 
@@ -1385,7 +1473,7 @@ public:
                                      const int count_thr ) const
       {
           double d = DIST_TOO_FAR;
-          const PlayerObject * p = getPlayerNearestTo( point, opponentsFromSelf(), count_thr, &d );
+          const PlayerObject * p = getPlayerNearestTo( point, PlayerGrid::THEIR_PLAYERS, count_thr, &d );
           return ( p ? d : DIST_TOO_FAR );
       }
 
@@ -1401,7 +1489,7 @@ public:
                                                const int count_thr,
                                                double * dist_to_point ) const
       {
-          return getPlayerNearestTo( point, teammatesFromSelf(), count_thr, dist_to_point );
+          return getPlayerNearestTo( point, PlayerGrid::TEAMMATE, count_thr, dist_to_point );
       }
 
     /*!
@@ -1432,7 +1520,7 @@ public:
                                                const int count_thr,
                                                double * dist_to_point ) const
       {
-          return getPlayerNearestTo( point, opponentsFromSelf(), count_thr, dist_to_point );
+          return getPlayerNearestTo( point, PlayerGrid::THEIR_PLAYERS, count_thr, dist_to_point );
       }
 
     /*!
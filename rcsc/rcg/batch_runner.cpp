@@ -0,0 +1,304 @@
+// -*-c++-*-
+
+/*!
+  \file batch_runner.cpp
+  \brief parallel rcg batch processing driver Source File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "batch_runner.h"
+
+#include "parser.h"
+#include "handler.h"
+
+#include <rcsc/gz/gzfstream.h>
+#include <rcsc/time/timer.h>
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+namespace rcsc {
+namespace rcg {
+
+namespace {
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+is_rcg_file( const std::filesystem::path & path )
+{
+    const std::string name = path.filename().string();
+
+    const auto ends_with = [&]( const char * suffix )
+                             {
+                                 const std::string s( suffix );
+                                 return ( name.length() >= s.length()
+                                          && name.compare( name.length() - s.length(), s.length(), s ) == 0 );
+                             };
+
+    return ends_with( ".rcg" ) || ends_with( ".rcg.gz" );
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+BatchRunner::BatchRunner( HandlerCreator creator )
+    : M_creator( creator ),
+      M_thread_count( 1 ),
+      M_elapsed_msec( 0.0 )
+{
+    setThreadCount( 0 );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+BatchRunner::setThreadCount( const int count )
+{
+    if ( count > 0 )
+    {
+        M_thread_count = count;
+    }
+    else
+    {
+        M_thread_count = std::max( 1, static_cast< int >( std::thread::hardware_concurrency() ) );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::size_t
+BatchRunner::collect_files( const std::string & path,
+                            std::vector< std::string > & files )
+{
+    std::error_code ec;
+    if ( ! std::filesystem::is_directory( path, ec ) )
+    {
+        files.push_back( path );
+        return 1;
+    }
+
+    std::vector< std::string > dir_files;
+    for ( const std::filesystem::directory_entry & entry : std::filesystem::directory_iterator( path, ec ) )
+    {
+        if ( entry.is_regular_file( ec )
+             && is_rcg_file( entry.path() ) )
+        {
+            dir_files.push_back( entry.path().string() );
+        }
+    }
+
+    if ( ec )
+    {
+        std::cerr << "(BatchRunner::collect_files) " << path << ": " << ec.message() << std::endl;
+    }
+
+    std::sort( dir_files.begin(), dir_files.end() );
+    files.insert( files.end(), dir_files.begin(), dir_files.end() );
+
+    return dir_files.size();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+BatchRunner::run( const std::vector< std::string > & files )
+{
+    M_results.clear();
+    M_results.resize( files.size() );
+    M_elapsed_msec = 0.0;
+
+    if ( files.empty() )
+    {
+        return true;
+    }
+
+    const std::size_t n_threads = std::min( static_cast< std::size_t >( M_thread_count ), files.size() );
+
+    std::atomic< std::size_t > next_index( 0 );
+
+    const auto worker = [&]()
+                          {
+                              for ( std::size_t i = next_index++; i < files.size(); i = next_index++ )
+                              {
+                                  processFile( i, files[i] );
+                              }
+                          };
+
+    rcsc::Timer timer;
+
+    std::vector< std::thread > threads;
+    threads.reserve( n_threads - 1 );
+    for ( std::size_t i = 1; i < n_threads; ++i )
+    {
+        threads.emplace_back( worker );
+    }
+
+    worker(); // the calling thread is also used as a worker.
+
+    for ( std::thread & t : threads )
+    {
+        t.join();
+    }
+
+    M_elapsed_msec = timer.elapsedReal();
+
+    return std::all_of( M_results.begin(), M_results.end(),
+                        []( const Result & r ) { return r.success_; } );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+BatchRunner::processFile( const std::size_t index,
+                          const std::string & filepath )
+{
+    // each worker only touches its own result slot.
+    Result & result = M_results[index];
+    result.filepath_ = filepath;
+
+    std::error_code ec;
+    result.file_size_ = std::filesystem::file_size( filepath, ec );
+    if ( ec )
+    {
+        result.file_size_ = 0;
+    }
+
+    rcsc::Timer timer;
+
+    rcsc::gzifstream fin( filepath.c_str() );
+    if ( ! fin.is_open() )
+    {
+        std::cerr << "(BatchRunner) Failed to open file : " << filepath << std::endl;
+        return;
+    }
+
+    Parser::Ptr parser = Parser::create( fin );
+    if ( ! parser )
+    {
+        std::cerr << "(BatchRunner) Failed to create rcg parser for " << filepath << std::endl;
+        return;
+    }
+
+    std::ostringstream os;
+    std::shared_ptr< Handler > handler = M_creator( filepath, os, index );
+    if ( ! handler )
+    {
+        std::cerr << "(BatchRunner) Failed to create rcg handler for " << filepath << std::endl;
+        return;
+    }
+
+    result.success_ = parser->parse( fin, *handler );
+    if ( ! result.success_ )
+    {
+        std::cerr << "(BatchRunner) Failed to parse [" << filepath << "]" << std::endl;
+    }
+
+    handler.reset();
+    result.output_ = os.str();
+    result.elapsed_msec_ = timer.elapsedReal();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::ostream &
+BatchRunner::printOutputs( std::ostream & os ) const
+{
+    for ( const Result & r : M_results )
+    {
+        os << r.output_;
+    }
+
+    return os;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::ostream &
+BatchRunner::printStatistics( std::ostream & os ) const
+{
+    std::size_t n_success = 0;
+    std::uintmax_t total_bytes = 0;
+    double total_busy_msec = 0.0;
+
+    for ( const Result & r : M_results )
+    {
+        if ( r.success_ ) ++n_success;
+        total_bytes += r.file_size_;
+        total_busy_msec += r.elapsed_msec_;
+    }
+
+    const std::size_t n_threads = std::max< std::size_t >( 1, std::min( static_cast< std::size_t >( M_thread_count ),
+                                                                        M_results.size() ) );
+    const double sec = M_elapsed_msec * 0.001;
+    const double mb = total_bytes / ( 1024.0 * 1024.0 );
+    const double files_per_sec = ( sec > 0.0 ? M_results.size() / sec : 0.0 );
+    const double mb_per_sec = ( sec > 0.0 ? mb / sec : 0.0 );
+    const double efficiency = ( M_elapsed_msec > 0.0
+                                ? total_busy_msec / ( M_elapsed_msec * n_threads )
+                                : 0.0 );
+
+    os << "files: " << M_results.size() << " (success " << n_success << ")\n"
+       << "threads: " << n_threads << '\n'
+       << "elapsed: " << M_elapsed_msec << " [ms]\n"
+       << "input: " << mb << " [MB]\n"
+       << "throughput: " << files_per_sec << " [files/s] "
+       << mb_per_sec << " [MB/s]\n"
+       << "throughput per thread: " << files_per_sec / n_threads << " [files/s] "
+       << mb_per_sec / n_threads << " [MB/s]\n"
+       << "thread utilization: " << efficiency * 100.0 << " [%]"
+       << std::endl;
+
+    return os;
+}
+
+} // end of namespace
+} // end of namespace
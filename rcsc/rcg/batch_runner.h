@@ -0,0 +1,182 @@
+// -*-c++-*-
+
+/*!
+  \file batch_runner.h
+  \brief parallel rcg batch processing driver Header File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_RCG_BATCH_RUNNER_H
+#define RCSC_RCG_BATCH_RUNNER_H
+
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <vector>
+#include <string>
+#include <cstdint>
+
+namespace rcsc {
+namespace rcg {
+
+class Handler;
+
+/*!
+  \class BatchRunner
+  \brief parse many rcg files in parallel by a pool of worker threads.
+
+  Each worker opens its own gzifstream and creates its own Parser and
+  Handler for every log file. The handler writes its result into the
+  per-log buffer given by the runner, and all buffers are merged in the
+  order of the input files.
+ */
+class BatchRunner {
+public:
+
+    /*!
+      \brief handler creator function.
+
+      The first argument is the path to the log file. The second argument
+      is the output stream for that log file. The third argument is the
+      index of the log file in the input list.
+     */
+    typedef std::function< std::shared_ptr< Handler >( const std::string &,
+                                                       std::ostream &,
+                                                       const std::size_t ) > HandlerCreator;
+
+    /*!
+      \struct Result
+      \brief result of one log file
+     */
+    struct Result {
+        std::string filepath_; //!< input file path
+        bool success_; //!< parse status
+        std::string output_; //!< output written by the handler
+        std::uintmax_t file_size_; //!< file size in bytes
+        double elapsed_msec_; //!< elapsed time to process this file
+
+        Result()
+            : success_( false ),
+              file_size_( 0 ),
+              elapsed_msec_( 0.0 )
+          { }
+    };
+
+private:
+
+    HandlerCreator M_creator; //!< handler creator function
+    int M_thread_count; //!< the number of worker threads
+
+    std::vector< Result > M_results; //!< results of the last run
+    double M_elapsed_msec; //!< wall clock time of the last run
+
+    // not used
+    BatchRunner() = delete;
+
+public:
+
+    /*!
+      \brief construct with the handler creator
+      \param creator handler creator function
+     */
+    explicit
+    BatchRunner( HandlerCreator creator );
+
+    /*!
+      \brief set the number of worker threads
+      \param count the number of threads. if count <= 0, the number of hardware threads is used.
+     */
+    void setThreadCount( const int count );
+
+    /*!
+      \brief get the number of worker threads
+      \return the number of threads
+     */
+    int threadCount() const
+      {
+          return M_thread_count;
+      }
+
+    /*!
+      \brief collect log files. If the path is a directory, *.rcg and *.rcg.gz files in it are collected.
+      \param path file or directory path
+      \param files reference to the result container
+      \return the number of added files
+     */
+    static
+    std::size_t collect_files( const std::string & path,
+                               std::vector< std::string > & files );
+
+    /*!
+      \brief process all files.
+      \param files input file paths
+      \return true if all files are successfully processed.
+     */
+    bool run( const std::vector< std::string > & files );
+
+    /*!
+      \brief get the results of the last run
+      \return const reference to the result container
+     */
+    const std::vector< Result > & results() const
+      {
+          return M_results;
+      }
+
+    /*!
+      \brief get the wall clock time of the last run
+      \return elapsed milliseconds
+     */
+    double elapsedMSec() const
+      {
+          return M_elapsed_msec;
+      }
+
+    /*!
+      \brief print merged outputs in the order of the input files
+      \param os reference to the output stream
+      \return reference to the output stream
+     */
+    std::ostream & printOutputs( std::ostream & os ) const;
+
+    /*!
+      \brief print throughput statistics of the last run
+      \param os reference to the output stream
+      \return reference to the output stream
+     */
+    std::ostream & printStatistics( std::ostream & os ) const;
+
+private:
+
+    void processFile( const std::size_t index,
+                      const std::string & filepath );
+
+};
+
+} // end of namespace
+} // end of namespace
+
+#endif
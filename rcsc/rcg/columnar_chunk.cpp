@@ -0,0 +1,707 @@
+// -*-c++-*-
+
+/*!
+  \file columnar_chunk.cpp
+  \brief binary columnar rcg chunk codec Source File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "columnar_chunk.h"
+
+#ifdef HAVE_LIBZ
+#include <zlib.h>
+#endif
+
+#include <algorithm>
+#include <iostream>
+#include <cstring>
+
+namespace rcsc {
+namespace rcg {
+
+const std::uint32_t ColumnarChunk::FORMAT_REVISION = 1;
+
+namespace {
+
+const std::uint8_t ENCODING_RAW = 0;
+const std::uint8_t ENCODING_ZLIB = 1;
+
+//! block header size: encoding(1) + raw size(4) + stored size(4)
+const std::size_t BLOCK_HEADER_SIZE = 9;
+
+//! upper bound of the block size to reject broken data
+const std::uint32_t MAX_BLOCK_SIZE = 256 * 1024 * 1024;
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief put the little endian value
+ */
+template < typename B >
+void
+put_bits( std::string & buf,
+          const B val )
+{
+    for ( std::size_t b = 0; b < sizeof( B ); ++b )
+    {
+        buf.push_back( static_cast< char >( ( val >> ( 8 * b ) ) & 0xFF ) );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief get the little endian value
+ */
+template < typename B >
+B
+get_bits( const char * p )
+{
+    B val = 0;
+    for ( std::size_t b = 0; b < sizeof( B ); ++b )
+    {
+        val |= static_cast< B >( static_cast< B >( static_cast< unsigned char >( p[b] ) ) << ( 8 * b ) );
+    }
+    return val;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief put the length prefixed string
+ */
+template < typename L >
+void
+put_string( std::string & buf,
+            const std::string & str )
+{
+    put_bits< L >( buf, static_cast< L >( str.length() ) );
+    buf.append( str, 0, static_cast< L >( str.length() ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \class ByteReader
+  \brief bounds checked little endian reader
+ */
+class ByteReader {
+private:
+    const char * M_p;
+    const char * M_end;
+    bool M_ok;
+
+public:
+    ByteReader( const std::string & buf )
+        : M_p( buf.data() ),
+          M_end( buf.data() + buf.size() ),
+          M_ok( true )
+      { }
+
+    bool ok() const { return M_ok; }
+    bool atEnd() const { return M_p == M_end; }
+    std::size_t remaining() const { return M_end - M_p; }
+
+    const char * take( const std::size_t len )
+      {
+          if ( ! M_ok
+               || static_cast< std::size_t >( M_end - M_p ) < len )
+          {
+              M_ok = false;
+              return nullptr;
+          }
+          const char * p = M_p;
+          M_p += len;
+          return p;
+      }
+
+    template < typename B >
+    B get()
+      {
+          const char * p = take( sizeof( B ) );
+          return ( p ? get_bits< B >( p ) : 0 );
+      }
+
+    template < typename L >
+    std::string getString()
+      {
+          const L len = get< L >();
+          const char * p = take( len );
+          return ( p ? std::string( p, len ) : std::string() );
+      }
+};
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief column codec of integer fields: delta from the previous frame.
+ */
+template < typename T, typename B >
+struct IntegerColumn {
+    typedef B bits_type;
+
+    static B to_bits( const T val ) { return static_cast< B >( val ); }
+    static T from_bits( const B bits ) { return static_cast< T >( bits ); }
+    static B encode( const B val, const B prev ) { return static_cast< B >( val - prev ); }
+    static B decode( const B code, const B prev ) { return static_cast< B >( code + prev ); }
+};
+
+template < typename T >
+struct ColumnTraits;
+
+template <>
+struct ColumnTraits< char >
+    : public IntegerColumn< char, std::uint8_t > {
+};
+
+template <>
+struct ColumnTraits< Int16 >
+    : public IntegerColumn< Int16, std::uint16_t > {
+};
+
+template <>
+struct ColumnTraits< UInt16 >
+    : public IntegerColumn< UInt16, std::uint16_t > {
+};
+
+template <>
+struct ColumnTraits< Int32 >
+    : public IntegerColumn< Int32, std::uint32_t > {
+};
+
+/*!
+  \brief column codec of float fields: xor with the previous frame.
+  Unchanged values become zero and small changes keep the upper bytes zero.
+ */
+template <>
+struct ColumnTraits< float > {
+    typedef std::uint32_t bits_type;
+
+    static std::uint32_t to_bits( const float val )
+      {
+          std::uint32_t bits;
+          std::memcpy( &bits, &val, sizeof( bits ) );
+          return bits;
+      }
+    static float from_bits( const std::uint32_t bits )
+      {
+          float val;
+          std::memcpy( &val, &bits, sizeof( val ) );
+          return val;
+      }
+    static std::uint32_t encode( const std::uint32_t val, const std::uint32_t prev ) { return val ^ prev; }
+    static std::uint32_t decode( const std::uint32_t code, const std::uint32_t prev ) { return code ^ prev; }
+};
+
+/*-------------------------------------------------------------------*/
+/*!
+  \class ColumnEncoder
+  \brief append each column as byte planes
+ */
+class ColumnEncoder {
+private:
+    const std::vector< ShowInfoT > & M_frames;
+    std::string & M_buf;
+
+    template < typename T, typename Get >
+    void column( Get get )
+      {
+          typedef ColumnTraits< T > Traits;
+          typedef typename Traits::bits_type B;
+
+          const std::size_t n = M_frames.size();
+          std::vector< B > codes( n );
+
+          B prev = 0;
+          for ( std::size_t i = 0; i < n; ++i )
+          {
+              const B val = Traits::to_bits( get( M_frames[i] ) );
+              codes[i] = Traits::encode( val, prev );
+              prev = val;
+          }
+
+          for ( std::size_t b = 0; b < sizeof( B ); ++b )
+          {
+              for ( std::size_t i = 0; i < n; ++i )
+              {
+                  M_buf.push_back( static_cast< char >( ( codes[i] >> ( 8 * b ) ) & 0xFF ) );
+              }
+          }
+      }
+
+public:
+    ColumnEncoder( const std::vector< ShowInfoT > & frames,
+                   std::string & buf )
+        : M_frames( frames ),
+          M_buf( buf )
+      { }
+
+    template < typename T >
+    void show( T ShowInfoT::*m )
+      {
+          column< T >( [m]( const ShowInfoT & s ) { return s.*m; } );
+      }
+
+    template < typename T >
+    void ball( T BallT::*m )
+      {
+          column< T >( [m]( const ShowInfoT & s ) { return s.ball_.*m; } );
+      }
+
+    template < typename T >
+    void player( const int idx,
+                 T PlayerT::*m )
+      {
+          column< T >( [m, idx]( const ShowInfoT & s ) { return s.player_[idx].*m; } );
+      }
+};
+
+/*-------------------------------------------------------------------*/
+/*!
+  \class ColumnDecoder
+  \brief restore each column from byte planes
+ */
+class ColumnDecoder {
+private:
+    std::vector< ShowInfoT > & M_frames;
+    ByteReader & M_reader;
+
+    template < typename T, typename Get >
+    void column( Get get )
+      {
+          typedef ColumnTraits< T > Traits;
+          typedef typename Traits::bits_type B;
+
+          const std::size_t n = M_frames.size();
+          const char * p = M_reader.take( n * sizeof( B ) );
+          if ( ! p )
+          {
+              return;
+          }
+
+          B prev = 0;
+          for ( std::size_t i = 0; i < n; ++i )
+          {
+              B code = 0;
+              for ( std::size_t b = 0; b < sizeof( B ); ++b )
+              {
+                  code |= static_cast< B >( static_cast< B >( static_cast< unsigned char >( p[b * n + i] ) ) << ( 8 * b ) );
+              }
+              prev = Traits::decode( code, prev );
+              get( M_frames[i] ) = Traits::from_bits( prev );
+          }
+      }
+
+public:
+    ColumnDecoder( std::vector< ShowInfoT > & frames,
+                   ByteReader & reader )
+        : M_frames( frames ),
+          M_reader( reader )
+      { }
+
+    template < typename T >
+    void show( T ShowInfoT::*m )
+      {
+          column< T >( [m]( ShowInfoT & s ) -> T & { return s.*m; } );
+      }
+
+    template < typename T >
+    void ball( T BallT::*m )
+      {
+          column< T >( [m]( ShowInfoT & s ) -> T & { return s.ball_.*m; } );
+      }
+
+    template < typename T >
+    void player( const int idx,
+                 T PlayerT::*m )
+      {
+          column< T >( [m, idx]( ShowInfoT & s ) -> T & { return s.player_[idx].*m; } );
+      }
+};
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief apply the operation to all columns in the stored order.
+ */
+template < typename Op >
+void
+visit_columns( Op & op )
+{
+    op.show( &ShowInfoT::time_ );
+
+    op.ball( &BallT::x_ );
+    op.ball( &BallT::y_ );
+    op.ball( &BallT::vx_ );
+    op.ball( &BallT::vy_ );
+
+    for ( int i = 0; i < MAX_PLAYER * 2; ++i )
+    {
+        op.player( i, &PlayerT::side_ );
+        op.player( i, &PlayerT::unum_ );
+        op.player( i, &PlayerT::type_ );
+        op.player( i, &PlayerT::view_quality_ );
+        op.player( i, &PlayerT::focus_side_ );
+        op.player( i, &PlayerT::focus_unum_ );
+        op.player( i, &PlayerT::state_ );
+
+        op.player( i, &PlayerT::x_ );
+        op.player( i, &PlayerT::y_ );
+        op.player( i, &PlayerT::vx_ );
+        op.player( i, &PlayerT::vy_ );
+        op.player( i, &PlayerT::body_ );
+        op.player( i, &PlayerT::neck_ );
+        op.player( i, &PlayerT::point_x_ );
+        op.player( i, &PlayerT::point_y_ );
+        op.player( i, &PlayerT::view_width_ );
+        op.player( i, &PlayerT::focus_dist_ );
+        op.player( i, &PlayerT::focus_dir_ );
+        op.player( i, &PlayerT::stamina_ );
+        op.player( i, &PlayerT::effort_ );
+        op.player( i, &PlayerT::recovery_ );
+        op.player( i, &PlayerT::stamina_capacity_ );
+
+        op.player( i, &PlayerT::kick_count_ );
+        op.player( i, &PlayerT::dash_count_ );
+        op.player( i, &PlayerT::turn_count_ );
+        op.player( i, &PlayerT::catch_count_ );
+        op.player( i, &PlayerT::move_count_ );
+        op.player( i, &PlayerT::turn_neck_count_ );
+        op.player( i, &PlayerT::change_view_count_ );
+        op.player( i, &PlayerT::say_count_ );
+        op.player( i, &PlayerT::tackle_count_ );
+        op.player( i, &PlayerT::pointto_count_ );
+        op.player( i, &PlayerT::attentionto_count_ );
+        op.player( i, &PlayerT::change_focus_count_ );
+    }
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::ostream &
+ColumnarChunk::write_header( std::ostream & os )
+{
+    std::string buf( "ULGC" );
+    put_bits< std::uint32_t >( buf, FORMAT_REVISION );
+
+    return os.write( buf.data(), buf.size() );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+ColumnarChunk::read_header( std::istream & is )
+{
+    char header[8];
+    is.read( header, 8 );
+
+    if ( is.gcount() != 8
+         || std::strncmp( header, "ULGC", 4 ) != 0 )
+    {
+        std::cerr << "(ColumnarChunk::read_header) illegal header." << std::endl;
+        return false;
+    }
+
+    const std::uint32_t revision = get_bits< std::uint32_t >( header + 4 );
+    if ( revision != FORMAT_REVISION )
+    {
+        std::cerr << "(ColumnarChunk::read_header) unsupported format revision "
+                  << revision << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+ColumnarChunk::addEvent( const Event & event )
+{
+    M_events.push_back( event );
+    M_events.back().frame_ = static_cast< std::uint32_t >( M_frames.size() );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+ColumnarChunk::write( std::ostream & os,
+                      const int compression_level ) const
+{
+    std::string raw;
+    encode( raw );
+
+    if ( raw.size() > MAX_BLOCK_SIZE )
+    {
+        std::cerr << "(ColumnarChunk::write) too large chunk." << std::endl;
+        return false;
+    }
+
+    std::uint8_t encoding = ENCODING_RAW;
+    std::string stored;
+
+#ifdef HAVE_LIBZ
+    if ( compression_level > 0 )
+    {
+        uLongf len = compressBound( raw.size() );
+        stored.resize( len );
+        if ( compress2( reinterpret_cast< Bytef * >( &stored[0] ), &len,
+                        reinterpret_cast< const Bytef * >( raw.data() ), raw.size(),
+                        std::min( compression_level, 9 ) ) == Z_OK
+             && len < raw.size() )
+        {
+            stored.resize( len );
+            encoding = ENCODING_ZLIB;
+        }
+    }
+#else
+    (void)compression_level;
+#endif
+
+    const std::string & data = ( encoding == ENCODING_ZLIB ? stored : raw );
+
+    std::string header;
+    put_bits< std::uint8_t >( header, encoding );
+    put_bits< std::uint32_t >( header, static_cast< std::uint32_t >( raw.size() ) );
+    put_bits< std::uint32_t >( header, static_cast< std::uint32_t >( data.size() ) );
+
+    os.write( header.data(), header.size() );
+    os.write( data.data(), data.size() );
+
+    return os.good();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+ColumnarChunk::read( std::istream & is )
+{
+    clear();
+
+    char header[BLOCK_HEADER_SIZE];
+    is.read( header, BLOCK_HEADER_SIZE );
+    if ( is.gcount() != static_cast< std::streamsize >( BLOCK_HEADER_SIZE ) )
+    {
+        std::cerr << "(ColumnarChunk::read) truncated block header." << std::endl;
+        return false;
+    }
+
+    const std::uint8_t encoding = get_bits< std::uint8_t >( header );
+    const std::uint32_t raw_size = get_bits< std::uint32_t >( header + 1 );
+    const std::uint32_t stored_size = get_bits< std::uint32_t >( header + 5 );
+
+    if ( raw_size > MAX_BLOCK_SIZE
+         || stored_size > MAX_BLOCK_SIZE
+         || ( encoding == ENCODING_RAW && raw_size != stored_size ) )
+    {
+        std::cerr << "(ColumnarChunk::read) illegal block size." << std::endl;
+        return false;
+    }
+
+    std::string stored( stored_size, '\0' );
+    is.read( &stored[0], stored_size );
+    if ( is.gcount() != static_cast< std::streamsize >( stored_size ) )
+    {
+        std::cerr << "(ColumnarChunk::read) truncated block." << std::endl;
+        return false;
+    }
+
+    if ( encoding == ENCODING_RAW )
+    {
+        return decode( stored );
+    }
+
+    if ( encoding == ENCODING_ZLIB )
+    {
+#ifdef HAVE_LIBZ
+        std::string raw( raw_size, '\0' );
+        uLongf len = raw_size;
+        if ( uncompress( reinterpret_cast< Bytef * >( &raw[0] ), &len,
+                         reinterpret_cast< const Bytef * >( stored.data() ), stored_size ) != Z_OK
+             || len != raw_size )
+        {
+            std::cerr << "(ColumnarChunk::read) failed to uncompress the block." << std::endl;
+            return false;
+        }
+        return decode( raw );
+#else
+        std::cerr << "(ColumnarChunk::read) zlib is not available." << std::endl;
+        return false;
+#endif
+    }
+
+    std::cerr << "(ColumnarChunk::read) unknown block encoding "
+              << static_cast< int >( encoding ) << std::endl;
+    return false;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+ColumnarChunk::encode( std::string & buf ) const
+{
+    buf.clear();
+    buf.reserve( 64 + M_frames.size() * 2048 );
+
+    put_bits< std::uint32_t >( buf, static_cast< std::uint32_t >( M_frames.size() ) );
+    put_bits< std::uint32_t >( buf, static_cast< std::uint32_t >( M_events.size() ) );
+
+    for ( const Event & e : M_events )
+    {
+        put_bits< std::uint8_t >( buf, static_cast< std::uint8_t >( e.type_ ) );
+        put_bits< std::uint32_t >( buf, e.frame_ );
+        put_bits< std::uint32_t >( buf, static_cast< std::uint32_t >( e.time_ ) );
+
+        switch ( e.type_ ) {
+        case SERVER_PARAM:
+        case PLAYER_PARAM:
+        case PLAYER_TYPE:
+            put_string< std::uint32_t >( buf, e.text_ );
+            break;
+        case PLAYMODE:
+            put_bits< std::uint32_t >( buf, static_cast< std::uint32_t >( e.value_ ) );
+            break;
+        case TEAM:
+            for ( const TeamT & t : e.team_ )
+            {
+                put_string< std::uint16_t >( buf, t.name_ );
+                put_bits< std::uint16_t >( buf, t.score_ );
+                put_bits< std::uint16_t >( buf, t.pen_score_ );
+                put_bits< std::uint16_t >( buf, t.pen_miss_ );
+            }
+            break;
+        case MSG:
+            put_bits< std::uint32_t >( buf, static_cast< std::uint32_t >( e.value_ ) );
+            put_string< std::uint32_t >( buf, e.text_ );
+            break;
+        default:
+            break;
+        }
+    }
+
+    ColumnEncoder encoder( M_frames, buf );
+    visit_columns( encoder );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+ColumnarChunk::decode( const std::string & buf )
+{
+    ByteReader reader( buf );
+
+    const std::uint32_t n_frames = reader.get< std::uint32_t >();
+    const std::uint32_t n_events = reader.get< std::uint32_t >();
+
+    if ( ! reader.ok()
+         || n_frames > reader.remaining()
+         || n_events > reader.remaining() )
+    {
+        std::cerr << "(ColumnarChunk::decode) illegal chunk size." << std::endl;
+        return false;
+    }
+
+    std::uint32_t prev_frame = 0;
+
+    M_events.resize( n_events );
+    for ( Event & e : M_events )
+    {
+        const std::uint8_t type = reader.get< std::uint8_t >();
+        e.frame_ = reader.get< std::uint32_t >();
+        e.time_ = static_cast< Int32 >( reader.get< std::uint32_t >() );
+
+        switch ( type ) {
+        case SERVER_PARAM:
+        case PLAYER_PARAM:
+        case PLAYER_TYPE:
+            e.text_ = reader.getString< std::uint32_t >();
+            break;
+        case PLAYMODE:
+            e.value_ = static_cast< Int32 >( reader.get< std::uint32_t >() );
+            break;
+        case TEAM:
+            for ( TeamT & t : e.team_ )
+            {
+                t.name_ = reader.getString< std::uint16_t >();
+                t.score_ = reader.get< std::uint16_t >();
+                t.pen_score_ = reader.get< std::uint16_t >();
+                t.pen_miss_ = reader.get< std::uint16_t >();
+            }
+            break;
+        case MSG:
+            e.value_ = static_cast< Int32 >( reader.get< std::uint32_t >() );
+            e.text_ = reader.getString< std::uint32_t >();
+            break;
+        default:
+            std::cerr << "(ColumnarChunk::decode) unknown event type "
+                      << static_cast< int >( type ) << std::endl;
+            return false;
+        }
+
+        e.type_ = static_cast< EventType >( type );
+
+        if ( ! reader.ok()
+             || e.frame_ < prev_frame
+             || e.frame_ > n_frames )
+        {
+            std::cerr << "(ColumnarChunk::decode) illegal event." << std::endl;
+            return false;
+        }
+
+        prev_frame = e.frame_;
+    }
+
+    M_frames.resize( n_frames );
+
+    ColumnDecoder decoder( M_frames, reader );
+    visit_columns( decoder );
+
+    if ( ! reader.ok()
+         || ! reader.atEnd() )
+    {
+        std::cerr << "(ColumnarChunk::decode) illegal column data." << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+} // end of namespace
+} // end of namespace
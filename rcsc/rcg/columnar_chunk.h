@@ -0,0 +1,200 @@
+// -*-c++-*-
+
+/*!
+  \file columnar_chunk.h
+  \brief binary columnar rcg chunk codec Header File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_RCG_COLUMNAR_CHUNK_H
+#define RCSC_RCG_COLUMNAR_CHUNK_H
+
+#include <rcsc/rcg/types.h>
+
+#include <vector>
+#include <string>
+#include <istream>
+#include <ostream>
+#include <cstdint>
+
+namespace rcsc {
+namespace rcg {
+
+/*!
+  \class ColumnarChunk
+  \brief a block of show frames and events in the binary columnar rcg.
+
+  The file consists of the 8 bytes header ('U', 'L', 'G', 'C' and the
+  little endian uint32 format revision) followed by the chunk blocks.
+
+  Each block has the encoding type (uint8, 0: raw, 1: zlib), the raw
+  payload size (uint32) and the stored size (uint32). The payload contains
+  the event records (parameters, playmode, team and message) with the index
+  of the frame that they precede, and then the frames stored column by
+  column. Every column is the sequence of one field over all frames in the
+  chunk. Integer fields are delta coded and float fields are xor coded
+  against the previous frame, and the bytes of each column are split into
+  byte planes so that the deflate compressor can find the redundancy.
+ */
+class ColumnarChunk {
+public:
+
+    //! revision number of the container format
+    static const std::uint32_t FORMAT_REVISION;
+
+    /*!
+      \enum EventType
+      \brief non-show record types
+     */
+    enum EventType {
+        SERVER_PARAM = 1,
+        PLAYER_PARAM = 2,
+        PLAYER_TYPE = 3,
+        PLAYMODE = 4,
+        TEAM = 5,
+        MSG = 6,
+    };
+
+    /*!
+      \struct Event
+      \brief non-show record
+     */
+    struct Event {
+        EventType type_; //!< record type
+        std::uint32_t frame_; //!< index of the frame that this event precedes
+        Int32 time_; //!< game time of the last show
+        Int32 value_; //!< playmode id or message board type
+        std::string text_; //!< parameter or message string
+        TeamT team_[2]; //!< team data
+
+        Event()
+            : type_( PLAYMODE ),
+              frame_( 0 ),
+              time_( 0 ),
+              value_( 0 )
+          { }
+    };
+
+private:
+
+    std::vector< ShowInfoT > M_frames; //!< show frames
+    std::vector< Event > M_events; //!< events ordered by frame index
+
+public:
+
+    /*!
+      \brief write the file header.
+      \param os reference to the output stream
+      \return reference to the output stream
+     */
+    static
+    std::ostream & write_header( std::ostream & os );
+
+    /*!
+      \brief read and check the file header.
+      \param is reference to the input stream
+      \return true if the header is valid and supported
+     */
+    static
+    bool read_header( std::istream & is );
+
+    /*!
+      \brief clear all data.
+     */
+    void clear()
+      {
+          M_frames.clear();
+          M_events.clear();
+      }
+
+    /*!
+      \brief check if no data are stored.
+      \return checked result
+     */
+    bool empty() const
+      {
+          return M_frames.empty() && M_events.empty();
+      }
+
+    /*!
+      \brief get the stored frames.
+      \return const reference to the frame container.
+     */
+    const std::vector< ShowInfoT > & frames() const
+      {
+          return M_frames;
+      }
+
+    /*!
+      \brief get the stored events.
+      \return const reference to the event container.
+     */
+    const std::vector< Event > & events() const
+      {
+          return M_events;
+      }
+
+    /*!
+      \brief append a frame.
+      \param show show data
+     */
+    void addFrame( const ShowInfoT & show )
+      {
+          M_frames.push_back( show );
+      }
+
+    /*!
+      \brief append an event that precedes the next frame.
+      \param event event data. frame_ is overwritten.
+     */
+    void addEvent( const Event & event );
+
+    /*!
+      \brief encode the chunk and write it as a block.
+      \param os reference to the output stream
+      \param compression_level zlib compression level (0-9). 0 means no compression.
+      \return true if successfully written.
+     */
+    bool write( std::ostream & os,
+                const int compression_level ) const;
+
+    /*!
+      \brief read one block and decode it.
+      \param is reference to the input stream
+      \return true if successfully decoded.
+     */
+    bool read( std::istream & is );
+
+private:
+
+    void encode( std::string & buf ) const;
+    bool decode( const std::string & buf );
+};
+
+} // end of namespace
+} // end of namespace
+
+#endif
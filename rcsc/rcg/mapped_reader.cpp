@@ -0,0 +1,544 @@
+// -*-c++-*-
+
+/*!
+  \file mapped_reader.cpp
+  \brief memory mapped rcg reader with the frame index Source File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "mapped_reader.h"
+
+#include "handler.h"
+#include "types.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <charconv>
+#include <cstring>
+
+#ifdef HAVE_UNISTD_H
+#include <unistd.h> // close()
+#endif
+#ifdef HAVE_FCNTL_H
+#include <fcntl.h> // open()
+#endif
+#ifdef HAVE_SYS_STAT_H
+#include <sys/stat.h> // fstat()
+#endif
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h> // mmap(), munmap()
+#endif
+
+namespace rcsc {
+namespace rcg {
+
+const std::size_t MappedReader::npos = static_cast< std::size_t >( -1 );
+
+namespace {
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief check if the line starts with the given keyword.
+ */
+inline
+bool
+starts_with( const char * begin,
+             const char * end,
+             const char * keyword,
+             const std::size_t len )
+{
+    while ( begin < end && *begin == ' ' ) ++begin;
+    return ( static_cast< std::size_t >( end - begin ) >= len
+             && ! std::memcmp( begin, keyword, len ) );
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+MappedReader::MappedReader()
+    : M_data( nullptr ),
+      M_size( 0 ),
+      M_mapped( false ),
+      M_version( 0 ),
+      M_header_begin( 0 ),
+      M_header_end( 0 )
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+MappedReader::~MappedReader()
+{
+    close();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+MappedReader::open( const std::string & filepath )
+{
+    close();
+
+    if ( ! map( filepath ) )
+    {
+        return false;
+    }
+
+    M_filepath = filepath;
+
+    if ( ! buildIndex() )
+    {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+MappedReader::close()
+{
+    unmap();
+
+    M_filepath.clear();
+    M_version = 0;
+    M_header_begin = 0;
+    M_header_end = 0;
+    M_frames.clear();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+MappedReader::map( const std::string & filepath )
+{
+#if defined(HAVE_SYS_MMAN_H) && defined(HAVE_SYS_STAT_H) && defined(HAVE_FCNTL_H)
+    const int fd = ::open( filepath.c_str(), O_RDONLY );
+    if ( fd == -1 )
+    {
+        std::cerr << "(MappedReader::map) could not open the file " << filepath << std::endl;
+        return false;
+    }
+
+    struct stat st;
+    if ( ::fstat( fd, &st ) == -1
+         || st.st_size <= 0 )
+    {
+        std::cerr << "(MappedReader::map) empty or illegal file " << filepath << std::endl;
+        ::close( fd );
+        return false;
+    }
+
+    void * addr = ::mmap( nullptr, static_cast< std::size_t >( st.st_size ),
+                          PROT_READ, MAP_PRIVATE, fd, 0 );
+    ::close( fd );
+
+    if ( addr == MAP_FAILED )
+    {
+        std::cerr << "(MappedReader::map) mmap failed " << filepath << std::endl;
+        return false;
+    }
+
+    M_data = static_cast< const char * >( addr );
+    M_size = static_cast< std::size_t >( st.st_size );
+    M_mapped = true;
+#else
+    std::ifstream fin( filepath.c_str(), std::ios_base::in | std::ios_base::binary );
+    if ( ! fin.is_open() )
+    {
+        std::cerr << "(MappedReader::map) could not open the file " << filepath << std::endl;
+        return false;
+    }
+
+    M_buffer.assign( std::istreambuf_iterator< char >( fin ),
+                     std::istreambuf_iterator< char >() );
+    if ( M_buffer.empty() )
+    {
+        std::cerr << "(MappedReader::map) empty file " << filepath << std::endl;
+        return false;
+    }
+
+    M_data = M_buffer.data();
+    M_size = M_buffer.size();
+    M_mapped = false;
+#endif
+
+    if ( M_size >= 2
+         && static_cast< unsigned char >( M_data[0] ) == 0x1f
+         && static_cast< unsigned char >( M_data[1] ) == 0x8b )
+    {
+        std::cerr << "(MappedReader::map) compressed file is not supported " << filepath << std::endl;
+        unmap();
+        return false;
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+MappedReader::unmap()
+{
+#ifdef HAVE_SYS_MMAN_H
+    if ( M_mapped
+         && M_data )
+    {
+        ::munmap( const_cast< char * >( M_data ), M_size );
+    }
+#endif
+
+    M_data = nullptr;
+    M_size = 0;
+    M_mapped = false;
+    std::vector< char >().swap( M_buffer );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+MappedReader::buildIndex()
+{
+    const char * const data_end = M_data + M_size;
+
+    //
+    // header line
+    //
+    const char * line_end = static_cast< const char * >( std::memchr( M_data, '\n', M_size ) );
+    if ( ! line_end ) line_end = data_end;
+
+    if ( line_end - M_data < 4
+         || std::memcmp( M_data, "ULG", 3 ) != 0 )
+    {
+        std::cerr << "(MappedReader::buildIndex) unknown header line." << std::endl;
+        return false;
+    }
+
+    int version = 0;
+    if ( std::from_chars( M_data + 3, line_end, version ).ec != std::errc()
+         || ( version != REC_VERSION_4
+              && version != REC_VERSION_5
+              && version != REC_VERSION_6 ) )
+    {
+        std::cerr << "(MappedReader::buildIndex) unsupported rcg version." << std::endl;
+        return false;
+    }
+
+    M_version = version;
+    M_header_begin = std::min( static_cast< std::size_t >( line_end - M_data ) + 1, M_size );
+    M_header_end = npos;
+
+    //
+    // data lines
+    //
+    std::size_t playmode = npos;
+    std::size_t team = npos;
+    std::size_t block_begin = M_header_begin;
+    std::uint32_t block_n_line = 2;
+    std::uint32_t n_line = 1;
+
+    const char * line_begin = M_data + M_header_begin;
+    while ( line_begin < data_end )
+    {
+        ++n_line;
+        line_end = static_cast< const char * >( std::memchr( line_begin, '\n', data_end - line_begin ) );
+        if ( ! line_end ) line_end = data_end;
+
+        const std::size_t offset = line_begin - M_data;
+
+        if ( M_header_end == npos
+             && line_begin != line_end
+             && ! starts_with( line_begin, line_end, "(server_param", 13 )
+             && ! starts_with( line_begin, line_end, "(player_param", 13 )
+             && ! starts_with( line_begin, line_end, "(player_type", 12 ) )
+        {
+            M_header_end = offset;
+            block_begin = offset;
+            block_n_line = n_line;
+        }
+
+        if ( starts_with( line_begin, line_end, "(show ", 6 ) )
+        {
+            const char * p = line_begin;
+            while ( *p == ' ' ) ++p;
+            p += 6;
+
+            long cycle = 0;
+            if ( std::from_chars( p, line_end, cycle ).ec != std::errc()
+                 || cycle < 0 )
+            {
+                std::cerr << "(MappedReader::buildIndex) " << n_line
+                          << ": illegal show time." << std::endl;
+                return false;
+            }
+
+            Frame frame;
+            frame.cycle_ = static_cast< std::uint32_t >( cycle );
+            frame.stopped_ = 0;
+            if ( ! M_frames.empty()
+                 && M_frames.back().cycle_ == frame.cycle_ )
+            {
+                frame.stopped_ = M_frames.back().stopped_ + 1;
+            }
+            frame.n_line_ = block_n_line;
+            frame.begin_ = block_begin;
+            frame.show_ = offset;
+            frame.end_ = line_end - M_data;
+            frame.playmode_ = playmode;
+            frame.team_ = team;
+
+            M_frames.push_back( frame );
+
+            block_begin = std::min( frame.end_ + 1, M_size );
+            block_n_line = n_line + 1;
+        }
+        else if ( starts_with( line_begin, line_end, "(playmode ", 10 ) )
+        {
+            playmode = offset;
+        }
+        else if ( starts_with( line_begin, line_end, "(team ", 6 ) )
+        {
+            team = offset;
+        }
+
+        line_begin = line_end + 1;
+    }
+
+    if ( M_header_end == npos )
+    {
+        M_header_end = M_size;
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::size_t
+MappedReader::find( const int cycle,
+                    const int stopped ) const
+{
+    const std::uint32_t c = static_cast< std::uint32_t >( std::max( 0, cycle ) );
+    const std::uint32_t s = static_cast< std::uint32_t >( std::max( 0, stopped ) );
+
+    std::vector< Frame >::const_iterator it
+        = std::lower_bound( M_frames.begin(), M_frames.end(), 0,
+                            [&]( const Frame & f, int )
+                              {
+                                  return ( f.cycle_ < c
+                                           || ( f.cycle_ == c && f.stopped_ < s ) );
+                              } );
+    if ( it == M_frames.end() )
+    {
+        return npos;
+    }
+
+    return static_cast< std::size_t >( it - M_frames.begin() );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+MappedReader::readLine( const char * begin,
+                        const char * end,
+                        const int n_line,
+                        Handler & handler ) const
+{
+    if ( begin == end )
+    {
+        return true;
+    }
+
+    if ( starts_with( begin, end, "(show ", 6 ) )
+    {
+        // an illegal show line is skipped in the same way as ParserV4
+        M_parser.parseShow( n_line, begin, end, handler );
+        return true;
+    }
+
+    return M_parser.parseLine( n_line, std::string( begin, end ), handler );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+MappedReader::readHeader( Handler & handler ) const
+{
+    if ( ! isOpen() )
+    {
+        return false;
+    }
+
+    if ( ! handler.handleLogVersion( M_version ) )
+    {
+        return false;
+    }
+
+    const char * const block_end = M_data + M_header_end;
+    const char * line_begin = M_data + M_header_begin;
+    int n_line = 1;
+    while ( line_begin < block_end )
+    {
+        ++n_line;
+        const char * line_end = static_cast< const char * >( std::memchr( line_begin, '\n', block_end - line_begin ) );
+        if ( ! line_end ) line_end = block_end;
+
+        if ( ! readLine( line_begin, line_end, n_line, handler ) )
+        {
+            return false;
+        }
+
+        line_begin = line_end + 1;
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+MappedReader::readFrames( const std::size_t first,
+                          const std::size_t last,
+                          Handler & handler ) const
+{
+    if ( ! isOpen() )
+    {
+        return false;
+    }
+
+    if ( first >= last
+         || first >= M_frames.size() )
+    {
+        return true;
+    }
+
+    const Frame & first_frame = M_frames[first];
+    const Frame & last_frame = M_frames[ std::min( last, M_frames.size() ) - 1 ];
+
+    //
+    // restore the game state at the first frame
+    //
+    std::size_t states[2] = { first_frame.team_, first_frame.playmode_ };
+    if ( states[1] < states[0] ) std::swap( states[0], states[1] );
+    for ( const std::size_t offset : states )
+    {
+        if ( offset == npos
+             || offset >= first_frame.begin_ )
+        {
+            continue;
+        }
+
+        const char * line_end = static_cast< const char * >( std::memchr( M_data + offset, '\n', M_size - offset ) );
+        if ( ! line_end ) line_end = M_data + M_size;
+
+        if ( ! readLine( M_data + offset, line_end, 0, handler ) )
+        {
+            return false;
+        }
+    }
+
+    //
+    // frame lines
+    //
+    const char * const block_end = M_data + last_frame.end_;
+    const char * line_begin = M_data + first_frame.begin_;
+    int n_line = first_frame.n_line_;
+    while ( line_begin < block_end )
+    {
+        const char * line_end = static_cast< const char * >( std::memchr( line_begin, '\n', block_end - line_begin ) );
+        if ( ! line_end ) line_end = block_end;
+
+        if ( ! readLine( line_begin, line_end, n_line, handler ) )
+        {
+            return false;
+        }
+
+        ++n_line;
+        line_begin = line_end + 1;
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+MappedReader::readCycles( const int first_cycle,
+                          const int last_cycle,
+                          Handler & handler ) const
+{
+    const std::size_t first = find( first_cycle, 0 );
+    if ( first == npos )
+    {
+        return true;
+    }
+
+    std::size_t last = ( last_cycle < first_cycle
+                         ? first
+                         : find( last_cycle + 1, 0 ) );
+    if ( last == npos )
+    {
+        last = M_frames.size();
+    }
+
+    return readFrames( first, last, handler );
+}
+
+} // end of namespace
+} // end of namespace
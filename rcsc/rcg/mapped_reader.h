@@ -0,0 +1,234 @@
+// -*-c++-*-
+
+/*!
+  \file mapped_reader.h
+  \brief memory mapped rcg reader with the frame index Header File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_RCG_MAPPED_READER_H
+#define RCSC_RCG_MAPPED_READER_H
+
+#include <rcsc/rcg/parser_v4_fast.h>
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace rcsc {
+namespace rcg {
+
+class Handler;
+
+/*!
+  \class MappedReader
+  \brief random access reader for the uncompressed text rcg (v4, v5, v6).
+
+  The whole file is mapped into memory and the offsets of show lines are
+  indexed by (cycle, stopped). Any range of frames can be decoded through
+  the Handler interface without parsing the preceding data.
+ */
+class MappedReader {
+public:
+
+    /*!
+      \struct Frame
+      \brief index entry of one show frame.
+
+      All offsets are the byte positions from the beginning of the file.
+     */
+    struct Frame {
+        std::uint32_t cycle_; //!< game cycle
+        std::uint32_t stopped_; //!< stopped cycle count
+        std::uint32_t n_line_; //!< line number of the first line of the frame
+        std::size_t begin_; //!< first line of the frame (the line after the previous show)
+        std::size_t show_; //!< beginning of the show line
+        std::size_t end_; //!< end of the show line, not including the new line character
+        std::size_t playmode_; //!< the last playmode line before this frame
+        std::size_t team_; //!< the last team line before this frame
+    };
+
+    //! invalid index or offset
+    static const std::size_t npos;
+
+private:
+
+    std::string M_filepath; //!< opened file path
+
+    const char * M_data; //!< head of the mapped data
+    std::size_t M_size; //!< data size in bytes
+    bool M_mapped; //!< true if the data are mapped by mmap
+    std::vector< char > M_buffer; //!< fallback buffer if mmap is not available
+
+    int M_version; //!< rcg version number
+    std::size_t M_header_begin; //!< offset of the first line after the header line
+    std::size_t M_header_end; //!< offset of the first line that is not a parameter line
+
+    std::vector< Frame > M_frames; //!< index of the show frames
+
+    ParserV4Fast M_parser; //!< line parser
+
+    // not used
+    MappedReader( const MappedReader & ) = delete;
+    MappedReader & operator=( const MappedReader & ) = delete;
+
+public:
+
+    /*!
+      \brief create an empty reader.
+     */
+    MappedReader();
+
+    /*!
+      \brief unmap the file.
+     */
+    ~MappedReader();
+
+    /*!
+      \brief map the file and build the frame index.
+      \param filepath path to the uncompressed rcg file.
+      \return true if successfully opened and indexed.
+     */
+    bool open( const std::string & filepath );
+
+    /*!
+      \brief unmap the file and clear the index.
+     */
+    void close();
+
+    /*!
+      \brief check if a file is opened.
+      \return checked result.
+     */
+    bool isOpen() const
+      {
+          return M_data != nullptr;
+      }
+
+    /*!
+      \brief get the opened file path.
+      \return file path string.
+     */
+    const std::string & filepath() const
+      {
+          return M_filepath;
+      }
+
+    /*!
+      \brief get the rcg version of the opened file.
+      \return version number
+     */
+    int version() const
+      {
+          return M_version;
+      }
+
+    /*!
+      \brief get the mapped data size.
+      \return size in bytes
+     */
+    std::size_t size() const
+      {
+          return M_size;
+      }
+
+    /*!
+      \brief get the frame index.
+      \return const reference to the container.
+     */
+    const std::vector< Frame > & frames() const
+      {
+          return M_frames;
+      }
+
+    /*!
+      \brief get the number of show frames.
+      \return number of frames
+     */
+    std::size_t frameCount() const
+      {
+          return M_frames.size();
+      }
+
+    /*!
+      \brief find the index of the frame.
+      \param cycle game cycle
+      \param stopped stopped cycle count
+      \return index of the first frame not less than (cycle, stopped), or npos.
+     */
+    std::size_t find( const int cycle,
+                      const int stopped = 0 ) const;
+
+    /*!
+      \brief decode the log version and the parameter lines.
+      \param handler reference to the rcg data handler.
+      \return true if successfully decoded.
+     */
+    bool readHeader( Handler & handler ) const;
+
+    /*!
+      \brief decode the frames in [first, last).
+      \param first index of the first frame
+      \param last index of the past-the-end frame
+      \param handler reference to the rcg data handler.
+      \return true if successfully decoded.
+
+      The last playmode and team before the first frame are also decoded,
+      so that the handler can know the game state at the first frame.
+     */
+    bool readFrames( const std::size_t first,
+                     const std::size_t last,
+                     Handler & handler ) const;
+
+    /*!
+      \brief decode the frames from (first_cycle, 0) to (last_cycle, max).
+      \param first_cycle the first game cycle
+      \param last_cycle the last game cycle, inclusive.
+      \param handler reference to the rcg data handler.
+      \return true if successfully decoded.
+     */
+    bool readCycles( const int first_cycle,
+                     const int last_cycle,
+                     Handler & handler ) const;
+
+private:
+
+    bool map( const std::string & filepath );
+    void unmap();
+
+    bool buildIndex();
+
+    bool readLine( const char * begin,
+                   const char * end,
+                   const int n_line,
+                   Handler & handler ) const;
+};
+
+} // end of namespace
+} // end of namespace
+
+#endif
@@ -0,0 +1,159 @@
+// -*-c++-*-
+
+/*!
+  \file parser_columnar.cpp
+  \brief binary columnar rcg parser Source File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "parser_columnar.h"
+
+#include "columnar_chunk.h"
+#include "handler.h"
+
+#include <iostream>
+
+namespace rcsc {
+namespace rcg {
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+ParserColumnar::parse( std::istream & is,
+                       Handler & handler ) const
+{
+    // streampos must be the first point!!!
+    is.seekg( 0 );
+
+    if ( ! is.good() )
+    {
+        return false;
+    }
+
+    if ( ! ColumnarChunk::read_header( is )
+         || ! handler.handleLogVersion( REC_VERSION_COLUMNAR ) )
+    {
+        return false;
+    }
+
+    ColumnarChunk chunk;
+
+    while ( is.peek() != std::istream::traits_type::eof() )
+    {
+        if ( ! chunk.read( is )
+             || ! handleChunk( chunk, handler ) )
+        {
+            return false;
+        }
+    }
+
+    return handler.handleEOF();
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+ParserColumnar::handleChunk( const ColumnarChunk & chunk,
+                             Handler & handler ) const
+{
+    const std::vector< ShowInfoT > & frames = chunk.frames();
+    const std::vector< ColumnarChunk::Event > & events = chunk.events();
+
+    std::vector< ColumnarChunk::Event >::const_iterator e = events.begin();
+
+    for ( std::size_t i = 0; i <= frames.size(); ++i )
+    {
+        for ( ; e != events.end() && e->frame_ <= i; ++e )
+        {
+            switch ( e->type_ ) {
+            case ColumnarChunk::SERVER_PARAM:
+                if ( ! handler.handleServerParam( e->text_ ) )
+                {
+                    std::cerr << "(ParserColumnar) Illegal server_param \"" << e->text_ << "\"" << std::endl;
+                }
+                break;
+            case ColumnarChunk::PLAYER_PARAM:
+                if ( ! handler.handlePlayerParam( e->text_ ) )
+                {
+                    std::cerr << "(ParserColumnar) Illegal player_param \"" << e->text_ << "\"" << std::endl;
+                }
+                break;
+            case ColumnarChunk::PLAYER_TYPE:
+                if ( ! handler.handlePlayerType( e->text_ ) )
+                {
+                    std::cerr << "(ParserColumnar) Illegal player_type \"" << e->text_ << "\"" << std::endl;
+                }
+                break;
+            case ColumnarChunk::PLAYMODE:
+                handler.handlePlayMode( e->time_, static_cast< PlayMode >( e->value_ ) );
+                break;
+            case ColumnarChunk::TEAM:
+                handler.handleTeam( e->time_, e->team_[0], e->team_[1] );
+                break;
+            case ColumnarChunk::MSG:
+                handler.handleMsg( e->time_, e->value_, e->text_ );
+                break;
+            default:
+                break;
+            }
+        }
+
+        if ( i < frames.size() )
+        {
+            handler.handleShow( frames[i] );
+        }
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+namespace {
+
+Parser::Ptr
+create_columnar()
+{
+    Parser::Ptr ptr( new ParserColumnar() );
+    return ptr;
+}
+
+rcss::RegHolder columnar = Parser::creators().autoReg( &create_columnar, REC_VERSION_COLUMNAR );
+
+}
+
+} // end of namespace
+} // end of namespace
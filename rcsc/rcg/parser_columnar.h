@@ -0,0 +1,85 @@
+// -*-c++-*-
+
+/*!
+  \file parser_columnar.h
+  \brief binary columnar rcg parser Header File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_RCG_PARSER_COLUMNAR_H
+#define RCSC_RCG_PARSER_COLUMNAR_H
+
+#include <rcsc/rcg/parser.h>
+#include <rcsc/rcg/types.h>
+
+namespace rcsc {
+namespace rcg {
+
+class ColumnarChunk;
+
+/*!
+  \class ParserColumnar
+  \brief binary columnar rcg parser class
+
+  All records are passed to the handler in the recorded order, in the same
+  way as the text rcg parser.
+ */
+class ParserColumnar
+    : public Parser {
+public:
+
+    /*!
+      \brief get supported rcg version
+      \return version number
+     */
+    virtual
+    int version() const override
+      {
+          return REC_VERSION_COLUMNAR;
+      }
+
+    /*!
+      \brief parse input stream
+      \param is reference to the imput stream (usually ifstream/gzifstream).
+      \param handler reference to the rcg data handler.
+      \retval true, if successfuly parsed.
+      \retval false, if incorrect format is detected.
+    */
+    virtual
+    bool parse( std::istream & is,
+                Handler & handler ) const override;
+
+private:
+
+    bool handleChunk( const ColumnarChunk & chunk,
+                      Handler & handler ) const;
+
+};
+
+} // end of namespace
+} // end of namespace
+
+#endif
@@ -80,6 +80,7 @@ public:
       First, check the type of data mode.
       Second, call each data item parsing method.
     */
+    virtual
     bool parseLine( const int n_line,
                     const std::string & line,
                     Handler & handler ) const;
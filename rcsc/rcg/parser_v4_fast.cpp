@@ -0,0 +1,508 @@
+// -*-c++-*-
+
+/*!
+  \file parser_v4_fast.cpp
+  \brief rcg v4/v5/v6 parser with the scanner for show lines Source File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "parser_v4_fast.h"
+
+#include "handler.h"
+#include "types.h"
+
+#include <iostream>
+#include <charconv>
+#include <cstring>
+#include <cstdint>
+
+namespace rcsc {
+namespace rcg {
+
+namespace {
+
+/*!
+  \class ShowScanner
+  \brief character cursor on the show line buffer.
+ */
+class ShowScanner {
+private:
+    const char * M_pos;
+    const char * const M_end;
+
+public:
+
+    ShowScanner( const char * begin,
+                 const char * end )
+        : M_pos( begin ),
+          M_end( end )
+      { }
+
+    bool atEnd() const
+      {
+          return M_pos >= M_end;
+      }
+
+    char peek() const
+      {
+          return M_pos < M_end ? *M_pos : '\0';
+      }
+
+    void skipSpace()
+      {
+          while ( M_pos < M_end
+                  && ( *M_pos == ' ' || *M_pos == '\t' || *M_pos == '\r' ) )
+          {
+              ++M_pos;
+          }
+      }
+
+    /*!
+      \brief skip white spaces and the specified character.
+      \return true if at least one character c is skipped.
+     */
+    bool consume( const char c )
+      {
+          skipSpace();
+          if ( M_pos < M_end && *M_pos == c )
+          {
+              ++M_pos;
+              return true;
+          }
+          return false;
+      }
+
+    /*!
+      \brief skip white spaces and the specified keyword.
+      \return true if the keyword is skipped.
+     */
+    bool consume( const char * str,
+                  const std::size_t len )
+      {
+          skipSpace();
+          if ( static_cast< std::size_t >( M_end - M_pos ) >= len
+               && ! std::memcmp( M_pos, str, len ) )
+          {
+              M_pos += len;
+              return true;
+          }
+          return false;
+      }
+
+    bool readChar( char & val )
+      {
+          skipSpace();
+          if ( M_pos >= M_end )
+          {
+              return false;
+          }
+          val = *M_pos;
+          ++M_pos;
+          return true;
+      }
+
+    template < typename T >
+    bool readInt( T & val )
+      {
+          skipSpace();
+          std::from_chars_result r = std::from_chars( M_pos, M_end, val );
+          if ( r.ec != std::errc() )
+          {
+              return false;
+          }
+          M_pos = r.ptr;
+          return true;
+      }
+
+    template < typename T >
+    bool readHex( T & val )
+      {
+          skipSpace();
+          if ( M_end - M_pos >= 2
+               && M_pos[0] == '0'
+               && ( M_pos[1] == 'x' || M_pos[1] == 'X' ) )
+          {
+              M_pos += 2;
+          }
+          std::from_chars_result r = std::from_chars( M_pos, M_end, val, 16 );
+          if ( r.ec != std::errc() )
+          {
+              return false;
+          }
+          M_pos = r.ptr;
+          return true;
+      }
+
+    bool readFloat( float & val )
+      {
+          skipSpace();
+          std::from_chars_result r = std::from_chars( M_pos, M_end, val );
+          if ( r.ec != std::errc() )
+          {
+              return false;
+          }
+          M_pos = r.ptr;
+          return true;
+      }
+
+    /*!
+      \brief read the token delimited by white spaces or parentheses.
+      \param buf destination buffer. the result is null terminated.
+      \param size size of the destination buffer.
+     */
+    bool readToken( char * buf,
+                    const std::size_t size )
+      {
+          skipSpace();
+          std::size_t n = 0;
+          while ( M_pos < M_end
+                  && *M_pos != ' ' && *M_pos != '(' && *M_pos != ')' )
+          {
+              if ( n + 1 < size )
+              {
+                  buf[n++] = *M_pos;
+              }
+              ++M_pos;
+          }
+          buf[n] = '\0';
+          return n > 0;
+      }
+};
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief scan one player data. the cursor must be at the beginning of "((side unum)"
+ */
+bool
+scan_player( ShowScanner & scanner,
+             ShowInfoT & show,
+             char & side,
+             int & unum )
+{
+    // ((side unum) type state x y vx vy body neck [pointx pointy] (v h 90) [(fp dist dir)] (s 4000 1 1[ 130600])[(f side unum)]
+    //              (c 1 1 1 1 1 1 1 1 1 1 1[ 1]))
+
+    if ( ! scanner.consume( '(' )
+         || ! scanner.consume( '(' )
+         || ! scanner.readChar( side )
+         || ( side != 'l' && side != 'r' )
+         || ! scanner.readInt( unum )
+         || unum <= 0 || MAX_PLAYER < unum
+         || ! scanner.consume( ')' ) )
+    {
+        return false;
+    }
+
+    PlayerT & p = show.player_[ side == 'l' ? unum - 1 : unum - 1 + MAX_PLAYER ];
+    p.side_ = side;
+    p.unum_ = static_cast< Int16 >( unum );
+
+    std::uint32_t state = 0;
+    if ( ! scanner.readInt( p.type_ )
+         || ! scanner.readHex( state )
+         || ! scanner.readFloat( p.x_ )
+         || ! scanner.readFloat( p.y_ )
+         || ! scanner.readFloat( p.vx_ )
+         || ! scanner.readFloat( p.vy_ )
+         || ! scanner.readFloat( p.body_ )
+         || ! scanner.readFloat( p.neck_ ) )
+    {
+        return false;
+    }
+    p.state_ = static_cast< Int32 >( state );
+
+    // arm
+    scanner.skipSpace();
+    if ( scanner.peek() != '(' )
+    {
+        if ( ! scanner.readFloat( p.point_x_ )
+             || ! scanner.readFloat( p.point_y_ ) )
+        {
+            return false;
+        }
+    }
+
+    // (v quality width)
+    if ( ! scanner.consume( "(v", 2 )
+         || ! scanner.readChar( p.view_quality_ )
+         || ! scanner.readFloat( p.view_width_ )
+         || ! scanner.consume( ')' ) )
+    {
+        return false;
+    }
+
+    // (fp dist dir)
+    // focus point is introduced in the monitor protocol v6
+    if ( scanner.consume( "(fp", 3 ) )
+    {
+        if ( ! scanner.readFloat( p.focus_dist_ )
+             || ! scanner.readFloat( p.focus_dir_ )
+             || ! scanner.consume( ')' ) )
+        {
+            return false;
+        }
+    }
+
+    // (s stamina effort recovery[ capacity])
+    // capacity is introduced in the monitor protocol v5
+    if ( ! scanner.consume( "(s", 2 )
+         || ! scanner.readFloat( p.stamina_ )
+         || ! scanner.readFloat( p.effort_ )
+         || ! scanner.readFloat( p.recovery_ ) )
+    {
+        return false;
+    }
+    scanner.skipSpace();
+    if ( scanner.peek() != ')' )
+    {
+        if ( ! scanner.readFloat( p.stamina_capacity_ ) )
+        {
+            return false;
+        }
+    }
+    if ( ! scanner.consume( ')' ) )
+    {
+        return false;
+    }
+
+    // (f side unum)
+    if ( scanner.consume( "(f", 2 ) )
+    {
+        if ( ! scanner.readChar( p.focus_side_ )
+             || ! scanner.readInt( p.focus_unum_ )
+             || ! scanner.consume( ')' ) )
+        {
+            return false;
+        }
+    }
+
+    // (c kick dash turn catch move tneck cview say tackle pointto atttention[ change_focus])
+    if ( ! scanner.consume( "(c", 2 )
+         || ! scanner.readInt( p.kick_count_ )
+         || ! scanner.readInt( p.dash_count_ )
+         || ! scanner.readInt( p.turn_count_ )
+         || ! scanner.readInt( p.catch_count_ )
+         || ! scanner.readInt( p.move_count_ )
+         || ! scanner.readInt( p.turn_neck_count_ )
+         || ! scanner.readInt( p.change_view_count_ )
+         || ! scanner.readInt( p.say_count_ )
+         || ! scanner.readInt( p.tackle_count_ )
+         || ! scanner.readInt( p.pointto_count_ )
+         || ! scanner.readInt( p.attentionto_count_ ) )
+    {
+        return false;
+    }
+    scanner.skipSpace();
+    if ( scanner.peek() != ')' )
+    {
+        if ( ! scanner.readInt( p.change_focus_count_ ) )
+        {
+            return false;
+        }
+    }
+
+    return ( scanner.consume( ')' )
+             && scanner.consume( ')' ) );
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+ParserV4Fast::parseLine( const int n_line,
+                         const std::string & line,
+                         Handler & handler ) const
+{
+    const char * begin = line.data();
+    const char * end = begin + line.size();
+
+    while ( begin < end && *begin == ' ' ) ++begin;
+
+    if ( end - begin >= 6
+         && ! std::memcmp( begin, "(show ", 6 ) )
+    {
+        parseShow( n_line, begin, end, handler );
+        return true;
+    }
+
+    return ParserV4::parseLine( n_line, line, handler );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+ParserV4Fast::parseShow( const int n_line,
+                         const std::string & line,
+                         Handler & handler ) const
+{
+    return parseShow( n_line, line.data(), line.data() + line.size(), handler );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+ParserV4Fast::parseShow( const int n_line,
+                         const char * begin,
+                         const char * end,
+                         Handler & handler ) const
+{
+    /*
+      (show <Time> [(pm <Playmode>)] [(tm <Team> <Team> <Score> <Score>[ <PenScore> <PenMiss> <PenScore> <PenMiss>])]
+       <Ball> <Players>)
+    */
+
+    ShowScanner scanner( begin, end );
+
+    //
+    // time
+    //
+    long time = 0;
+    if ( ! scanner.consume( "(show", 5 )
+         || ! scanner.readInt( time ) )
+    {
+        std::cerr << n_line << ": error: "
+                  << " Illegal show info time. "
+                  << " \"" << std::string( begin, end ) << "\""
+                  << std::endl;
+        return false;
+    }
+
+    ShowInfoT show;
+    show.time_ = static_cast< UInt32 >( time );
+
+    //
+    // playmode
+    //
+    if ( scanner.consume( "(pm", 3 ) )
+    {
+        int pm = 0;
+        if ( scanner.readInt( pm )
+             && scanner.consume( ')' ) )
+        {
+            handler.handlePlayMode( time, static_cast< PlayMode >( pm ) );
+        }
+    }
+
+    //
+    // team
+    //
+    if ( scanner.consume( "(tm", 3 ) )
+    {
+        char name_l[32], name_r[32];
+        int score_l = 0, score_r = 0;
+        int pen_score_l = 0, pen_miss_l = 0, pen_score_r = 0, pen_miss_r = 0;
+
+        if ( ! scanner.readToken( name_l, sizeof( name_l ) )
+             || ! scanner.readToken( name_r, sizeof( name_r ) )
+             || ! scanner.readInt( score_l )
+             || ! scanner.readInt( score_r ) )
+        {
+            std::cerr << n_line << ": error: "
+                      << "Illegal team info. \"" << std::string( begin, end ) << "\"" << std::endl;;
+            return false;
+        }
+
+        scanner.skipSpace();
+        if ( scanner.peek() != ')'
+             && ( ! scanner.readInt( pen_score_l )
+                  || ! scanner.readInt( pen_miss_l )
+                  || ! scanner.readInt( pen_score_r )
+                  || ! scanner.readInt( pen_miss_r ) ) )
+        {
+            std::cerr << n_line << ": error: "
+                      << "Illegal team info. \"" << std::string( begin, end ) << "\"" << std::endl;;
+            return false;
+        }
+        scanner.consume( ')' );
+
+        if ( ! std::strcmp( name_l, "null" ) ) std::memset( name_l, 0, 4 );
+        if ( ! std::strcmp( name_r, "null" ) ) std::memset( name_r, 0, 4 );
+
+        TeamT team_l( name_l, score_l, pen_score_l, pen_miss_l );
+        TeamT team_r( name_r, score_r, pen_score_r, pen_miss_r );
+
+        handler.handleTeam( time, team_l, team_r );
+    }
+
+    //
+    // ball
+    //
+    {
+        // ((b) x y vx vy)
+        BallT & ball = show.ball_;
+        if ( ! scanner.consume( "((b)", 4 )
+             || ! scanner.readFloat( ball.x_ )
+             || ! scanner.readFloat( ball.y_ )
+             || ! scanner.readFloat( ball.vx_ )
+             || ! scanner.readFloat( ball.vy_ )
+             || ! scanner.consume( ')' ) )
+        {
+            std::cerr << n_line << ": error: "
+                      << " Illegal ball info. "
+                      << " \"" << std::string( begin, end ) << "\""
+                      << std::endl;;
+            return false;
+        }
+    }
+
+    //
+    // players
+    //
+    for ( int i = 0; i < MAX_PLAYER*2; ++i )
+    {
+        scanner.skipSpace();
+        if ( scanner.atEnd() || scanner.peek() == ')' ) break;
+
+        char side = '?';
+        int unum = 0;
+        if ( ! scan_player( scanner, show, side, unum ) )
+        {
+            std::cerr << n_line << ": error: "
+                      << " Illegal player info. " << side << ' ' << unum
+                      << " \"" << std::string( begin, end ) << "\""
+                      << std::endl;;
+            return false;
+        }
+    }
+
+    handler.handleShow( show );
+
+    return true;
+}
+
+} // end of namespace
+} // end of namespace
@@ -0,0 +1,100 @@
+// -*-c++-*-
+
+/*!
+  \file parser_v4_fast.h
+  \brief rcg v4/v5/v6 parser with the scanner for show lines Header File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_RCG_PARSER_V4_FAST_H
+#define RCSC_RCG_PARSER_V4_FAST_H
+
+#include <rcsc/rcg/parser_v4.h>
+
+#include <string>
+
+namespace rcsc {
+namespace rcg {
+
+/*!
+  \class ParserV4Fast
+  \brief rcg v4/v5/v6 parser that decodes show lines without sscanf/strtod.
+
+  Show lines are scanned directly on the line buffer and numbers are
+  converted by std::from_chars. Other data lines are delegated to ParserV4.
+  The parsed data are same as ParserV4, so that both parsers can be compared.
+ */
+class ParserV4Fast
+    : public ParserV4 {
+public:
+
+    /*!
+      \brief parse data line.
+      \param n_line the number of total read line
+      \param line the data string
+      \param handler reference to the rcg data handler.
+      \retval true, if successfuly parsed.
+      \retval false, if incorrect format is detected.
+    */
+    virtual
+    bool parseLine( const int n_line,
+                    const std::string & line,
+                    Handler & handler ) const override;
+
+    /*!
+      \brief parse show line in the character buffer.
+      \param n_line the number of total read line
+      \param begin pointer to the first character of the line
+      \param end pointer to the past-the-end character of the line
+      \param handler reference to the data handler object
+      \retval true if successfully parsed.
+      \retval false if failed to parse.
+    */
+    bool parseShow( const int n_line,
+                    const char * begin,
+                    const char * end,
+                    Handler & handler ) const;
+
+protected:
+
+    /*!
+      \brief parse show line
+      \param n_line the number of total read line
+      \param line the data string
+      \param handler reference to the data handler object
+      \retval true if successfully parsed.
+      \retval false if failed to parse.
+    */
+    virtual
+    bool parseShow( const int n_line,
+                    const std::string & line,
+                    Handler & handler ) const override;
+};
+
+} // end of namespace
+} // end of namespace
+
+#endif
@@ -405,6 +405,17 @@ public:
     std::ostream & serialize( std::ostream & os,
                               const DispInfoT & disp ) = 0;
 
+    /*!
+      \brief write the buffered data, if any. called after the last data.
+      \param os reference to the output stream
+      \return reference to the output stream
+     */
+    virtual
+    std::ostream & serializeEnd( std::ostream & os )
+      {
+          return os;
+      }
+
 };
 
 } // end of namespace rcg
@@ -0,0 +1,345 @@
+// -*-c++-*-
+
+/*!
+  \file serializer_columnar.cpp
+  \brief binary columnar rcg serializer class Source File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "serializer_columnar.h"
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+
+namespace rcsc {
+namespace rcg {
+
+const std::size_t SerializerColumnar::DEFAULT_CHUNK_SIZE = 512;
+
+namespace {
+
+//! the maximum number of events in one chunk
+const std::size_t MAX_CHUNK_EVENTS = 65536;
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+inline
+bool
+starts_with( const std::string & str,
+             const char * prefix )
+{
+    return str.compare( 0, std::char_traits< char >::length( prefix ), prefix ) == 0;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+inline
+std::string
+chomp( const std::string & str )
+{
+    std::string::size_type end = str.find_last_not_of( "\r\n" );
+    return ( end == std::string::npos ? std::string() : str.substr( 0, end + 1 ) );
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+SerializerColumnar::SerializerColumnar()
+    : SerializerV4(),
+      M_chunk_size( DEFAULT_CHUNK_SIZE ),
+      M_compression_level( 6 )
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+SerializerColumnar::setChunkSize( const std::size_t size )
+{
+    M_chunk_size = std::max( static_cast< std::size_t >( 1 ), size );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::ostream &
+SerializerColumnar::serializeHeader( std::ostream & os )
+{
+    M_chunk.clear();
+    return ColumnarChunk::write_header( os );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::ostream &
+SerializerColumnar::serializeParam( std::ostream & os,
+                                    const std::string & msg )
+{
+    ColumnarChunk::Event event;
+    event.time_ = M_time;
+    event.text_ = chomp( msg );
+
+    if ( starts_with( event.text_, "(server_param" ) )
+    {
+        event.type_ = ColumnarChunk::SERVER_PARAM;
+    }
+    else if ( starts_with( event.text_, "(player_param" ) )
+    {
+        event.type_ = ColumnarChunk::PLAYER_PARAM;
+    }
+    else if ( starts_with( event.text_, "(player_type" ) )
+    {
+        event.type_ = ColumnarChunk::PLAYER_TYPE;
+    }
+    else
+    {
+        std::cerr << "(SerializerColumnar::serializeParam) unknown parameter message ["
+                  << event.text_ << "]" << std::endl;
+        return os;
+    }
+
+    addEvent( os, event );
+    return os;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::ostream &
+SerializerColumnar::serialize( std::ostream & os,
+                               const server_params_t & param )
+{
+    std::ostringstream buf;
+    SerializerV4::serialize( buf, param );
+    return serializeParam( os, buf.str() );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::ostream &
+SerializerColumnar::serialize( std::ostream & os,
+                               const player_params_t & pparam )
+{
+    std::ostringstream buf;
+    SerializerV4::serialize( buf, pparam );
+    return serializeParam( os, buf.str() );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::ostream &
+SerializerColumnar::serialize( std::ostream & os,
+                               const player_type_t & type )
+{
+    std::ostringstream buf;
+    SerializerV4::serialize( buf, type );
+    return serializeParam( os, buf.str() );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::ostream &
+SerializerColumnar::serialize( std::ostream & os,
+                               const msginfo_t & msg )
+{
+    return serialize( os, msg.board, std::string( msg.message ) );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::ostream &
+SerializerColumnar::serialize( std::ostream & os,
+                               const Int16 board,
+                               const std::string & msg )
+{
+    ColumnarChunk::Event event;
+    event.type_ = ColumnarChunk::MSG;
+    event.time_ = M_time;
+    event.value_ = board;
+    event.text_ = msg;
+
+    addEvent( os, event );
+    return os;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::ostream &
+SerializerColumnar::serialize( std::ostream & os,
+                               const char playmode )
+{
+    M_playmode = playmode;
+
+    PlayMode pm = static_cast< PlayMode >( playmode );
+    if ( pm < PM_Null || PM_MAX <= pm )
+    {
+        return os;
+    }
+
+    ColumnarChunk::Event event;
+    event.type_ = ColumnarChunk::PLAYMODE;
+    event.time_ = M_time;
+    event.value_ = pm;
+
+    addEvent( os, event );
+    return os;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::ostream &
+SerializerColumnar::serialize( std::ostream & os,
+                               const TeamT & team_l,
+                               const TeamT & team_r )
+{
+    M_teams[0] = team_l;
+    M_teams[1] = team_r;
+
+    ColumnarChunk::Event event;
+    event.type_ = ColumnarChunk::TEAM;
+    event.time_ = M_time;
+    event.team_[0] = team_l;
+    event.team_[1] = team_r;
+
+    addEvent( os, event );
+    return os;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::ostream &
+SerializerColumnar::serialize( std::ostream & os,
+                               const ShowInfoT & show )
+{
+    M_time = show.time_;
+
+    M_chunk.addFrame( show );
+
+    if ( M_chunk.frames().size() >= M_chunk_size )
+    {
+        flushChunk( os );
+    }
+
+    return os;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::ostream &
+SerializerColumnar::serializeEnd( std::ostream & os )
+{
+    return flushChunk( os );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+SerializerColumnar::addEvent( std::ostream & os,
+                              const ColumnarChunk::Event & event )
+{
+    M_chunk.addEvent( event );
+
+    if ( M_chunk.events().size() >= MAX_CHUNK_EVENTS )
+    {
+        flushChunk( os );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::ostream &
+SerializerColumnar::flushChunk( std::ostream & os )
+{
+    if ( ! M_chunk.empty() )
+    {
+        if ( ! M_chunk.write( os, M_compression_level ) )
+        {
+            std::cerr << "(SerializerColumnar) failed to write the chunk." << std::endl;
+        }
+        M_chunk.clear();
+    }
+
+    return os;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+*/
+namespace {
+
+Serializer::Ptr
+create_columnar()
+{
+    Serializer::Ptr ptr( new SerializerColumnar() );
+    return ptr;
+}
+
+rcss::RegHolder columnar = Serializer::creators().autoReg( &create_columnar, REC_VERSION_COLUMNAR );
+
+}
+
+} // end of namespace
+} // end of namespace
@@ -0,0 +1,213 @@
+// -*-c++-*-
+
+/*!
+  \file serializer_columnar.h
+  \brief binary columnar rcg serializer class Header File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_RCG_SERIALIZER_COLUMNAR_H
+#define RCSC_RCG_SERIALIZER_COLUMNAR_H
+
+#include <rcsc/rcg/serializer_v4.h>
+#include <rcsc/rcg/columnar_chunk.h>
+
+namespace rcsc {
+namespace rcg {
+
+/*!
+  \class SerializerColumnar
+  \brief binary columnar rcg serializer.
+
+  Show frames and other records are buffered into a chunk and written when
+  the chunk becomes full. serializeEnd() must be called to write the last
+  chunk. The old version data are converted by the SerializerV4 methods.
+*/
+class SerializerColumnar
+    : public SerializerV4 {
+public:
+
+    //! default number of frames in one chunk
+    static const std::size_t DEFAULT_CHUNK_SIZE;
+
+private:
+
+    ColumnarChunk M_chunk; //!< buffered data
+    std::size_t M_chunk_size; //!< the number of frames in one chunk
+    int M_compression_level; //!< zlib compression level
+
+public:
+    /*!
+      \brief constructor
+    */
+    SerializerColumnar();
+
+    /*!
+      \brief destructor
+    */
+    ~SerializerColumnar()
+      { }
+
+    /*!
+      \brief set the number of frames in one chunk
+      \param size the number of frames
+     */
+    void setChunkSize( const std::size_t size );
+
+    /*!
+      \brief set the zlib compression level
+      \param level compression level (0-9). 0 means no compression.
+     */
+    void setCompressionLevel( const int level )
+      {
+          M_compression_level = level;
+      }
+
+    /*!
+      \brief write header
+      \param os reference to the output stream
+      \return reference to the output stream
+    */
+    virtual
+    std::ostream & serializeHeader( std::ostream & os ) override;
+
+    /*!
+      \brief write parameter message
+      \param os reference to the output stream
+      \param msg server parameter message
+      \return reference to the output stream
+    */
+    virtual
+    std::ostream & serializeParam( std::ostream & os,
+                                   const std::string & msg ) override;
+
+    /*!
+      \brief write server param
+      \param os reference to the output stream
+      \param param network byte order data
+      \return reference to the output stream
+    */
+    virtual
+    std::ostream & serialize( std::ostream & os,
+                              const server_params_t & param ) override;
+
+    /*!
+      \brief write player param
+      \param os reference to the output stream
+      \param pparam network byte order data
+      \return reference to the output stream
+    */
+    virtual
+    std::ostream & serialize( std::ostream & os,
+                              const player_params_t & pparam ) override;
+
+    /*!
+      \brief write player type
+      \param os reference to the output stream
+      \param type network byte order data
+      \return reference to the output stream
+    */
+    virtual
+    std::ostream & serialize( std::ostream & os,
+                              const player_type_t & type ) override;
+
+    /*!
+      \brief write message info
+      \param os reference to the output stream
+      \param msg network byte order data
+      \return reference to the output stream
+    */
+    virtual
+    std::ostream & serialize( std::ostream & os,
+                              const msginfo_t & msg ) override;
+
+    /*!
+      \brief write message info
+      \param os reference to the output stream
+      \param board message board type
+      \param msg message string
+      \return reference to the output stream
+    */
+    virtual
+    std::ostream & serialize( std::ostream & os,
+                              const Int16 board,
+                              const std::string & msg ) override;
+
+    /*!
+      \brief write playmode
+      \param os reference to the output stream
+      \param playmode play mode variable
+      \return reference to the output stream
+    */
+    virtual
+    std::ostream & serialize( std::ostream & os,
+                              const char playmode ) override;
+
+    /*!
+      \brief write team info
+      \param os reference to the output stream
+      \param team_l left team variable
+      \param team_r right team variable
+      \return reference to the output stream
+    */
+    virtual
+    std::ostream & serialize( std::ostream & os,
+                              const TeamT & team_l,
+                              const TeamT & team_r ) override;
+
+    /*!
+      \brief write ShowInfoT
+      \param os reference to the output stream
+      \param show data to be written
+      \return reference to the output stream
+     */
+    virtual
+    std::ostream & serialize( std::ostream & os,
+                              const ShowInfoT & show ) override;
+
+    /*!
+      \brief write the last chunk
+      \param os reference to the output stream
+      \return reference to the output stream
+     */
+    virtual
+    std::ostream & serializeEnd( std::ostream & os ) override;
+
+    // the remaining overloads of SerializerV4 convert the old data and call the above methods.
+    using SerializerV4::serialize;
+
+private:
+
+    void addEvent( std::ostream & os,
+                   const ColumnarChunk::Event & event );
+
+    std::ostream & flushChunk( std::ostream & os );
+};
+
+} // end of namespace rcg
+} // end of namespace rcsc
+
+#endif
@@ -1145,6 +1145,9 @@ constexpr int REC_VERSION_6 = 6;
 //! recorded value of json rcg
 constexpr int REC_VERSION_JSON = -1;
 
+//! recorded value of the binary columnar rcg ("ULGC" header)
+constexpr int REC_VERSION_COLUMNAR = static_cast< int >( 'C' );
+
 //! default rcg version
 constexpr int DEFAULT_LOG_VERSION = REC_VERSION_6;
 
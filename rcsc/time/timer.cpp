@@ -39,6 +39,8 @@
 
 namespace rcsc {
 
+thread_local const TimeStamp::value_type * TimeStamp::S_virtual_clock = nullptr;
+
 /*-------------------------------------------------------------------*/
 /*!
 
@@ -45,6 +45,9 @@ class TimeStamp {
 public:
     typedef std::chrono::system_clock::time_point value_type;
 private:
+    //! if not NULL, setNow() uses this value instead of the system clock in the current thread.
+    static thread_local const value_type * S_virtual_clock;
+
     std::chrono::system_clock::time_point M_time_point;
 
 public:
@@ -70,12 +73,25 @@ public:
           return M_time_point.time_since_epoch().count() > 0;
       }
 
+    /*!
+      \brief replace the clock used by setNow() in the current thread.
+      The offline client uses this to make the time stamps reproducible.
+      \param tp pointer to the time point updated by the caller. NULL restores the system clock.
+     */
+    static
+    void set_virtual_clock( const value_type * tp )
+      {
+          S_virtual_clock = tp;
+      }
+
     /*!
       \brief update to the current time point
      */
     void setNow()
       {
-          M_time_point = std::chrono::system_clock::now();
+          M_time_point = ( S_virtual_clock
+                           ? *S_virtual_clock
+                           : std::chrono::system_clock::now() );
       }
 
     /*!
@@ -133,7 +149,7 @@ public:
      */
     void restart()
       {
-          M_start_time.setNow();
+          M_start_time = TimeStamp( std::chrono::system_clock::now() );
       }
 
     /*!
@@ -44,6 +44,7 @@
 #include <rcsc/common/offline_client.h>
 #include <rcsc/common/logger.h>
 #include <rcsc/common/server_param.h>
+#include <rcsc/common/shared_param_lock.h>
 #include <rcsc/common/player_param.h>
 #include <rcsc/common/player_type.h>
 #include <rcsc/common/audio_memory.h>
@@ -992,8 +993,14 @@ TrainerAgent::Impl::analyzeChangePlayerType( const char * msg )
 void
 TrainerAgent::Impl::analyzePlayerType( const char * msg )
 {
-    PlayerType player_type( msg, agent_.config().version() );
-    PlayerTypeSet::instance().insert( player_type );
+    {
+        SharedParamLock lock( msg );
+        if ( lock.isNewMessage() )
+        {
+            PlayerType player_type( msg, agent_.config().version() );
+            PlayerTypeSet::instance().insert( player_type );
+        }
+    }
 
     agent_.handlePlayerType();
 }
@@ -1005,7 +1012,13 @@ TrainerAgent::Impl::analyzePlayerType( const char * msg )
 void
 TrainerAgent::Impl::analyzePlayerParam( const char * msg )
 {
-    PlayerParam::instance().parse( msg, agent_.config().version() );
+    {
+        SharedParamLock lock( msg );
+        if ( lock.isNewMessage() )
+        {
+            PlayerParam::instance().parse( msg, agent_.config().version() );
+        }
+    }
 
     agent_.handlePlayerParam();
 }
@@ -1017,8 +1030,14 @@ TrainerAgent::Impl::analyzePlayerParam( const char * msg )
 void
 TrainerAgent::Impl::analyzeServerParam( const char * msg )
 {
-    ServerParam::instance().parse( msg, agent_.config().version() );
-    PlayerTypeSet::instance().resetDefaultType();
+    {
+        SharedParamLock lock( msg );
+        if ( lock.isNewMessage() )
+        {
+            ServerParam::instance().parse( msg, agent_.config().version() );
+            PlayerTypeSet::instance().resetDefaultType();
+        }
+    }
 
     // update alarm interval
     if ( ! ServerParam::i().synchMode()
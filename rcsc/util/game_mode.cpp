@@ -506,7 +506,7 @@ GameMode::getServerPlayMode() const
 const char *
 GameMode::toCString() const
 {
-    static char msg[32];
+    thread_local char msg[32];
 
     switch ( type() ) {
     case BeforeKickOff:
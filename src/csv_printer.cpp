@@ -0,0 +1,408 @@
+// -*-c++-*-
+
+/*!
+  \file csv_printer.cpp
+  \brief rcg to csv converter class Source File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa Akiyama
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "csv_printer.h"
+
+#include <iostream>
+#include <string>
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+CSVPrinter::CSVPrinter( std::ostream & os,
+                        const bool print_header )
+    : M_os( os ),
+      M_print_header( print_header ),
+      M_show_count( 0 ),
+      M_cycle( 0 ),
+      M_stopped( 0 ),
+      M_playmode( rcsc::PM_Null )
+{
+
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+CSVPrinter::handleLogVersion( const int ver )
+{
+    rcsc::rcg::Handler::handleLogVersion( ver );
+
+    if ( ver < 4 )
+    {
+        std::cerr << "Unsupported RCG version " << ver << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+CSVPrinter::handleEOF()
+{
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+CSVPrinter::handleShow( const rcsc::rcg::ShowInfoT & show )
+{
+    if ( M_print_header )
+    {
+        printShowHeader();
+        M_print_header = false;
+    }
+
+    // update show count
+    ++M_show_count;
+
+    // update game time
+    if ( M_cycle == show.time_ )
+    {
+        ++M_stopped;
+    }
+    else
+    {
+        M_cycle = show.time_;
+        M_stopped = 0;
+    }
+
+    printShowData( show );
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+CSVPrinter::handleMsg( const int,
+                       const int,
+                       const std::string & )
+{
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+CSVPrinter::handleDraw( const int,
+                        const rcsc::rcg::drawinfo_t & )
+{
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+CSVPrinter::handlePlayMode( const int,
+                            const rcsc::PlayMode pm )
+{
+    M_playmode = pm;
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+CSVPrinter::handleTeam( const int,
+                        const rcsc::rcg::TeamT & team_l,
+                        const rcsc::rcg::TeamT & team_r )
+{
+    M_teams[0] = team_l;
+    M_teams[1] = team_r;
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+CSVPrinter::handleServerParam( const std::string & )
+{
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+CSVPrinter::handlePlayerParam( const std::string & )
+{
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+CSVPrinter::handlePlayerType( const std::string & )
+{
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+const std::string &
+CSVPrinter::getPlayModeString( const rcsc::PlayMode playmode ) const
+{
+    static const std::string s_playmode_str[] = PLAYMODE_STRINGS;
+
+    if ( playmode < rcsc::PM_Null
+         || rcsc::PM_MAX < playmode )
+    {
+        return s_playmode_str[0];
+    }
+
+    return s_playmode_str[playmode];
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::ostream &
+CSVPrinter::printServerParam() const
+{
+    return M_os;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::ostream &
+CSVPrinter::printPlayerParam() const
+{
+    return M_os;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::ostream &
+CSVPrinter::printPlayerTypes() const
+{
+    return M_os;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::ostream &
+CSVPrinter::printShowHeader() const
+{
+    M_os << "#"
+         << ", cycle, stopped"
+         << ", playmode"
+         << ", l_name, l_score, l_pen_score"
+         << ", r_name, r_score, r_pen_score"
+         << ", b_x, b_y, b_vx, b_vy";
+
+    char side = 'l';
+    for ( int s = 0; s < 2; ++s )
+    {
+        for ( int i = 1; i <= rcsc::MAX_PLAYER; ++i )
+        {
+            M_os << ", " << side << i << "_t"
+                 << ", " << side << i << "_x"
+                 << ", " << side << i << "_y"
+                 << ", " << side << i << "_vx"
+                 << ", " << side << i << "_vy"
+                 << ", " << side << i << "_body"
+                 << ", " << side << i << "_neck";
+        }
+        side = 'r';
+    }
+
+    M_os << '\n';
+    return M_os;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::ostream &
+CSVPrinter::printShowData( const rcsc::rcg::ShowInfoT & show ) const
+{
+    printShowCount();
+    printTime();
+    printPlayMode();
+    printTeams();
+    printBall( show.ball_ );
+    printPlayers( show );
+
+    M_os << '\n';
+    return M_os;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::ostream &
+CSVPrinter::printShowCount() const
+{
+    M_os << M_show_count;
+    return M_os;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::ostream &
+CSVPrinter::printTime() const
+{
+    M_os << ',' << M_cycle << ',' << M_stopped;
+    return M_os;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::ostream &
+CSVPrinter::printPlayMode() const
+{
+    M_os << ',' << getPlayModeString( M_playmode );
+    return M_os;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::ostream &
+CSVPrinter::printTeams() const
+{
+    for ( const auto & t : M_teams )
+    {
+        M_os << ',' << t.name_
+             << ',' << t.score_
+             << ',' << t.pen_score_;
+    }
+
+    return M_os;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::ostream &
+CSVPrinter::printBall( const rcsc::rcg::BallT & ball ) const
+{
+    M_os << ',' << ball.x_
+         << ',' << ball.y_
+         << ',' << ball.vx_
+         << ',' << ball.vy_;
+    return M_os;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::ostream &
+CSVPrinter::printPlayers( const rcsc::rcg::ShowInfoT & show ) const
+{
+    for ( const auto & p : show.player_ )
+    {
+        printPlayer( p );
+    }
+
+    return M_os;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+std::ostream &
+CSVPrinter::printPlayer( const rcsc::rcg::PlayerT & player ) const
+{
+    if ( player.state_ == rcsc::rcg::DISABLE )
+    {
+        M_os << ',' //<< player.type_
+             << ',' //<< player.x_
+             << ',' //<< player.y_
+             << ',' //<< player.vx_
+             << ',' //<< player.vy_
+             << ',' //<< player.body_
+             << ',' //<< player.neck_;
+            ;
+    }
+    else
+    {
+        M_os << ',' << player.type_
+             << ',' << player.x_
+             << ',' << player.y_
+             << ',' << player.vx_
+             << ',' << player.vy_
+             << ',' << player.body_
+             << ',' << player.neck_
+            ;
+    }
+    return M_os;
+}
@@ -0,0 +1,161 @@
+// -*-c++-*-
+
+/*!
+  \file csv_printer.h
+  \brief rcg to csv converter class Header File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa Akiyama
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_SRC_CSV_PRINTER_H
+#define RCSC_SRC_CSV_PRINTER_H
+
+#include <rcsc/types.h>
+#include <rcsc/rcg.h>
+
+#include <ostream>
+#include <string>
+
+class CSVPrinter
+    : public rcsc::rcg::Handler {
+private:
+    struct CommandCount {
+        int kick_;
+        int dash_;
+        int turn_;
+        int say_;
+        int turn_neck_;
+        int catch_;
+        int move_;
+        int change_view_;
+
+        CommandCount()
+            : kick_( 0 )
+            , dash_( 0 )
+            , turn_( 0 )
+            , say_( 0 )
+            , turn_neck_( 0 )
+            , catch_( 0 )
+            , move_( 0 )
+            , change_view_( 0 )
+          { }
+        void update( const rcsc::rcg::player_t & player )
+          {
+              kick_ = rcsc::rcg::nstohi( player.kick_count );
+              dash_ = rcsc::rcg::nstohi( player.dash_count );
+              turn_ = rcsc::rcg::nstohi( player.turn_count );
+              say_ = rcsc::rcg::nstohi( player.say_count );
+              turn_neck_ = rcsc::rcg::nstohi( player.turn_neck_count );
+              catch_ = rcsc::rcg::nstohi( player.catch_count );
+              move_ = rcsc::rcg::nstohi( player.move_count );
+              change_view_ = rcsc::rcg::nstohi( player.change_view_count );
+          }
+        void update( const rcsc::rcg::PlayerT & player )
+          {
+              kick_ = player.kick_count_;
+              dash_ = player.dash_count_;
+              turn_ = player.turn_count_;
+              say_ = player.say_count_;
+              turn_neck_ = player.turn_neck_count_;
+              catch_ = player.catch_count_;
+              move_ = player.move_count_;
+              change_view_ = player.change_view_count_;
+          }
+    };
+
+
+    std::ostream & M_os;
+    bool M_print_header; //!< if true, the column header line is printed before the first show
+
+    int M_show_count;
+
+    rcsc::rcg::UInt32 M_cycle;
+    rcsc::rcg::UInt32 M_stopped;
+
+    rcsc::PlayMode M_playmode;
+    rcsc::rcg::TeamT M_teams[2];
+
+    CommandCount M_command_count[rcsc::MAX_PLAYER * 2];
+
+    // not used
+    CSVPrinter() = delete;
+public:
+
+    explicit
+    CSVPrinter( std::ostream & os,
+                const bool print_header = true );
+
+    virtual
+    bool handleLogVersion( const int ver );
+
+    virtual
+    bool handleEOF();
+
+    virtual
+    bool handleShow( const rcsc::rcg::ShowInfoT & show );
+    virtual
+    bool handleMsg( const int time,
+                    const int board,
+                    const std::string & msg );
+    virtual
+    bool handleDraw( const int time,
+                     const rcsc::rcg::drawinfo_t & draw );
+    virtual
+    bool handlePlayMode( const int time,
+                         const rcsc::PlayMode pm );
+    virtual
+    bool handleTeam( const int time,
+                     const rcsc::rcg::TeamT & team_l,
+                     const rcsc::rcg::TeamT & team_r );
+    virtual
+    bool handleServerParam( const std::string & msg );
+    virtual
+    bool handlePlayerParam( const std::string & msg );
+    virtual
+    bool handlePlayerType( const std::string & msg );
+
+private:
+    const std::string & getPlayModeString( const rcsc::PlayMode playmode ) const;
+
+    std::ostream & printServerParam() const;
+    std::ostream & printPlayerParam() const;
+    std::ostream & printPlayerTypes() const;
+
+
+    std::ostream & printShowHeader() const;
+    std::ostream & printShowData( const rcsc::rcg::ShowInfoT & show ) const;
+
+    // print values
+    std::ostream & printShowCount() const;
+    std::ostream & printTime() const;
+    std::ostream & printPlayMode() const;
+    std::ostream & printTeams() const;
+    std::ostream & printBall( const rcsc::rcg::BallT & ball ) const;
+    std::ostream & printPlayers( const rcsc::rcg::ShowInfoT & show ) const;
+    std::ostream & printPlayer( const rcsc::rcg::PlayerT & player ) const;
+
+};
+
+#endif
@@ -0,0 +1,114 @@
+// -*-c++-*-
+
+/*!
+  \file dlog2txt.cpp
+  \brief binary debug log to text converter.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <rcsc/common/log_record.h>
+#include <rcsc/gz.h>
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <cstring>
+
+////////////////////////////////////////////////////////////////////////
+
+int
+main( int argc, char** argv )
+{
+    if ( argc < 2 || 3 < argc
+         || ! std::strncmp( argv[1], "--help", 6 )
+         || ! std::strncmp( argv[1], "-h", 2 ) )
+    {
+        std::cerr << "usage: " << argv[0] << " <BinaryLogFile>[.gz] [<OutputFile>]\n"
+                  << "  Convert the binary debug log to the text format.\n"
+                  << "  The result is written to the standard output if no output file is given."
+                  << std::endl;
+        return 0;
+    }
+
+    rcsc::gzpipeifstream fin( argv[1] );
+
+    if ( ! fin.is_open() )
+    {
+        std::cerr << "Failed to open file : " << argv[1] << std::endl;
+        return 1;
+    }
+
+    if ( ! rcsc::LogRecordDecoder::read_header( fin ) )
+    {
+        std::cerr << "Unsupported file format : " << argv[1] << std::endl;
+        return 1;
+    }
+
+    std::ofstream fout;
+    if ( argc == 3 )
+    {
+        fout.open( argv[2], std::ios_base::out | std::ios_base::binary );
+        if ( ! fout.is_open() )
+        {
+            std::cerr << "Failed to open file : " << argv[2] << std::endl;
+            return 1;
+        }
+    }
+
+    std::ostream & os = ( fout.is_open() ? fout : std::cout );
+
+    rcsc::LogRecordDecoder decoder;
+    rcsc::LogRecord record;
+    std::string text;
+    std::string buf;
+
+    while ( decoder.read( fin, record, text ) )
+    {
+        record.appendText( decoder.colorName( record ),
+                           text.data(), text.size(),
+                           buf );
+        if ( buf.length() > 65536 )
+        {
+            os.write( buf.data(), buf.length() );
+            buf.clear();
+        }
+    }
+
+    os.write( buf.data(), buf.length() );
+    os.flush();
+
+    if ( ! fin.eof() )
+    {
+        std::cerr << "Broken record found in " << argv[1] << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
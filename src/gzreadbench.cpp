@@ -0,0 +1,297 @@
+// -*-c++-*-
+
+/*!
+  \file gzreadbench.cpp
+  \brief gzip input stream benchmark source file.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <rcsc/rcg/parser.h>
+#include <rcsc/rcg/handler.h>
+#include <rcsc/gz.h>
+#include <rcsc/timer.h>
+
+#include <iostream>
+#include <string>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+
+/*
+
+  Usage:
+    gzreadbench [--repeat N] <RcgFile>[.gz]
+
+  The file is read by gzifstream and gzpipeifstream. For each stream, the
+  time to read all lines and the time to parse the whole log by
+  rcg::Parser are printed.
+
+*/
+
+namespace {
+
+class ShowCounter
+    : public rcsc::rcg::Handler {
+private:
+    std::size_t M_show_count;
+
+public:
+
+    ShowCounter()
+        : M_show_count( 0 )
+      { }
+
+    std::size_t showCount() const
+      {
+          return M_show_count;
+      }
+
+    bool handleEOF()
+      {
+          return true;
+      }
+    bool handleShow( const rcsc::rcg::ShowInfoT & )
+      {
+          ++M_show_count;
+          return true;
+      }
+    bool handleMsg( const int,
+                    const int,
+                    const std::string & )
+      {
+          return true;
+      }
+    bool handleDraw( const int,
+                     const rcsc::rcg::drawinfo_t & )
+      {
+          return true;
+      }
+    bool handlePlayMode( const int,
+                         const rcsc::PlayMode )
+      {
+          return true;
+      }
+    bool handleTeam( const int,
+                     const rcsc::rcg::TeamT &,
+                     const rcsc::rcg::TeamT & )
+      {
+          return true;
+      }
+    bool handleServerParam( const std::string & )
+      {
+          return true;
+      }
+    bool handlePlayerParam( const std::string & )
+      {
+          return true;
+      }
+    bool handlePlayerType( const std::string & )
+      {
+          return true;
+      }
+};
+
+struct Result {
+    double read_msec_;
+    double parse_msec_;
+    std::size_t bytes_;
+    std::size_t lines_;
+    std::size_t shows_;
+
+    Result()
+        : read_msec_( 0.0 ),
+          parse_msec_( 0.0 ),
+          bytes_( 0 ),
+          lines_( 0 ),
+          shows_( 0 )
+      { }
+};
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+template < typename Stream >
+bool
+run( const char * filepath,
+     const int repeat,
+     Result & result )
+{
+    for ( int i = 0; i < repeat; ++i )
+    {
+        // read all lines
+        {
+            rcsc::Timer timer;
+
+            Stream fin( filepath );
+            if ( ! fin.is_open() )
+            {
+                std::cerr << "Failed to open file : " << filepath << std::endl;
+                return false;
+            }
+
+            std::size_t bytes = 0;
+            std::size_t lines = 0;
+            std::string line;
+            while ( std::getline( fin, line ) )
+            {
+                bytes += line.length() + 1;
+                ++lines;
+            }
+
+            result.read_msec_ += timer.elapsedReal();
+            result.bytes_ = bytes;
+            result.lines_ = lines;
+        }
+
+        // parse the whole log
+        {
+            rcsc::Timer timer;
+
+            Stream fin( filepath );
+            rcsc::rcg::Parser::Ptr parser = rcsc::rcg::Parser::create( fin );
+            if ( ! parser )
+            {
+                std::cerr << "Failed to create rcg parser." << std::endl;
+                return false;
+            }
+
+            ShowCounter counter;
+            parser->parse( fin, counter );
+
+            result.parse_msec_ += timer.elapsedReal();
+            result.shows_ = counter.showCount();
+        }
+    }
+
+    result.read_msec_ /= repeat;
+    result.parse_msec_ /= repeat;
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+print( const char * name,
+       const Result & result )
+{
+    const double mb = result.bytes_ / ( 1024.0 * 1024.0 );
+
+    std::cout << name << ": read "
+              << result.read_msec_ << " [ms] "
+              << ( result.read_msec_ > 0.0 ? mb / ( result.read_msec_ * 0.001 ) : 0.0 ) << " [MB/s], parse "
+              << result.parse_msec_ << " [ms] "
+              << ( result.parse_msec_ > 0.0 ? mb / ( result.parse_msec_ * 0.001 ) : 0.0 ) << " [MB/s] ("
+              << result.lines_ << " lines, "
+              << result.shows_ << " shows)"
+              << std::endl;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+usage( const char * prog )
+{
+    std::cerr << "Usage: " << prog << " [--repeat N] <RcgFile>[.gz]"
+              << std::endl;
+}
+
+}
+
+////////////////////////////////////////////////////////////////////////
+
+int
+main( int argc, char ** argv )
+{
+    int repeat = 3;
+    const char * filepath = nullptr;
+
+    for ( int i = 1; i < argc; ++i )
+    {
+        if ( ! std::strcmp( argv[i], "--help" )
+             || ! std::strcmp( argv[i], "-h" ) )
+        {
+            usage( argv[0] );
+            return 0;
+        }
+        else if ( ! std::strcmp( argv[i], "--repeat" )
+                  && i + 1 < argc )
+        {
+            repeat = std::max( 1, std::atoi( argv[++i] ) );
+        }
+        else
+        {
+            filepath = argv[i];
+        }
+    }
+
+    if ( ! filepath )
+    {
+        usage( argv[0] );
+        return 1;
+    }
+
+    Result gz;
+    Result pipe;
+
+    if ( ! run< rcsc::gzifstream >( filepath, repeat, gz )
+         || ! run< rcsc::gzpipeifstream >( filepath, repeat, pipe ) )
+    {
+        return 1;
+    }
+
+    std::cout << "file=" << filepath
+              << " repeat=" << repeat
+              << std::endl;
+    print( "gzifstream    ", gz );
+    print( "gzpipeifstream", pipe );
+
+    if ( pipe.read_msec_ > 0.0 && pipe.parse_msec_ > 0.0 )
+    {
+        std::cout << "speedup: read " << gz.read_msec_ / pipe.read_msec_
+                  << " parse " << gz.parse_msec_ / pipe.parse_msec_
+                  << std::endl;
+    }
+
+    if ( gz.lines_ != pipe.lines_
+         || gz.bytes_ != pipe.bytes_
+         || gz.shows_ != pipe.shows_ )
+    {
+        std::cout << "check: NG" << std::endl;
+        return 1;
+    }
+
+    std::cout << "check: OK" << std::endl;
+    return 0;
+}
@@ -0,0 +1,357 @@
+// -*-c++-*-
+
+/*!
+  \file msgparsebench.cpp
+  \brief server message parsing latency benchmark.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <rcsc/player/visual_sensor.h>
+#include <rcsc/player/body_sensor.h>
+#include <rcsc/player/audio_sensor.h>
+#include <rcsc/player/fullstate_sensor.h>
+#include <rcsc/common/server_param.h>
+#include <rcsc/common/player_param.h>
+#include <rcsc/common/player_type.h>
+#include <rcsc/game_time.h>
+#include <rcsc/types.h>
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+
+/*
+
+  Usage:
+    msgparsebench [--repeat N] [--version V] [--team NAME] [--side {l|r}] LogFile
+
+  The raw server messages are read from LogFile. For each line, the text
+  before the first '(' is ignored, so the player's message log can be given
+  directly. The messages are replayed in the same order by the sensors and
+  the parameter parsers of the player, and the percentiles of the parsing
+  time are printed for each message type. Only the public interfaces are
+  used, so the same program can be built against the older library to
+  compare the results.
+
+*/
+
+namespace {
+
+using namespace rcsc;
+
+enum MessageKind {
+    MSG_SEE,
+    MSG_SENSE_BODY,
+    MSG_HEAR,
+    MSG_FULLSTATE,
+    MSG_SERVER_PARAM,
+    MSG_PLAYER_PARAM,
+    MSG_PLAYER_TYPE,
+    MSG_KIND_SIZE,
+};
+
+const char * KIND_NAMES[MSG_KIND_SIZE] = {
+    "see",
+    "sense_body",
+    "hear",
+    "fullstate",
+    "server_param",
+    "player_param",
+    "player_type",
+};
+
+struct Message {
+    MessageKind kind_;
+    long cycle_;
+    std::string str_;
+};
+
+/*-------------------------------------------------------------------*/
+void
+usage( const char * prog )
+{
+    std::cerr << "Usage: " << prog
+              << " [--repeat N] [--version V] [--team NAME] [--side {l|r}] LogFile"
+              << std::endl;
+}
+
+/*-------------------------------------------------------------------*/
+bool
+read_messages( const char * filepath,
+               std::vector< Message > & messages )
+{
+    std::ifstream fin( filepath );
+    if ( ! fin )
+    {
+        std::cerr << "could not open the file [" << filepath << "]" << std::endl;
+        return false;
+    }
+
+    std::string line;
+    while ( std::getline( fin, line ) )
+    {
+        const std::string::size_type begin = line.find( '(' );
+        if ( begin == std::string::npos )
+        {
+            continue;
+        }
+
+        const std::string::size_type end = line.find_first_of( " )", begin );
+        if ( end == std::string::npos )
+        {
+            continue;
+        }
+
+        const std::string tag( line, begin + 1, end - begin - 1 );
+
+        Message m;
+        m.kind_ = MSG_KIND_SIZE;
+        for ( int k = 0; k < MSG_KIND_SIZE; ++k )
+        {
+            if ( tag == KIND_NAMES[k] )
+            {
+                m.kind_ = static_cast< MessageKind >( k );
+                break;
+            }
+        }
+
+        if ( m.kind_ == MSG_KIND_SIZE )
+        {
+            continue;
+        }
+
+        m.cycle_ = std::strtol( line.c_str() + end, nullptr, 10 );
+        m.str_.assign( line, begin, std::string::npos );
+        messages.push_back( m );
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief dispatch the hear message in the same manner as PlayerAgent.
+ */
+void
+parse_hear( AudioSensor & audio,
+            const char * msg,
+            const GameTime & current )
+{
+    const char * sender = msg + 5; // skip "(hear"
+    while ( *sender == ' ' ) ++sender;
+    while ( *sender != '\0' && *sender != ' ' ) ++sender; // skip time
+    while ( *sender == ' ' ) ++sender;
+
+    if ( *sender == '-'
+         || ( '0' <= *sender && *sender <= '9' ) )
+    {
+        audio.parsePlayerMessage( msg, current );
+    }
+    else if ( ! std::strncmp( sender, "online_coach_", 13 ) )
+    {
+        audio.parseCoachMessage( msg, current );
+    }
+    else if ( ! std::strncmp( sender, "coach", 5 ) )
+    {
+        audio.parseTrainerMessage( msg, current );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+double
+percentile( const std::vector< double > & sorted,
+            const double rate )
+{
+    if ( sorted.empty() )
+    {
+        return 0.0;
+    }
+
+    std::size_t idx = static_cast< std::size_t >( rate * ( sorted.size() - 1 ) + 0.5 );
+    return sorted[std::min( idx, sorted.size() - 1 )];
+}
+
+}
+
+/*-------------------------------------------------------------------*/
+int
+main( int argc, char ** argv )
+{
+    int repeat = 20;
+    double version = 18.0;
+    std::string team_name = "HELIOS_base";
+    SideID our_side = LEFT;
+    const char * filepath = nullptr;
+
+    for ( int i = 1; i < argc; ++i )
+    {
+        if ( ! std::strcmp( argv[i], "--repeat" )
+             && i + 1 < argc )
+        {
+            repeat = std::max( 1, std::atoi( argv[++i] ) );
+        }
+        else if ( ! std::strcmp( argv[i], "--version" )
+                  && i + 1 < argc )
+        {
+            version = std::atof( argv[++i] );
+        }
+        else if ( ! std::strcmp( argv[i], "--team" )
+                  && i + 1 < argc )
+        {
+            team_name = argv[++i];
+        }
+        else if ( ! std::strcmp( argv[i], "--side" )
+                  && i + 1 < argc )
+        {
+            ++i;
+            our_side = ( argv[i][0] == 'r' ? RIGHT : LEFT );
+        }
+        else if ( argv[i][0] != '-'
+                  && ! filepath )
+        {
+            filepath = argv[i];
+        }
+        else
+        {
+            usage( argv[0] );
+            return 1;
+        }
+    }
+
+    if ( ! filepath )
+    {
+        usage( argv[0] );
+        return 1;
+    }
+
+    std::vector< Message > messages;
+    if ( ! read_messages( filepath, messages ) )
+    {
+        return 1;
+    }
+
+    VisualSensor visual;
+    BodySensor body;
+    AudioSensor audio;
+    FullstateSensor fullstate;
+
+    std::vector< double > nsec[MSG_KIND_SIZE];
+    double total[MSG_KIND_SIZE] = { 0.0 };
+
+    for ( int r = 0; r < repeat; ++r )
+    {
+        for ( const Message & m : messages )
+        {
+            // advance the time in every message so that the sensors do not skip the update.
+            const GameTime current( m.cycle_ + r * 100000, 0 );
+            const char * msg = m.str_.c_str();
+
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+            switch ( m.kind_ ) {
+            case MSG_SEE:
+                visual.parse( msg, team_name, version, current );
+                break;
+            case MSG_SENSE_BODY:
+                body.parse( msg, version, current );
+                break;
+            case MSG_HEAR:
+                parse_hear( audio, msg, current );
+                break;
+            case MSG_FULLSTATE:
+                fullstate.parse( msg, our_side, version, current );
+                break;
+            case MSG_SERVER_PARAM:
+                ServerParam::instance().parse( msg, version );
+                break;
+            case MSG_PLAYER_PARAM:
+                PlayerParam::instance().parse( msg, version );
+                break;
+            case MSG_PLAYER_TYPE:
+                {
+                    PlayerType ptype( msg, version );
+                    (void)ptype;
+                }
+                break;
+            default:
+                break;
+            }
+
+            const double elapsed
+                = std::chrono::duration< double, std::nano >( std::chrono::steady_clock::now() - start ).count();
+            nsec[m.kind_].push_back( elapsed );
+            total[m.kind_] += elapsed;
+        }
+    }
+
+    std::cout << "messages=" << messages.size()
+              << " repeat=" << repeat
+              << " version=" << version
+              << "\n";
+    std::cout << std::left << std::setw( 14 ) << "[nsec]"
+              << std::right
+              << std::setw( 8 ) << "count"
+              << std::setw( 10 ) << "mean"
+              << std::setw( 10 ) << "p50"
+              << std::setw( 10 ) << "p90"
+              << std::setw( 10 ) << "p99"
+              << std::setw( 10 ) << "max"
+              << '\n';
+    std::cout << std::fixed << std::setprecision( 0 );
+
+    for ( int k = 0; k < MSG_KIND_SIZE; ++k )
+    {
+        std::vector< double > & v = nsec[k];
+        if ( v.empty() )
+        {
+            continue;
+        }
+
+        std::sort( v.begin(), v.end() );
+        std::cout << std::left << std::setw( 14 ) << KIND_NAMES[k]
+                  << std::right
+                  << std::setw( 8 ) << v.size()
+                  << std::setw( 10 ) << total[k] / v.size()
+                  << std::setw( 10 ) << percentile( v, 0.5 )
+                  << std::setw( 10 ) << percentile( v, 0.9 )
+                  << std::setw( 10 ) << percentile( v, 0.99 )
+                  << std::setw( 10 ) << v.back()
+                  << '\n';
+    }
+    std::cout << std::flush;
+
+    return 0;
+}
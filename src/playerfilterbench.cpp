@@ -0,0 +1,349 @@
+// -*-c++-*-
+
+/*!
+  \file playerfilterbench.cpp
+  \brief PlayerPredicate and PlayerFilter benchmark.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <rcsc/player/player_filter.h>
+#include <rcsc/player/player_predicate.h>
+#include <rcsc/player/player_object.h>
+#include <rcsc/timer.h>
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+
+/*
+
+  Usage:
+    playerfilterbench [--repeat N]
+
+  The player conditions used in Body_Pass and Body_HoldBall2008 are
+  evaluated for the random player sets. Each condition is written with the
+  heap allocated PlayerPredicate objects and with the PlayerFilter
+  expression, and the time per query of both versions is printed.
+
+*/
+
+namespace {
+
+using namespace rcsc;
+
+const SideID OUR_SIDE = LEFT;
+const int SELF_UNUM = 10;
+
+/*!
+  \brief player object with the arbitrary state
+ */
+class BenchPlayer
+    : public PlayerObject {
+public:
+
+    BenchPlayer( const SideID side,
+                 const int unum,
+                 const bool goalie,
+                 const Vector2D & pos,
+                 const int pos_count,
+                 const bool ghost )
+      {
+          setTeam( side, unum, goalie );
+          M_pos = pos;
+          M_pos_count = pos_count;
+          if ( ghost )
+          {
+              setGhost();
+          }
+      }
+};
+
+struct Result {
+    double predicate_msec_;
+    double filter_msec_;
+    std::size_t predicate_matched_;
+    std::size_t filter_matched_;
+
+    Result()
+        : predicate_msec_( 0.0 ),
+          filter_msec_( 0.0 ),
+          predicate_matched_( 0 ),
+          filter_matched_( 0 )
+      { }
+};
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+create_players( std::mt19937 & engine,
+                std::vector< BenchPlayer > & players )
+{
+    std::uniform_real_distribution<> x_dist( -52.5, 52.5 );
+    std::uniform_real_distribution<> y_dist( -34.0, 34.0 );
+    std::uniform_int_distribution<> count_dist( 0, 15 );
+    std::uniform_int_distribution<> ghost_dist( 0, 9 );
+
+    players.clear();
+    for ( int unum = 1; unum <= 11; ++unum )
+    {
+        if ( unum == SELF_UNUM ) continue;
+        players.emplace_back( OUR_SIDE, unum, unum == 1,
+                              Vector2D( x_dist( engine ), y_dist( engine ) ),
+                              count_dist( engine ), ghost_dist( engine ) == 0 );
+    }
+    for ( int unum = 1; unum <= 11; ++unum )
+    {
+        players.emplace_back( RIGHT, unum, unum == 1,
+                              Vector2D( x_dist( engine ), y_dist( engine ) ),
+                              count_dist( engine ), ghost_dist( engine ) == 0 );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  evaluate the predicate created for each query, as the callers of
+  WorldModel::getPlayers() do.
+ */
+template < typename Factory >
+void
+run_predicate( const std::vector< const AbstractPlayerObject * > & players,
+               const int queries,
+               Factory factory,
+               Result & result )
+{
+    rcsc::Timer timer;
+    std::size_t matched = 0;
+
+    for ( int q = 0; q < queries; ++q )
+    {
+        const PlayerPredicate * predicate = factory( q );
+        for ( const AbstractPlayerObject * p : players )
+        {
+            if ( (*predicate)( *p ) )
+            {
+                ++matched;
+            }
+        }
+        delete predicate;
+    }
+
+    result.predicate_msec_ += timer.elapsedReal();
+    result.predicate_matched_ += matched;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+template < typename Factory >
+void
+run_filter( const std::vector< const AbstractPlayerObject * > & players,
+            const int queries,
+            Factory factory,
+            Result & result )
+{
+    rcsc::Timer timer;
+    std::size_t matched = 0;
+
+    for ( int q = 0; q < queries; ++q )
+    {
+        const auto filter = factory( q );
+        for ( const AbstractPlayerObject * p : players )
+        {
+            if ( filter( *p ) )
+            {
+                ++matched;
+            }
+        }
+    }
+
+    result.filter_msec_ += timer.elapsedReal();
+    result.filter_matched_ += matched;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+print( const char * name,
+       const int queries,
+       const Result & result )
+{
+    const double n = queries;
+    std::cout << name << ": predicate "
+              << result.predicate_msec_ * 1.0e6 / n << " [ns/query], filter "
+              << result.filter_msec_ * 1.0e6 / n << " [ns/query] (matched "
+              << result.predicate_matched_ << '/' << result.filter_matched_
+              << ( result.predicate_matched_ == result.filter_matched_ ? "" : " MISMATCH" )
+              << ")" << std::endl;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+usage( const char * prog )
+{
+    std::cerr << "Usage: " << prog << " [--repeat N]"
+              << std::endl;
+}
+
+}
+
+////////////////////////////////////////////////////////////////////////
+
+int
+main( int argc, char ** argv )
+{
+    int repeat = 10;
+
+    for ( int i = 1; i < argc; ++i )
+    {
+        if ( ! std::strcmp( argv[i], "--repeat" )
+             && i + 1 < argc )
+        {
+            repeat = std::max( 1, std::atoi( argv[++i] ) );
+        }
+        else
+        {
+            usage( argv[0] );
+            return 0;
+        }
+    }
+
+    const int queries = 100000;
+
+    std::mt19937 engine( 1 );
+    std::vector< BenchPlayer > players;
+    std::vector< const AbstractPlayerObject * > ptrs;
+
+    Result pass_receiver, pass_opponent, hold_opponent;
+
+    for ( int r = 0; r < repeat; ++r )
+    {
+        create_players( engine, players );
+        ptrs.clear();
+        for ( const BenchPlayer & p : players )
+        {
+            ptrs.push_back( &p );
+        }
+
+        const Vector2D ball_pos( 10.0, 5.0 );
+
+        //
+        // Body_Pass: receiver candidates
+        //
+        run_predicate( ptrs, queries,
+                       []( int )
+                       {
+                           return new AndPlayerPredicate
+                               ( new TeammatePlayerPredicate( OUR_SIDE, SELF_UNUM ),
+                                 new NotPlayerPredicate
+                                 ( new AndPlayerPredicate( new GoaliePlayerPredicate(),
+                                                           new XCoordinateBackwardPlayerPredicate( -22.0 ) ) ),
+                                 new CoordinateAccuratePlayerPredicate( 3 ) );
+                       },
+                       pass_receiver );
+        run_filter( ptrs, queries,
+                    []( int )
+                    {
+                        using namespace player_filter;
+                        return teammate( OUR_SIDE, SELF_UNUM )
+                            && ! ( goalie() && x_backward( -22.0 ) )
+                            && coordinate_accurate( 3 );
+                    },
+                    pass_receiver );
+
+        //
+        // Body_Pass: opponents checked for the pass course
+        //
+        run_predicate( ptrs, queries,
+                       []( int )
+                       {
+                           return new AndPlayerPredicate
+                               ( new OpponentOrUnknownPlayerPredicate( OUR_SIDE ),
+                                 new CoordinateAccuratePlayerPredicate( 10 ),
+                                 new NotPlayerPredicate
+                                 ( new AndPlayerPredicate( new GhostPlayerPredicate(),
+                                                           new NotPlayerPredicate( new CoordinateAccuratePlayerPredicate( 3 ) ) ) ) );
+                       },
+                       pass_opponent );
+        run_filter( ptrs, queries,
+                    []( int )
+                    {
+                        using namespace player_filter;
+                        return opponent_or_unknown( OUR_SIDE )
+                            && coordinate_accurate( 10 )
+                            && ! ( ghost() && ! coordinate_accurate( 3 ) );
+                    },
+                    pass_opponent );
+
+        //
+        // Body_HoldBall2008: opponents around the ball
+        //
+        run_predicate( ptrs, queries,
+                       [&]( int q )
+                       {
+                           return new AndPlayerPredicate
+                               ( new OpponentOrUnknownPlayerPredicate( OUR_SIDE ),
+                                 new PointNearPlayerPredicate( ball_pos, 5.0 + ( q & 7 ) ),
+                                 new CoordinateAccuratePlayerPredicate( 10 ),
+                                 new NotPlayerPredicate( new GhostPlayerPredicate() ) );
+                       },
+                       hold_opponent );
+        run_filter( ptrs, queries,
+                    [&]( int q )
+                    {
+                        using namespace player_filter;
+                        return opponent_or_unknown( OUR_SIDE )
+                            && point_near( ball_pos, 5.0 + ( q & 7 ) )
+                            && coordinate_accurate( 10 )
+                            && ! ghost();
+                    },
+                    hold_opponent );
+    }
+
+    const int total = queries * repeat;
+    print( "pass receiver", total, pass_receiver );
+    print( "pass opponent", total, pass_opponent );
+    print( "hold opponent", total, hold_opponent );
+
+    return ( pass_receiver.predicate_matched_ == pass_receiver.filter_matched_
+             && pass_opponent.predicate_matched_ == pass_opponent.filter_matched_
+             && hold_opponent.predicate_matched_ == hold_opponent.filter_matched_
+             ? 0 : 1 );
+}
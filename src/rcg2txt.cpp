@@ -646,7 +646,7 @@ main( int argc, char** argv )
         return 0;
     }
 
-    rcsc::gzifstream fin( argv[1] );
+    rcsc::gzpipeifstream fin( argv[1] );
 
     if ( ! fin.is_open() )
     {
@@ -0,0 +1,186 @@
+// -*-c++-*-
+
+/*!
+  \file rcgbatch.cpp
+  \brief parallel rcg batch analyzer program source File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "csv_printer.h"
+#include "result_printer.h"
+
+#include <rcsc/rcg/batch_runner.h>
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdlib>
+
+/*
+
+  Usage:
+    rcgbatch [-j N] [--mode result|csv] [--list FILE] <RcgFileOrDir>...
+
+  All given log files (or *.rcg[.gz] files in the given directories) are
+  processed by N worker threads. The per-log outputs are printed to the
+  standard output in the order of the input, and the throughput statistics
+  are printed to the standard error.
+
+*/
+
+namespace {
+
+void
+usage( const char * prog )
+{
+    std::cerr << "Usage: " << prog << " [options] <RcgFileOrDir>...\n"
+              << "Options:\n"
+              << "  -j, --threads N   the number of worker threads (default: hardware threads)\n"
+              << "  --mode MODE       result | csv (default: result)\n"
+              << "  --list FILE       read log file paths from FILE (one path per line)\n"
+              << "  -q, --quiet       do not print statistics"
+              << std::endl;
+}
+
+}
+
+////////////////////////////////////////////////////////////////////////
+
+int
+main( int argc, char ** argv )
+{
+    int threads = 0;
+    std::string mode = "result";
+    bool quiet = false;
+    std::vector< std::string > files;
+
+    for ( int i = 1; i < argc; ++i )
+    {
+        if ( ! std::strcmp( argv[i], "--help" )
+             || ! std::strcmp( argv[i], "-h" ) )
+        {
+            usage( argv[0] );
+            return 0;
+        }
+        else if ( ( ! std::strcmp( argv[i], "-j" )
+                    || ! std::strcmp( argv[i], "--threads" ) )
+                  && i + 1 < argc )
+        {
+            threads = std::atoi( argv[++i] );
+        }
+        else if ( ! std::strcmp( argv[i], "--mode" )
+                  && i + 1 < argc )
+        {
+            mode = argv[++i];
+        }
+        else if ( ! std::strcmp( argv[i], "--list" )
+                  && i + 1 < argc )
+        {
+            std::ifstream fin( argv[++i] );
+            if ( ! fin.is_open() )
+            {
+                std::cerr << "Failed to open the list file : " << argv[i] << std::endl;
+                return 1;
+            }
+
+            std::string line;
+            while ( std::getline( fin, line ) )
+            {
+                if ( line.empty() || line[0] == '#' ) continue;
+                rcsc::rcg::BatchRunner::collect_files( line, files );
+            }
+        }
+        else if ( ! std::strcmp( argv[i], "-q" )
+                  || ! std::strcmp( argv[i], "--quiet" ) )
+        {
+            quiet = true;
+        }
+        else if ( argv[i][0] == '-' )
+        {
+            std::cerr << "Unknown option : " << argv[i] << std::endl;
+            usage( argv[0] );
+            return 1;
+        }
+        else
+        {
+            rcsc::rcg::BatchRunner::collect_files( argv[i], files );
+        }
+    }
+
+    if ( files.empty() )
+    {
+        usage( argv[0] );
+        return 1;
+    }
+
+    rcsc::rcg::BatchRunner::HandlerCreator creator;
+    if ( mode == "result" )
+    {
+        creator = []( const std::string & filepath,
+                      std::ostream & os,
+                      const std::size_t )
+                    {
+                        return std::shared_ptr< rcsc::rcg::Handler >( new ResultPrinter( os, filepath ) );
+                    };
+    }
+    else if ( mode == "csv" )
+    {
+        // the column header is printed only for the first log file.
+        creator = []( const std::string &,
+                      std::ostream & os,
+                      const std::size_t index )
+                    {
+                        return std::shared_ptr< rcsc::rcg::Handler >( new CSVPrinter( os, index == 0 ) );
+                    };
+    }
+    else
+    {
+        std::cerr << "Unknown mode : " << mode << std::endl;
+        usage( argv[0] );
+        return 1;
+    }
+
+    rcsc::rcg::BatchRunner runner( creator );
+    runner.setThreadCount( threads );
+
+    const bool result = runner.run( files );
+
+    runner.printOutputs( std::cout );
+    std::cout << std::flush;
+
+    if ( ! quiet )
+    {
+        runner.printStatistics( std::cerr );
+    }
+
+    return result ? 0 : 1;
+}
@@ -0,0 +1,353 @@
+// -*-c++-*-
+
+/*!
+  \file rcgparsebench.cpp
+  \brief rcg parser benchmark source file.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <rcsc/rcg/parser_v4.h>
+#include <rcsc/rcg/parser_v4_fast.h>
+#include <rcsc/rcg/handler.h>
+#include <rcsc/rcg/types.h>
+#include <rcsc/gz.h>
+#include <rcsc/timer.h>
+
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+
+/*
+
+  Usage:
+    rcgparsebench [--repeat N] [--check] <RcgFile>[.gz]
+
+  The whole file is loaded into memory at first. Then, the show lines are
+  decoded by ParserV4 and ParserV4Fast, and the throughput of each parser
+  is printed. If --check is given, parsed show data are compared.
+
+*/
+
+namespace {
+
+class ShowCollector
+    : public rcsc::rcg::Handler {
+private:
+    bool M_store;
+    std::size_t M_show_count;
+    std::vector< rcsc::rcg::ShowInfoT > M_shows;
+
+public:
+
+    explicit
+    ShowCollector( const bool store )
+        : M_store( store ),
+          M_show_count( 0 )
+      { }
+
+    std::size_t showCount() const
+      {
+          return M_show_count;
+      }
+
+    const std::vector< rcsc::rcg::ShowInfoT > & shows() const
+      {
+          return M_shows;
+      }
+
+    bool handleEOF()
+      {
+          return true;
+      }
+    bool handleShow( const rcsc::rcg::ShowInfoT & show )
+      {
+          ++M_show_count;
+          if ( M_store ) M_shows.push_back( show );
+          return true;
+      }
+    bool handleMsg( const int,
+                    const int,
+                    const std::string & )
+      {
+          return true;
+      }
+    bool handleDraw( const int,
+                     const rcsc::rcg::drawinfo_t & )
+      {
+          return true;
+      }
+    bool handlePlayMode( const int,
+                         const rcsc::PlayMode )
+      {
+          return true;
+      }
+    bool handleTeam( const int,
+                     const rcsc::rcg::TeamT &,
+                     const rcsc::rcg::TeamT & )
+      {
+          return true;
+      }
+    bool handleServerParam( const std::string & )
+      {
+          return true;
+      }
+    bool handlePlayerParam( const std::string & )
+      {
+          return true;
+      }
+    bool handlePlayerType( const std::string & )
+      {
+          return true;
+      }
+};
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+same_player( const rcsc::rcg::PlayerT & lhs,
+             const rcsc::rcg::PlayerT & rhs )
+{
+    return ( lhs.side_ == rhs.side_
+             && lhs.unum_ == rhs.unum_
+             && lhs.type_ == rhs.type_
+             && lhs.view_quality_ == rhs.view_quality_
+             && lhs.focus_side_ == rhs.focus_side_
+             && lhs.focus_unum_ == rhs.focus_unum_
+             && lhs.state_ == rhs.state_
+             && lhs.x_ == rhs.x_
+             && lhs.y_ == rhs.y_
+             && lhs.vx_ == rhs.vx_
+             && lhs.vy_ == rhs.vy_
+             && lhs.body_ == rhs.body_
+             && lhs.neck_ == rhs.neck_
+             && lhs.point_x_ == rhs.point_x_
+             && lhs.point_y_ == rhs.point_y_
+             && lhs.view_width_ == rhs.view_width_
+             && lhs.focus_dist_ == rhs.focus_dist_
+             && lhs.focus_dir_ == rhs.focus_dir_
+             && lhs.stamina_ == rhs.stamina_
+             && lhs.effort_ == rhs.effort_
+             && lhs.recovery_ == rhs.recovery_
+             && lhs.stamina_capacity_ == rhs.stamina_capacity_
+             && lhs.kick_count_ == rhs.kick_count_
+             && lhs.dash_count_ == rhs.dash_count_
+             && lhs.turn_count_ == rhs.turn_count_
+             && lhs.catch_count_ == rhs.catch_count_
+             && lhs.move_count_ == rhs.move_count_
+             && lhs.turn_neck_count_ == rhs.turn_neck_count_
+             && lhs.change_view_count_ == rhs.change_view_count_
+             && lhs.say_count_ == rhs.say_count_
+             && lhs.tackle_count_ == rhs.tackle_count_
+             && lhs.pointto_count_ == rhs.pointto_count_
+             && lhs.attentionto_count_ == rhs.attentionto_count_
+             && lhs.change_focus_count_ == rhs.change_focus_count_ );
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+bool
+same_show( const rcsc::rcg::ShowInfoT & lhs,
+           const rcsc::rcg::ShowInfoT & rhs )
+{
+    if ( lhs.time_ != rhs.time_
+         || lhs.ball_.x_ != rhs.ball_.x_
+         || lhs.ball_.y_ != rhs.ball_.y_
+         || lhs.ball_.vx_ != rhs.ball_.vx_
+         || lhs.ball_.vy_ != rhs.ball_.vy_ )
+    {
+        return false;
+    }
+
+    for ( int i = 0; i < rcsc::MAX_PLAYER*2; ++i )
+    {
+        if ( ! same_player( lhs.player_[i], rhs.player_[i] ) )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+double
+run( const char * name,
+     const rcsc::rcg::Parser & parser,
+     const std::string & data,
+     const int repeat,
+     ShowCollector & collector )
+{
+    const std::size_t n_lines = std::count( data.begin(), data.end(), '\n' );
+
+    double total_msec = 0.0;
+    for ( int i = 0; i < repeat; ++i )
+    {
+        std::istringstream is( data );
+        ShowCollector counter( false );
+        ShowCollector & handler = ( i == 0 ? collector : counter );
+
+        rcsc::Timer timer;
+        parser.parse( is, handler );
+        total_msec += timer.elapsedReal();
+    }
+
+    const double sec = total_msec * 0.001;
+    const double lines_per_sec = ( sec > 0.0 ? n_lines * repeat / sec : 0.0 );
+    const double mb_per_sec = ( sec > 0.0 ? data.size() * repeat / sec / ( 1024.0 * 1024.0 ) : 0.0 );
+
+    std::cout << name << ": "
+              << total_msec / repeat << " [ms/file] "
+              << lines_per_sec << " [lines/s] "
+              << mb_per_sec << " [MB/s]"
+              << std::endl;
+
+    return total_msec;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+usage( const char * prog )
+{
+    std::cerr << "Usage: " << prog << " [--repeat N] [--check] <RcgFile>[.gz]"
+              << std::endl;
+}
+
+}
+
+////////////////////////////////////////////////////////////////////////
+
+int
+main( int argc, char ** argv )
+{
+    int repeat = 5;
+    bool check = false;
+    const char * filepath = nullptr;
+
+    for ( int i = 1; i < argc; ++i )
+    {
+        if ( ! std::strcmp( argv[i], "--help" )
+             || ! std::strcmp( argv[i], "-h" ) )
+        {
+            usage( argv[0] );
+            return 0;
+        }
+        else if ( ! std::strcmp( argv[i], "--repeat" )
+                  && i + 1 < argc )
+        {
+            repeat = std::max( 1, std::atoi( argv[++i] ) );
+        }
+        else if ( ! std::strcmp( argv[i], "--check" ) )
+        {
+            check = true;
+        }
+        else
+        {
+            filepath = argv[i];
+        }
+    }
+
+    if ( ! filepath )
+    {
+        usage( argv[0] );
+        return 1;
+    }
+
+    rcsc::gzifstream fin( filepath );
+
+    if ( ! fin.is_open() )
+    {
+        std::cerr << "Failed to open file : " << filepath << std::endl;
+        return 1;
+    }
+
+    std::ostringstream buf;
+    buf << fin.rdbuf();
+    const std::string data = buf.str();
+
+    std::cout << "file=" << filepath
+              << " size=" << data.size() << " [bytes]"
+              << " lines=" << std::count( data.begin(), data.end(), '\n' )
+              << " repeat=" << repeat
+              << std::endl;
+
+    ShowCollector collector_v4( check );
+    ShowCollector collector_fast( check );
+
+    const double msec_v4 = run( "ParserV4    ", rcsc::rcg::ParserV4(), data, repeat, collector_v4 );
+    const double msec_fast = run( "ParserV4Fast", rcsc::rcg::ParserV4Fast(), data, repeat, collector_fast );
+
+    if ( msec_fast > 0.0 )
+    {
+        std::cout << "speedup: " << msec_v4 / msec_fast << std::endl;
+    }
+
+    if ( check )
+    {
+        const std::vector< rcsc::rcg::ShowInfoT > & lhs = collector_v4.shows();
+        const std::vector< rcsc::rcg::ShowInfoT > & rhs = collector_fast.shows();
+
+        std::size_t n_diff = 0;
+        if ( lhs.size() != rhs.size() )
+        {
+            std::cout << "show count mismatch. "
+                      << lhs.size() << " != " << rhs.size() << std::endl;
+            ++n_diff;
+        }
+
+        for ( std::size_t i = 0; i < std::min( lhs.size(), rhs.size() ); ++i )
+        {
+            if ( ! same_show( lhs[i], rhs[i] ) )
+            {
+                std::cout << "show mismatch at time " << lhs[i].time_ << std::endl;
+                ++n_diff;
+            }
+        }
+
+        std::cout << "check: " << ( n_diff == 0 ? "OK" : "NG" )
+                  << " (" << lhs.size() << " shows)" << std::endl;
+        return n_diff == 0 ? 0 : 1;
+    }
+
+    return 0;
+}
@@ -408,7 +408,7 @@ main( int argc, char** argv )
         return 1;
     }
 
-    rcsc::gzifstream fin( input_file.c_str() );
+    rcsc::gzpipeifstream fin( input_file.c_str() );
 
     if ( ! fin.is_open() )
     {
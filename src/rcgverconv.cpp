@@ -35,6 +35,7 @@
 
 #include <rcsc/gz.h>
 #include <rcsc/rcg.h>
+#include <rcsc/rcg/serializer_columnar.h>
 
 #include <memory>
 #include <iostream>
@@ -58,7 +59,8 @@ private:
 public:
 
     VersionConverter( std::ostream & os,
-                      const int version );
+                      const int version,
+                      const int compression_level );
 
     bool handleLogVersion( const int ver );
 
@@ -86,11 +88,18 @@ public:
 
 */
 VersionConverter::VersionConverter( std::ostream & os,
-                                    const int version )
+                                    const int version,
+                                    const int compression_level )
     : M_os( os ),
       M_version( version )
 {
     M_serializer = rcsc::rcg::Serializer::create( version );
+
+    rcsc::rcg::SerializerColumnar * columnar = dynamic_cast< rcsc::rcg::SerializerColumnar * >( M_serializer.get() );
+    if ( columnar )
+    {
+        columnar->setCompressionLevel( compression_level );
+    }
 }
 
 /*-------------------------------------------------------------------*/
@@ -131,6 +140,10 @@ VersionConverter::handleLogVersion( const int ver )
 bool
 VersionConverter::handleEOF()
 {
+    if ( M_serializer )
+    {
+        M_serializer->serializeEnd( M_os );
+    }
     M_os.flush();
     return true;
 }
@@ -286,6 +299,9 @@ usage( const char * prog )
               << "        print this message.\n"
               << "    --version [ -v ] <Value> : (DefaultValue=4)\n"
               << "        specify the new rcg version.\n"
+              << "        'C' or 'columnar' means the binary columnar format.\n"
+              << "    --compression [ -c ] <Value> : (DefaultValue=6)\n"
+              << "        specify the zlib compression level (0-9) for the columnar format.\n"
               << "    --output [ -o ] <Value>\n"
               << "        specify the output file name.\n"
               << std::endl;
@@ -300,6 +316,7 @@ main( int argc, char** argv )
     std::string input_file;
     std::string output_file;
     int version = 4;
+    int compression_level = 6;
 
     for ( int i = 1; i < argc; ++i )
     {
@@ -318,7 +335,27 @@ main( int argc, char** argv )
                 usage( argv[0] );
                 return 1;
             }
-            version = std::atoi( argv[i] );
+            if ( ! std::strcmp( argv[i], "C" )
+                 || ! std::strcmp( argv[i], "c" )
+                 || ! std::strcmp( argv[i], "columnar" ) )
+            {
+                version = rcsc::rcg::REC_VERSION_COLUMNAR;
+            }
+            else
+            {
+                version = std::atoi( argv[i] );
+            }
+        }
+        else if ( ! std::strcmp( argv[i], "--compression" )
+                  || ! std::strcmp( argv[i], "-c" ) )
+        {
+            ++i;
+            if ( i >= argc )
+            {
+                usage( argv[0] );
+                return 1;
+            }
+            compression_level = std::atoi( argv[i] );
         }
         else if ( ! std::strcmp( argv[i], "--output" )
                   || ! std::strcmp( argv[i], "-o" ) )
@@ -358,7 +395,7 @@ main( int argc, char** argv )
         return 1;
     }
 
-    rcsc::gzifstream fin( input_file.c_str() );
+    rcsc::gzpipeifstream fin( input_file.c_str() );
 
     if ( ! fin.is_open() )
     {
@@ -395,7 +432,7 @@ main( int argc, char** argv )
     }
 
     // create rcg handler instance
-    VersionConverter converter( *fout, version );
+    VersionConverter converter( *fout, version, compression_level );
 
     parser->parse( fin, converter );
 
@@ -0,0 +1,128 @@
+// -*-c++-*-
+
+/*!
+  \file result_printer.h
+  \brief game result printer class Header File.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa Akiyama
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifndef RCSC_SRC_RESULT_PRINTER_H
+#define RCSC_SRC_RESULT_PRINTER_H
+
+#include <rcsc/rcg.h>
+#include <rcsc/types.h>
+
+#include <ostream>
+#include <string>
+#include <ctime>
+
+struct Point {
+    double x;
+    double y;
+
+    Point()
+        : x( 0.0 ),
+          y( 0.0 )
+      { }
+};
+
+class ResultPrinter
+    : public rcsc::rcg::Handler {
+private:
+
+    static const double PITCH_LENGTH;
+    static const double PITCH_WIDTH;
+
+    static const double GOAL_POST_RADIUS;
+
+    std::ostream & M_os;
+
+    std::string M_file_path;
+    std::time_t M_game_date;
+
+    double M_goal_width;
+    double M_ball_size;
+    int M_half_time;
+
+    rcsc::PlayMode M_playmode;
+    int M_cycle;
+
+    std::string M_left_team_name; //!< left teamname string
+    std::string M_right_team_name; //!< right teamname string
+
+    int M_left_score; //!< left team score
+    int M_right_score; //!< right team score
+
+    int M_left_penalty_taken; //!< total number of left team penalty trial
+    int M_right_penalty_taken; //!< total number of left team penalty trial
+
+    int M_left_penalty_score; //!< left team penalty kick score
+    int M_right_penalty_score; //!< left team penalty kick score
+
+    rcsc::SideID M_last_penalty_taker_side;
+
+    Point M_prev_ball_pos; //!< ball position at the previous show
+
+    // not used
+    ResultPrinter() = delete;
+    ResultPrinter( const ResultPrinter & ) = delete;
+    ResultPrinter & operator=( const ResultPrinter & ) = delete;
+
+public:
+
+    ResultPrinter( std::ostream & os,
+                   const std::string & input_file );
+
+    bool handleEOF();
+
+    bool handleShow( const rcsc::rcg::ShowInfoT & show );
+    bool handleMsg( const int time,
+                    const int board,
+                    const std::string & msg );
+    bool handleDraw( const int ,
+                     const rcsc::rcg::drawinfo_t & )
+      {
+          return true;
+      }
+    bool handlePlayMode( const int time,
+                         const rcsc::PlayMode pm );
+    bool handleTeam( const int time,
+                     const rcsc::rcg::TeamT & team_l,
+                     const rcsc::rcg::TeamT & team_r );
+    bool handleServerParam( const std::string & msg );
+    bool handlePlayerParam( const std::string & msg );
+    bool handlePlayerType( const std::string & msg );
+
+private:
+
+    bool crossGoalLine( const Point & ball_pos,
+                        const Point & prev_ball_pos );
+
+    void checkFinalPenaltyGoal( const Point & ball_pos );
+
+};
+
+#endif
@@ -0,0 +1,401 @@
+// -*-c++-*-
+
+/*!
+  \file visualsensorbench.cpp
+  \brief VisualSensor see message parsing benchmark.
+*/
+
+/*
+ *Copyright:
+
+ Copyright (C) Hidehisa AKIYAMA
+
+ This code is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 3 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+ *EndCopyright:
+ */
+
+/////////////////////////////////////////////////////////////////////
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <rcsc/player/visual_sensor.h>
+#include <rcsc/player/object_table.h>
+#include <rcsc/geom/vector_2d.h>
+#include <rcsc/game_time.h>
+#include <rcsc/timer.h>
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+#include <string>
+#include <random>
+#include <algorithm>
+#include <new>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <cmath>
+
+/*
+
+  Usage:
+    visualsensorbench [--repeat N] [--version V] [SeeFile]
+
+  The see messages are read from SeeFile. Each line that contains "(see "
+  is used from that position, so the player's message log can be given
+  directly. If no file is given, the see messages of the random situations
+  are generated. The messages are parsed by VisualSensor, and the time and
+  the number of the memory allocations per message are printed.
+  The parsed results are checked by rcsc/player/test_visual_sensor.cpp.
+
+*/
+
+namespace {
+
+using namespace rcsc;
+
+//! the number of the operator new calls
+std::size_t g_alloc_count = 0;
+
+}
+
+void *
+operator new( std::size_t size )
+{
+    ++g_alloc_count;
+    if ( void * ptr = std::malloc( size ? size : 1 ) )
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void
+operator delete( void * ptr ) noexcept
+{
+    std::free( ptr );
+}
+
+void
+operator delete( void * ptr,
+                 std::size_t ) noexcept
+{
+    std::free( ptr );
+}
+
+namespace {
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief create the marker names in the order of MarkerID
+ */
+std::vector< std::string >
+create_marker_names()
+{
+    std::vector< std::string > names = {
+        "g l", "g r",
+        "f c", "f c t", "f c b", "f l t", "f l b", "f r t", "f r b",
+        "f p l t", "f p l c", "f p l b", "f p r t", "f p r c", "f p r b",
+        "f g l t", "f g l b", "f g r t", "f g r b",
+    };
+
+    const char * tb_prefix[] = { "f t ", "f b " };
+    for ( const char * p : tb_prefix )
+    {
+        for ( int x = 50; x >= 10; x -= 10 ) names.push_back( std::string( p ) + "l " + std::to_string( x ) );
+        names.push_back( std::string( p ) + "0" );
+        for ( int x = 10; x <= 50; x += 10 ) names.push_back( std::string( p ) + "r " + std::to_string( x ) );
+    }
+
+    const char * lr_prefix[] = { "f l ", "f r " };
+    for ( const char * p : lr_prefix )
+    {
+        for ( int y = 30; y >= 10; y -= 10 ) names.push_back( std::string( p ) + "t " + std::to_string( y ) );
+        names.push_back( std::string( p ) + "0" );
+        for ( int y = 10; y <= 30; y += 10 ) names.push_back( std::string( p ) + "b " + std::to_string( y ) );
+    }
+
+    return names;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief write the object name in the protocol of the version
+ */
+void
+write_name( std::ostream & os,
+            const double version,
+            const char * new_name,
+            const char * old_name,
+            const char * rest )
+{
+    os << "((" << ( version >= 6.0 ? new_name : old_name ) << rest << ')';
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief generate the see messages of the random situations
+ */
+void
+generate_messages( const std::vector< std::string > & marker_names,
+                   const double version,
+                   const int size,
+                   std::vector< std::string > & messages )
+{
+    const ObjectTable table;
+    const std::unordered_map< MarkerID, Vector2D > & landmarks = table.landmarkMap();
+
+    std::mt19937 engine( 1 );
+    std::uniform_real_distribution<> x_dist( -52.5, 52.5 );
+    std::uniform_real_distribution<> y_dist( -34.0, 34.0 );
+    std::uniform_real_distribution<> dir_dist( -180.0, 180.0 );
+    std::uniform_real_distribution<> chg_dist( -1.0, 1.0 );
+    std::uniform_int_distribution<> flag_dist( 0, 9 );
+
+    const double half_view = 45.0;
+
+    for ( int m = 0; m < size; ++m )
+    {
+        const Vector2D self_pos( x_dist( engine ), y_dist( engine ) );
+        const AngleDeg face( dir_dist( engine ) );
+
+        std::ostringstream os;
+        os << "(see " << m;
+
+        // markers
+        for ( int id = 0; id < Marker_Unknown; ++id )
+        {
+            const Vector2D rel = landmarks.at( static_cast< MarkerID >( id ) ) - self_pos;
+            const double dir = ( rel.th() - face ).degree();
+            const std::string & name = marker_names[id];
+            if ( std::fabs( dir ) < half_view )
+            {
+                write_name( os << ' ', version,
+                            name.substr( 0, 1 ).c_str(),
+                            name[0] == 'f' ? "flag" : "goal",
+                            name.c_str() + 1 );
+                os << ' ' << std::round( rel.r() * 10.0 ) / 10.0 << ' ' << std::lround( dir ) << ')';
+            }
+            else if ( rel.r() < 3.0 )
+            {
+                write_name( os << ' ', version,
+                            name[0] == 'f' ? "F" : "G",
+                            name[0] == 'f' ? "Flag" : "Goal",
+                            "" );
+                os << ' ' << std::round( rel.r() * 10.0 ) / 10.0 << ' ' << std::lround( dir ) << ')';
+            }
+        }
+
+        // ball
+        {
+            const Vector2D rel = Vector2D( x_dist( engine ), y_dist( engine ) ) - self_pos;
+            const double dir = ( rel.th() - face ).degree();
+            if ( std::fabs( dir ) < half_view )
+            {
+                write_name( os << ' ', version, "b", "ball", "" );
+                os << ' ' << std::round( rel.r() * 10.0 ) / 10.0 << ' ' << std::lround( dir );
+                if ( rel.r() < 40.0 )
+                {
+                    os << ' ' << std::round( chg_dist( engine ) * 100.0 ) / 100.0
+                       << ' ' << std::round( chg_dist( engine ) * 10.0 ) / 10.0;
+                }
+                os << ')';
+            }
+        }
+
+        // players
+        for ( int i = 0; i < 22; ++i )
+        {
+            const Vector2D rel = Vector2D( x_dist( engine ), y_dist( engine ) ) - self_pos;
+            const double dir = ( rel.th() - face ).degree();
+            if ( std::fabs( dir ) >= half_view )
+            {
+                continue;
+            }
+
+            const char * team = ( i < 11 ? "HELIOS_base" : "opponent" );
+            const int unum = i % 11 + 1;
+            char rest[64];
+            if ( rel.r() < 20.0 )
+            {
+                std::snprintf( rest, sizeof( rest ), " \"%s\" %d%s", team, unum, unum == 1 ? " goalie" : "" );
+            }
+            else if ( rel.r() < 40.0 )
+            {
+                std::snprintf( rest, sizeof( rest ), " \"%s\"", team );
+            }
+            else
+            {
+                rest[0] = '\0';
+            }
+
+            write_name( os << ' ', version, "p", "player", rest );
+            os << ' ' << std::round( rel.r() * 10.0 ) / 10.0 << ' ' << std::lround( dir );
+            if ( rel.r() < 20.0 )
+            {
+                os << ' ' << std::round( chg_dist( engine ) * 100.0 ) / 100.0
+                   << ' ' << std::round( chg_dist( engine ) * 10.0 ) / 10.0
+                   << ' ' << std::lround( dir_dist( engine ) )
+                   << ' ' << std::lround( dir_dist( engine ) / 2.0 );
+                const int flag = flag_dist( engine );
+                if ( flag == 0 ) os << ' ' << std::lround( dir_dist( engine ) );
+                if ( flag == 1 ) os << " k";
+                if ( flag == 2 ) os << " t";
+            }
+            os << ')';
+        }
+
+        // lines
+        const char * lines[] = { "l", "r", "t", "b" };
+        for ( int i = 0; i < 4; ++i )
+        {
+            if ( flag_dist( engine ) < 3 )
+            {
+                write_name( os << ' ', version, "l ", "line ", lines[i] );
+                os << ' ' << std::round( ( x_dist( engine ) + 52.5 ) * 10.0 ) / 10.0
+                   << ' ' << std::lround( dir_dist( engine ) / 2.0 ) << ')';
+            }
+        }
+
+        os << ')';
+        messages.push_back( os.str() );
+    }
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+  \brief read the see messages from the file
+ */
+bool
+read_messages( const char * filepath,
+               std::vector< std::string > & messages )
+{
+    std::ifstream fin( filepath );
+    if ( ! fin )
+    {
+        std::cerr << "Failed to open " << filepath << std::endl;
+        return false;
+    }
+
+    std::string line;
+    while ( std::getline( fin, line ) )
+    {
+        const std::string::size_type pos = line.find( "(see " );
+        if ( pos != std::string::npos )
+        {
+            messages.push_back( line.substr( pos ) );
+        }
+    }
+
+    return true;
+}
+
+/*-------------------------------------------------------------------*/
+/*!
+
+ */
+void
+usage( const char * prog )
+{
+    std::cerr << "Usage: " << prog << " [--repeat N] [--version V] [SeeFile]"
+              << std::endl;
+}
+
+}
+
+////////////////////////////////////////////////////////////////////////
+
+int
+main( int argc, char ** argv )
+{
+    int repeat = 100;
+    double version = 18.0;
+    const char * filepath = nullptr;
+
+    for ( int i = 1; i < argc; ++i )
+    {
+        if ( ! std::strcmp( argv[i], "--repeat" )
+             && i + 1 < argc )
+        {
+            repeat = std::max( 1, std::atoi( argv[++i] ) );
+        }
+        else if ( ! std::strcmp( argv[i], "--version" )
+                  && i + 1 < argc )
+        {
+            version = std::atof( argv[++i] );
+        }
+        else if ( argv[i][0] != '-'
+                  && ! filepath )
+        {
+            filepath = argv[i];
+        }
+        else
+        {
+            usage( argv[0] );
+            return 0;
+        }
+    }
+
+    const std::string team_name = "HELIOS_base";
+
+    std::vector< std::string > messages;
+    if ( filepath )
+    {
+        if ( ! read_messages( filepath, messages ) )
+        {
+            return 1;
+        }
+    }
+    else
+    {
+        generate_messages( create_marker_names(), version, 1000, messages );
+    }
+
+    if ( messages.empty() )
+    {
+        std::cerr << "No see message." << std::endl;
+        return 1;
+    }
+
+    VisualSensor sensor;
+
+    double msec = 0.0;
+    std::size_t alloc_count = 0;
+    long cycle = 0;
+
+    for ( int r = 0; r < repeat; ++r )
+    {
+        const std::size_t alloc = g_alloc_count;
+        rcsc::Timer timer;
+        for ( const std::string & msg : messages )
+        {
+            sensor.parse( msg.c_str(), team_name, version, GameTime( ++cycle, 0 ) );
+        }
+        msec += timer.elapsedReal();
+        alloc_count += g_alloc_count - alloc;
+    }
+
+    const double n = static_cast< double >( messages.size() ) * repeat;
+    std::cout << messages.size() << " messages x " << repeat << '\n'
+              << msec * 1.0e3 / n << " [usec/see], "
+              << alloc_count / n << " [alloc/see]" << std::endl;
+
+    return 0;
+}